@@ -0,0 +1,300 @@
+/**
+ * EMCP_WB_BulkCreateEntity.c - Create, parent and configure many entities in one undo step
+ *
+ * entities is a record payload (see EMCP_WB_Records), one entity per line:
+ *   prefab \t name \t layerID \t position \t rotation \t parent
+ * properties is a second record payload, one property per line:
+ *   entityName \t propertyPath \t propertyKey \t value
+ * Property fields are escaped (EMCP_WB_Records.Unescape) so values may hold
+ * tabs and newlines.
+ *
+ * Entities are created in order, so parent may name an entity earlier in the
+ * same batch or one that already exists in the world. As with
+ * EMCP_WB_CreateEntity + EMCP_WB_ModifyEntity reparent, a parented entity keeps
+ * its coords as local coords (position is relative to the parent).
+ * layerID "" means layer 0.
+ *
+ * Everything runs inside one BeginEntityAction/EndEntityAction pair. Property
+ * failures are reported as warnings. With atomic = true, any create/parent
+ * failure deletes everything created by this call before the action closes;
+ * rolledBackCount and leftBehind report what that deletion actually removed.
+ *
+ * Called via NET API TCP protocol: APIFunc = "EMCP_WB_BulkCreateEntity"
+ */
+
+class EMCP_WB_BulkCreateEntityRequest : JsonApiStruct
+{
+	string entities;
+	string properties;
+	bool atomic;
+
+	void EMCP_WB_BulkCreateEntityRequest()
+	{
+		RegV("entities");
+		RegV("properties");
+		RegV("atomic");
+	}
+}
+
+class EMCP_WB_BulkCreateEntityResponse : JsonApiStruct
+{
+	string status;
+	string message;
+	int createdCount;
+	int errorCount;
+	bool rolledBack;
+	int rolledBackCount;
+
+	ref array<string> m_aCreatedNames;
+	ref array<int> m_aErrorIndices;
+	ref array<string> m_aErrorMessages;
+	ref array<string> m_aWarnings;
+	//! Entities a rollback failed to delete
+	ref array<string> m_aLeftBehind;
+
+	void EMCP_WB_BulkCreateEntityResponse()
+	{
+		RegV("status");
+		RegV("message");
+		RegV("createdCount");
+		RegV("errorCount");
+		RegV("rolledBack");
+		RegV("rolledBackCount");
+
+		m_aCreatedNames = {};
+		m_aErrorIndices = {};
+		m_aErrorMessages = {};
+		m_aWarnings = {};
+		m_aLeftBehind = {};
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddError(int index, string errMessage)
+	{
+		m_aErrorIndices.Insert(index);
+		m_aErrorMessages.Insert(errMessage);
+		errorCount++;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void OnPack()
+	{
+		// Parallel to the request records: created name, or "" where that record failed
+		StartArray("names");
+		for (int i = 0; i < m_aCreatedNames.Count(); i++)
+		{
+			StoreString("", m_aCreatedNames[i]);
+		}
+		EndArray();
+
+		StartArray("errors");
+		for (int e = 0; e < m_aErrorIndices.Count(); e++)
+		{
+			StartObject("");
+			StoreInteger("index", m_aErrorIndices[e]);
+			StoreString("message", m_aErrorMessages[e]);
+			EndObject();
+		}
+		EndArray();
+
+		StartArray("propertyWarnings");
+		for (int w = 0; w < m_aWarnings.Count(); w++)
+		{
+			StoreString("", m_aWarnings[w]);
+		}
+		EndArray();
+
+		StartArray("leftBehind");
+		for (int l = 0; l < m_aLeftBehind.Count(); l++)
+		{
+			StoreString("", m_aLeftBehind[l]);
+		}
+		EndArray();
+	}
+}
+
+class EMCP_WB_BulkCreateEntity : NetApiHandler
+{
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetRequest()
+	{
+		return new EMCP_WB_BulkCreateEntityRequest();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetResponse(JsonApiStruct request)
+	{
+		EMCP_WB_BulkCreateEntityRequest req = EMCP_WB_BulkCreateEntityRequest.Cast(request);
+		EMCP_WB_BulkCreateEntityResponse resp = new EMCP_WB_BulkCreateEntityResponse();
+
+		array<ref array<string>> entityRows = {};
+		EMCP_WB_Records.Parse(req.entities, entityRows);
+		if (entityRows.Count() == 0)
+		{
+			resp.status = "error";
+			resp.message = "entities parameter required (one 'prefab\\tname\\tlayerID\\tposition\\trotation\\tparent' record per line)";
+			return resp;
+		}
+
+		array<ref array<string>> propertyRows = {};
+		EMCP_WB_Records.Parse(req.properties, propertyRows);
+
+		WorldEditor worldEditor = Workbench.GetModule(WorldEditor);
+		if (!worldEditor)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditor module not available";
+			return resp;
+		}
+
+		WorldEditorAPI api = worldEditor.GetApi();
+		if (!api)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditorAPI not available (in game mode?)";
+			return resp;
+		}
+
+		// Entities created by this call, by requested name, so later records can parent to them
+		map<string, IEntitySource> batchByName = new map<string, IEntitySource>();
+		array<IEntitySource> created = {};
+		// Request record of each created entity, parallel to created
+		array<int> createdRows = {};
+
+		api.BeginEntityAction("Bulk create " + entityRows.Count().ToString() + " entities via NetAPI");
+
+		for (int i = 0; i < entityRows.Count(); i++)
+		{
+			array<string> row = entityRows[i];
+			string prefab = EMCP_WB_Records.Field(row, 0);
+			string entityName = EMCP_WB_Records.Field(row, 1);
+			string layerField = EMCP_WB_Records.Field(row, 2);
+			string parentName = EMCP_WB_Records.Field(row, 5);
+
+			resp.m_aCreatedNames.Insert("");
+
+			if (prefab == "")
+			{
+				resp.AddError(i, "prefab is empty");
+				continue;
+			}
+
+			IEntitySource parentSrc;
+			if (parentName != "")
+			{
+				if (!batchByName.Find(parentName, parentSrc))
+					parentSrc = EMCP_WB_EntityIndex.Find(api, parentName);
+
+				if (!parentSrc)
+				{
+					resp.AddError(i, "Parent entity not found: " + parentName);
+					continue;
+				}
+			}
+
+			int targetLayer = 0;
+			if (layerField != "")
+				targetLayer = layerField.ToInt();
+
+			vector pos = EMCP_WB_CreateEntity.ParseVectorString(EMCP_WB_Records.Field(row, 3));
+			vector rot = EMCP_WB_CreateEntity.ParseVectorString(EMCP_WB_Records.Field(row, 4));
+
+			IEntitySource entSrc = api.CreateEntity(prefab, entityName, targetLayer, null, pos, rot);
+			if (!entSrc)
+			{
+				resp.AddError(i, "CreateEntity returned null. Check prefab path: " + prefab);
+				continue;
+			}
+
+			if (entityName != "" && entSrc.GetName() != entityName)
+				api.RenameEntity(entSrc, entityName);
+
+			// false = keep coords as local coords, matches EMCP_WB_ModifyEntity reparent
+			if (parentSrc)
+				api.ParentEntity(parentSrc, entSrc, false);
+
+			created.Insert(entSrc);
+			createdRows.Insert(i);
+			resp.m_aCreatedNames[i] = entSrc.GetName();
+			if (entityName != "")
+				batchByName.Set(entityName, entSrc);
+		}
+
+		if (req.atomic && resp.errorCount > 0)
+		{
+			// Children first so no deletion removes an entity we still hold
+			array<IEntitySource> kept = {};
+			for (int d = created.Count() - 1; d >= 0; d--)
+			{
+				string createdName = created[d].GetName();
+				if (api.DeleteEntity(created[d]))
+				{
+					resp.m_aCreatedNames[createdRows[d]] = "";
+					resp.rolledBackCount++;
+				}
+				else
+				{
+					resp.m_aLeftBehind.Insert(createdName);
+					kept.Insert(created[d]);
+				}
+			}
+			created = kept;
+			resp.rolledBack = true;
+		}
+		else
+		{
+			for (int p = 0; p < propertyRows.Count(); p++)
+			{
+				array<string> propRow = propertyRows[p];
+				string targetName = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(propRow, 0));
+				string propertyPath = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(propRow, 1));
+				string propertyKey = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(propRow, 2));
+				string propertyValue = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(propRow, 3));
+				string propLabel = targetName + " " + propertyPath + "." + propertyKey + " = " + propertyValue;
+
+				IEntitySource targetSrc;
+				if (!batchByName.Find(targetName, targetSrc))
+					targetSrc = EMCP_WB_EntityIndex.Find(api, targetName);
+
+				if (!targetSrc)
+				{
+					resp.m_aWarnings.Insert(propLabel + " (entity not found)");
+					continue;
+				}
+
+				array<ref ContainerIdPathEntry> pathEntries = EMCP_WB_ModifyEntity.BuildPathEntries(propertyPath);
+				if (!api.SetVariableValue(targetSrc, pathEntries, propertyKey, propertyValue))
+					resp.m_aWarnings.Insert(propLabel + " (SetVariableValue returned false)");
+			}
+		}
+
+		api.EndEntityAction();
+
+		for (int c = 0; c < created.Count(); c++)
+		{
+			EMCP_WB_EntityIndex.OnCreated(api, created[c]);
+			EMCP_WB_ChangeJournal.OnCreated(created[c]);
+		}
+
+		resp.createdCount = created.Count();
+		if (resp.errorCount == 0)
+			resp.status = "ok";
+		else if (resp.createdCount > 0)
+			resp.status = "partial";
+		else
+			resp.status = "error";
+
+		resp.message = "Created " + resp.createdCount.ToString() + " of " + entityRows.Count().ToString() + " entities";
+		if (resp.rolledBack)
+		{
+			resp.message = resp.message + " (rolled back " + resp.rolledBackCount.ToString() + " after " + resp.errorCount.ToString() + " errors";
+			if (resp.m_aLeftBehind.Count() > 0)
+				resp.message = resp.message + ", " + resp.m_aLeftBehind.Count().ToString() + " could not be deleted";
+			resp.message = resp.message + ")";
+		}
+		if (resp.m_aWarnings.Count() > 0)
+			resp.message = resp.message + ", " + resp.m_aWarnings.Count().ToString() + " property warnings";
+
+		return resp;
+	}
+}
@@ -0,0 +1,266 @@
+/**
+ * EMCP_WB_BulkModifyEntity.c - Apply many entity edits as one undo step
+ *
+ * ops is a record payload (see EMCP_WB_Records), one operation per line:
+ *   action \t name \t value \t propertyPath \t propertyKey
+ * Actions: move, rotate, rename, reparent, setProperty, clearProperty
+ * (same semantics as the matching EMCP_WB_ModifyEntity actions).
+ *
+ * All operations run inside a single BeginEntityAction/EndEntityAction pair,
+ * so the whole batch is one undo step and one editor refresh. Failed operations
+ * are reported per-op and do not roll back the others; with stopOnError the
+ * remaining operations are reported as "skipped".
+ *
+ * Called via NET API TCP protocol: APIFunc = "EMCP_WB_BulkModifyEntity"
+ */
+
+class EMCP_WB_BulkModifyEntityRequest : JsonApiStruct
+{
+	string ops;
+	bool stopOnError;
+
+	void EMCP_WB_BulkModifyEntityRequest()
+	{
+		RegV("ops");
+		RegV("stopOnError");
+	}
+}
+
+class EMCP_WB_BulkOpResult
+{
+	int m_iIndex;
+	string m_sName;
+	string m_sAction;
+	string m_sStatus;
+	string m_sMessage;
+}
+
+class EMCP_WB_BulkModifyEntityResponse : JsonApiStruct
+{
+	string status;
+	string message;
+	int opCount;
+	int okCount;
+	int errorCount;
+	ref array<ref EMCP_WB_BulkOpResult> m_aResults;
+
+	void EMCP_WB_BulkModifyEntityResponse()
+	{
+		RegV("status");
+		RegV("message");
+		RegV("opCount");
+		RegV("okCount");
+		RegV("errorCount");
+		m_aResults = {};
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddResult(int index, string name, string action, string opStatus, string opMessage)
+	{
+		EMCP_WB_BulkOpResult r = new EMCP_WB_BulkOpResult();
+		r.m_iIndex = index;
+		r.m_sName = name;
+		r.m_sAction = action;
+		r.m_sStatus = opStatus;
+		r.m_sMessage = opMessage;
+		m_aResults.Insert(r);
+
+		if (opStatus == "ok")
+			okCount++;
+		else if (opStatus == "error")
+			errorCount++;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void OnPack()
+	{
+		StartArray("results");
+		for (int i = 0; i < m_aResults.Count(); i++)
+		{
+			EMCP_WB_BulkOpResult r = m_aResults[i];
+			StartObject("");
+			StoreInteger("index", r.m_iIndex);
+			StoreString("name", r.m_sName);
+			StoreString("action", r.m_sAction);
+			StoreString("status", r.m_sStatus);
+			StoreString("message", r.m_sMessage);
+			EndObject();
+		}
+		EndArray();
+	}
+}
+
+class EMCP_WB_BulkModifyEntity : NetApiHandler
+{
+	//------------------------------------------------------------------------------------------------
+	//! Apply one operation. Must be called inside an open entity action. Returns "" on success, else the error.
+	static string ApplyOp(WorldEditorAPI api, string action, string name, string value, string propertyPath, string propertyKey)
+	{
+		IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, name);
+		if (!entSrc)
+			return "Entity not found: " + name;
+
+		if (action == "move")
+		{
+			if (value == "")
+				return "value required for move ('x y z')";
+
+			if (!api.SetVariableValue(entSrc, null, "coords", value))
+				return "SetVariableValue(coords) returned false";
+
+			EMCP_WB_SpatialGrid.Invalidate();
+			EMCP_WB_ChangeJournal.OnMoved(name, EMCP_WB_ModifyEntity.ParseVectorString(value));
+			return "";
+		}
+
+		if (action == "rotate")
+		{
+			if (value == "")
+				return "value required for rotate ('pitch yaw roll')";
+
+			vector angles = EMCP_WB_ModifyEntity.ParseVectorString(value);
+			api.SetVariableValue(entSrc, null, "angleX", angles[0].ToString());
+			api.SetVariableValue(entSrc, null, "angleY", angles[1].ToString());
+			api.SetVariableValue(entSrc, null, "angleZ", angles[2].ToString());
+			EMCP_WB_ChangeJournal.Record("rotate", name, value);
+			return "";
+		}
+
+		if (action == "rename")
+		{
+			if (value == "")
+				return "value required for rename (new name)";
+
+			string oldName = entSrc.GetName();
+			if (!api.RenameEntity(entSrc, value))
+				return "RenameEntity returned false";
+
+			EMCP_WB_EntityIndex.OnRenamed(oldName, value);
+			EMCP_WB_ChangeJournal.OnRenamed(oldName, value);
+			return "";
+		}
+
+		if (action == "reparent")
+		{
+			if (value == "")
+				return "value required for reparent (parent entity name)";
+
+			IEntitySource parentSrc = EMCP_WB_EntityIndex.Find(api, value);
+			if (!parentSrc)
+				return "Parent entity not found: " + value;
+
+			api.ParentEntity(parentSrc, entSrc, false); // false = keep local coords, matches EMCP_WB_ModifyEntity
+			EMCP_WB_SpatialGrid.Invalidate();
+			EMCP_WB_ChangeJournal.Record("reparent", name, value);
+			return "";
+		}
+
+		if (action == "setProperty")
+		{
+			if (propertyKey == "")
+				return "propertyKey required for setProperty";
+
+			array<ref ContainerIdPathEntry> setPath = EMCP_WB_ModifyEntity.BuildPathEntries(propertyPath);
+			if (!api.SetVariableValue(entSrc, setPath, propertyKey, value))
+				return "SetVariableValue returned false for key: " + propertyKey;
+			EMCP_WB_ChangeJournal.Record("property", name, propertyPath + "." + propertyKey + " = " + value);
+			return "";
+		}
+
+		if (action == "clearProperty")
+		{
+			if (propertyKey == "")
+				return "propertyKey required for clearProperty";
+
+			array<ref ContainerIdPathEntry> clearPath = EMCP_WB_ModifyEntity.BuildPathEntries(propertyPath);
+			if (!api.ClearVariableValue(entSrc, clearPath, propertyKey))
+				return "ClearVariableValue returned false for key: " + propertyKey;
+			EMCP_WB_ChangeJournal.Record("property", name, propertyPath + "." + propertyKey + " cleared");
+			return "";
+		}
+
+		return "Unknown action: " + action + ". Valid: move, rotate, rename, reparent, setProperty, clearProperty";
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetRequest()
+	{
+		return new EMCP_WB_BulkModifyEntityRequest();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetResponse(JsonApiStruct request)
+	{
+		EMCP_WB_BulkModifyEntityRequest req = EMCP_WB_BulkModifyEntityRequest.Cast(request);
+		EMCP_WB_BulkModifyEntityResponse resp = new EMCP_WB_BulkModifyEntityResponse();
+
+		array<ref array<string>> rows = {};
+		EMCP_WB_Records.Parse(req.ops, rows);
+		resp.opCount = rows.Count();
+
+		if (rows.Count() == 0)
+		{
+			resp.status = "error";
+			resp.message = "ops parameter required (one 'action\\tname\\tvalue\\tpropertyPath\\tpropertyKey' record per line)";
+			return resp;
+		}
+
+		WorldEditor worldEditor = Workbench.GetModule(WorldEditor);
+		if (!worldEditor)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditor module not available";
+			return resp;
+		}
+
+		WorldEditorAPI api = worldEditor.GetApi();
+		if (!api)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditorAPI not available";
+			return resp;
+		}
+
+		bool stopped = false;
+		api.BeginEntityAction("Bulk modify " + rows.Count().ToString() + " entities via NetAPI");
+		for (int i = 0; i < rows.Count(); i++)
+		{
+			array<string> row = rows[i];
+			string action = EMCP_WB_Records.Field(row, 0);
+			string name = EMCP_WB_Records.Field(row, 1);
+
+			if (stopped)
+			{
+				resp.AddResult(i, name, action, "skipped", "Skipped after earlier error (stopOnError)");
+				continue;
+			}
+
+			string err = ApplyOp(api, action, name,
+				EMCP_WB_Records.Field(row, 2),
+				EMCP_WB_Records.Field(row, 3),
+				EMCP_WB_Records.Field(row, 4));
+
+			if (err == "")
+			{
+				resp.AddResult(i, name, action, "ok", "");
+			}
+			else
+			{
+				resp.AddResult(i, name, action, "error", err);
+				if (req.stopOnError)
+					stopped = true;
+			}
+		}
+		api.EndEntityAction();
+
+		if (resp.errorCount == 0)
+			resp.status = "ok";
+		else if (resp.okCount > 0)
+			resp.status = "partial";
+		else
+			resp.status = "error";
+
+		resp.message = "Applied " + resp.okCount.ToString() + " of " + resp.opCount.ToString() + " operations in one undo step";
+		return resp;
+	}
+}
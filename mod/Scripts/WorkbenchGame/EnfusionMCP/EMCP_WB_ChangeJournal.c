@@ -0,0 +1,205 @@
+/**
+ * EMCP_WB_ChangeJournal.c - Sequence-numbered log of World Editor changes
+ *
+ * Every event gets a monotonically increasing seq. Clients remember the last
+ * seq they saw and ask EMCP_WB_GetChanges for everything after it, so keeping a
+ * mirror of the level in sync costs O(changes) instead of a full re-list.
+ *
+ * Two sources feed the journal:
+ *   - our own handlers record create/delete/rename/move/rotate/reparent/property
+ *     events as they apply them (exact, no scan needed)
+ *   - Diff() compares entity names and "coords" against a baseline to catch
+ *     edits made elsewhere (GUI, undo, clipboard). It only reads the entity
+ *     source (no SourceToEntity) and is rate-limited to DIFF_INTERVAL_MS.
+ *     External renames show up as delete + create.
+ *
+ * Handler events also patch the diff baseline so they are not reported twice.
+ * Events live in a ring buffer of CAPACITY; a client that falls further behind
+ * than that is told to resync from a full listing.
+ *
+ * The journal is static script state, so a script recompile or Workbench
+ * restart starts it over at seq 0. Epoch() identifies one journal lifetime;
+ * clients keep it with their cursor so a restart is never mistaken for
+ * "no changes" or continued at an unrelated seq.
+ */
+
+class EMCP_WB_ChangeEvent
+{
+	int m_iSeq;
+	string m_sType;
+	string m_sName;
+	string m_sDetail;
+}
+
+class EMCP_WB_ChangeJournal
+{
+	static const int CAPACITY = 8192;
+	static const int DIFF_INTERVAL_MS = 1000;
+
+	protected static ref array<ref EMCP_WB_ChangeEvent> s_aRing;
+	protected static int s_iLastSeq;
+	protected static string s_sEpoch;
+
+	// Diff baseline: entity name -> coords at the last diff or handler event
+	protected static ref map<string, vector> s_mBaseline;
+	protected static int s_iLastDiffTick;
+
+	//------------------------------------------------------------------------------------------------
+	static void Record(string type, string name, string detail)
+	{
+		if (!s_aRing)
+		{
+			s_aRing = {};
+			s_aRing.Resize(CAPACITY);
+		}
+
+		EMCP_WB_ChangeEvent ev = new EMCP_WB_ChangeEvent();
+		s_iLastSeq++;
+		ev.m_iSeq = s_iLastSeq;
+		ev.m_sType = type;
+		ev.m_sName = name;
+		ev.m_sDetail = detail;
+		s_aRing[s_iLastSeq % CAPACITY] = ev;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Id of this journal's lifetime, chosen on first use after the scripts were (re)loaded.
+	static string Epoch()
+	{
+		if (s_sEpoch == "")
+			s_sEpoch = System.GetUnixTime().ToString() + "-" + Math.RandomInt(0, int.MAX).ToString();
+		return s_sEpoch;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static int LatestSeq()
+	{
+		return s_iLastSeq;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Oldest seq still held (LatestSeq() + 1 when the journal is empty).
+	static int OldestSeq()
+	{
+		return Math.Max(1, s_iLastSeq - CAPACITY + 1);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Events with seq > since, oldest first, at most limit.
+	static void Since(int since, int limit, notnull array<ref EMCP_WB_ChangeEvent> outEvents)
+	{
+		if (!s_aRing)
+			return;
+
+		int first = Math.Max(since + 1, OldestSeq());
+		for (int seq = first; seq <= s_iLastSeq && outEvents.Count() < limit; seq++)
+		{
+			outEvents.Insert(s_aRing[seq % CAPACITY]);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void OnCreated(IEntitySource entSrc)
+	{
+		if (!entSrc)
+			return;
+
+		string entName = entSrc.GetName();
+		string coords;
+		entSrc.Get("coords", coords);
+		if (s_mBaseline && entName != "")
+			s_mBaseline.Set(entName, EMCP_WB_ModifyEntity.ParseVectorString(coords));
+
+		Record("create", entName, coords);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void OnDeleted(string name)
+	{
+		if (s_mBaseline)
+			s_mBaseline.Remove(name);
+
+		Record("delete", name, "");
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void OnRenamed(string oldName, string newName)
+	{
+		if (s_mBaseline)
+		{
+			vector coords;
+			if (s_mBaseline.Find(oldName, coords))
+			{
+				s_mBaseline.Remove(oldName);
+				s_mBaseline.Set(newName, coords);
+			}
+		}
+
+		Record("rename", oldName, newName);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void OnMoved(string name, vector coords)
+	{
+		if (s_mBaseline && s_mBaseline.Contains(name))
+			s_mBaseline.Set(name, coords);
+
+		Record("move", name, coords[0].ToString() + " " + coords[1].ToString() + " " + coords[2].ToString());
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Detect changes made outside our handlers. Returns true if a scan ran.
+	static bool Diff(WorldEditorAPI api, bool force)
+	{
+		int now = System.GetTickCount();
+		if (!force && s_mBaseline && now - s_iLastDiffTick < DIFF_INTERVAL_MS)
+			return false;
+
+		s_iLastDiffTick = now;
+		map<string, vector> current = new map<string, vector>();
+		int count = api.GetEditorEntityCount();
+		for (int i = 0; i < count; i++)
+		{
+			IEntitySource entSrc = api.GetEditorEntity(i);
+			if (!entSrc)
+				continue;
+
+			string entName = entSrc.GetName();
+			if (entName == "" || current.Contains(entName))
+				continue;
+
+			string coordsStr;
+			entSrc.Get("coords", coordsStr);
+			current.Set(entName, EMCP_WB_ModifyEntity.ParseVectorString(coordsStr));
+		}
+
+		// First scan only establishes the baseline
+		if (!s_mBaseline)
+		{
+			s_mBaseline = current;
+			return true;
+		}
+
+		for (int c = 0; c < current.Count(); c++)
+		{
+			string curName = current.GetKey(c);
+			vector curCoords = current.GetElement(c);
+
+			vector oldCoords;
+			if (!s_mBaseline.Find(curName, oldCoords))
+				Record("create", curName, curCoords[0].ToString() + " " + curCoords[1].ToString() + " " + curCoords[2].ToString());
+			else if (vector.DistanceSq(oldCoords, curCoords) > 0.0001)
+				Record("move", curName, curCoords[0].ToString() + " " + curCoords[1].ToString() + " " + curCoords[2].ToString());
+		}
+
+		for (int b = 0; b < s_mBaseline.Count(); b++)
+		{
+			string oldName = s_mBaseline.GetKey(b);
+			if (!current.Contains(oldName))
+				Record("delete", oldName, "");
+		}
+
+		s_mBaseline = current;
+		return true;
+	}
+}
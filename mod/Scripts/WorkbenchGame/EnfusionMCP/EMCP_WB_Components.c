@@ -1,7 +1,21 @@
 /**
  * EMCP_WB_Components.c - Component management handler
  *
- * Actions: add, remove, list
+ * Actions: add, remove, list, bulkAdd, bulkRemove
+ *
+ * bulkAdd/bulkRemove apply componentClass to a set of entities in one entity
+ * action (one undo step). The set is chosen by a selector:
+ *   names        - newline-separated entity names
+ *   useSelection - the current World Editor selection
+ *   classFilter / prefabFilter - case-insensitive substrings of the class name /
+ *                  any prefab in the ancestor chain. They narrow names/selection
+ *                  when given, otherwise they are matched against every entity.
+ * bulkAdd applies properties (EMCP_WB_Records, one 'propertyPath\tpropertyKey\tvalue'
+ * per line, path relative to the new component, fields escaped and decoded with
+ * EMCP_WB_Records.Unescape) and skips entities that already
+ * have the class when skipExisting is set. bulkRemove removes the first
+ * component of the class. Outcomes are reported per entity in results.
+ *
  * Called via NET API TCP protocol: APIFunc = "EMCP_WB_Components"
  */
 
@@ -12,12 +26,26 @@ class EMCP_WB_ComponentsRequest : JsonApiStruct
 	string componentClass;
 	int componentIndex;
 
+	// bulkAdd / bulkRemove
+	string names;
+	bool useSelection;
+	string classFilter;
+	string prefabFilter;
+	string properties;
+	bool skipExisting;
+
 	void EMCP_WB_ComponentsRequest()
 	{
 		RegV("entityName");
 		RegV("action");
 		RegV("componentClass");
 		RegV("componentIndex");
+		RegV("names");
+		RegV("useSelection");
+		RegV("classFilter");
+		RegV("prefabFilter");
+		RegV("properties");
+		RegV("skipExisting");
 		componentIndex = -1;
 	}
 }
@@ -29,11 +57,19 @@ class EMCP_WB_ComponentsResponse : JsonApiStruct
 	string entityName;
 	string action;
 	int componentCount;
+	int okCount;
+	int skippedCount;
+	int errorCount;
 
 	// Component data for list action
 	ref array<string> m_aComponentClasses;
 	ref array<int> m_aComponentIndices;
 
+	// Per-entity outcomes for bulk actions
+	ref array<string> m_aResultNames;
+	ref array<string> m_aResultStatus;
+	ref array<string> m_aResultMessages;
+
 	void EMCP_WB_ComponentsResponse()
 	{
 		RegV("status");
@@ -41,9 +77,30 @@ class EMCP_WB_ComponentsResponse : JsonApiStruct
 		RegV("entityName");
 		RegV("action");
 		RegV("componentCount");
+		RegV("okCount");
+		RegV("skippedCount");
+		RegV("errorCount");
 
 		m_aComponentClasses = {};
 		m_aComponentIndices = {};
+		m_aResultNames = {};
+		m_aResultStatus = {};
+		m_aResultMessages = {};
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddResult(string entName, string resultStatus, string resultMessage)
+	{
+		m_aResultNames.Insert(entName);
+		m_aResultStatus.Insert(resultStatus);
+		m_aResultMessages.Insert(resultMessage);
+
+		if (resultStatus == "ok")
+			okCount++;
+		else if (resultStatus == "skipped")
+			skippedCount++;
+		else
+			errorCount++;
 	}
 
 	override void OnPack()
@@ -60,24 +117,240 @@ class EMCP_WB_ComponentsResponse : JsonApiStruct
 			}
 			EndArray();
 		}
+
+		if (m_aResultNames.Count() > 0)
+		{
+			StartArray("results");
+			for (int r = 0; r < m_aResultNames.Count(); r++)
+			{
+				StartObject("");
+				StoreString("name", m_aResultNames[r]);
+				StoreString("status", m_aResultStatus[r]);
+				StoreString("message", m_aResultMessages[r]);
+				EndObject();
+			}
+			EndArray();
+		}
 	}
 }
 
 class EMCP_WB_Components : NetApiHandler
 {
 	//------------------------------------------------------------------------------------------------
-	static IEntitySource FindEntityByName(WorldEditorAPI api, string name)
+	//! First component of exactly componentClass, or null.
+	static IEntityComponentSource FindComponent(IEntitySource entSrc, string componentClass)
 	{
-		int count = api.GetEditorEntityCount();
-		for (int i = 0; i < count; i++)
+		int compCount = entSrc.GetComponentCount();
+		for (int i = 0; i < compCount; i++)
 		{
-			IEntitySource candidate = api.GetEditorEntity(i);
-			if (candidate && candidate.GetName() == name)
-				return candidate;
+			IEntityComponentSource comp = entSrc.GetComponent(i);
+			if (comp && comp.GetClassName() == componentClass)
+				return comp;
 		}
 		return null;
 	}
 
+	//------------------------------------------------------------------------------------------------
+	//! Index of comp among entSrc's components, or -1.
+	static int ComponentIndex(IEntitySource entSrc, IEntityComponentSource comp)
+	{
+		int compCount = entSrc.GetComponentCount();
+		for (int i = 0; i < compCount; i++)
+		{
+			if (entSrc.GetComponent(i) == comp)
+				return i;
+		}
+		return -1;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Resolve the bulk selector into target entities. Unknown names are reported as errors on resp.
+	static void CollectTargets(WorldEditorAPI api, EMCP_WB_ComponentsRequest req, EMCP_WB_ComponentsResponse resp, notnull array<IEntitySource> outTargets)
+	{
+		array<IEntitySource> candidates = {};
+		bool explicitSet = false;
+
+		if (req.names != "")
+		{
+			explicitSet = true;
+			array<string> nameList = {};
+			req.names.Split("\n", nameList, true);
+			for (int n = 0; n < nameList.Count(); n++)
+			{
+				string wanted = nameList[n].Trim();
+				if (wanted == "")
+					continue;
+
+				IEntitySource namedSrc = EMCP_WB_EntityIndex.Find(api, wanted);
+				if (namedSrc)
+					candidates.Insert(namedSrc);
+				else
+					resp.AddResult(wanted, "error", "Entity not found");
+			}
+		}
+
+		if (req.useSelection)
+		{
+			explicitSet = true;
+			int selCount = api.GetSelectedEntitiesCount();
+			for (int s = 0; s < selCount; s++)
+			{
+				IEntitySource selSrc = api.GetSelectedEntity(s);
+				if (selSrc)
+					candidates.Insert(selSrc);
+			}
+		}
+
+		if (!explicitSet)
+		{
+			int count = api.GetEditorEntityCount();
+			for (int i = 0; i < count; i++)
+			{
+				IEntitySource entSrc = api.GetEditorEntity(i);
+				if (entSrc)
+					candidates.Insert(entSrc);
+			}
+		}
+
+		string classFilter = req.classFilter;
+		classFilter.ToLower();
+		string prefabFilter = req.prefabFilter;
+		prefabFilter.ToLower();
+
+		set<IEntitySource> seen = new set<IEntitySource>();
+		for (int c = 0; c < candidates.Count(); c++)
+		{
+			IEntitySource candidate = candidates[c];
+			if (seen.Contains(candidate))
+				continue;
+			seen.Insert(candidate);
+
+			if (classFilter != "")
+			{
+				string lowerClass = candidate.GetClassName();
+				lowerClass.ToLower();
+				if (!lowerClass.Contains(classFilter))
+					continue;
+			}
+
+			if (prefabFilter != "" && !EMCP_WB_ListEntities.PrefabChainMatches(candidate, prefabFilter))
+				continue;
+
+			outTargets.Insert(candidate);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! bulkAdd / bulkRemove over the selector in one entity action.
+	static void ApplyBulk(WorldEditorAPI api, EMCP_WB_ComponentsRequest req, EMCP_WB_ComponentsResponse resp)
+	{
+		if (req.componentClass == "")
+		{
+			resp.status = "error";
+			resp.message = "componentClass parameter required for " + req.action;
+			return;
+		}
+
+		if (req.names == "" && !req.useSelection && req.classFilter == "" && req.prefabFilter == "")
+		{
+			resp.status = "error";
+			resp.message = "Selector required: names, useSelection, classFilter or prefabFilter";
+			return;
+		}
+
+		array<IEntitySource> targets = {};
+		CollectTargets(api, req, resp, targets);
+
+		array<ref array<string>> propRows = {};
+		EMCP_WB_Records.Parse(req.properties, propRows);
+
+		bool adding = req.action == "bulkAdd";
+		if (adding)
+			api.BeginEntityAction("Bulk add component " + req.componentClass + " via NetAPI");
+		else
+			api.BeginEntityAction("Bulk remove component " + req.componentClass + " via NetAPI");
+
+		for (int t = 0; t < targets.Count(); t++)
+		{
+			IEntitySource target = targets[t];
+			string targetName = target.GetName();
+			IEntityComponentSource existing = FindComponent(target, req.componentClass);
+
+			if (!adding)
+			{
+				if (!existing)
+				{
+					resp.AddResult(targetName, "skipped", "No " + req.componentClass + " component");
+					continue;
+				}
+
+				if (api.DeleteComponent(target, existing))
+				{
+					resp.AddResult(targetName, "ok", "");
+					EMCP_WB_ChangeJournal.Record("component", targetName, "-" + req.componentClass);
+				}
+				else
+				{
+					resp.AddResult(targetName, "error", "DeleteComponent returned false");
+				}
+				continue;
+			}
+
+			if (existing && req.skipExisting)
+			{
+				resp.AddResult(targetName, "skipped", "Already has " + req.componentClass);
+				continue;
+			}
+
+			IEntityComponentSource newComp = api.CreateComponent(target, req.componentClass);
+			if (!newComp)
+			{
+				resp.AddResult(targetName, "error", "CreateComponent returned null");
+				continue;
+			}
+
+			// A class-name path entry resolves to the first component of that class,
+			// which is the pre-existing one when skipExisting is off; address the new
+			// component by its index instead
+			string compPath = "components[" + ComponentIndex(target, newComp).ToString() + "]";
+			string failedProps = "";
+			for (int p = 0; p < propRows.Count(); p++)
+			{
+				array<string> propRow = propRows[p];
+				string subPath = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(propRow, 0));
+				string propKey = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(propRow, 1));
+				string fullPath = compPath;
+				if (subPath != "")
+					fullPath = fullPath + "." + subPath;
+
+				array<ref ContainerIdPathEntry> pathEntries = EMCP_WB_ModifyEntity.BuildPathEntries(fullPath);
+				if (!api.SetVariableValue(target, pathEntries, propKey, EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(propRow, 2))))
+				{
+					if (failedProps != "")
+						failedProps += ", ";
+					failedProps += propKey;
+				}
+			}
+
+			if (failedProps == "")
+				resp.AddResult(targetName, "ok", "");
+			else
+				resp.AddResult(targetName, "ok", "Added, but properties failed: " + failedProps);
+			EMCP_WB_ChangeJournal.Record("component", targetName, "+" + req.componentClass);
+		}
+
+		api.EndEntityAction();
+
+		if (resp.errorCount == 0)
+			resp.status = "ok";
+		else if (resp.okCount > 0)
+			resp.status = "partial";
+		else
+			resp.status = "error";
+
+		resp.message = req.action + " " + req.componentClass + ": " + resp.okCount.ToString() + " ok, " + resp.skippedCount.ToString() + " skipped, " + resp.errorCount.ToString() + " failed of " + targets.Count().ToString() + " matched";
+	}
+
 	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
@@ -92,7 +365,8 @@ class EMCP_WB_Components : NetApiHandler
 		resp.action = req.action;
 		resp.entityName = req.entityName;
 
-		if (req.entityName == "")
+		bool isBulk = req.action == "bulkAdd" || req.action == "bulkRemove";
+		if (!isBulk && req.entityName == "")
 		{
 			resp.status = "error";
 			resp.message = "entityName parameter required";
@@ -115,7 +389,13 @@ class EMCP_WB_Components : NetApiHandler
 			return resp;
 		}
 
-		IEntitySource entSrc = FindEntityByName(api, req.entityName);
+		if (isBulk)
+		{
+			ApplyBulk(api, req, resp);
+			return resp;
+		}
+
+		IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.entityName);
 		if (!entSrc)
 		{
 			resp.status = "error";
@@ -221,7 +501,7 @@ class EMCP_WB_Components : NetApiHandler
 		else
 		{
 			resp.status = "error";
-			resp.message = "Unknown action: " + req.action + ". Valid: add, remove, list";
+			resp.message = "Unknown action: " + req.action + ". Valid: add, remove, list, bulkAdd, bulkRemove";
 		}
 
 		return resp;
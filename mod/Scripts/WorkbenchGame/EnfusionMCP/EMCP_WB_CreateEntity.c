@@ -134,6 +134,8 @@ class EMCP_WB_CreateEntity : NetApiHandler
 		}
 
 		api.EndEntityAction();
+		EMCP_WB_EntityIndex.OnCreated(api, entSrc);
+		EMCP_WB_ChangeJournal.OnCreated(entSrc);
 
 		resp.entityName = entSrc.GetName();
 		resp.entityClass = entSrc.GetClassName();
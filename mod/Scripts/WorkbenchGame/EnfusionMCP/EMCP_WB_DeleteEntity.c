@@ -36,19 +36,6 @@ class EMCP_WB_DeleteEntityResponse : JsonApiStruct
 
 class EMCP_WB_DeleteEntity : NetApiHandler
 {
-	//------------------------------------------------------------------------------------------------
-	static IEntitySource FindEntityByName(WorldEditorAPI api, string name)
-	{
-		int count = api.GetEditorEntityCount();
-		for (int i = 0; i < count; i++)
-		{
-			IEntitySource candidate = api.GetEditorEntity(i);
-			if (candidate && candidate.GetName() == name)
-				return candidate;
-		}
-		return null;
-	}
-
 	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
@@ -84,7 +71,7 @@ class EMCP_WB_DeleteEntity : NetApiHandler
 			return resp;
 		}
 
-		IEntitySource entSrc = FindEntityByName(api, req.name);
+		IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.name);
 		if (!entSrc)
 		{
 			resp.status = "error";
@@ -103,6 +90,8 @@ class EMCP_WB_DeleteEntity : NetApiHandler
 
 		if (deleted)
 		{
+			EMCP_WB_EntityIndex.OnDeleted(resp.deletedName);
+			EMCP_WB_ChangeJournal.OnDeleted(resp.deletedName);
 			resp.status = "ok";
 			resp.message = "Entity deleted: " + resp.deletedName;
 		}
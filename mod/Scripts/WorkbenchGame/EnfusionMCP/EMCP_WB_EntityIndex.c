@@ -0,0 +1,184 @@
+/**
+ * EMCP_WB_EntityIndex.c - Shared name -> editor entity lookup for all handlers
+ *
+ * Replaces the per-handler FindEntityByName loops over GetEditorEntityCount().
+ * The index maps entity name -> editor entity index and is built once on first use.
+ *
+ * Entries are only hints: every hit is verified in O(1) by re-reading
+ * GetEditorEntity(index) and comparing its name, so a stale entry (entity
+ * deleted, indices shifted by another edit, world reloaded, cut/paste in the
+ * GUI) is never returned. A failed verification rebuilds the index once and
+ * retries. A plain miss rebuilds when StructureGeneration() moved since the
+ * last rebuild, and otherwise at most once per name per MISS_REBUILD_MS, so an
+ * entity renamed in the GUI is still found under its new name while repeated
+ * failing lookups (existence checks before a create) stay O(1).
+ *
+ * Indices are stored instead of IEntitySource pointers so a deleted entity never
+ * leaves a dangling source in the map.
+ *
+ * Create/delete/rename handlers keep the index in sync via OnCreated/OnDeleted/OnRenamed.
+ *
+ * StructureGeneration() changes whenever our handlers add or remove entities,
+ * and when the entity count changes under it (GUI, clipboard, undo). Outside
+ * edits that keep the count - a delete plus a create, or undo/redo of such a
+ * pair - are not detected, so index-based cursors and the miss-rebuild rule
+ * can in that case still act on shifted indices (verification keeps Find()
+ * from returning the wrong entity).
+ */
+
+class EMCP_WB_EntityIndex
+{
+	protected static ref map<string, int> s_mNameToIndex;
+	protected static int s_iStructureGeneration;
+	protected static int s_iLastSeenCount = -1;
+	//! StructureGeneration() token the index was last rebuilt at.
+	protected static string s_sIndexedGeneration;
+	//! Name -> tick of the last rebuild a plain miss on it triggered, for the current generation.
+	protected static ref map<string, int> s_mMissRebuildTick;
+
+	static const int MISS_REBUILD_MS = 1000;
+
+	//------------------------------------------------------------------------------------------------
+	//! Resolve an entity by name. O(1) when the index is current, one O(N) rebuild otherwise.
+	static IEntitySource Find(WorldEditorAPI api, string name)
+	{
+		if (!api || name == "")
+			return null;
+
+		if (!s_mNameToIndex)
+			Rebuild(api);
+
+		IEntitySource entSrc = Verify(api, name);
+		if (entSrc)
+			return entSrc;
+
+		// Stale hit: the index predates edits made elsewhere. Plain miss: rebuild
+		// if entities were added or removed since the last one, else rate-limit
+		// per name (the entity may have been renamed in the GUI).
+		if (!s_mNameToIndex.Contains(name) && StructureGeneration(api) == s_sIndexedGeneration)
+		{
+			if (!s_mMissRebuildTick)
+				s_mMissRebuildTick = new map<string, int>();
+
+			int now = System.GetTickCount();
+			int lastTick;
+			if (s_mMissRebuildTick.Find(name, lastTick) && now - lastTick < MISS_REBUILD_MS)
+				return null;
+
+			Rebuild(api);
+			s_mMissRebuildTick.Set(name, now);
+			return Verify(api, name);
+		}
+
+		Rebuild(api);
+		return Verify(api, name);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Rebuild the whole index. First occurrence wins for duplicate names, matching the old linear scan.
+	static void Rebuild(WorldEditorAPI api)
+	{
+		string generation = StructureGeneration(api);
+		if (generation != s_sIndexedGeneration)
+			s_mMissRebuildTick = null;
+		s_sIndexedGeneration = generation;
+		s_mNameToIndex = new map<string, int>();
+		int count = api.GetEditorEntityCount();
+		for (int i = 0; i < count; i++)
+		{
+			IEntitySource candidate = api.GetEditorEntity(i);
+			if (!candidate)
+				continue;
+
+			string entName = candidate.GetName();
+			if (entName != "" && !s_mNameToIndex.Contains(entName))
+				s_mNameToIndex.Set(entName, i);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Drop the index; the next Find() rebuilds it.
+	static void Invalidate()
+	{
+		s_mNameToIndex = null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Token for the current entity set. Different tokens mean editor indices may have
+	//! shifted; equal tokens do not rule out a count-preserving delete+create made elsewhere.
+	static string StructureGeneration(WorldEditorAPI api)
+	{
+		int count = api.GetEditorEntityCount();
+		if (count != s_iLastSeenCount)
+		{
+			// Added or removed outside our handlers (GUI, clipboard, undo)
+			if (s_iLastSeenCount >= 0)
+				s_iStructureGeneration++;
+			s_iLastSeenCount = count;
+		}
+		return s_iStructureGeneration.ToString() + "-" + count.ToString();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Record a newly created entity. New entities are appended, so the last index is the best hint.
+	static void OnCreated(WorldEditorAPI api, IEntitySource entSrc)
+	{
+		s_iStructureGeneration++;
+		if (!s_mNameToIndex || !entSrc)
+			return;
+
+		string entName = entSrc.GetName();
+		if (entName == "")
+			return;
+
+		// Keep first-occurrence semantics for duplicate names
+		if (s_mNameToIndex.Contains(entName))
+			return;
+
+		int hint = api.GetEditorEntityCount() - 1;
+		if (api.GetEditorEntity(hint) == entSrc)
+			s_mNameToIndex.Set(entName, hint);
+		// Otherwise leave it out — the next miss rebuilds
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Forget a deleted entity. Indices after it have shifted; verification catches those lazily.
+	static void OnDeleted(string name)
+	{
+		s_iStructureGeneration++;
+		if (s_mNameToIndex)
+			s_mNameToIndex.Remove(name);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Move an entry to its new name after a successful RenameEntity.
+	static void OnRenamed(string oldName, string newName)
+	{
+		if (!s_mNameToIndex)
+			return;
+
+		int idx;
+		if (s_mNameToIndex.Find(oldName, idx))
+		{
+			s_mNameToIndex.Remove(oldName);
+			s_mNameToIndex.Set(newName, idx);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static IEntitySource Verify(WorldEditorAPI api, string name)
+	{
+		int idx;
+		if (!s_mNameToIndex.Find(name, idx))
+			return null;
+
+		if (idx < 0 || idx >= api.GetEditorEntityCount())
+			return null;
+
+		IEntitySource candidate = api.GetEditorEntity(idx);
+		if (candidate && candidate.GetName() == name)
+			return candidate;
+
+		return null;
+	}
+}
@@ -0,0 +1,241 @@
+/**
+ * EMCP_WB_ExportSnapshot.c - Dump every editor entity to a JSON-lines file
+ *
+ * Walks the editor entities once and writes one JSON object per line to
+ * $profile:EnfusionMCP/<fileName>, so a client can load the whole level locally
+ * instead of issuing one EMCP_WB_GetEntity call per entity.
+ *
+ * Line 1 is a header: {"type":"header","entityCount":N,"generation":"..."}
+ * Every other line is an entity:
+ *   {"name","class","prefab","layer","parent","position","rotation",
+ *    "props":{var:value},"components":[{"class","props":{var:value}}]}
+ *
+ * Transforms are read from the entity source ("coords"/"angles"), not the
+ * runtime entity, so parented entities report local coords. With
+ * onlySetProperties, props only holds values set directly on the instance
+ * (not inherited from the prefab), which keeps the file small on big worlds.
+ *
+ * Called via NET API TCP protocol: APIFunc = "EMCP_WB_ExportSnapshot"
+ */
+
+class EMCP_WB_ExportSnapshotRequest : JsonApiStruct
+{
+	string fileName;
+	bool skipProperties;
+	bool onlySetProperties;
+
+	void EMCP_WB_ExportSnapshotRequest()
+	{
+		RegV("fileName");
+		RegV("skipProperties");
+		RegV("onlySetProperties");
+	}
+}
+
+class EMCP_WB_ExportSnapshotResponse : JsonApiStruct
+{
+	string status;
+	string message;
+	string path;
+	string generation;
+	int entityCount;
+	int propertyCount;
+
+	void EMCP_WB_ExportSnapshotResponse()
+	{
+		RegV("status");
+		RegV("message");
+		RegV("path");
+		RegV("generation");
+		RegV("entityCount");
+		RegV("propertyCount");
+	}
+}
+
+class EMCP_WB_ExportSnapshot : NetApiHandler
+{
+	static const string SNAPSHOT_DIR = "$profile:EnfusionMCP";
+	static const string HEX_DIGITS = "0123456789abcdef";
+
+	//------------------------------------------------------------------------------------------------
+	//! Quote and escape a string as a JSON string literal. Every control
+	//! character below 0x20 is escaped; \n \r \t get their short forms.
+	static string JsonString(string value)
+	{
+		string escaped = "";
+		int len = value.Length();
+		for (int i = 0; i < len; i++)
+		{
+			string ch = value.Get(i);
+			int code = ch.ToAscii();
+			if (ch == "\\")
+				escaped += "\\\\";
+			else if (ch == "\"")
+				escaped += "\\\"";
+			else if (ch == "\n")
+				escaped += "\\n";
+			else if (ch == "\r")
+				escaped += "\\r";
+			else if (ch == "\t")
+				escaped += "\\t";
+			else if (code >= 0 && code < 0x20)
+				escaped += "\\u00" + HEX_DIGITS.Get(code / 16) + HEX_DIGITS.Get(code % 16);
+			else
+				escaped += ch;
+		}
+		return "\"" + escaped + "\"";
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Append "props":{...} for a container. Returns the number of properties written.
+	static int AppendProps(BaseContainer container, bool onlySet, inout string line)
+	{
+		int written = 0;
+		line += "\"props\":{";
+		int numVars = container.GetNumVars();
+		for (int v = 0; v < numVars; v++)
+		{
+			string varName = container.GetVarName(v);
+			if (onlySet && !container.IsVariableSetDirectly(varName))
+				continue;
+
+			string varValue;
+			container.Get(varName, varValue);
+			if (written > 0)
+				line += ",";
+			line += JsonString(varName) + ":" + JsonString(varValue);
+			written++;
+		}
+		line += "}";
+		return written;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetRequest()
+	{
+		return new EMCP_WB_ExportSnapshotRequest();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetResponse(JsonApiStruct request)
+	{
+		EMCP_WB_ExportSnapshotRequest req = EMCP_WB_ExportSnapshotRequest.Cast(request);
+		EMCP_WB_ExportSnapshotResponse resp = new EMCP_WB_ExportSnapshotResponse();
+
+		WorldEditor worldEditor = Workbench.GetModule(WorldEditor);
+		if (!worldEditor)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditor module not available";
+			return resp;
+		}
+
+		WorldEditorAPI api = worldEditor.GetApi();
+		if (!api)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditorAPI not available";
+			return resp;
+		}
+
+		string fileName = req.fileName;
+		if (fileName == "")
+			fileName = "snapshot.jsonl";
+		if (fileName.Contains("/") || fileName.Contains("\\") || fileName.Contains(".."))
+		{
+			resp.status = "error";
+			resp.message = "fileName must be a bare file name: " + fileName;
+			return resp;
+		}
+
+		if (!FileIO.FileExists(SNAPSHOT_DIR))
+			FileIO.MakeDirectory(SNAPSHOT_DIR);
+
+		string filePath = SNAPSHOT_DIR + "/" + fileName;
+		FileHandle file = FileIO.OpenFile(filePath, FileMode.WRITE);
+		if (!file)
+		{
+			resp.status = "error";
+			resp.message = "Could not open " + filePath + " for writing";
+			return resp;
+		}
+
+		int count = api.GetEditorEntityCount();
+		resp.generation = EMCP_WB_EntityIndex.StructureGeneration(api);
+		file.WriteLine("{\"type\":\"header\",\"entityCount\":" + count.ToString() + ",\"generation\":" + JsonString(resp.generation) + "}");
+
+		for (int i = 0; i < count; i++)
+		{
+			IEntitySource entSrc = api.GetEditorEntity(i);
+			if (!entSrc)
+				continue;
+
+			string coords;
+			entSrc.Get("coords", coords);
+			string angles;
+			entSrc.Get("angles", angles);
+
+			string parentName = "";
+			IEntitySource parentSrc = entSrc.GetParent();
+			if (parentSrc)
+				parentName = parentSrc.GetName();
+
+			string line = "{\"name\":" + JsonString(entSrc.GetName());
+			line += ",\"class\":" + JsonString(entSrc.GetClassName());
+			line += ",\"prefab\":" + JsonString(EMCP_WB_ListEntities.DirectPrefab(entSrc));
+			line += ",\"layer\":" + entSrc.GetLayerID().ToString();
+			line += ",\"parent\":" + JsonString(parentName);
+			line += ",\"position\":" + JsonString(coords);
+			line += ",\"rotation\":" + JsonString(angles);
+
+			if (!req.skipProperties)
+			{
+				line += ",";
+				resp.propertyCount += AppendProps(entSrc, req.onlySetProperties, line);
+			}
+
+			line += ",\"components\":[";
+			int compCount = entSrc.GetComponentCount();
+			for (int c = 0; c < compCount; c++)
+			{
+				IEntityComponentSource compSrc = entSrc.GetComponent(c);
+				if (c > 0)
+					line += ",";
+				if (!compSrc)
+				{
+					line += "{\"class\":\"null\"}";
+					continue;
+				}
+
+				line += "{\"class\":" + JsonString(compSrc.GetClassName());
+				if (!req.skipProperties)
+				{
+					line += ",";
+					resp.propertyCount += AppendProps(compSrc, req.onlySetProperties, line);
+				}
+				line += "}";
+			}
+			line += "]}";
+
+			file.WriteLine(line);
+			resp.entityCount++;
+		}
+
+		file.Close();
+
+		string absPath;
+		if (Workbench.GetAbsolutePath(filePath, absPath, false))
+		{
+			absPath.Replace("\\", "/");
+			resp.path = absPath;
+		}
+		else
+		{
+			resp.path = filePath;
+		}
+
+		resp.status = "ok";
+		resp.message = "Exported " + resp.entityCount.ToString() + " entities (" + resp.propertyCount.ToString() + " properties) to " + resp.path;
+		return resp;
+	}
+}
@@ -0,0 +1,159 @@
+/**
+ * EMCP_WB_GetChanges.c - Delta polling over EMCP_WB_ChangeJournal
+ *
+ * since = last seq the client has applied (0 = from the beginning of the journal,
+ * -1 = return no events, just latestSeq, to start polling after a full listing).
+ * epoch = the epoch returned with that seq ("" on the first poll).
+ * Runs a rate-limited external diff first unless skipDiff is set.
+ *
+ * reset = true means events after since were already dropped from the ring
+ * buffer, or the journal restarted since the client's cursor (epoch differs:
+ * script recompile or Workbench restart); the client must resync with a full
+ * listing and continue from latestSeq with the returned epoch.
+ * hasMore = true means limit was hit; poll again with since = nextSince.
+ *
+ * Called via NET API TCP protocol: APIFunc = "EMCP_WB_GetChanges"
+ */
+
+class EMCP_WB_GetChangesRequest : JsonApiStruct
+{
+	int since;
+	string epoch;
+	int limit;
+	bool skipDiff;
+	bool forceDiff;
+
+	void EMCP_WB_GetChangesRequest()
+	{
+		RegV("since");
+		RegV("epoch");
+		RegV("limit");
+		RegV("skipDiff");
+		RegV("forceDiff");
+	}
+}
+
+class EMCP_WB_GetChangesResponse : JsonApiStruct
+{
+	string status;
+	string message;
+	string epoch;
+	int latestSeq;
+	int oldestSeq;
+	int nextSince;
+	bool reset;
+	bool hasMore;
+	bool diffRan;
+
+	ref array<ref EMCP_WB_ChangeEvent> m_aEvents;
+
+	void EMCP_WB_GetChangesResponse()
+	{
+		RegV("status");
+		RegV("message");
+		RegV("epoch");
+		RegV("latestSeq");
+		RegV("oldestSeq");
+		RegV("nextSince");
+		RegV("reset");
+		RegV("hasMore");
+		RegV("diffRan");
+
+		m_aEvents = {};
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void OnPack()
+	{
+		StartArray("events");
+		for (int i = 0; i < m_aEvents.Count(); i++)
+		{
+			EMCP_WB_ChangeEvent ev = m_aEvents[i];
+			StartObject("");
+			StoreInteger("seq", ev.m_iSeq);
+			StoreString("type", ev.m_sType);
+			StoreString("name", ev.m_sName);
+			StoreString("detail", ev.m_sDetail);
+			EndObject();
+		}
+		EndArray();
+	}
+}
+
+class EMCP_WB_GetChanges : NetApiHandler
+{
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetRequest()
+	{
+		return new EMCP_WB_GetChangesRequest();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetResponse(JsonApiStruct request)
+	{
+		EMCP_WB_GetChangesRequest req = EMCP_WB_GetChangesRequest.Cast(request);
+		EMCP_WB_GetChangesResponse resp = new EMCP_WB_GetChangesResponse();
+
+		WorldEditor worldEditor = Workbench.GetModule(WorldEditor);
+		if (!worldEditor)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditor module not available";
+			return resp;
+		}
+
+		WorldEditorAPI api = worldEditor.GetApi();
+		if (!api)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditorAPI not available";
+			return resp;
+		}
+
+		if (!req.skipDiff)
+			resp.diffRan = EMCP_WB_ChangeJournal.Diff(api, req.forceDiff);
+
+		resp.epoch = EMCP_WB_ChangeJournal.Epoch();
+		resp.latestSeq = EMCP_WB_ChangeJournal.LatestSeq();
+		resp.oldestSeq = EMCP_WB_ChangeJournal.OldestSeq();
+		resp.nextSince = resp.latestSeq;
+		resp.status = "ok";
+
+		if (req.since < 0)
+		{
+			resp.message = "Journal at seq " + resp.latestSeq.ToString();
+			return resp;
+		}
+
+		// A recompile or restart started the journal over at seq 0; the cursor's
+		// seq refers to the previous journal whether or not the new one passed it
+		if ((req.epoch != "" && req.epoch != resp.epoch) || req.since > resp.latestSeq)
+		{
+			resp.reset = true;
+			resp.message = "Journal restarted (now at seq " + resp.latestSeq.ToString() + ", cursor was " + req.since.ToString() + "); resync with a full listing";
+			return resp;
+		}
+
+		// Events between since and the oldest retained one were overwritten
+		if (req.since + 1 < resp.oldestSeq)
+		{
+			resp.reset = true;
+			resp.message = "Journal no longer holds events after seq " + req.since.ToString() + "; resync with a full listing";
+			return resp;
+		}
+
+		int maxEvents = req.limit;
+		if (maxEvents <= 0)
+			maxEvents = 1000;
+
+		EMCP_WB_ChangeJournal.Since(req.since, maxEvents, resp.m_aEvents);
+		if (resp.m_aEvents.Count() > 0)
+			resp.nextSince = resp.m_aEvents[resp.m_aEvents.Count() - 1].m_iSeq;
+		else
+			resp.nextSince = Math.Max(req.since, resp.latestSeq);
+		resp.hasMore = resp.nextSince < resp.latestSeq;
+
+		resp.message = resp.m_aEvents.Count().ToString() + " changes since seq " + req.since.ToString();
+		return resp;
+	}
+}
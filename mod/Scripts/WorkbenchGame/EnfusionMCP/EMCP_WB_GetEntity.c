@@ -114,16 +114,7 @@ class EMCP_WB_GetEntity : NetApiHandler
 		if (req.name != "")
 		{
 			// Search by name
-			int count = api.GetEditorEntityCount();
-			for (int i = 0; i < count; i++)
-			{
-				IEntitySource candidate = api.GetEditorEntity(i);
-				if (candidate && candidate.GetName() == req.name)
-				{
-					entSrc = candidate;
-					break;
-				}
-			}
+			entSrc = EMCP_WB_EntityIndex.Find(api, req.name);
 
 			if (!entSrc)
 			{
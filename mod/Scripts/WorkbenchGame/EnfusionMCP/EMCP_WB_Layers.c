@@ -158,17 +158,12 @@ class EMCP_WB_Layers : NetApiHandler
 				return resp;
 			}
 
-			int count = api.GetEditorEntityCount();
+			IEntitySource namedSrc = EMCP_WB_EntityIndex.Find(api, req.entityName);
 			bool found = false;
-			for (int i = 0; i < count; i++)
+			if (namedSrc)
 			{
-				IEntitySource entSrc = api.GetEditorEntity(i);
-				if (entSrc && entSrc.GetName() == req.entityName)
-				{
-					resp.layerID = entSrc.GetLayerID();
-					found = true;
-					break;
-				}
+				resp.layerID = namedSrc.GetLayerID();
+				found = true;
 			}
 
 			if (found)
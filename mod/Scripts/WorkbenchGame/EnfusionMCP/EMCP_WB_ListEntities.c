@@ -1,8 +1,37 @@
 /**
- * EMCP_WB_ListEntities.c - Entity listing with pagination and name filter
+ * EMCP_WB_ListEntities.c - Entity listing with filters, pagination and cursors
  *
  * Lists editor entities with offset/limit pagination.
  * Uses OnPack() to build JSON array dynamically via StartArray/EndArray.
+ *
+ * Filters (all optional, combined with AND):
+ *   nameFilter / classFilter - case-insensitive substring of name / class name
+ *   prefabFilter             - case-insensitive substring of any prefab in the ancestor chain
+ *   layerID                  - exact layer ID ("" = any)
+ *   bboxMin / bboxMax        - "x y z" corners the entity origin must lie within
+ *
+ * fields is a comma-separated projection of name, class, position, prefab, layer
+ * (default "name,class,position"). The name is always returned. Positions and
+ * prefab chains are only resolved when requested or filtered on.
+ *
+ * Pagination:
+ *   offset - legacy: skip matches, then also scan to the end for totalCount
+ *   cursor - resume where the previous page stopped; no totalCount, so paging
+ *            through the whole level is one linear pass. "*" starts a new listing.
+ * Each response returns nextCursor ("" when done). A cursor is tied to the
+ * EMCP_WB_EntityIndex structure generation it was issued under and is rejected
+ * with status "stale_cursor" once entities have been added or removed through
+ * our handlers or the entity count has changed. A delete+create pair made in
+ * the GUI keeps the count and is not detected; such a cursor resumes at
+ * shifted indices.
+ *
+ * encoding = "objects" (default): entities[] of {name, className, position "x y z", prefab, layerID}
+ * encoding = "columnar": parallel arrays instead of one object per entity —
+ *   names[], classIndex[] into a classNames[] dictionary, positions[] as a
+ *   flat numeric x,y,z triple per entity, prefabs[], layerIDs[]. Avoids
+ *   repeating keys and formatting positions as strings, which dominates the
+ *   payload on large levels.
+ *
  * Called via NET API TCP protocol: APIFunc = "EMCP_WB_ListEntities"
  */
 
@@ -11,12 +40,28 @@ class EMCP_WB_ListEntitiesRequest : JsonApiStruct
 	int offset;
 	int limit;
 	string nameFilter;
+	string classFilter;
+	string prefabFilter;
+	string layerID;
+	string bboxMin;
+	string bboxMax;
+	string fields;
+	string cursor;
+	string encoding;
 
 	void EMCP_WB_ListEntitiesRequest()
 	{
 		RegV("offset");
 		RegV("limit");
 		RegV("nameFilter");
+		RegV("classFilter");
+		RegV("prefabFilter");
+		RegV("layerID");
+		RegV("bboxMin");
+		RegV("bboxMax");
+		RegV("fields");
+		RegV("cursor");
+		RegV("encoding");
 	}
 }
 
@@ -27,11 +72,27 @@ class EMCP_WB_ListEntitiesResponse : JsonApiStruct
 	int totalCount;
 	int returnedCount;
 	int offset;
+	string encoding;
+	string nextCursor;
+	string generation;
+
+	// Projection, set by the handler before entities are added
+	bool m_bWantClass;
+	bool m_bWantPosition;
+	bool m_bWantPrefab;
+	bool m_bWantLayer;
 
 	// Entity data collected before OnPack
 	ref array<string> m_aNames;
 	ref array<string> m_aClassNames;
-	ref array<string> m_aPositions;
+	ref array<vector> m_aPositions;
+	ref array<string> m_aPrefabs;
+	ref array<int> m_aLayerIDs;
+
+	// Columnar encoding: class name dictionary and per-entity index into it
+	ref array<string> m_aClassDict;
+	ref array<int> m_aClassIndices;
+	ref map<string, int> m_mClassLookup;
 
 	void EMCP_WB_ListEntitiesResponse()
 	{
@@ -40,21 +101,123 @@ class EMCP_WB_ListEntitiesResponse : JsonApiStruct
 		RegV("totalCount");
 		RegV("returnedCount");
 		RegV("offset");
+		RegV("encoding");
+		RegV("nextCursor");
+		RegV("generation");
 
 		m_aNames = {};
 		m_aClassNames = {};
 		m_aPositions = {};
+		m_aPrefabs = {};
+		m_aLayerIDs = {};
+		m_aClassDict = {};
+		m_aClassIndices = {};
+		m_mClassLookup = new map<string, int>();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddEntity(string entName, string className, vector pos, string prefab, int layer)
+	{
+		m_aNames.Insert(entName);
+		m_aPositions.Insert(pos);
+		m_aPrefabs.Insert(prefab);
+		m_aLayerIDs.Insert(layer);
+
+		if (encoding != "columnar")
+		{
+			m_aClassNames.Insert(className);
+			return;
+		}
+
+		int classIdx;
+		if (!m_mClassLookup.Find(className, classIdx))
+		{
+			classIdx = m_aClassDict.Insert(className);
+			m_mClassLookup.Set(className, classIdx);
+		}
+		m_aClassIndices.Insert(classIdx);
 	}
 
+	//------------------------------------------------------------------------------------------------
 	override void OnPack()
 	{
+		if (encoding == "columnar")
+		{
+			StartArray("names");
+			for (int n = 0; n < m_aNames.Count(); n++)
+			{
+				StoreString("", m_aNames[n]);
+			}
+			EndArray();
+
+			if (m_bWantClass)
+			{
+				StartArray("classNames");
+				for (int c = 0; c < m_aClassDict.Count(); c++)
+				{
+					StoreString("", m_aClassDict[c]);
+				}
+				EndArray();
+
+				StartArray("classIndex");
+				for (int ci = 0; ci < m_aClassIndices.Count(); ci++)
+				{
+					StoreInteger("", m_aClassIndices[ci]);
+				}
+				EndArray();
+			}
+
+			if (m_bWantPosition)
+			{
+				StartArray("positions");
+				for (int p = 0; p < m_aPositions.Count(); p++)
+				{
+					vector pos = m_aPositions[p];
+					StoreFloat("", pos[0]);
+					StoreFloat("", pos[1]);
+					StoreFloat("", pos[2]);
+				}
+				EndArray();
+			}
+
+			if (m_bWantPrefab)
+			{
+				StartArray("prefabs");
+				for (int pf = 0; pf < m_aPrefabs.Count(); pf++)
+				{
+					StoreString("", m_aPrefabs[pf]);
+				}
+				EndArray();
+			}
+
+			if (m_bWantLayer)
+			{
+				StartArray("layerIDs");
+				for (int l = 0; l < m_aLayerIDs.Count(); l++)
+				{
+					StoreInteger("", m_aLayerIDs[l]);
+				}
+				EndArray();
+			}
+			return;
+		}
+
 		StartArray("entities");
 		for (int i = 0; i < m_aNames.Count(); i++)
 		{
 			StartObject("");
 			StoreString("name", m_aNames[i]);
-			StoreString("className", m_aClassNames[i]);
-			StoreString("position", m_aPositions[i]);
+			if (m_bWantClass)
+				StoreString("className", m_aClassNames[i]);
+			if (m_bWantPosition)
+			{
+				vector entPos = m_aPositions[i];
+				StoreString("position", entPos[0].ToString() + " " + entPos[1].ToString() + " " + entPos[2].ToString());
+			}
+			if (m_bWantPrefab)
+				StoreString("prefab", m_aPrefabs[i]);
+			if (m_bWantLayer)
+				StoreInteger("layerID", m_aLayerIDs[i]);
 			EndObject();
 		}
 		EndArray();
@@ -63,15 +226,46 @@ class EMCP_WB_ListEntitiesResponse : JsonApiStruct
 
 class EMCP_WB_ListEntities : NetApiHandler
 {
+	//------------------------------------------------------------------------------------------------
+	//! Case-insensitive substring match of filter (already lowercased) against any prefab in the ancestor chain.
+	static bool PrefabChainMatches(IEntitySource entSrc, string lowerFilter)
+	{
+		BaseContainer ancestor = entSrc.GetAncestor();
+		while (ancestor)
+		{
+			string resName = ancestor.GetResourceName();
+			resName.ToLower();
+			if (resName.IndexOf(lowerFilter) >= 0)
+				return true;
+			ancestor = ancestor.GetAncestor();
+		}
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Direct prefab of an entity, or "" for entities not placed from a prefab.
+	static string DirectPrefab(IEntitySource entSrc)
+	{
+		BaseContainer ancestor = entSrc.GetAncestor();
+		if (!ancestor)
+			return "";
+		return ancestor.GetResourceName();
+	}
+
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
 		return new EMCP_WB_ListEntitiesRequest();
 	}
 
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetResponse(JsonApiStruct request)
 	{
 		EMCP_WB_ListEntitiesRequest req = EMCP_WB_ListEntitiesRequest.Cast(request);
 		EMCP_WB_ListEntitiesResponse resp = new EMCP_WB_ListEntitiesResponse();
+		resp.encoding = "objects";
+		if (req.encoding == "columnar")
+			resp.encoding = "columnar";
 
 		WorldEditor worldEditor = Workbench.GetModule(WorldEditor);
 		if (!worldEditor)
@@ -89,24 +283,90 @@ class EMCP_WB_ListEntities : NetApiHandler
 			return resp;
 		}
 
+		// Projection
+		string fieldList = req.fields;
+		if (fieldList == "")
+			fieldList = "name,class,position";
+		array<string> fieldNames = {};
+		fieldList.Split(",", fieldNames, true);
+		for (int f = 0; f < fieldNames.Count(); f++)
+		{
+			string fieldName = fieldNames[f].Trim();
+			if (fieldName == "class")
+				resp.m_bWantClass = true;
+			else if (fieldName == "position")
+				resp.m_bWantPosition = true;
+			else if (fieldName == "prefab")
+				resp.m_bWantPrefab = true;
+			else if (fieldName == "layer")
+				resp.m_bWantLayer = true;
+		}
+
 		int entityCount = api.GetEditorEntityCount();
+		string generation = EMCP_WB_EntityIndex.StructureGeneration(api);
+		resp.generation = generation;
+
 		int pageLimit = req.limit;
 		if (pageLimit <= 0)
 			pageLimit = 50;
 
-		int pageOffset = req.offset;
-		if (pageOffset < 0)
-			pageOffset = 0;
+		// Cursor mode resumes at an editor index; legacy mode skips offset matches
+		bool cursorMode = req.cursor != "";
+		int startIndex = 0;
+		int pageOffset = 0;
+		if (cursorMode && req.cursor != "*")
+		{
+			array<string> cursorParts = {};
+			req.cursor.Split("@", cursorParts, false);
+			if (cursorParts.Count() != 2)
+			{
+				resp.status = "error";
+				resp.message = "Malformed cursor: " + req.cursor;
+				return resp;
+			}
+			if (cursorParts[0] != generation)
+			{
+				resp.status = "stale_cursor";
+				resp.message = "Entities were added or removed since this cursor was issued; restart the listing with cursor '*'";
+				return resp;
+			}
+			startIndex = cursorParts[1].ToInt();
+		}
+		else if (!cursorMode)
+		{
+			pageOffset = req.offset;
+			if (pageOffset < 0)
+				pageOffset = 0;
+		}
 
 		string filter = req.nameFilter;
 		filter.ToLower();
+		string classFilter = req.classFilter;
+		classFilter.ToLower();
+		string prefabFilter = req.prefabFilter;
+		prefabFilter.ToLower();
+		bool filterLayer = req.layerID != "";
+		int layerFilter = req.layerID.ToInt();
+
+		bool filterBox = req.bboxMin != "" && req.bboxMax != "";
+		vector boxMin, boxMax;
+		if (filterBox)
+		{
+			vector cornerA = EMCP_WB_ModifyEntity.ParseVectorString(req.bboxMin);
+			vector cornerB = EMCP_WB_ModifyEntity.ParseVectorString(req.bboxMax);
+			boxMin = Vector(Math.Min(cornerA[0], cornerB[0]), Math.Min(cornerA[1], cornerB[1]), Math.Min(cornerA[2], cornerB[2]));
+			boxMax = Vector(Math.Max(cornerA[0], cornerB[0]), Math.Max(cornerA[1], cornerB[1]), Math.Max(cornerA[2], cornerB[2]));
+		}
+
+		bool needPosition = resp.m_bWantPosition || filterBox;
 
 		// Collect matching entities with pagination
 		int matched = 0;
 		int skipped = 0;
+		int resumeIndex = -1;
 		resp.totalCount = 0;
 
-		for (int i = 0; i < entityCount; i++)
+		for (int i = startIndex; i < entityCount; i++)
 		{
 			IEntitySource entSrc = api.GetEditorEntity(i);
 			if (!entSrc)
@@ -114,7 +374,7 @@ class EMCP_WB_ListEntities : NetApiHandler
 
 			string entName = entSrc.GetName();
 
-			// Apply name filter
+			// Cheap filters first
 			if (filter != "")
 			{
 				string lowerName = entName;
@@ -123,6 +383,38 @@ class EMCP_WB_ListEntities : NetApiHandler
 					continue;
 			}
 
+			if (filterLayer && entSrc.GetLayerID() != layerFilter)
+				continue;
+
+			string className = entSrc.GetClassName();
+			if (classFilter != "")
+			{
+				string lowerClass = className;
+				lowerClass.ToLower();
+				if (lowerClass.IndexOf(classFilter) < 0)
+					continue;
+			}
+
+			if (prefabFilter != "" && !PrefabChainMatches(entSrc, prefabFilter))
+				continue;
+
+			// Get position from the runtime entity only when needed
+			vector pos = "0 0 0";
+			if (needPosition)
+			{
+				IEntity ent = api.SourceToEntity(entSrc);
+				if (ent)
+					pos = ent.GetOrigin();
+				else if (filterBox)
+					continue;
+			}
+
+			if (filterBox)
+			{
+				if (pos[0] < boxMin[0] || pos[0] > boxMax[0] || pos[1] < boxMin[1] || pos[1] > boxMax[1] || pos[2] < boxMin[2] || pos[2] > boxMax[2])
+					continue;
+			}
+
 			resp.totalCount++;
 
 			// Pagination: skip until offset
@@ -132,31 +424,39 @@ class EMCP_WB_ListEntities : NetApiHandler
 				continue;
 			}
 
-			// Pagination: stop at limit
+			// Pagination: stop at limit. Cursor mode stops scanning; legacy mode keeps counting.
 			if (matched >= pageLimit)
-				continue;
-
-			string className = entSrc.GetClassName();
-
-			// Get position from the runtime entity
-			string posStr = "0 0 0";
-			IEntity ent = api.SourceToEntity(entSrc);
-			if (ent)
 			{
-				vector pos = ent.GetOrigin();
-				posStr = pos[0].ToString() + " " + pos[1].ToString() + " " + pos[2].ToString();
+				if (resumeIndex < 0)
+					resumeIndex = i;
+				if (cursorMode)
+					break;
+				continue;
 			}
 
-			resp.m_aNames.Insert(entName);
-			resp.m_aClassNames.Insert(className);
-			resp.m_aPositions.Insert(posStr);
+			string prefab;
+			if (resp.m_bWantPrefab)
+				prefab = DirectPrefab(entSrc);
+
+			resp.AddEntity(entName, className, pos, prefab, entSrc.GetLayerID());
 			matched++;
 		}
 
+		if (resumeIndex >= 0)
+			resp.nextCursor = generation + "@" + resumeIndex.ToString();
+
 		resp.returnedCount = matched;
 		resp.offset = pageOffset;
 		resp.status = "ok";
-		resp.message = "Listed " + matched.ToString() + " of " + resp.totalCount.ToString() + " entities";
+		if (cursorMode)
+		{
+			resp.totalCount = -1;
+			resp.message = "Listed " + matched.ToString() + " entities";
+		}
+		else
+		{
+			resp.message = "Listed " + matched.ToString() + " of " + resp.totalCount.ToString() + " entities";
+		}
 
 		return resp;
 	}
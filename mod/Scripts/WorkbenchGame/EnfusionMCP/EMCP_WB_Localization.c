@@ -1,8 +1,19 @@
 /**
  * EMCP_WB_Localization.c - Localization editor handler
  *
- * Actions: insert, delete, modify, getTable, listLanguages
+ * Actions: insert, delete, modify, getTable, listLanguages, exportTable, importRows
  * Uses the LocalizationEditor Workbench module.
+ *
+ * exportTable returns rows[] as objects keyed by column, for columns (comma-
+ * separated property names, default "Id,en_us,target,comment"; "*" = every
+ * property of the first item), paged by offset/limit (limit 0 = all rows).
+ *
+ * importRows upserts many items in one BeginModify/EndModify:
+ *   columns  - tab-separated property names; the first must be Id
+ *   rows     - EMCP_WB_Records payload escaped with encodeEscapedRecords, one item
+ *              per line, fields in columns order
+ *   deleteIds - newline-separated item IDs to delete
+ * Missing items are inserted; only columns whose value differs are modified.
  * Called via NET API TCP protocol: APIFunc = "EMCP_WB_Localization"
  */
 
@@ -12,6 +23,11 @@ class EMCP_WB_LocalizationRequest : JsonApiStruct
 	string itemId;
 	string property;
 	string value;
+	string columns;
+	string rows;
+	string deleteIds;
+	int offset;
+	int limit;
 
 	void EMCP_WB_LocalizationRequest()
 	{
@@ -19,6 +35,11 @@ class EMCP_WB_LocalizationRequest : JsonApiStruct
 		RegV("itemId");
 		RegV("property");
 		RegV("value");
+		RegV("columns");
+		RegV("rows");
+		RegV("deleteIds");
+		RegV("offset");
+		RegV("limit");
 	}
 }
 
@@ -37,9 +58,21 @@ class EMCP_WB_LocalizationResponse : JsonApiStruct
 	string action;
 	string itemId;
 	int tableItemCount;
+	int insertedCount;
+	int modifiedCount;
+	int unchangedCount;
+	int deletedCount;
 	ref array<ref EMCP_WB_LocalizationEntry> m_aEntries;
 	ref array<string> m_aLanguages;
 
+	// exportTable: column names and row values (row-major, m_aColumns.Count() per row)
+	ref array<string> m_aColumns;
+	ref array<string> m_aCells;
+
+	// importRows failures
+	ref array<string> m_aErrorIds;
+	ref array<string> m_aErrorMessages;
+
 	void EMCP_WB_LocalizationResponse()
 	{
 		RegV("status");
@@ -47,8 +80,16 @@ class EMCP_WB_LocalizationResponse : JsonApiStruct
 		RegV("action");
 		RegV("itemId");
 		RegV("tableItemCount");
+		RegV("insertedCount");
+		RegV("modifiedCount");
+		RegV("unchangedCount");
+		RegV("deletedCount");
 		m_aEntries = {};
 		m_aLanguages = {};
+		m_aColumns = {};
+		m_aCells = {};
+		m_aErrorIds = {};
+		m_aErrorMessages = {};
 	}
 
 	override void OnPack()
@@ -78,16 +119,230 @@ class EMCP_WB_LocalizationResponse : JsonApiStruct
 			}
 			EndArray();
 		}
+
+		if (m_aColumns.Count() > 0)
+		{
+			StartArray("columns");
+			for (int c = 0; c < m_aColumns.Count(); c++)
+			{
+				StoreString("", m_aColumns[c]);
+			}
+			EndArray();
+
+			int colCount = m_aColumns.Count();
+			StartArray("rows");
+			for (int r = 0; r + colCount <= m_aCells.Count(); r += colCount)
+			{
+				StartObject("");
+				for (int k = 0; k < colCount; k++)
+				{
+					StoreString(m_aColumns[k], m_aCells[r + k]);
+				}
+				EndObject();
+			}
+			EndArray();
+		}
+
+		if (m_aErrorIds.Count() > 0)
+		{
+			StartArray("errors");
+			for (int e = 0; e < m_aErrorIds.Count(); e++)
+			{
+				StartObject("");
+				StoreString("id", m_aErrorIds[e]);
+				StoreString("message", m_aErrorMessages[e]);
+				EndObject();
+			}
+			EndArray();
+		}
 	}
 }
 
 class EMCP_WB_Localization : NetApiHandler
 {
+	//------------------------------------------------------------------------------------------------
+	//! Map item Id -> item container for the whole table, so bulk actions avoid a scan per row.
+	static map<string, BaseContainer> IndexTable(BaseContainer table)
+	{
+		map<string, BaseContainer> byId = new map<string, BaseContainer>();
+		int childCount = table.GetNumChildren();
+		for (int i = 0; i < childCount; i++)
+		{
+			BaseContainer child = table.GetChild(i);
+			if (!child)
+				continue;
+
+			string childId;
+			if (child.Get("Id", childId) && childId != "")
+				byId.Set(childId, child);
+		}
+		return byId;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void ExportTable(BaseContainer table, EMCP_WB_LocalizationRequest req, EMCP_WB_LocalizationResponse resp)
+	{
+		int childCount = table.GetNumChildren();
+		resp.tableItemCount = childCount;
+
+		string columnSpec = req.columns;
+		if (columnSpec == "")
+			columnSpec = "Id,en_us,target,comment";
+
+		if (columnSpec == "*")
+		{
+			BaseContainer firstItem = table.GetChild(0);
+			if (firstItem)
+			{
+				int varCount = firstItem.GetNumVars();
+				for (int v = 0; v < varCount; v++)
+				{
+					resp.m_aColumns.Insert(firstItem.GetVarName(v));
+				}
+			}
+		}
+		else
+		{
+			array<string> parts = {};
+			columnSpec.Split(",", parts, true);
+			for (int p = 0; p < parts.Count(); p++)
+			{
+				resp.m_aColumns.Insert(parts[p].Trim());
+			}
+		}
+
+		int first = Math.Max(req.offset, 0);
+		int last = childCount;
+		if (req.limit > 0)
+			last = Math.Min(childCount, first + req.limit);
+
+		for (int i = first; i < last; i++)
+		{
+			BaseContainer child = table.GetChild(i);
+			if (!child)
+				continue;
+
+			for (int c = 0; c < resp.m_aColumns.Count(); c++)
+			{
+				string cell;
+				child.Get(resp.m_aColumns[c], cell);
+				resp.m_aCells.Insert(cell);
+			}
+		}
+
+		resp.status = "ok";
+		resp.message = "Exported rows " + first.ToString() + "-" + (last - 1).ToString() + " of " + childCount.ToString();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void ImportRows(LocalizationEditor locEditor, BaseContainer table, EMCP_WB_LocalizationRequest req, EMCP_WB_LocalizationResponse resp)
+	{
+		array<string> columnNames = {};
+		req.columns.Split("\t", columnNames, false);
+		if (columnNames.Count() == 0 || columnNames[0] != "Id")
+		{
+			resp.status = "error";
+			resp.message = "columns must be tab-separated property names starting with Id";
+			return;
+		}
+
+		array<ref array<string>> rowList = {};
+		EMCP_WB_Records.Parse(req.rows, rowList);
+
+		array<string> deleteList = {};
+		if (req.deleteIds != "")
+			req.deleteIds.Split("\n", deleteList, true);
+
+		map<string, BaseContainer> byId = IndexTable(table);
+
+		locEditor.BeginModify("Import " + rowList.Count().ToString() + " localization rows via NetAPI");
+
+		for (int d = 0; d < deleteList.Count(); d++)
+		{
+			string deleteId = deleteList[d];
+			if (!byId.Contains(deleteId))
+				continue;
+
+			locEditor.DeleteItem(deleteId);
+			byId.Remove(deleteId);
+			resp.deletedCount++;
+		}
+
+		for (int r = 0; r < rowList.Count(); r++)
+		{
+			array<string> row = rowList[r];
+			string rowId = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(row, 0));
+			if (rowId == "")
+			{
+				resp.m_aErrorIds.Insert("");
+				resp.m_aErrorMessages.Insert("Row " + r.ToString() + " has an empty Id");
+				continue;
+			}
+
+			BaseContainer item;
+			bool inserted = false;
+			if (!byId.Find(rowId, item))
+			{
+				item = locEditor.InsertItem(rowId, true, true);
+				if (!item)
+				{
+					resp.m_aErrorIds.Insert(rowId);
+					resp.m_aErrorMessages.Insert("InsertItem returned null");
+					continue;
+				}
+				byId.Set(rowId, item);
+				inserted = true;
+			}
+
+			bool changed = false;
+			for (int c = 1; c < columnNames.Count(); c++)
+			{
+				string columnName = columnNames[c];
+				int varIdx = item.GetVarIndex(columnName);
+				if (varIdx < 0)
+				{
+					resp.m_aErrorIds.Insert(rowId);
+					resp.m_aErrorMessages.Insert("Property not found: " + columnName);
+					continue;
+				}
+
+				string newValue = EMCP_WB_Records.Unescape(EMCP_WB_Records.Field(row, c));
+				string oldValue;
+				item.Get(columnName, oldValue);
+				if (oldValue == newValue)
+					continue;
+
+				locEditor.ModifyProperty(item, varIdx, newValue);
+				changed = true;
+			}
+
+			if (inserted)
+				resp.insertedCount++;
+			else if (changed)
+				resp.modifiedCount++;
+			else
+				resp.unchangedCount++;
+		}
+
+		locEditor.EndModify();
+
+		resp.tableItemCount = table.GetNumChildren();
+		if (resp.m_aErrorIds.Count() == 0)
+			resp.status = "ok";
+		else
+			resp.status = "partial";
+		resp.message = "Imported " + rowList.Count().ToString() + " rows: " + resp.insertedCount.ToString() + " inserted, " + resp.modifiedCount.ToString() + " modified, " + resp.unchangedCount.ToString() + " unchanged, " + resp.deletedCount.ToString() + " deleted";
+		if (resp.m_aErrorIds.Count() > 0)
+			resp.message = resp.message + ", " + resp.m_aErrorIds.Count().ToString() + " errors";
+	}
+
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
 		return new EMCP_WB_LocalizationRequest();
 	}
 
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetResponse(JsonApiStruct request)
 	{
 		EMCP_WB_LocalizationRequest req = EMCP_WB_LocalizationRequest.Cast(request);
@@ -265,10 +520,25 @@ class EMCP_WB_Localization : NetApiHandler
 			resp.status = "ok";
 			resp.message = "Found " + resp.m_aLanguages.Count().ToString() + " language columns";
 		}
+		else if (req.action == "exportTable" || req.action == "importRows")
+		{
+			BaseContainer bulkTable = locEditor.GetTable();
+			if (!bulkTable)
+			{
+				resp.status = "error";
+				resp.message = "Could not get string table (no localization file loaded?)";
+				return resp;
+			}
+
+			if (req.action == "exportTable")
+				ExportTable(bulkTable, req, resp);
+			else
+				ImportRows(locEditor, bulkTable, req, resp);
+		}
 		else
 		{
 			resp.status = "error";
-			resp.message = "Unknown action: " + req.action + ". Valid: insert, delete, modify, getTable, listLanguages";
+			resp.message = "Unknown action: " + req.action + ". Valid: insert, delete, modify, getTable, listLanguages, exportTable, importRows";
 		}
 
 		return resp;
@@ -89,19 +89,6 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 		return result;
 	}
 
-	//------------------------------------------------------------------------------------------------
-	static IEntitySource FindEntityByName(WorldEditorAPI api, string name)
-	{
-		int count = api.GetEditorEntityCount();
-		for (int i = 0; i < count; i++)
-		{
-			IEntitySource candidate = api.GetEditorEntity(i);
-			if (candidate && candidate.GetName() == name)
-				return candidate;
-		}
-		return null;
-	}
-
 	//------------------------------------------------------------------------------------------------
 	// Build a ContainerIdPathEntry array from a dot-separated path string.
 	// Supports array indices: "m_aTriggerActions[0].m_aNames" produces
@@ -177,7 +164,7 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 			return resp;
 		}
 
-		IEntitySource entSrc = FindEntityByName(api, req.name);
+		IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.name);
 		if (!entSrc)
 		{
 			resp.status = "error";
@@ -208,6 +195,8 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 			}
 
 			api.EndEntityAction();
+			EMCP_WB_SpatialGrid.Invalidate();
+			EMCP_WB_ChangeJournal.OnMoved(entSrc.GetName(), ParseVectorString(req.value));
 			resp.status = "ok";
 			resp.message = "Entity moved to " + req.value;
 		}
@@ -233,6 +222,7 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 			}
 
 			api.EndEntityAction();
+			EMCP_WB_ChangeJournal.Record("rotate", entSrc.GetName(), req.value);
 			resp.status = "ok";
 			resp.message = "Entity rotated to " + req.value;
 		}
@@ -245,12 +235,15 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 				return resp;
 			}
 
+			string oldName = entSrc.GetName();
 			api.BeginEntityAction("Rename entity via NetAPI");
 			bool renamed = api.RenameEntity(entSrc, req.value);
 			api.EndEntityAction();
 
 			if (renamed)
 			{
+				EMCP_WB_EntityIndex.OnRenamed(oldName, req.value);
+				EMCP_WB_ChangeJournal.OnRenamed(oldName, req.value);
 				resp.status = "ok";
 				resp.message = "Entity renamed to: " + req.value;
 			}
@@ -269,7 +262,7 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 				return resp;
 			}
 
-			IEntitySource parentSrc = FindEntityByName(api, req.value);
+			IEntitySource parentSrc = EMCP_WB_EntityIndex.Find(api, req.value);
 			if (!parentSrc)
 			{
 				resp.status = "error";
@@ -280,6 +273,8 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 			api.BeginEntityAction("Reparent entity via NetAPI");
 			api.ParentEntity(parentSrc, entSrc, false); // false = keep local coords (0 0 0), true would convert world pos causing offset
 			api.EndEntityAction();
+			EMCP_WB_SpatialGrid.Invalidate();
+			EMCP_WB_ChangeJournal.Record("reparent", entSrc.GetName(), req.value);
 
 			resp.status = "ok";
 			resp.message = "Entity reparented to: " + req.value;
@@ -301,6 +296,7 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 
 			if (result)
 			{
+				EMCP_WB_ChangeJournal.Record("property", entSrc.GetName(), req.propertyPath + "." + req.propertyKey + " = " + req.value);
 				resp.status = "ok";
 				resp.message = "Property '" + req.propertyKey + "' set to '" + req.value + "'";
 			}
@@ -327,6 +323,7 @@ class EMCP_WB_ModifyEntity : NetApiHandler
 
 			if (result)
 			{
+				EMCP_WB_ChangeJournal.Record("property", entSrc.GetName(), req.propertyPath + "." + req.propertyKey + " cleared");
 				resp.status = "ok";
 				resp.message = "Property '" + req.propertyKey + "' cleared";
 			}
@@ -41,19 +41,6 @@ class EMCP_WB_PrefabsResponse : JsonApiStruct
 
 class EMCP_WB_Prefabs : NetApiHandler
 {
-	//------------------------------------------------------------------------------------------------
-	static IEntitySource FindEntityByName(WorldEditorAPI api, string name)
-	{
-		int count = api.GetEditorEntityCount();
-		for (int i = 0; i < count; i++)
-		{
-			IEntitySource candidate = api.GetEditorEntity(i);
-			if (candidate && candidate.GetName() == name)
-				return candidate;
-		}
-		return null;
-	}
-
 	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
@@ -127,7 +114,7 @@ class EMCP_WB_Prefabs : NetApiHandler
 					FileIO.MakeDirectory(absFolder);
 			}
 
-			IEntitySource entSrc = FindEntityByName(api, req.entityName);
+			IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.entityName);
 			if (!entSrc)
 			{
 				resp.status = "error";
@@ -182,7 +169,7 @@ class EMCP_WB_Prefabs : NetApiHandler
 				return resp;
 			}
 
-			IEntitySource entSrc = FindEntityByName(api, req.entityName);
+			IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.entityName);
 			if (!entSrc)
 			{
 				resp.status = "error";
@@ -211,7 +198,7 @@ class EMCP_WB_Prefabs : NetApiHandler
 				return resp;
 			}
 
-			IEntitySource entSrc = FindEntityByName(api, req.entityName);
+			IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.entityName);
 			if (!entSrc)
 			{
 				resp.status = "error";
@@ -0,0 +1,73 @@
+/**
+ * EMCP_WB_Records.c - Shared decoder for batched request payloads
+ *
+ * JsonApiStruct requests only carry scalar fields, so bulk handlers receive
+ * their rows as one string: records separated by "\n", fields by "\t".
+ * The Node side (src/workbench/records.ts) rejects fields containing either
+ * separator, so no escaping is needed here. Empty fields are preserved.
+ *
+ * Payloads built with encodeEscapedRecords carry free text (tabs, line breaks);
+ * decode those fields with Unescape().
+ */
+
+class EMCP_WB_Records
+{
+	//------------------------------------------------------------------------------------------------
+	//! Split a payload into rows of fields. Blank lines are skipped.
+	static void Parse(string payload, notnull array<ref array<string>> rows)
+	{
+		array<string> lines = {};
+		payload.Split("\n", lines, true);
+		for (int i = 0; i < lines.Count(); i++)
+		{
+			string line = lines[i];
+			if (line == "")
+				continue;
+
+			array<string> fields = {};
+			line.Split("\t", fields, false);
+			rows.Insert(fields);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Undo encodeEscapedRecords: \\ \t \n \r back to the original characters.
+	static string Unescape(string field)
+	{
+		if (!field.Contains("\\"))
+			return field;
+
+		string result = "";
+		int len = field.Length();
+		for (int i = 0; i < len; i++)
+		{
+			string ch = field.Get(i);
+			if (ch != "\\" || i + 1 >= len)
+			{
+				result += ch;
+				continue;
+			}
+
+			i++;
+			string code = field.Get(i);
+			if (code == "t")
+				result += "\t";
+			else if (code == "n")
+				result += "\n";
+			else if (code == "r")
+				result += "\r";
+			else
+				result += code;
+		}
+		return result;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Field at index, or "" when the row is shorter (trailing empty fields may be omitted).
+	static string Field(array<string> row, int index)
+	{
+		if (index < row.Count())
+			return row[index];
+		return "";
+	}
+}
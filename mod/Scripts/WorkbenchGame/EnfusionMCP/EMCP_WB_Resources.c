@@ -3,6 +3,15 @@
  *
  * Actions: register, rebuild, open, browse
  * Uses the ResourceManager Workbench module.
+ *
+ * browse asks Workbench's resource database (project and dependency addons)
+ * via Workbench.SearchResources instead of walking the filesystem:
+ *   path       - root folder to search under ("" = everything)
+ *   extensions - comma-separated extensions without dot ("et,conf"; "" = all)
+ *   filter     - case-insensitive substring of the resource path
+ *   offset/limit - page over the sorted results (limit default 200)
+ * Results are cached per query for the Workbench session (EMCP_WB_ResourceSearchCache);
+ * refresh = true re-runs the search, e.g. after adding files.
  * Called via NET API TCP protocol: APIFunc = "EMCP_WB_Resources"
  */
 
@@ -11,12 +20,22 @@ class EMCP_WB_ResourcesRequest : JsonApiStruct
 	string action;
 	string path;
 	bool buildRuntime;
+	string extensions;
+	string filter;
+	int offset;
+	int limit;
+	bool refresh;
 
 	void EMCP_WB_ResourcesRequest()
 	{
 		RegV("action");
 		RegV("path");
 		RegV("buildRuntime");
+		RegV("extensions");
+		RegV("filter");
+		RegV("offset");
+		RegV("limit");
+		RegV("refresh");
 	}
 }
 
@@ -25,6 +44,65 @@ class EMCP_WB_ResourceEntry
 	string m_sName;
 	string m_sPath;
 	string m_sType;
+	string m_sResourceName;
+}
+
+//! Receives Workbench.SearchResources hits; the method is passed as the WorkbenchSearchResourcesCallback.
+class EMCP_WB_ResourceCollector
+{
+	ref array<string> m_aFound = {};
+
+	//------------------------------------------------------------------------------------------------
+	void OnResourceFound(ResourceName resName, string filePath = "")
+	{
+		m_aFound.Insert(resName);
+	}
+}
+
+//! Per-session cache of browse results, keyed by query. Oldest query is evicted past MAX_QUERIES.
+class EMCP_WB_ResourceSearchCache
+{
+	static const int MAX_QUERIES = 32;
+
+	protected static ref map<string, ref array<string>> s_mResults;
+	protected static ref array<string> s_aOrder;
+
+	//------------------------------------------------------------------------------------------------
+	static array<string> Get(string key)
+	{
+		if (!s_mResults)
+			return null;
+		return s_mResults.Get(key);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void Put(string key, array<string> results)
+	{
+		if (!s_mResults)
+		{
+			s_mResults = new map<string, ref array<string>>();
+			s_aOrder = {};
+		}
+
+		if (!s_mResults.Contains(key))
+		{
+			s_aOrder.Insert(key);
+			if (s_aOrder.Count() > MAX_QUERIES)
+			{
+				s_mResults.Remove(s_aOrder[0]);
+				s_aOrder.RemoveOrdered(0);
+			}
+		}
+		s_mResults.Set(key, results);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Forget every query, e.g. after the resource database changed.
+	static void Clear()
+	{
+		s_mResults = null;
+		s_aOrder = null;
+	}
 }
 
 class EMCP_WB_ResourcesResponse : JsonApiStruct
@@ -34,6 +112,9 @@ class EMCP_WB_ResourcesResponse : JsonApiStruct
 	string action;
 	string path;
 	int entryCount;
+	int offset;
+	int nextOffset;
+	bool cached;
 	ref array<ref EMCP_WB_ResourceEntry> m_aEntries;
 
 	void EMCP_WB_ResourcesResponse()
@@ -43,6 +124,9 @@ class EMCP_WB_ResourcesResponse : JsonApiStruct
 		RegV("action");
 		RegV("path");
 		RegV("entryCount");
+		RegV("offset");
+		RegV("nextOffset");
+		RegV("cached");
 		m_aEntries = {};
 	}
 
@@ -58,6 +142,7 @@ class EMCP_WB_ResourcesResponse : JsonApiStruct
 				StoreString("name", e.m_sName);
 				StoreString("path", e.m_sPath);
 				StoreString("type", e.m_sType);
+				StoreString("resourceName", e.m_sResourceName);
 				EndObject();
 			}
 			EndArray();
@@ -67,11 +152,138 @@ class EMCP_WB_ResourcesResponse : JsonApiStruct
 
 class EMCP_WB_Resources : NetApiHandler
 {
+	static const int DEFAULT_BROWSE_LIMIT = 200;
+
+	//------------------------------------------------------------------------------------------------
+	//! "{GUID}Path/To/File.ext" -> "Path/To/File.ext"
+	static string StripGuid(string resName)
+	{
+		int guidEnd = resName.IndexOf("}");
+		if (resName.StartsWith("{") && guidEnd > 0)
+			return resName.Substring(guidEnd + 1, resName.Length() - guidEnd - 1);
+		return resName;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Sorted resource names matching the query, from the session cache unless refresh is set.
+	static array<string> Search(EMCP_WB_ResourcesRequest req, out bool fromCache)
+	{
+		string lowerFilter = req.filter;
+		lowerFilter.ToLower();
+		string rootPath = req.path;
+		rootPath.Replace("\\", "/");
+
+		string cacheKey = rootPath + "|" + req.extensions + "|" + lowerFilter;
+		array<string> results = EMCP_WB_ResourceSearchCache.Get(cacheKey);
+		fromCache = results != null && !req.refresh;
+		if (fromCache)
+			return results;
+
+		array<string> extList = null;
+		if (req.extensions != "")
+		{
+			extList = {};
+			array<string> rawExts = {};
+			req.extensions.Split(",", rawExts, true);
+			for (int e = 0; e < rawExts.Count(); e++)
+			{
+				string ext = rawExts[e].Trim();
+				if (ext.StartsWith("."))
+					ext = ext.Substring(1, ext.Length() - 1);
+				extList.Insert(ext);
+			}
+		}
+
+		EMCP_WB_ResourceCollector collector = new EMCP_WB_ResourceCollector();
+		Workbench.SearchResources(collector.OnResourceFound, extList, null, rootPath, true);
+
+		// Sort by path, not by the GUID prefix, so pages read like a folder listing
+		map<string, string> byPath = new map<string, string>();
+		array<string> paths = {};
+		for (int i = 0; i < collector.m_aFound.Count(); i++)
+		{
+			string found = collector.m_aFound[i];
+			string foundPath = StripGuid(found);
+			if (lowerFilter != "")
+			{
+				string lowerFound = foundPath;
+				lowerFound.ToLower();
+				if (!lowerFound.Contains(lowerFilter))
+					continue;
+			}
+			if (byPath.Contains(foundPath))
+				continue;
+
+			byPath.Set(foundPath, found);
+			paths.Insert(foundPath);
+		}
+		paths.Sort();
+
+		results = {};
+		for (int p = 0; p < paths.Count(); p++)
+		{
+			results.Insert(byPath.Get(paths[p]));
+		}
+
+		EMCP_WB_ResourceSearchCache.Put(cacheKey, results);
+		return results;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void Browse(EMCP_WB_ResourcesRequest req, EMCP_WB_ResourcesResponse resp)
+	{
+		if (req.path == "" && req.extensions == "" && req.filter == "")
+		{
+			resp.status = "error";
+			resp.message = "browse needs at least one of path, extensions or filter";
+			return;
+		}
+
+		bool fromCache;
+		array<string> results = Search(req, fromCache);
+
+		int limit = req.limit;
+		if (limit <= 0)
+			limit = DEFAULT_BROWSE_LIMIT;
+		int first = Math.Max(req.offset, 0);
+		int last = Math.Min(results.Count(), first + limit);
+
+		for (int i = first; i < last; i++)
+		{
+			string resName = results[i];
+			string resPath = StripGuid(resName);
+
+			EMCP_WB_ResourceEntry entry = new EMCP_WB_ResourceEntry();
+			entry.m_sResourceName = resName;
+			entry.m_sPath = resPath;
+			entry.m_sName = FilePath.StripPath(resPath);
+			int dot = entry.m_sName.LastIndexOf(".");
+			if (dot >= 0)
+				entry.m_sType = entry.m_sName.Substring(dot + 1, entry.m_sName.Length() - dot - 1);
+			else
+				entry.m_sType = "";
+			resp.m_aEntries.Insert(entry);
+		}
+
+		resp.entryCount = results.Count();
+		resp.offset = first;
+		resp.nextOffset = -1;
+		if (last < results.Count())
+			resp.nextOffset = last;
+		resp.cached = fromCache;
+		resp.status = "ok";
+		resp.message = "Resources " + first.ToString() + "-" + (last - 1).ToString() + " of " + results.Count().ToString();
+		if (fromCache)
+			resp.message = resp.message + " (cached)";
+	}
+
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
 		return new EMCP_WB_ResourcesRequest();
 	}
 
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetResponse(JsonApiStruct request)
 	{
 		EMCP_WB_ResourcesRequest req = EMCP_WB_ResourcesRequest.Cast(request);
@@ -79,6 +291,12 @@ class EMCP_WB_Resources : NetApiHandler
 		resp.action = req.action;
 		resp.path = req.path;
 
+		if (req.action == "browse")
+		{
+			Browse(req, resp);
+			return resp;
+		}
+
 		if (req.path == "")
 		{
 			resp.status = "error";
@@ -97,6 +315,7 @@ class EMCP_WB_Resources : NetApiHandler
 		if (req.action == "register")
 		{
 			bool result = resMgr.RegisterResourceFile(req.path, req.buildRuntime);
+			EMCP_WB_ResourceSearchCache.Clear();
 			resp.status = "ok";
 			if (result)
 				resp.message = "Resource registered: " + req.path;
@@ -106,6 +325,7 @@ class EMCP_WB_Resources : NetApiHandler
 		else if (req.action == "rebuild")
 		{
 			resMgr.RebuildResourceFile(req.path, "", false);
+			EMCP_WB_ResourceSearchCache.Clear();
 			resp.status = "ok";
 			resp.message = "Rebuild initiated for: " + req.path;
 		}
@@ -118,14 +338,6 @@ class EMCP_WB_Resources : NetApiHandler
 			else
 				resp.message = "SetOpenedResource returned false for: " + req.path;
 		}
-		else if (req.action == "browse")
-		{
-			// Workbench.SearchResources requires a WorkbenchSearchResourcesCallback subclass
-			// whose exact callback method signature is not publicly documented.
-			// Until the callback pattern is confirmed at runtime, return a helpful error.
-			resp.status = "error";
-			resp.message = "browse action not yet implemented: Workbench.SearchResources requires a WorkbenchSearchResourcesCallback subclass. Use wb_open_resource or project_browse instead.";
-		}
 		else
 		{
 			resp.status = "error";
@@ -1,8 +1,24 @@
 /**
  * EMCP_WB_ScriptEditor.c - Script editor operations handler
  *
- * Actions: getCurrentFile, getLine, setLine, insertLine, removeLine, getLinesCount, openFile
+ * Actions: getCurrentFile, getLine, setLine, insertLine, removeLine, getLinesCount, openFile,
+ *          getRange, replaceRange, applyPatch
  * Uses the ScriptEditor Workbench module.
+ *
+ * Range actions move whole blocks of lines per request. Line indices are the
+ * ScriptEditor's own (0 = first line). Multi-line text travels in text joined
+ * by "\n" (lines may contain tabs, so EMCP_WB_Records is only used for the
+ * numeric hunk headers).
+ *   getRange     - line (default 0), count (-1 = to end of file) -> rangeText
+ *   replaceRange - replace count lines at line with text (newCount lines;
+ *                  -1 = however many lines text has, "" = none)
+ *   applyPatch   - hunks: one 'line\tremoveCount\tinsertCount' record per hunk,
+ *                  ascending and non-overlapping, line numbers against the
+ *                  current file; text holds every hunk's inserted lines in order
+ * Every range response carries contentHash of the whole file. Pass it back as
+ * expectedHash on a write to reject it (status "conflict") if the file changed
+ * since it was read.
+ *
  * Called via NET API TCP protocol: APIFunc = "EMCP_WB_ScriptEditor"
  */
 
@@ -12,6 +28,10 @@ class EMCP_WB_ScriptEditorRequest : JsonApiStruct
 	int line;
 	string text;
 	string path;
+	int count;
+	int newCount;
+	string hunks;
+	string expectedHash;
 
 	void EMCP_WB_ScriptEditorRequest()
 	{
@@ -19,7 +39,13 @@ class EMCP_WB_ScriptEditorRequest : JsonApiStruct
 		RegV("line");
 		RegV("text");
 		RegV("path");
+		RegV("count");
+		RegV("newCount");
+		RegV("hunks");
+		RegV("expectedHash");
 		line = -1;
+		count = -1;
+		newCount = -1;
 	}
 }
 
@@ -32,6 +58,10 @@ class EMCP_WB_ScriptEditorResponse : JsonApiStruct
 	int currentLine;
 	int linesCount;
 	string lineText;
+	string rangeText;
+	int rangeStart;
+	int rangeCount;
+	string contentHash;
 
 	void EMCP_WB_ScriptEditorResponse()
 	{
@@ -42,16 +72,103 @@ class EMCP_WB_ScriptEditorResponse : JsonApiStruct
 		RegV("currentLine");
 		RegV("linesCount");
 		RegV("lineText");
+		RegV("rangeText");
+		RegV("rangeStart");
+		RegV("rangeCount");
+		RegV("contentHash");
 	}
 }
 
 class EMCP_WB_ScriptEditor : NetApiHandler
 {
+	static const int HASH_MULTIPLIER = 16777619;
+
+	//------------------------------------------------------------------------------------------------
+	//! Hash of the whole open file as "lineCount:hash". Only compared for equality.
+	static string ContentHash(ScriptEditor scriptEditor)
+	{
+		int total = scriptEditor.GetLinesCount();
+		int hash = total;
+		for (int i = 0; i < total; i++)
+		{
+			string lineText;
+			scriptEditor.GetLineText(lineText, i);
+			hash = hash * HASH_MULTIPLIER + lineText.Hash();
+		}
+		return total.ToString() + ":" + hash.ToString();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Split text into exactly wanted lines (-1 = as many as text has, "" = none). Strips "\r".
+	static void SplitLines(string text, int wanted, notnull array<string> outLines)
+	{
+		if (text != "")
+			text.Split("\n", outLines, false);
+
+		for (int i = 0; i < outLines.Count(); i++)
+		{
+			string part = outLines[i];
+			if (part.EndsWith("\r"))
+				outLines[i] = part.Substring(0, part.Length() - 1);
+		}
+
+		if (wanted < 0)
+			return;
+		while (outLines.Count() > wanted)
+		{
+			outLines.Remove(outLines.Count() - 1);
+		}
+		while (outLines.Count() < wanted)
+		{
+			outLines.Insert("");
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Replace removeCount lines at start with insertCount lines of newLines starting at offset.
+	//! Overlapping lines are overwritten in place so the editor does the least work.
+	static void ApplyHunk(ScriptEditor scriptEditor, int start, int removeCount, array<string> newLines, int offset, int insertCount)
+	{
+		int common = Math.Min(removeCount, insertCount);
+		for (int k = 0; k < common; k++)
+		{
+			scriptEditor.SetLineText(newLines[offset + k], start + k);
+		}
+		for (int r = common; r < removeCount; r++)
+		{
+			scriptEditor.RemoveLine(start + common);
+		}
+		for (int n = common; n < insertCount; n++)
+		{
+			scriptEditor.InsertLine(newLines[offset + n], start + n);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Fail with status "conflict" when expectedHash is set and no longer matches. Returns true if the write may proceed.
+	static bool CheckHash(ScriptEditor scriptEditor, string expectedHash, EMCP_WB_ScriptEditorResponse resp)
+	{
+		if (expectedHash == "")
+			return true;
+
+		string currentHash = ContentHash(scriptEditor);
+		if (currentHash == expectedHash)
+			return true;
+
+		resp.status = "conflict";
+		resp.contentHash = currentHash;
+		resp.linesCount = scriptEditor.GetLinesCount();
+		resp.message = "File changed since it was read (expected " + expectedHash + ", now " + currentHash + "); re-read and retry";
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
 		return new EMCP_WB_ScriptEditorRequest();
 	}
 
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetResponse(JsonApiStruct request)
 	{
 		EMCP_WB_ScriptEditorRequest req = EMCP_WB_ScriptEditorRequest.Cast(request);
@@ -140,10 +257,124 @@ class EMCP_WB_ScriptEditor : NetApiHandler
 			else
 				resp.message = "SetOpenedResource returned false for: " + req.path;
 		}
+		else if (req.action == "getRange")
+		{
+			int total = scriptEditor.GetLinesCount();
+			int start = Math.Max(req.line, 0);
+			int rangeLen = req.count;
+			if (rangeLen < 0 || start + rangeLen > total)
+				rangeLen = Math.Max(total - start, 0);
+
+			string block = "";
+			for (int g = 0; g < rangeLen; g++)
+			{
+				string rangeLine;
+				scriptEditor.GetLineText(rangeLine, start + g);
+				if (g > 0)
+					block += "\n";
+				block += rangeLine;
+			}
+
+			resp.rangeText = block;
+			resp.rangeStart = start;
+			resp.rangeCount = rangeLen;
+			resp.linesCount = total;
+			resp.contentHash = ContentHash(scriptEditor);
+			resp.status = "ok";
+			resp.message = "Lines " + start.ToString() + "-" + (start + rangeLen - 1).ToString() + " of " + total.ToString();
+		}
+		else if (req.action == "replaceRange")
+		{
+			if (!CheckHash(scriptEditor, req.expectedHash, resp))
+				return resp;
+
+			int replTotal = scriptEditor.GetLinesCount();
+			int replStart = Math.Max(req.line, 0);
+			int removeCount = req.count;
+			if (removeCount < 0)
+				removeCount = replTotal - replStart;
+
+			if (replStart > replTotal || replStart + removeCount > replTotal)
+			{
+				resp.status = "error";
+				resp.message = "Range " + replStart.ToString() + "+" + removeCount.ToString() + " is outside the file (" + replTotal.ToString() + " lines)";
+				return resp;
+			}
+
+			array<string> replLines = {};
+			SplitLines(req.text, req.newCount, replLines);
+			ApplyHunk(scriptEditor, replStart, removeCount, replLines, 0, replLines.Count());
+
+			resp.rangeStart = replStart;
+			resp.rangeCount = replLines.Count();
+			resp.linesCount = scriptEditor.GetLinesCount();
+			resp.contentHash = ContentHash(scriptEditor);
+			resp.status = "ok";
+			resp.message = "Replaced " + removeCount.ToString() + " lines at " + replStart.ToString() + " with " + replLines.Count().ToString();
+		}
+		else if (req.action == "applyPatch")
+		{
+			if (!CheckHash(scriptEditor, req.expectedHash, resp))
+				return resp;
+
+			array<ref array<string>> hunkRows = {};
+			EMCP_WB_Records.Parse(req.hunks, hunkRows);
+			if (hunkRows.Count() == 0)
+			{
+				resp.status = "error";
+				resp.message = "hunks parameter required (one 'line\\tremoveCount\\tinsertCount' record per hunk)";
+				return resp;
+			}
+
+			// Validate every hunk before touching the buffer so a bad patch changes nothing
+			int patchTotal = scriptEditor.GetLinesCount();
+			array<int> starts = {};
+			array<int> removes = {};
+			array<int> inserts = {};
+			array<int> offsets = {};
+			int prevEnd = 0;
+			int insertTotal = 0;
+			for (int h = 0; h < hunkRows.Count(); h++)
+			{
+				array<string> hunkRow = hunkRows[h];
+				int hunkStart = EMCP_WB_Records.Field(hunkRow, 0).ToInt();
+				int hunkRemove = EMCP_WB_Records.Field(hunkRow, 1).ToInt();
+				int hunkInsert = EMCP_WB_Records.Field(hunkRow, 2).ToInt();
+
+				if (hunkStart < prevEnd || hunkRemove < 0 || hunkInsert < 0 || hunkStart + hunkRemove > patchTotal)
+				{
+					resp.status = "error";
+					resp.message = "Hunk " + h.ToString() + " (" + hunkStart.ToString() + "+" + hunkRemove.ToString() + ") overlaps a previous hunk or is outside the file (" + patchTotal.ToString() + " lines)";
+					return resp;
+				}
+
+				starts.Insert(hunkStart);
+				removes.Insert(hunkRemove);
+				inserts.Insert(hunkInsert);
+				offsets.Insert(insertTotal);
+				insertTotal += hunkInsert;
+				prevEnd = hunkStart + hunkRemove;
+			}
+
+			array<string> patchLines = {};
+			SplitLines(req.text, insertTotal, patchLines);
+
+			// Bottom-up so earlier hunks' line numbers stay valid
+			for (int a = starts.Count() - 1; a >= 0; a--)
+			{
+				ApplyHunk(scriptEditor, starts[a], removes[a], patchLines, offsets[a], inserts[a]);
+			}
+
+			resp.rangeCount = starts.Count();
+			resp.linesCount = scriptEditor.GetLinesCount();
+			resp.contentHash = ContentHash(scriptEditor);
+			resp.status = "ok";
+			resp.message = "Applied " + starts.Count().ToString() + " hunks (" + patchTotal.ToString() + " -> " + resp.linesCount.ToString() + " lines)";
+		}
 		else
 		{
 			resp.status = "error";
-			resp.message = "Unknown action: " + req.action + ". Valid: getCurrentFile, getLine, setLine, insertLine, removeLine, getLinesCount, openFile";
+			resp.message = "Unknown action: " + req.action + ". Valid: getCurrentFile, getLine, setLine, insertLine, removeLine, getLinesCount, openFile, getRange, replaceRange, applyPatch";
 		}
 
 		return resp;
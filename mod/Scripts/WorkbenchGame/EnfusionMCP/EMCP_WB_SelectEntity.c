@@ -6,7 +6,9 @@
  * "select" uses ClearEntitySelection + a workaround via entity iteration.
  * "deselect" uses RemoveFromEntitySelection.
  * "clear" uses ClearEntitySelection.
- * "getSelected" iterates GetSelectedEntity.
+ * "getSelected" iterates GetSelectedEntity. With encoding = "columnar" the
+ *   selection is returned as names[] + classIndex[] into a classNames[] dictionary
+ *   (same layout as EMCP_WB_ListEntities) instead of one object per entity.
  *
  * Called via NET API TCP protocol: APIFunc = "EMCP_WB_SelectEntity"
  */
@@ -15,11 +17,13 @@ class EMCP_WB_SelectEntityRequest : JsonApiStruct
 {
 	string action;
 	string name;
+	string encoding;
 
 	void EMCP_WB_SelectEntityRequest()
 	{
 		RegV("action");
 		RegV("name");
+		RegV("encoding");
 	}
 }
 
@@ -29,6 +33,7 @@ class EMCP_WB_SelectEntityResponse : JsonApiStruct
 	string message;
 	string action;
 	int selectedCount;
+	string encoding;
 
 	// Selected entity names for getSelected
 	ref array<string> m_aSelectedNames;
@@ -40,6 +45,7 @@ class EMCP_WB_SelectEntityResponse : JsonApiStruct
 		RegV("message");
 		RegV("action");
 		RegV("selectedCount");
+		RegV("encoding");
 
 		m_aSelectedNames = {};
 		m_aSelectedClasses = {};
@@ -47,6 +53,45 @@ class EMCP_WB_SelectEntityResponse : JsonApiStruct
 
 	override void OnPack()
 	{
+		if (encoding == "columnar")
+		{
+			array<string> classDict = {};
+			array<int> classIndices = {};
+			map<string, int> classLookup = new map<string, int>();
+			for (int c = 0; c < m_aSelectedClasses.Count(); c++)
+			{
+				int classIdx;
+				if (!classLookup.Find(m_aSelectedClasses[c], classIdx))
+				{
+					classIdx = classDict.Insert(m_aSelectedClasses[c]);
+					classLookup.Set(m_aSelectedClasses[c], classIdx);
+				}
+				classIndices.Insert(classIdx);
+			}
+
+			StartArray("classNames");
+			for (int d = 0; d < classDict.Count(); d++)
+			{
+				StoreString("", classDict[d]);
+			}
+			EndArray();
+
+			StartArray("names");
+			for (int n = 0; n < m_aSelectedNames.Count(); n++)
+			{
+				StoreString("", m_aSelectedNames[n]);
+			}
+			EndArray();
+
+			StartArray("classIndex");
+			for (int ci = 0; ci < classIndices.Count(); ci++)
+			{
+				StoreInteger("", classIndices[ci]);
+			}
+			EndArray();
+			return;
+		}
+
 		if (m_aSelectedNames.Count() > 0)
 		{
 			StartArray("selectedEntities");
@@ -64,19 +109,6 @@ class EMCP_WB_SelectEntityResponse : JsonApiStruct
 
 class EMCP_WB_SelectEntity : NetApiHandler
 {
-	//------------------------------------------------------------------------------------------------
-	static IEntitySource FindEntityByName(WorldEditorAPI api, string name)
-	{
-		int count = api.GetEditorEntityCount();
-		for (int i = 0; i < count; i++)
-		{
-			IEntitySource candidate = api.GetEditorEntity(i);
-			if (candidate && candidate.GetName() == name)
-				return candidate;
-		}
-		return null;
-	}
-
 	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
@@ -89,6 +121,9 @@ class EMCP_WB_SelectEntity : NetApiHandler
 		EMCP_WB_SelectEntityRequest req = EMCP_WB_SelectEntityRequest.Cast(request);
 		EMCP_WB_SelectEntityResponse resp = new EMCP_WB_SelectEntityResponse();
 		resp.action = req.action;
+		resp.encoding = "objects";
+		if (req.encoding == "columnar")
+			resp.encoding = "columnar";
 
 		WorldEditor worldEditor = Workbench.GetModule(WorldEditor);
 		if (!worldEditor)
@@ -115,7 +150,7 @@ class EMCP_WB_SelectEntity : NetApiHandler
 				return resp;
 			}
 
-			IEntitySource entSrc = FindEntityByName(api, req.name);
+			IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.name);
 			if (!entSrc)
 			{
 				resp.status = "error";
@@ -147,7 +182,7 @@ class EMCP_WB_SelectEntity : NetApiHandler
 				return resp;
 			}
 
-			IEntitySource entSrc = FindEntityByName(api, req.name);
+			IEntitySource entSrc = EMCP_WB_EntityIndex.Find(api, req.name);
 			if (!entSrc)
 			{
 				resp.status = "error";
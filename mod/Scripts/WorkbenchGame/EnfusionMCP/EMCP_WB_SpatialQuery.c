@@ -0,0 +1,639 @@
+/**
+ * EMCP_WB_SpatialQuery.c - Radius / box / k-nearest entity queries
+ *
+ * modes:
+ *   radius  - entities within radius of center
+ *   box     - entities inside the AABB [min, max]
+ *   nearest - the k entities closest to center (optionally capped by radius)
+ * Optional filters: classFilter (case-insensitive substring of the class name),
+ * layerID (exact). horizontal = true measures distance in XZ only.
+ * Results are sorted by distance (to the box center in box mode), so when
+ * limit truncates a radius or box query the closest matches are kept. Matches
+ * are kept in a bounded max-heap and sorted once at the end. k above limit is
+ * clamped to limit and reported as kClamped and in the message.
+ *
+ * Backed by EMCP_WB_SpatialGrid, a uniform XZ cell grid over entity origins.
+ * The grid is rebuilt lazily when the editor entity count changes, when a
+ * handler that moves entities invalidates it, or on refresh = true. Candidates
+ * from the grid are re-checked against their live origin, so a result is never
+ * outside the query; an entity moved by hand into the area since the last
+ * rebuild can be missed until refresh.
+ *
+ * Numeric inputs are strings ("x y z", "200") because RegV float ignores JSON integers.
+ *
+ * Called via NET API TCP protocol: APIFunc = "EMCP_WB_SpatialQuery"
+ */
+
+class EMCP_WB_SpatialGrid
+{
+	static const float CELL_SIZE = 64.0;
+
+	protected static ref map<int, ref array<int>> s_mCells;
+	protected static ref array<int> s_aEditorIndex;
+	protected static int s_iEntityCount = -1;
+	protected static int s_iMinCellX;
+	protected static int s_iMaxCellX;
+	protected static int s_iMinCellZ;
+	protected static int s_iMaxCellZ;
+
+	//------------------------------------------------------------------------------------------------
+	//! Rebuild if missing or the entity count changed. Returns true if a rebuild happened.
+	static bool Ensure(WorldEditorAPI api, bool force)
+	{
+		if (!force && s_mCells && s_iEntityCount == api.GetEditorEntityCount())
+			return false;
+
+		Rebuild(api);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Drop the grid; the next query rebuilds it. Called by handlers that move entities.
+	static void Invalidate()
+	{
+		s_mCells = null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static void Rebuild(WorldEditorAPI api)
+	{
+		s_mCells = new map<int, ref array<int>>();
+		s_aEditorIndex = {};
+		s_iEntityCount = api.GetEditorEntityCount();
+		s_iMinCellX = int.MAX;
+		s_iMaxCellX = int.MIN;
+		s_iMinCellZ = int.MAX;
+		s_iMaxCellZ = int.MIN;
+
+		for (int i = 0; i < s_iEntityCount; i++)
+		{
+			IEntitySource entSrc = api.GetEditorEntity(i);
+			if (!entSrc)
+				continue;
+
+			// Entities without a runtime instance have no origin to index
+			IEntity ent = api.SourceToEntity(entSrc);
+			if (!ent)
+				continue;
+
+			vector origin = ent.GetOrigin();
+			int cx = CellCoord(origin[0]);
+			int cz = CellCoord(origin[2]);
+
+			int entry = s_aEditorIndex.Insert(i);
+
+			int key = CellKey(cx, cz);
+			array<int> cell = s_mCells.Get(key);
+			if (!cell)
+			{
+				cell = {};
+				s_mCells.Set(key, cell);
+			}
+			cell.Insert(entry);
+
+			if (cx < s_iMinCellX) s_iMinCellX = cx;
+			if (cx > s_iMaxCellX) s_iMaxCellX = cx;
+			if (cz < s_iMinCellZ) s_iMinCellZ = cz;
+			if (cz > s_iMaxCellZ) s_iMaxCellZ = cz;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Editor entity indices of all entries whose cell overlaps the XZ rectangle.
+	static void CollectRect(float minX, float minZ, float maxX, float maxZ, notnull array<int> outIndices)
+	{
+		if (!s_mCells || s_aEditorIndex.IsEmpty())
+			return;
+
+		// Clamp to occupied cells so a huge radius doesn't walk empty space
+		int x0 = Math.Max(CellCoord(minX), s_iMinCellX);
+		int x1 = Math.Min(CellCoord(maxX), s_iMaxCellX);
+		int z0 = Math.Max(CellCoord(minZ), s_iMinCellZ);
+		int z1 = Math.Min(CellCoord(maxZ), s_iMaxCellZ);
+
+		for (int cx = x0; cx <= x1; cx++)
+		{
+			for (int cz = z0; cz <= z1; cz++)
+			{
+				AppendCell(cx, cz, outIndices);
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Editor entity indices in the square ring of cells at Chebyshev distance ring around (cx, cz).
+	static void CollectRing(int cx, int cz, int ring, notnull array<int> outIndices)
+	{
+		if (!s_mCells)
+			return;
+
+		if (ring == 0)
+		{
+			AppendCell(cx, cz, outIndices);
+			return;
+		}
+
+		for (int x = cx - ring; x <= cx + ring; x++)
+		{
+			AppendCell(x, cz - ring, outIndices);
+			AppendCell(x, cz + ring, outIndices);
+		}
+		for (int z = cz - ring + 1; z <= cz + ring - 1; z++)
+		{
+			AppendCell(cx - ring, z, outIndices);
+			AppendCell(cx + ring, z, outIndices);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Number of rings needed from (cx, cz) to cover every occupied cell.
+	static int MaxRing(int cx, int cz)
+	{
+		if (!s_mCells || s_aEditorIndex.IsEmpty())
+			return -1;
+
+		int r = Math.AbsInt(cx - s_iMinCellX);
+		r = Math.Max(r, Math.AbsInt(cx - s_iMaxCellX));
+		r = Math.Max(r, Math.AbsInt(cz - s_iMinCellZ));
+		r = Math.Max(r, Math.AbsInt(cz - s_iMaxCellZ));
+		return r;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static int IndexedCount()
+	{
+		if (!s_aEditorIndex)
+			return 0;
+		return s_aEditorIndex.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static int CellCount()
+	{
+		if (!s_mCells)
+			return 0;
+		return s_mCells.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static int CellCoord(float v)
+	{
+		return Math.Floor(v / CELL_SIZE);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static int CellKey(int cx, int cz)
+	{
+		// 16 bits per axis covers +-2000 km at 64 m cells
+		return ((cx & 0xFFFF) << 16) | (cz & 0xFFFF);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static void AppendCell(int cx, int cz, notnull array<int> outIndices)
+	{
+		array<int> cell = s_mCells.Get(CellKey(cx, cz));
+		if (!cell)
+			return;
+
+		for (int i = 0; i < cell.Count(); i++)
+		{
+			outIndices.Insert(s_aEditorIndex[cell[i]]);
+		}
+	}
+}
+
+class EMCP_WB_SpatialQueryRequest : JsonApiStruct
+{
+	string mode;
+	string center;
+	string radius;
+	string min;
+	string max;
+	int k;
+	string classFilter;
+	string layerID;
+	bool horizontal;
+	int limit;
+	bool refresh;
+
+	void EMCP_WB_SpatialQueryRequest()
+	{
+		RegV("mode");
+		RegV("center");
+		RegV("radius");
+		RegV("min");
+		RegV("max");
+		RegV("k");
+		RegV("classFilter");
+		RegV("layerID");
+		RegV("horizontal");
+		RegV("limit");
+		RegV("refresh");
+	}
+}
+
+class EMCP_WB_SpatialQueryResponse : JsonApiStruct
+{
+	string status;
+	string message;
+	string mode;
+	int totalCount;
+	int returnedCount;
+	int candidateCount;
+	int indexedCount;
+	int cellCount;
+	bool rebuilt;
+	bool kClamped;
+
+	ref array<string> m_aNames;
+	ref array<string> m_aClassNames;
+	ref array<int> m_aLayerIDs;
+	ref array<vector> m_aPositions;
+	ref array<float> m_aDistances;
+
+	void EMCP_WB_SpatialQueryResponse()
+	{
+		RegV("status");
+		RegV("message");
+		RegV("mode");
+		RegV("totalCount");
+		RegV("returnedCount");
+		RegV("candidateCount");
+		RegV("indexedCount");
+		RegV("cellCount");
+		RegV("rebuilt");
+		RegV("kClamped");
+
+		m_aNames = {};
+		m_aClassNames = {};
+		m_aLayerIDs = {};
+		m_aPositions = {};
+		m_aDistances = {};
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddResult(IEntitySource entSrc, vector pos, float dist)
+	{
+		m_aNames.Insert(entSrc.GetName());
+		m_aClassNames.Insert(entSrc.GetClassName());
+		m_aLayerIDs.Insert(entSrc.GetLayerID());
+		m_aPositions.Insert(pos);
+		m_aDistances.Insert(dist);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void OnPack()
+	{
+		StartArray("entities");
+		for (int i = 0; i < m_aNames.Count(); i++)
+		{
+			vector entPos = m_aPositions[i];
+			StartObject("");
+			StoreString("name", m_aNames[i]);
+			StoreString("className", m_aClassNames[i]);
+			StoreInteger("layerID", m_aLayerIDs[i]);
+			StoreString("position", entPos[0].ToString() + " " + entPos[1].ToString() + " " + entPos[2].ToString());
+			StoreFloat("distance", m_aDistances[i]);
+			EndObject();
+		}
+		EndArray();
+	}
+}
+
+class EMCP_WB_SpatialQuery : NetApiHandler
+{
+	protected WorldEditorAPI m_Api;
+	protected string m_sClassFilter;
+	protected bool m_bFilterLayer;
+	protected int m_iLayerID;
+	protected bool m_bHorizontal;
+
+	// Matches kept so far as a max-heap on distance (farthest at 0) until SortBest()
+	protected ref array<int> m_aBestIndices;
+	protected ref array<float> m_aBestDists;
+	protected ref array<vector> m_aBestPositions;
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetRequest()
+	{
+		return new EMCP_WB_SpatialQueryRequest();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Resolve a candidate: null if it fails the class/layer filters, else its live origin in outPos.
+	protected IEntitySource Accept(int editorIndex, out vector outPos)
+	{
+		IEntitySource entSrc = m_Api.GetEditorEntity(editorIndex);
+		if (!entSrc)
+			return null;
+
+		if (m_bFilterLayer && entSrc.GetLayerID() != m_iLayerID)
+			return null;
+
+		if (m_sClassFilter != "")
+		{
+			string lowerClass = entSrc.GetClassName();
+			lowerClass.ToLower();
+			if (lowerClass.IndexOf(m_sClassFilter) < 0)
+				return null;
+		}
+
+		IEntity ent = m_Api.SourceToEntity(entSrc);
+		if (!ent)
+			return null;
+
+		outPos = ent.GetOrigin();
+		return entSrc;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected float Dist(vector a, vector b)
+	{
+		if (m_bHorizontal)
+		{
+			a[1] = 0;
+			b[1] = 0;
+		}
+		return vector.Distance(a, b);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Keep a match if it is among the maxKept closest so far. O(log maxKept) per match.
+	protected void Offer(int editorIndex, vector pos, float dist, int maxKept)
+	{
+		int count = m_aBestDists.Count();
+		if (count < maxKept)
+		{
+			m_aBestDists.Insert(dist);
+			m_aBestIndices.Insert(editorIndex);
+			m_aBestPositions.Insert(pos);
+			SiftUp(count);
+			return;
+		}
+
+		// Full: replace the farthest kept match if this one is closer
+		if (dist >= m_aBestDists[0])
+			return;
+
+		m_aBestDists[0] = dist;
+		m_aBestIndices[0] = editorIndex;
+		m_aBestPositions[0] = pos;
+		SiftDown(0, count);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Distance of the farthest kept match, or -1 if none are kept.
+	protected float WorstDist()
+	{
+		if (m_aBestDists.IsEmpty())
+			return -1;
+		return m_aBestDists[0];
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Heap-sort the kept matches in place into ascending distance.
+	protected void SortBest()
+	{
+		for (int last = m_aBestDists.Count() - 1; last > 0; last--)
+		{
+			SwapBest(0, last);
+			SiftDown(0, last);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SiftUp(int i)
+	{
+		while (i > 0)
+		{
+			int parent = (i - 1) / 2;
+			if (m_aBestDists[parent] >= m_aBestDists[i])
+				return;
+
+			SwapBest(parent, i);
+			i = parent;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Restore the heap below i, considering only the first count entries.
+	protected void SiftDown(int i, int count)
+	{
+		while (true)
+		{
+			int largest = i;
+			int left = 2 * i + 1;
+			int right = left + 1;
+			if (left < count && m_aBestDists[left] > m_aBestDists[largest])
+				largest = left;
+			if (right < count && m_aBestDists[right] > m_aBestDists[largest])
+				largest = right;
+			if (largest == i)
+				return;
+
+			SwapBest(i, largest);
+			i = largest;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SwapBest(int a, int b)
+	{
+		float dist = m_aBestDists[a];
+		m_aBestDists[a] = m_aBestDists[b];
+		m_aBestDists[b] = dist;
+
+		int index = m_aBestIndices[a];
+		m_aBestIndices[a] = m_aBestIndices[b];
+		m_aBestIndices[b] = index;
+
+		vector pos = m_aBestPositions[a];
+		m_aBestPositions[a] = m_aBestPositions[b];
+		m_aBestPositions[b] = pos;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override JsonApiStruct GetResponse(JsonApiStruct request)
+	{
+		EMCP_WB_SpatialQueryRequest req = EMCP_WB_SpatialQueryRequest.Cast(request);
+		EMCP_WB_SpatialQueryResponse resp = new EMCP_WB_SpatialQueryResponse();
+		resp.mode = req.mode;
+
+		WorldEditor worldEditor = Workbench.GetModule(WorldEditor);
+		if (!worldEditor)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditor module not available";
+			return resp;
+		}
+
+		m_Api = worldEditor.GetApi();
+		if (!m_Api)
+		{
+			resp.status = "error";
+			resp.message = "WorldEditorAPI not available";
+			return resp;
+		}
+
+		m_sClassFilter = req.classFilter;
+		m_sClassFilter.ToLower();
+		m_bFilterLayer = req.layerID != "";
+		m_iLayerID = req.layerID.ToInt();
+		m_bHorizontal = req.horizontal;
+		m_aBestIndices = {};
+		m_aBestDists = {};
+		m_aBestPositions = {};
+
+		int maxResults = req.limit;
+		if (maxResults <= 0)
+			maxResults = 500;
+
+		resp.rebuilt = EMCP_WB_SpatialGrid.Ensure(m_Api, req.refresh);
+		resp.indexedCount = EMCP_WB_SpatialGrid.IndexedCount();
+		resp.cellCount = EMCP_WB_SpatialGrid.CellCount();
+
+		if (req.mode == "radius")
+		{
+			if (req.center == "" || req.radius == "")
+			{
+				resp.status = "error";
+				resp.message = "center ('x y z') and radius are required for radius mode";
+				return resp;
+			}
+
+			vector center = EMCP_WB_ModifyEntity.ParseVectorString(req.center);
+			float rad = req.radius.ToFloat();
+
+			array<int> radiusCandidates = {};
+			EMCP_WB_SpatialGrid.CollectRect(center[0] - rad, center[2] - rad, center[0] + rad, center[2] + rad, radiusCandidates);
+			resp.candidateCount = radiusCandidates.Count();
+
+			for (int i = 0; i < radiusCandidates.Count(); i++)
+			{
+				vector radiusPos;
+				IEntitySource radiusSrc = Accept(radiusCandidates[i], radiusPos);
+				if (!radiusSrc)
+					continue;
+
+				float radiusDist = Dist(center, radiusPos);
+				if (radiusDist > rad)
+					continue;
+
+				resp.totalCount++;
+				Offer(radiusCandidates[i], radiusPos, radiusDist, maxResults);
+			}
+		}
+		else if (req.mode == "box")
+		{
+			if (req.min == "" || req.max == "")
+			{
+				resp.status = "error";
+				resp.message = "min and max ('x y z') are required for box mode";
+				return resp;
+			}
+
+			vector boxA = EMCP_WB_ModifyEntity.ParseVectorString(req.min);
+			vector boxB = EMCP_WB_ModifyEntity.ParseVectorString(req.max);
+			vector boxMin = Vector(Math.Min(boxA[0], boxB[0]), Math.Min(boxA[1], boxB[1]), Math.Min(boxA[2], boxB[2]));
+			vector boxMax = Vector(Math.Max(boxA[0], boxB[0]), Math.Max(boxA[1], boxB[1]), Math.Max(boxA[2], boxB[2]));
+			vector boxCenter = (boxMin + boxMax) * 0.5;
+
+			array<int> boxCandidates = {};
+			EMCP_WB_SpatialGrid.CollectRect(boxMin[0], boxMin[2], boxMax[0], boxMax[2], boxCandidates);
+			resp.candidateCount = boxCandidates.Count();
+
+			for (int b = 0; b < boxCandidates.Count(); b++)
+			{
+				vector boxPos;
+				IEntitySource boxSrc = Accept(boxCandidates[b], boxPos);
+				if (!boxSrc)
+					continue;
+
+				if (boxPos[0] < boxMin[0] || boxPos[0] > boxMax[0] || boxPos[2] < boxMin[2] || boxPos[2] > boxMax[2])
+					continue;
+				if (!m_bHorizontal && (boxPos[1] < boxMin[1] || boxPos[1] > boxMax[1]))
+					continue;
+
+				resp.totalCount++;
+				Offer(boxCandidates[b], boxPos, Dist(boxCenter, boxPos), maxResults);
+			}
+		}
+		else if (req.mode == "nearest")
+		{
+			if (req.center == "")
+			{
+				resp.status = "error";
+				resp.message = "center ('x y z') is required for nearest mode";
+				return resp;
+			}
+
+			vector origin = EMCP_WB_ModifyEntity.ParseVectorString(req.center);
+			int k = req.k;
+			if (k <= 0)
+				k = 10;
+			if (k > maxResults)
+			{
+				k = maxResults;
+				resp.kClamped = true;
+			}
+
+			float maxDist = -1;
+			if (req.radius != "")
+				maxDist = req.radius.ToFloat();
+
+			int cx = EMCP_WB_SpatialGrid.CellCoord(origin[0]);
+			int cz = EMCP_WB_SpatialGrid.CellCoord(origin[2]);
+			int lastRing = EMCP_WB_SpatialGrid.MaxRing(cx, cz);
+
+			for (int ring = 0; ring <= lastRing; ring++)
+			{
+				// The origin can sit on the edge of its cell, so ring and beyond are
+				// only guaranteed to be (ring - 1) * CELL_SIZE away horizontally
+				float ringFloor = (ring - 1) * EMCP_WB_SpatialGrid.CELL_SIZE;
+				if (m_aBestDists.Count() >= k && WorstDist() <= ringFloor)
+					break;
+				if (maxDist >= 0 && ring > 0 && (ring - 1) * EMCP_WB_SpatialGrid.CELL_SIZE > maxDist)
+					break;
+
+				array<int> ringCandidates = {};
+				EMCP_WB_SpatialGrid.CollectRing(cx, cz, ring, ringCandidates);
+				resp.candidateCount += ringCandidates.Count();
+
+				for (int c = 0; c < ringCandidates.Count(); c++)
+				{
+					vector nearPos;
+					IEntitySource nearSrc = Accept(ringCandidates[c], nearPos);
+					if (!nearSrc)
+						continue;
+
+					float nearDist = Dist(origin, nearPos);
+					if (maxDist >= 0 && nearDist > maxDist)
+						continue;
+
+					Offer(ringCandidates[c], nearPos, nearDist, k);
+				}
+			}
+
+			resp.totalCount = m_aBestIndices.Count();
+		}
+		else
+		{
+			resp.status = "error";
+			resp.message = "Unknown mode: " + req.mode + ". Valid: radius, box, nearest";
+			return resp;
+		}
+
+		SortBest();
+		for (int n = 0; n < m_aBestIndices.Count(); n++)
+		{
+			resp.AddResult(m_Api.GetEditorEntity(m_aBestIndices[n]), m_aBestPositions[n], m_aBestDists[n]);
+		}
+
+		resp.returnedCount = resp.m_aNames.Count();
+		resp.status = "ok";
+		resp.message = "Found " + resp.totalCount.ToString() + " entities (" + resp.candidateCount.ToString() + " candidates from " + resp.cellCount.ToString() + " cells)";
+		if (resp.kClamped)
+			resp.message += "; k " + req.k.ToString() + " clamped to limit " + maxResults.ToString();
+		return resp;
+	}
+}
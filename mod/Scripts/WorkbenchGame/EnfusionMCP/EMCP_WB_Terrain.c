@@ -1,7 +1,18 @@
 /**
  * EMCP_WB_Terrain.c - Terrain operations handler
  *
- * Actions: getHeight, getBounds
+ * Actions: getHeight, getBounds, sample
+ *
+ * sample returns many heights in one call as a packed numeric heights[] array:
+ *   mode = "grid":     min/max "x z" corners and step; heights are row-major
+ *                      (z outer, x inner), cols x rows samples starting at min
+ *   mode = "polyline": points (records "x\tz", see EMCP_WB_Records) sampled
+ *                      every step meters along the line; positions[] holds the
+ *                      flat x,z pair of each sample
+ *   mode = "points":   points records, one height per point in order
+ * maxSamples caps the sample count. Grid and polyline coarsen step to fit and
+ * report the step actually used; points over the cap is an error.
+ *
  * Called via NET API TCP protocol: APIFunc = "EMCP_WB_Terrain"
  */
 
@@ -10,12 +21,24 @@ class EMCP_WB_TerrainRequest : JsonApiStruct
 	string action;
 	string x;
 	string z;
+	string mode;
+	string points;
+	string min;
+	string max;
+	string step;
+	int maxSamples;
 
 	void EMCP_WB_TerrainRequest()
 	{
 		RegV("action");
 		RegV("x");
 		RegV("z");
+		RegV("mode");
+		RegV("points");
+		RegV("min");
+		RegV("max");
+		RegV("step");
+		RegV("maxSamples");
 	}
 }
 
@@ -28,6 +51,17 @@ class EMCP_WB_TerrainResponse : JsonApiStruct
 	string boundsMin;
 	string boundsMax;
 
+	// sample
+	string mode;
+	int sampleCount;
+	int cols;
+	int rows;
+	float originX;
+	float originZ;
+	float stepUsed;
+	ref array<float> m_aHeights;
+	ref array<float> m_aPositions;
+
 	void EMCP_WB_TerrainResponse()
 	{
 		RegV("status");
@@ -36,11 +70,185 @@ class EMCP_WB_TerrainResponse : JsonApiStruct
 		RegV("height");
 		RegV("boundsMin");
 		RegV("boundsMax");
+		RegV("mode");
+		RegV("sampleCount");
+		RegV("cols");
+		RegV("rows");
+		RegV("originX");
+		RegV("originZ");
+		RegV("stepUsed");
+
+		m_aHeights = {};
+		m_aPositions = {};
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void OnPack()
+	{
+		if (action != "sample")
+			return;
+
+		StartArray("heights");
+		for (int i = 0; i < m_aHeights.Count(); i++)
+		{
+			StoreFloat("", m_aHeights[i]);
+		}
+		EndArray();
+
+		if (m_aPositions.Count() > 0)
+		{
+			StartArray("positions");
+			for (int p = 0; p < m_aPositions.Count(); p++)
+			{
+				StoreFloat("", m_aPositions[p]);
+			}
+			EndArray();
+		}
 	}
 }
 
 class EMCP_WB_Terrain : NetApiHandler
 {
+	static const int DEFAULT_MAX_SAMPLES = 16384;
+	static const int HARD_MAX_SAMPLES = 262144;
+
+	//------------------------------------------------------------------------------------------------
+	//! Parse "x z" into outX/outZ. Returns false if fewer than two numbers.
+	static bool ParseXZ(string str, out float outX, out float outZ)
+	{
+		array<string> parts = {};
+		str.Split(" ", parts, true);
+		if (parts.Count() < 2)
+			return false;
+
+		outX = parts[0].ToFloat();
+		outZ = parts[1].ToFloat();
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static string SampleGrid(WorldEditorAPI api, EMCP_WB_TerrainRequest req, int cap, EMCP_WB_TerrainResponse resp)
+	{
+		float ax, az, bx, bz;
+		if (!ParseXZ(req.min, ax, az) || !ParseXZ(req.max, bx, bz))
+			return "min and max ('x z') are required for grid sampling";
+
+		float step = req.step.ToFloat();
+		if (step <= 0)
+			return "step (meters, > 0) is required for grid sampling";
+
+		float minX = Math.Min(ax, bx);
+		float minZ = Math.Min(az, bz);
+		float spanX = Math.AbsFloat(bx - ax);
+		float spanZ = Math.AbsFloat(bz - az);
+
+		// Counted in float: a tiny step over a large span overflows int before the cap check
+		float colsF = Math.Floor(spanX / step) + 1;
+		float rowsF = Math.Floor(spanZ / step) + 1;
+		while (colsF * rowsF > cap)
+		{
+			step = step * Math.Sqrt(colsF * rowsF / cap) * 1.01;
+			colsF = Math.Floor(spanX / step) + 1;
+			rowsF = Math.Floor(spanZ / step) + 1;
+		}
+		int gridCols = colsF;
+		int gridRows = rowsF;
+
+		for (int r = 0; r < gridRows; r++)
+		{
+			float sz = minZ + r * step;
+			for (int c = 0; c < gridCols; c++)
+			{
+				resp.m_aHeights.Insert(api.GetTerrainSurfaceY(minX + c * step, sz));
+			}
+		}
+
+		resp.cols = gridCols;
+		resp.rows = gridRows;
+		resp.originX = minX;
+		resp.originZ = minZ;
+		resp.stepUsed = step;
+		return "";
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static string SamplePolyline(WorldEditorAPI api, EMCP_WB_TerrainRequest req, int cap, EMCP_WB_TerrainResponse resp)
+	{
+		array<ref array<string>> rows = {};
+		EMCP_WB_Records.Parse(req.points, rows);
+		if (rows.Count() < 2)
+			return "points must contain at least two 'x\tz' records for polyline sampling";
+
+		float step = req.step.ToFloat();
+		if (step <= 0)
+			return "step (meters, > 0) is required for polyline sampling";
+
+		array<float> xs = {};
+		array<float> zs = {};
+		float totalLength = 0;
+		for (int i = 0; i < rows.Count(); i++)
+		{
+			xs.Insert(EMCP_WB_Records.Field(rows[i], 0).ToFloat());
+			zs.Insert(EMCP_WB_Records.Field(rows[i], 1).ToFloat());
+			if (i > 0)
+				totalLength += Math.Sqrt((xs[i] - xs[i - 1]) * (xs[i] - xs[i - 1]) + (zs[i] - zs[i - 1]) * (zs[i] - zs[i - 1]));
+		}
+
+		// Samples every step meters plus the final vertex
+		if (cap < 3)
+			return "maxSamples must be at least 3 for polyline sampling";
+		if (totalLength / step + 2 > cap)
+			step = totalLength / (cap - 2);
+
+		float carry = 0; // distance into the current segment of the next sample
+		for (int s = 1; s < xs.Count(); s++)
+		{
+			float dx = xs[s] - xs[s - 1];
+			float dz = zs[s] - zs[s - 1];
+			float segLength = Math.Sqrt(dx * dx + dz * dz);
+			float t = carry;
+			while (t < segLength)
+			{
+				float px = xs[s - 1] + dx * (t / segLength);
+				float pz = zs[s - 1] + dz * (t / segLength);
+				resp.m_aPositions.Insert(px);
+				resp.m_aPositions.Insert(pz);
+				resp.m_aHeights.Insert(api.GetTerrainSurfaceY(px, pz));
+				t += step;
+			}
+			carry = t - segLength;
+		}
+
+		float lastX = xs[xs.Count() - 1];
+		float lastZ = zs[zs.Count() - 1];
+		resp.m_aPositions.Insert(lastX);
+		resp.m_aPositions.Insert(lastZ);
+		resp.m_aHeights.Insert(api.GetTerrainSurfaceY(lastX, lastZ));
+
+		resp.stepUsed = step;
+		return "";
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static string SamplePoints(WorldEditorAPI api, EMCP_WB_TerrainRequest req, int cap, EMCP_WB_TerrainResponse resp)
+	{
+		array<ref array<string>> rows = {};
+		EMCP_WB_Records.Parse(req.points, rows);
+		if (rows.Count() == 0)
+			return "points ('x\tz' records) are required for point sampling";
+		if (rows.Count() > cap)
+			return "Too many points: " + rows.Count().ToString() + " (maxSamples " + cap.ToString() + ")";
+
+		for (int i = 0; i < rows.Count(); i++)
+		{
+			float px = EMCP_WB_Records.Field(rows[i], 0).ToFloat();
+			float pz = EMCP_WB_Records.Field(rows[i], 1).ToFloat();
+			resp.m_aHeights.Insert(api.GetTerrainSurfaceY(px, pz));
+		}
+		return "";
+	}
+
+	//------------------------------------------------------------------------------------------------
 	override JsonApiStruct GetRequest()
 	{
 		return new EMCP_WB_TerrainRequest();
@@ -95,10 +303,48 @@ class EMCP_WB_Terrain : NetApiHandler
 				resp.message = "GetTerrainBounds returned false (no terrain loaded?)";
 			}
 		}
+		else if (req.action == "sample")
+		{
+			WorldEditorAPI sampleApi = worldEditor.GetApi();
+			if (!sampleApi)
+			{
+				resp.status = "error";
+				resp.message = "WorldEditorAPI not available";
+				return resp;
+			}
+
+			int cap = req.maxSamples;
+			if (cap <= 0)
+				cap = DEFAULT_MAX_SAMPLES;
+			if (cap > HARD_MAX_SAMPLES)
+				cap = HARD_MAX_SAMPLES;
+
+			resp.mode = req.mode;
+			string sampleErr;
+			if (req.mode == "grid")
+				sampleErr = SampleGrid(sampleApi, req, cap, resp);
+			else if (req.mode == "polyline")
+				sampleErr = SamplePolyline(sampleApi, req, cap, resp);
+			else if (req.mode == "points")
+				sampleErr = SamplePoints(sampleApi, req, cap, resp);
+			else
+				sampleErr = "Unknown sample mode: " + req.mode + ". Valid: grid, polyline, points";
+
+			if (sampleErr != "")
+			{
+				resp.status = "error";
+				resp.message = sampleErr;
+				return resp;
+			}
+
+			resp.sampleCount = resp.m_aHeights.Count();
+			resp.status = "ok";
+			resp.message = "Sampled " + resp.sampleCount.ToString() + " terrain heights";
+		}
 		else
 		{
 			resp.status = "error";
-			resp.message = "Unknown action: " + req.action + ". Valid: getHeight, getBounds";
+			resp.message = "Unknown action: " + req.action + ". Valid: getHeight, getBounds, sample";
 		}
 
 		return resp;
@@ -0,0 +1,174 @@
+/**
+ * Throughput benchmark for the Enfusion text lexer and parser.
+ *
+ * Compares the previous per-character tokenizer (string concatenation and a
+ * regex test per identifier character, kept here as the baseline) against
+ * the charCode lexer (tokenize), the event parser, the full parse() and a
+ * header-only read through parseLazy() over real files. Point it at .et, .ent, .layer, .conf or .gproj files, or at
+ * directories to scan recursively; with no arguments it benchmarks two
+ * synthetic 5000-entity layers, one with an escaped string in every entity and
+ * one without escapes (most real layers), since the lexer's string fast and
+ * slow paths differ.
+ *
+ * Usage:  tsx scripts/bench-enfusion-text.ts [file|dir ...] [--iterations N]
+ */
+
+import { readFileSync, readdirSync, statSync } from "node:fs";
+import { extname, join } from "node:path";
+import { parse, tokenize } from "../src/formats/enfusion-text.js";
+import { parseEvents } from "../src/formats/enfusion-events.js";
+import { parseLazy } from "../src/formats/enfusion-lazy.js";
+
+const EXTENSIONS = new Set([".et", ".ent", ".layer", ".conf", ".gproj"]);
+
+function collectFiles(path: string, out: string[]): void {
+  const st = statSync(path);
+  if (st.isDirectory()) {
+    for (const entry of readdirSync(path)) collectFiles(join(path, entry), out);
+  } else if (EXTENSIONS.has(extname(path).toLowerCase())) {
+    out.push(path);
+  }
+}
+
+function syntheticLayer(entities: number, escapes: boolean): string {
+  const lines: string[] = [];
+  for (let i = 0; i < entities; i++) {
+    lines.push(`GenericEntity Tree_${i} : "{5E2F0A1B2C3D4E5F}Prefabs/Vegetation/Tree_${i % 40}.et" {`);
+    lines.push(` ID "${(0x1000 + i).toString(16).toUpperCase().padStart(16, "0")}"`);
+    lines.push(` components {`);
+    lines.push(`  MeshObject "{A1B2C3D4E5F60718}" {`);
+    lines.push(`   Object "{0123456789ABCDEF}Assets/Trees/Tree_${i % 40}.xob"`);
+    lines.push(`  }`);
+    lines.push(`  SCR_DestructionComponent "{B2C3D4E5F6071829}" {`);
+    lines.push(
+      escapes ? `   m_sDescription "Tree \\"${i}\\" with an escaped\\tvalue"` : `   m_sDescription "Tree ${i} with a plain value"`
+    );
+    lines.push(`  }`);
+    lines.push(` }`);
+    lines.push(` coords ${i * 1.5} 12.25 ${i * -0.75}`);
+    lines.push(` angleY ${i % 360}`);
+    lines.push(`}`);
+  }
+  return `Layer {\n${lines.join("\n")}\n}\n`;
+}
+
+/** The tokenizer this lexer replaced, kept as the benchmark baseline. Returns the token count. */
+function legacyTokenize(input: string): number {
+  const tokens: { value: string; pos: number }[] = [];
+  let i = 0;
+  const len = input.length;
+  while (i < len) {
+    const ch = input[i];
+    if (ch === " " || ch === "\t" || ch === "\n" || ch === "\r") {
+      i++;
+      continue;
+    }
+    if (ch === "/" && i + 1 < len && input[i + 1] === "/") {
+      while (i < len && input[i] !== "\n") i++;
+      continue;
+    }
+    if (ch === '"') {
+      i++;
+      let str = "";
+      while (i < len && input[i] !== '"') {
+        if (input[i] === "\\" && i + 1 < len) {
+          const esc = input[i + 1];
+          str += esc === "n" ? "\n" : esc === "t" ? "\t" : esc === "r" ? "\r" : esc;
+          i += 2;
+        } else {
+          str += input[i];
+          i++;
+        }
+      }
+      if (i < len) i++;
+      tokens.push({ value: str, pos: i });
+      continue;
+    }
+    if (ch === "{" || ch === "}" || ch === ":") {
+      tokens.push({ value: ch, pos: i });
+      i++;
+      continue;
+    }
+    if (/[a-zA-Z0-9_.\-]/.test(ch)) {
+      const start = i;
+      while (i < len && /[a-zA-Z0-9_.\-]/.test(input[i])) i++;
+      tokens.push({ value: input.substring(start, i), pos: start });
+      continue;
+    }
+    i++;
+  }
+  return tokens.length;
+}
+
+function lexerTokenize(input: string): number {
+  return tokenize(input).length;
+}
+
+function measure(label: string, texts: string[], totalBytes: number, iterations: number, fn: (text: string) => unknown): number {
+  // Warm-up so the JIT sees every path before timing starts
+  for (const text of texts) fn(text);
+
+  const start = process.hrtime.bigint();
+  for (let n = 0; n < iterations; n++) {
+    for (const text of texts) fn(text);
+  }
+  const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+  const mbPerSec = (totalBytes * iterations) / (1024 * 1024) / seconds;
+  console.log(`  ${label.padEnd(22)} ${mbPerSec.toFixed(1).padStart(8)} MB/s  (${((seconds * 1000) / iterations).toFixed(1)} ms/pass)`);
+  return mbPerSec;
+}
+
+function main(): void {
+  const args = process.argv.slice(2);
+  let iterations = 20;
+  const paths: string[] = [];
+  for (let a = 0; a < args.length; a++) {
+    if (args[a] === "--iterations") iterations = Math.max(1, Number(args[++a]) || iterations);
+    else paths.push(args[a]);
+  }
+
+  const files: string[] = [];
+  for (const p of paths) collectFiles(p, files);
+
+  if (files.length === 0) {
+    run("synthetic 5000-entity layer, escape-free", [syntheticLayer(5000, false)], iterations);
+    console.log("");
+    run("synthetic 5000-entity layer, one escaped string per entity", [syntheticLayer(5000, true)], iterations);
+    console.log("\n(pass files or directories to benchmark real data)");
+    return;
+  }
+
+  const texts: string[] = [];
+  for (const f of files) {
+    const text = readFileSync(f, "utf-8");
+    try {
+      parse(text);
+      texts.push(text);
+    } catch {
+      // Skip files the parser rejects so every variant sees the same corpus
+    }
+  }
+  run(`${texts.length} of ${files.length} files parsed`, texts, iterations);
+}
+
+function run(corpus: string, texts: string[], iterations: number): void {
+  console.log(`Corpus: ${corpus}`);
+  const totalBytes = texts.reduce((sum, t) => sum + Buffer.byteLength(t, "utf-8"), 0);
+  console.log(`Size: ${(totalBytes / (1024 * 1024)).toFixed(2)} MB, ${iterations} iterations\n`);
+
+  const legacyTokens = texts.reduce((sum, t) => sum + legacyTokenize(t), 0);
+  const lexerTokens = texts.reduce((sum, t) => sum + lexerTokenize(t), 0);
+  if (legacyTokens !== lexerTokens) {
+    console.error(`Token count mismatch: legacy ${legacyTokens}, lexer ${lexerTokens}`);
+    process.exitCode = 1;
+  }
+
+  const legacy = measure("legacy tokenize", texts, totalBytes, iterations, legacyTokenize);
+  const lexer = measure("tokenize", texts, totalBytes, iterations, lexerTokenize);
+  measure("parseEvents (no tree)", texts, totalBytes, iterations, (text) => parseEvents(text, {}));
+  measure("parse()", texts, totalBytes, iterations, parse);
+  measure("parseLazy (root only)", texts, totalBytes, iterations, (text) => parseLazy(text).properties);
+  console.log(`\nLexer speedup: ${(lexer / legacy).toFixed(2)}x over ${lexerTokens} tokens per pass`);
+}
+
+main();
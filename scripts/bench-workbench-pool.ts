@@ -0,0 +1,91 @@
+/**
+ * Round-trip benchmark for Workbench NET API calls with and without the
+ * connection pool.
+ *
+ * Runs the same sequence of replay-safe EMCP_WB_Ping calls through a client
+ * that opens a socket per call and through one that takes pre-connected
+ * sockets from the pool. With no --port it starts a local mock NET API server
+ * that answers immediately, so the numbers isolate connect and framing cost;
+ * pass --port (and --host) to measure a running Workbench instead.
+ *
+ * Usage:  tsx scripts/bench-workbench-pool.ts [--calls N] [--pool N] [--host H] [--port P]
+ */
+
+import { createServer, type Server, type Socket } from "node:net";
+import { WorkbenchClient } from "../src/workbench/client.js";
+import { encodePascalString } from "../src/workbench/protocol.js";
+import type { Config } from "../src/config.js";
+
+/** Mock NET API server: answers every request with an empty Ok, ignores pooled sockets closed unused. */
+function startMock(): Promise<{ server: Server; port: number; sockets: Set<Socket> }> {
+  const sockets = new Set<Socket>();
+  const server = createServer((socket) => {
+    sockets.add(socket);
+    socket.on("error", () => {});
+    socket.on("close", () => sockets.delete(socket));
+    let received = 0;
+    socket.on("data", (chunk) => (received += chunk.length));
+    socket.on("end", () => {
+      if (received === 0) return;
+      socket.end(Buffer.concat([encodePascalString("Ok"), encodePascalString('{"status":"ok"}')]));
+    });
+  });
+  return new Promise((resolve) => {
+    server.listen(0, "127.0.0.1", () => {
+      const addr = server.address();
+      resolve({ server, port: addr && typeof addr !== "string" ? addr.port : 0, sockets });
+    });
+  });
+}
+
+async function measure(label: string, client: WorkbenchClient, calls: number): Promise<number> {
+  // Warm-up so the pool is full and the JIT has seen the call path
+  for (let i = 0; i < 20; i++) await client.call("EMCP_WB_Ping", {}, { skipAutoLaunch: true, replaySafe: true });
+  await new Promise((r) => setTimeout(r, 50));
+
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < calls; i++) {
+    await client.call("EMCP_WB_Ping", {}, { skipAutoLaunch: true, replaySafe: true });
+  }
+  const usPerCall = Number(process.hrtime.bigint() - start) / 1e3 / calls;
+  console.log(`  ${label.padEnd(18)} ${usPerCall.toFixed(1).padStart(8)} us/call`);
+  return usPerCall;
+}
+
+async function main(): Promise<void> {
+  const args = process.argv.slice(2);
+  let calls = 2000;
+  let poolSize = 2;
+  let host = "127.0.0.1";
+  let port = 0;
+  for (let a = 0; a < args.length; a++) {
+    if (args[a] === "--calls") calls = Math.max(1, Number(args[++a]) || calls);
+    else if (args[a] === "--pool") poolSize = Math.max(1, Number(args[++a]) || poolSize);
+    else if (args[a] === "--host") host = args[++a];
+    else if (args[a] === "--port") port = Number(args[++a]) || 0;
+  }
+
+  const mock = port === 0 ? await startMock() : null;
+  if (mock) port = mock.port;
+  console.log(`Target: ${mock ? "local mock server" : "Workbench"} at ${host}:${port}, ${calls} calls\n`);
+
+  const perCall = new WorkbenchClient(host, port, { workbenchPoolSize: 0 } as unknown as Config);
+  const pooled = new WorkbenchClient(host, port, { workbenchPoolSize: poolSize } as unknown as Config);
+  try {
+    const single = await measure("per-call socket", perCall, calls);
+    const fromPool = await measure(`pool of ${poolSize}`, pooled, calls);
+    console.log(`\nPool speedup: ${(single / fromPool).toFixed(2)}x`);
+  } finally {
+    perCall.close();
+    pooled.close();
+    if (mock) {
+      for (const s of mock.sockets) s.destroy();
+      mock.server.close();
+    }
+  }
+}
+
+main().catch((err) => {
+  console.error(err);
+  process.exitCode = 1;
+});
@@ -23,6 +23,10 @@ export interface Config {
   workbenchHost: string;
   /** Workbench NET API port (default 5775) */
   workbenchPort: number;
+  /** Number of pre-connected NET API sockets to keep warm (default 0 = connect per call).
+   *  The NET API closes every connection after one response, so this only saves the
+   *  connect round trip. Set via ENFUSION_WORKBENCH_POOL_SIZE env var. */
+  workbenchPoolSize?: number;
   /** Default addon folder name used when modName is not specified in tool calls.
    *  Automatically set at runtime when wb_launch opens a .gproj file.
    *  Can also be set via ENFUSION_DEFAULT_MOD env var as a static fallback. */
@@ -109,6 +113,12 @@ export function loadConfig(): Config {
       config.workbenchPort = port;
     }
   }
+  if (process.env.ENFUSION_WORKBENCH_POOL_SIZE) {
+    const poolSize = parseInt(process.env.ENFUSION_WORKBENCH_POOL_SIZE, 10);
+    if (!isNaN(poolSize) && poolSize >= 0 && poolSize <= 16) {
+      config.workbenchPoolSize = poolSize;
+    }
+  }
   if (process.env.ENFUSION_DEFAULT_MOD) {
     config.defaultMod = process.env.ENFUSION_DEFAULT_MOD;
   }
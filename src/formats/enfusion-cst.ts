@@ -0,0 +1,359 @@
+/**
+ * Lossless concrete syntax tree for Enfusion text files.
+ *
+ * serialize() regenerates a file from the EnfusionNode model, which drops
+ * comments and formatting and rewrites every line. EnfusionDocument keeps the
+ * original text plus the source span of every node, property and value, and
+ * records edits as splices against that text: an edit costs O(edit size),
+ * toString() reproduces the file byte for byte outside the edited ranges, and
+ * version-control diffs show only the lines that changed.
+ *
+ * Spans are character offsets into the original source and stay valid while
+ * edits are pending; node and property objects reflect the edited values.
+ */
+
+import { EnfusionEventParser, type EnfusionEventHandler, type NodeEndEvent, type NodeStartEvent, type PropertyEvent, type ValueEvent } from "./enfusion-events.js";
+import { escapeString, formatValue } from "./enfusion-text.js";
+
+export interface CstProperty {
+  key: string;
+  value: string;
+  /** Offset of the key; -1 for a property added by an edit. */
+  start: number;
+  valueStart: number;
+  end: number;
+}
+
+export interface CstValue {
+  value: string;
+  start: number;
+  end: number;
+}
+
+export interface CstNode {
+  /** Type name ("" for anonymous blocks and the document node). */
+  type: string;
+  id?: string;
+  className?: string;
+  inheritance?: string;
+  /** Offset of the type name (of "{" for an anonymous block). */
+  start: number;
+  /** Offsets of ":" and just past the parent reference, when inheritance is set in the source. */
+  inheritanceStart?: number;
+  inheritanceEnd?: number;
+  /** Offset just past "{". */
+  bodyStart: number;
+  /** Offset of the closing "}" (the end of the source for the document node). */
+  closeStart: number;
+  properties: CstProperty[];
+  values: CstValue[];
+  children: CstNode[];
+  parent: CstNode | null;
+}
+
+/** Replace source[start, end) with text. Insertions have start === end. */
+export interface Splice {
+  start: number;
+  end: number;
+  text: string;
+}
+
+class CstBuilder implements EnfusionEventHandler {
+  private readonly stack: CstNode[];
+
+  constructor(top: CstNode) {
+    this.stack = [top];
+  }
+
+  onNodeStart(event: NodeStartEvent): void {
+    const parent = this.stack[this.stack.length - 1];
+    const node: CstNode = {
+      type: event.type,
+      start: event.pos,
+      bodyStart: event.bodyStart,
+      closeStart: -1,
+      properties: [],
+      values: [],
+      children: [],
+      parent,
+    };
+    if (event.id !== undefined) node.id = event.id;
+    if (event.className !== undefined) node.className = event.className;
+    if (event.inheritance !== undefined) {
+      node.inheritance = event.inheritance;
+      node.inheritanceStart = event.inheritanceStart;
+      node.inheritanceEnd = event.inheritanceEnd;
+    }
+    parent.children.push(node);
+    this.stack.push(node);
+  }
+
+  onProperty(event: PropertyEvent): void {
+    this.stack[this.stack.length - 1].properties.push({
+      key: event.key,
+      value: event.value,
+      start: event.pos,
+      valueStart: event.valueStart,
+      end: event.end,
+    });
+  }
+
+  onValue(event: ValueEvent): void {
+    this.stack[this.stack.length - 1].values.push({ value: event.value, start: event.pos, end: event.end });
+  }
+
+  onNodeEnd(event: NodeEndEvent): void {
+    this.stack.pop()!.closeStart = event.pos;
+  }
+}
+
+/** Only whitespace (and an optional // comment) — what may follow an item on its line. */
+const REST_OF_LINE_BLANK = /^[ \t]*(\/\/[^\n]*)?\r?$/;
+
+export class EnfusionDocument {
+  readonly source: string;
+  /** Synthetic node holding the top-level items; its body is the whole file. */
+  readonly top: CstNode;
+  private readonly eol: string;
+
+  /** Pending edits in creation order (insertions at the same offset apply in this order). */
+  private splices: Splice[] = [];
+  /** The splice currently editing a property's value, a node's parent reference, or an added property. */
+  private readonly owned = new Map<object, Splice>();
+
+  private constructor(source: string) {
+    this.source = source;
+    this.eol = source.includes("\r\n") ? "\r\n" : "\n";
+    this.top = {
+      type: "",
+      start: 0,
+      bodyStart: 0,
+      closeStart: source.length,
+      properties: [],
+      values: [],
+      children: [],
+      parent: null,
+    };
+  }
+
+  /** Parse a document (a single root node or a .layer-style sequence of nodes). */
+  static parse(source: string): EnfusionDocument {
+    const doc = new EnfusionDocument(source);
+    new EnfusionEventParser(new CstBuilder(doc.top)).end(source);
+    return doc;
+  }
+
+  /** First top-level node (what parse() returns as the root). */
+  get root(): CstNode | undefined {
+    return this.top.children[0];
+  }
+
+  get changed(): boolean {
+    return this.splices.length > 0;
+  }
+
+  /** Pending edits sorted by offset; at one offset, insertions (in creation order) come first. */
+  get edits(): Splice[] {
+    return [...this.splices].sort((a, b) => a.start - b.start || (a.end - a.start) - (b.end - b.start));
+  }
+
+  /** First child node with the given type (e.g. "components"). */
+  findChild(node: CstNode, type: string): CstNode | undefined {
+    return node.children.find((c) => c.type === type);
+  }
+
+  getProperty(node: CstNode, key: string): string | undefined {
+    return node.properties.find((p) => p.key === key)?.value;
+  }
+
+  /**
+   * Set a property value. An existing property has just its value replaced;
+   * a new one is added on its own line after the node's last property.
+   */
+  setProperty(node: CstNode, key: string, value: string): void {
+    const existing = node.properties.find((p) => p.key === key);
+
+    if (existing) {
+      // Keep a value quoted if it was quoted in the source (e.g. an all-digit ID)
+      const quoted = existing.start >= 0 && this.source[existing.valueStart] === '"';
+      const text = quoted ? `"${escapeString(value)}"` : formatValue(value);
+      const added = this.owned.get(existing);
+      if (existing.start < 0 && added) {
+        added.text = `${this.eol}${this.itemIndent(node)}${key} ${text}`;
+      } else if (added) {
+        added.text = text;
+      } else {
+        this.owned.set(existing, this.addSplice(existing.valueStart, existing.end, text));
+      }
+      existing.value = value;
+      return;
+    }
+
+    const text = formatValue(value);
+    const sourceProps = node.properties.filter((p) => p.start >= 0);
+    const last = sourceProps[sourceProps.length - 1];
+    const at = this.afterItem(last ? last.end : node.bodyStart);
+    const splice = this.addSplice(at, at, `${this.eol}${this.itemIndent(node)}${key} ${text}`);
+    const prop: CstProperty = { key, value, start: -1, valueStart: -1, end: -1 };
+    node.properties.push(prop);
+    this.owned.set(prop, splice);
+  }
+
+  /** Remove a property (its whole line when it stands alone). Returns false if it is not set. */
+  removeProperty(node: CstNode, key: string): boolean {
+    const index = node.properties.findIndex((p) => p.key === key);
+    if (index === -1) return false;
+    const prop = node.properties[index];
+
+    // Splice first: if it is refused, the model must still match the pending edits
+    if (prop.start >= 0) {
+      const [start, end] = this.lineSpan(prop.start, prop.end);
+      this.addSplice(start, end, "");
+    }
+    const pending = this.owned.get(prop);
+    if (pending) this.dropSplice(pending);
+    this.owned.delete(prop);
+    node.properties.splice(index, 1);
+    return true;
+  }
+
+  /** Set, replace or (with undefined) remove a node's ": "parent"" reference. */
+  setInheritance(node: CstNode, parent: string | undefined): void {
+    if (node === this.top || node.type === "") throw new Error("Anonymous blocks have no parent reference");
+    const text = parent === undefined ? "" : ` : "${escapeString(parent)}"`;
+
+    const pending = this.owned.get(node);
+    if (pending) {
+      pending.text = text;
+    } else if (node.inheritanceStart !== undefined && node.inheritanceEnd !== undefined) {
+      // Replace from the end of the preceding token so " : " spacing is normalized
+      let start = node.inheritanceStart;
+      while (start > node.start && /[ \t]/.test(this.source[start - 1])) start--;
+      this.owned.set(node, this.addSplice(start, node.inheritanceEnd, text));
+    } else {
+      let at = node.bodyStart - 1; // the "{"
+      while (at > node.start && /\s/.test(this.source[at - 1])) at--;
+      this.owned.set(node, this.addSplice(at, at, text));
+    }
+
+    if (parent === undefined) delete node.inheritance;
+    else node.inheritance = parent;
+  }
+
+  /**
+   * Insert raw text (one or more already-indented lines, e.g. a serialized
+   * child node) at the start or end of a node's body.
+   */
+  insertText(node: CstNode, text: string, where: "start" | "end" = "end"): void {
+    if (where === "start") {
+      const at = this.afterItem(node.bodyStart);
+      this.addSplice(at, at, `${this.eol}${text}`);
+      return;
+    }
+
+    const lineStart = this.source.lastIndexOf("\n", node.closeStart - 1) + 1;
+    if (/^[ \t]*$/.test(this.source.slice(lineStart, node.closeStart))) {
+      // "}" alone on its line (or a document ending in a newline): insert whole lines before it
+      this.addSplice(lineStart, lineStart, `${text}${this.eol}`);
+    } else {
+      this.addSplice(node.closeStart, node.closeStart, `${this.eol}${text}${this.eol}`);
+    }
+  }
+
+  /** Remove a node (its whole lines when it stands alone). */
+  removeNode(node: CstNode): void {
+    const parent = node.parent;
+    if (!parent) throw new Error("Cannot remove the document node");
+    const [start, end] = this.lineSpan(node.start, node.closeStart + 1);
+    this.addSplice(start, end, "");
+    const index = parent.children.indexOf(node);
+    if (index !== -1) parent.children.splice(index, 1);
+  }
+
+  /** The document with all pending edits applied. */
+  toString(): string {
+    if (this.splices.length === 0) return this.source;
+    const parts: string[] = [];
+    let at = 0;
+    for (const splice of this.edits) {
+      parts.push(this.source.slice(at, splice.start), splice.text);
+      at = splice.end;
+    }
+    parts.push(this.source.slice(at));
+    return parts.join("");
+  }
+
+  // ── Internals ────────────────────────────────────────────────────────────
+
+  /**
+   * Record a splice. A deletion swallows pending edits inside its range;
+   * partial overlaps are refused since the result would be ambiguous, and so
+   * is an insertion strictly inside a pending deletion or replacement, which
+   * toString() would otherwise drop silently.
+   */
+  private addSplice(start: number, end: number, text: string): Splice {
+    if (end === start) {
+      for (const other of this.splices) {
+        if (other.start < start && start < other.end) {
+          throw new Error(`Insertion at ${start} falls inside a pending edit at ${other.start}-${other.end}`);
+        }
+      }
+    } else {
+      for (const other of [...this.splices]) {
+        if (other.start >= start && other.end <= end) {
+          // Insertions exactly at either edge survive; everything else inside is replaced
+          if (other.start === other.end && (other.start === start || other.start === end)) continue;
+          this.dropSplice(other);
+        } else if (other.start < end && other.end > start) {
+          throw new Error(`Edit at ${start}-${end} overlaps a pending edit at ${other.start}-${other.end}`);
+        }
+      }
+    }
+    const splice: Splice = { start, end, text };
+    this.splices.push(splice);
+    return splice;
+  }
+
+  private dropSplice(splice: Splice): void {
+    this.splices = this.splices.filter((s) => s !== splice);
+    for (const [key, owned] of this.owned) if (owned === splice) this.owned.delete(key);
+  }
+
+  /** Insertion point after an item ending at offset: the end of its line if nothing but a comment follows. */
+  private afterItem(offset: number): number {
+    const nl = this.source.indexOf("\n", offset);
+    const lineEnd = nl === -1 ? this.source.length : nl;
+    if (!REST_OF_LINE_BLANK.test(this.source.slice(offset, lineEnd))) return offset;
+    return lineEnd > offset && this.source[lineEnd - 1] === "\r" ? lineEnd - 1 : lineEnd;
+  }
+
+  /** [start, end) widened to whole lines when the span stands alone on them. */
+  private lineSpan(start: number, end: number): [number, number] {
+    const lineStart = this.source.lastIndexOf("\n", start - 1) + 1;
+    const nl = this.source.indexOf("\n", end);
+    const lineEnd = nl === -1 ? this.source.length : nl;
+    const before = this.source.slice(lineStart, start);
+    if (/^[ \t]*$/.test(before) && REST_OF_LINE_BLANK.test(this.source.slice(end, lineEnd))) {
+      return [lineStart, nl === -1 ? lineEnd : nl + 1];
+    }
+    return [start, end];
+  }
+
+  /** Indentation for a new item in node: that of its first existing item, else one space deeper than the node. */
+  private itemIndent(node: CstNode): string {
+    const first = [
+      ...node.properties.filter((p) => p.start >= 0).map((p) => p.start),
+      ...node.values.map((v) => v.start),
+      ...node.children.map((c) => c.start),
+    ].sort((a, b) => a - b)[0];
+    if (first !== undefined) {
+      const lineStart = this.source.lastIndexOf("\n", first - 1) + 1;
+      const indent = this.source.slice(lineStart, first);
+      if (/^[ \t]*$/.test(indent)) return indent;
+    }
+    if (node === this.top) return "";
+    const lineStart = this.source.lastIndexOf("\n", node.start - 1) + 1;
+    const nodeIndent = /^[ \t]*/.exec(this.source.slice(lineStart, node.start))![0];
+    return `${nodeIndent} `;
+  }
+}
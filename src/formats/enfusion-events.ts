@@ -0,0 +1,646 @@
+/**
+ * Streaming (SAX-style) parser for the Enfusion text format.
+ *
+ * Reports nodes, properties and values as they are read instead of building
+ * an EnfusionNode tree, so world .layer files with tens of thousands of
+ * entities can be scanned from a file or pak stream in bounded memory: only
+ * the unlexed tail of the current chunk, a few lookahead tokens and the stack
+ * of open node types are held at any time.
+ *
+ * This is the grammar parse() uses too (it builds its tree from these
+ * events). parse() reads a single root node; by default the event parser
+ * reads a sequence of top-level items, which is what .layer files contain:
+ *
+ *   Document  = Content*                       (singleRoot: Node)
+ *   Node      = TypeName [BareId | [Class] GUID] [":" QuotedString] "{" Content* "}"
+ *             | "{" Content* "}"               (anonymous block, e.g. child entities)
+ *   Content   = Property | BareValue | Node
+ *   Property  = Key (QuotedString | BareWord Number*)
+ */
+
+import { EnfusionLexer, TokenType, findBlockEnd, type Token } from "./enfusion-lexer.js";
+
+export interface NodeStartEvent {
+  /** Type name ("" for an anonymous block). */
+  type: string;
+  /** Bare-word name or quoted GUID after the type name. */
+  id?: string;
+  /** Class qualifier between the type name and the GUID. */
+  className?: string;
+  /** Parent reference after ":". */
+  inheritance?: string;
+  /** Number of enclosing nodes (0 for a top-level node). */
+  depth: number;
+  /** Character offset of the type name (or of "{" for an anonymous block). */
+  pos: number;
+  /** Offsets of ":" and just past the quoted parent reference, when inheritance is set. */
+  inheritanceStart?: number;
+  inheritanceEnd?: number;
+  /** Offset just past the opening "{". */
+  bodyStart: number;
+}
+
+export interface NodeEndEvent {
+  type: string;
+  depth: number;
+  /** Character offset of the closing "}". */
+  pos: number;
+}
+
+export interface PropertyEvent {
+  key: string;
+  /** Unescaped string, bare word, or space-joined numbers ("1 2 3" for a vector). */
+  value: string;
+  /** Number of enclosing nodes. */
+  depth: number;
+  /** Character offset of the key. */
+  pos: number;
+  /** Offset of the value's first token and just past its last one. */
+  valueStart: number;
+  end: number;
+}
+
+export interface ValueEvent {
+  value: string;
+  depth: number;
+  pos: number;
+  end: number;
+}
+
+export interface EnfusionEventHandler {
+  /**
+   * Return false to skip the node's contents: no events are reported for
+   * anything inside it, only its onNodeEnd. When the closing "}" is already in
+   * the buffered text the body is brace-scanned instead of lexed.
+   */
+  onNodeStart?(event: NodeStartEvent): void | boolean;
+  onProperty?(event: PropertyEvent): void;
+  onValue?(event: ValueEvent): void;
+  onNodeEnd?(event: NodeEndEvent): void;
+}
+
+export interface EnfusionEventParserOptions {
+  /** Read one root node and ignore anything after it (parse() semantics). */
+  singleRoot?: boolean;
+  /** Document offset of the first character written, for parsing a slice of a larger text. */
+  offset?: number;
+}
+
+/** Any chunk source: fs.createReadStream(), PakVirtualFS.createReadStream(), or an async generator. */
+export type EnfusionTextSource = AsyncIterable<string | Uint8Array>;
+
+/** Most tokens one grammar decision looks at: Type BareId "GUID" ":" "Parent" "{". */
+const LOOKAHEAD = 6;
+
+/** Consumed tokens kept before the queue is compacted. */
+const QUEUE_TRIM = 1024;
+
+/** Handler in effect inside a skipped node that could not be brace-scanned. */
+const NO_EVENTS: EnfusionEventHandler = {};
+
+/** A bare word that continues a numeric value (the 2nd and 3rd parts of "coords 1 2 3"). */
+function isNumberWord(tok: Token | undefined): boolean {
+  if (!tok || tok.type !== TokenType.Identifier) return false;
+  const code = tok.value.charCodeAt(tok.value[0] === "-" ? 1 : 0);
+  return (code >= 48 && code <= 57) || code === 46; // 0-9 or "."
+}
+
+function propertyEvent(keyTok: Token, valueTok: Token, depth: number): PropertyEvent {
+  return {
+    key: keyTok.value,
+    value: valueTok.value,
+    depth,
+    pos: keyTok.pos,
+    valueStart: valueTok.pos,
+    end: valueTok.end,
+  };
+}
+
+/**
+ * Push parser: feed text with write() as it arrives and finish with end().
+ * Tokens split across chunk boundaries are carried over, so chunks can be cut
+ * anywhere. Errors are thrown from write()/end() with the same messages as
+ * parse().
+ */
+export class EnfusionEventParser {
+  private readonly userHandler: EnfusionEventHandler;
+  /** userHandler, or NO_EVENTS while inside a skipped node. */
+  private handler: EnfusionEventHandler;
+  private readonly singleRoot: boolean;
+
+  /** Text not yet lexed into complete tokens; text[0] is at document offset textBase. */
+  private text = "";
+  private textBase = 0;
+  private lexer = new EnfusionLexer("");
+  /** Offset in text just past the last complete token. */
+  private safeOffset = 0;
+  private final = false;
+
+  private queue: Token[] = [];
+  private head = 0;
+
+  /** Types of the open nodes, innermost last. */
+  private readonly open: string[] = [];
+  /** The next token starts a node header (decided by the previous step). */
+  private headerNext: boolean;
+  /** `Key Number` waiting to see whether more numbers follow. */
+  private pendingProperty: PropertyEvent | null = null;
+  /** Depth (open.length) of the skipped node being parsed silently; 0 if none. */
+  private skipDepth = 0;
+  private sawRoot = false;
+  private done = false;
+
+  constructor(handler: EnfusionEventHandler, options: EnfusionEventParserOptions = {}) {
+    this.userHandler = handler;
+    this.handler = handler;
+    this.singleRoot = options.singleRoot ?? false;
+    this.headerNext = this.singleRoot;
+    this.textBase = options.offset ?? 0;
+  }
+
+  /** True once a singleRoot document's root node has closed or stop() was called; further input is ignored. */
+  get finished(): boolean {
+    return this.done;
+  }
+
+  /**
+   * Stop reading: no further events are reported and end() skips its EOF
+   * checks. For handlers that have what they need before the document ends.
+   */
+  stop(): void {
+    this.done = true;
+  }
+
+  write(chunk: string): void {
+    if (this.final) throw new Error("write() after end()");
+    this.feed(chunk);
+  }
+
+  /** Feed the last chunk (if any) and finish the document. */
+  end(chunk = ""): void {
+    if (this.final) return;
+    this.final = true;
+    this.feed(chunk);
+    if (this.done) return;
+
+    this.flushPendingProperty();
+    if (this.open.length > 0) throw new Error("Unexpected EOF, expected '}'");
+    if (this.singleRoot && !this.sawRoot) throw new Error("Empty input");
+  }
+
+  private feed(chunk: string): void {
+    if (this.done) return;
+    this.text = this.text.slice(this.safeOffset) + chunk;
+    this.textBase += this.safeOffset;
+    this.safeOffset = 0;
+    this.lexer = new EnfusionLexer(this.text);
+    this.run();
+  }
+
+  private run(): void {
+    while (!this.done) {
+      if (!this.fill(LOOKAHEAD) && !this.final) return;
+      if (this.head >= this.queue.length) return;
+      this.step();
+    }
+  }
+
+  /** Make n tokens available; false if the input so far has fewer complete tokens. */
+  private fill(n: number): boolean {
+    while (this.queue.length - this.head < n) {
+      const tok = this.lexer.next();
+      // A token touching the end of the text may continue in the next chunk
+      if (!tok || (!this.final && this.lexer.offset >= this.text.length)) return false;
+      this.safeOffset = this.lexer.offset;
+      tok.pos += this.textBase;
+      tok.end += this.textBase;
+      this.queue.push(tok);
+    }
+    return true;
+  }
+
+  private peek(k: number): Token | undefined {
+    return this.queue[this.head + k];
+  }
+
+  private expect(type: TokenType): Token {
+    const tok = this.queue[this.head++];
+    if (!tok || tok.type !== type) {
+      const got = tok ? `${TokenType[tok.type]}("${tok.value}") at pos ${tok.pos}` : "EOF";
+      throw new Error(`Expected ${TokenType[type]} but got ${got}`);
+    }
+    return tok;
+  }
+
+  private step(): void {
+    if (this.head >= QUEUE_TRIM) {
+      this.queue = this.queue.slice(this.head);
+      this.head = 0;
+    }
+
+    if (this.headerNext) {
+      this.headerNext = false;
+      this.readHeader();
+      return;
+    }
+
+    const tok = this.queue[this.head];
+    if (this.pendingProperty) {
+      if (isNumberWord(tok)) {
+        this.pendingProperty.value += ` ${tok.value}`;
+        this.pendingProperty.end = tok.end;
+        this.head++;
+        return;
+      }
+      this.flushPendingProperty();
+    }
+
+    const depth = this.open.length;
+    switch (tok.type) {
+      case TokenType.CloseBrace:
+        this.head++;
+        if (depth > 0) {
+          const type = this.open.pop()!;
+          if (depth === this.skipDepth) {
+            this.skipDepth = 0;
+            this.handler = this.userHandler;
+          }
+          this.closeNode(type, depth - 1, tok.pos);
+        }
+        // A stray "}" between top-level items is skipped
+        return;
+
+      case TokenType.Identifier:
+        this.readIdentifierItem(tok, depth);
+        return;
+
+      case TokenType.String: {
+        // Quoted type name node (rare but possible), else a standalone value (e.g. dependency GUIDs)
+        if (this.peek(1)?.type === TokenType.OpenBrace) {
+          this.headerNext = true;
+          return;
+        }
+        this.head++;
+        this.handler.onValue?.({ value: tok.value, depth, pos: tok.pos, end: tok.end });
+        return;
+      }
+
+      case TokenType.OpenBrace:
+        // Anonymous block, e.g. the child entity list inside a layer entity
+        this.head++;
+        this.openNode({ type: "", depth, pos: tok.pos, bodyStart: tok.end });
+        return;
+
+      default:
+        // Skip unexpected tokens
+        this.head++;
+    }
+  }
+
+  /**
+   * Content starting with a bare word:
+   *   Key "value" | Key BareValue [Number...] | TypeName ... "{" (child node)
+   */
+  private readIdentifierItem(identTok: Token, depth: number): void {
+    const after = this.peek(1);
+
+    if (!after || after.type === TokenType.CloseBrace) {
+      // Bare identifier at end of block — treat as a value
+      this.head++;
+      this.handler.onValue?.({ value: identTok.value, depth, pos: identTok.pos, end: identTok.end });
+      return;
+    }
+
+    if (after.type === TokenType.OpenBrace || after.type === TokenType.Colon) {
+      // TypeName { ... }  or  TypeName : "parent" { ... }
+      this.headerNext = true;
+      return;
+    }
+
+    if (after.type === TokenType.String) {
+      const afterStr = this.peek(2);
+      if (afterStr && (afterStr.type === TokenType.OpenBrace || afterStr.type === TokenType.Colon)) {
+        // TypeName "guid" [: "parent"] { ... }
+        this.headerNext = true;
+        return;
+      }
+      this.head += 2;
+      this.handler.onProperty?.(propertyEvent(identTok, after, depth));
+      return;
+    }
+
+    // Two bare words
+    const afterIdent2 = this.peek(2);
+    if (afterIdent2 && (afterIdent2.type === TokenType.OpenBrace || afterIdent2.type === TokenType.Colon)) {
+      // TypeName Name { ... }  or  TypeName Name : "parent" { ... }
+      this.headerNext = true;
+      return;
+    }
+    if (afterIdent2 && afterIdent2.type === TokenType.String) {
+      if (this.peek(3)?.type === TokenType.OpenBrace) {
+        // TypeName Class "guid" { ... }
+        this.headerNext = true;
+        return;
+      }
+      // Ident Ident "string" without brace: first ident is the key, the second starts the next item
+      this.head++;
+      this.handler.onProperty?.(propertyEvent(identTok, after, depth));
+      return;
+    }
+
+    // Key BareValue — numbers may continue as a vector
+    this.head += 2;
+    const event = propertyEvent(identTok, after, depth);
+    if (isNumberWord(after)) this.pendingProperty = event;
+    else this.handler.onProperty?.(event);
+  }
+
+  /** TypeName [BareId | [Class] "GUID"] [":" "Parent"] "{" */
+  private readHeader(): void {
+    const typeTok = this.queue[this.head++];
+    if (!typeTok || (typeTok.type !== TokenType.Identifier && typeTok.type !== TokenType.String)) {
+      const got = typeTok ? `${TokenType[typeTok.type]}("${typeTok.value}")` : "EOF";
+      throw new Error(`Expected type name but got ${got}`);
+    }
+
+    const event: NodeStartEvent = { type: typeTok.value, depth: this.open.length, pos: typeTok.pos, bodyStart: 0 };
+
+    // Optional bare word after the type name (e.g. "GameProjectConfig PC" or a class qualifier)
+    const bare = this.peek(0);
+    if (bare && bare.type === TokenType.Identifier) {
+      const afterBare = this.peek(1);
+      if (afterBare && (afterBare.type === TokenType.OpenBrace || afterBare.type === TokenType.Colon)) {
+        event.id = bare.value;
+        this.head++;
+      } else if (afterBare && afterBare.type === TokenType.String) {
+        const afterStr = this.peek(2);
+        if (afterStr && (afterStr.type === TokenType.OpenBrace || afterStr.type === TokenType.Colon)) {
+          // Type Class "GUID" {
+          event.className = bare.value;
+          event.id = afterBare.value;
+          this.head += 2;
+        } else {
+          event.id = bare.value;
+          this.head++;
+        }
+      }
+    }
+
+    // Optional quoted GUID (when no bare word was consumed)
+    if (event.id === undefined) {
+      const guid = this.peek(0);
+      const afterGuid = this.peek(1);
+      if (
+        guid && guid.type === TokenType.String &&
+        afterGuid && (afterGuid.type === TokenType.OpenBrace || afterGuid.type === TokenType.Colon)
+      ) {
+        event.id = guid.value;
+        this.head++;
+      }
+    }
+
+    // Optional inheritance: ":" QuotedString
+    const colon = this.peek(0);
+    if (colon?.type === TokenType.Colon) {
+      this.head++;
+      const parentTok = this.expect(TokenType.String);
+      event.inheritance = parentTok.value;
+      event.inheritanceStart = colon.pos;
+      event.inheritanceEnd = parentTok.end;
+    }
+
+    event.bodyStart = this.expect(TokenType.OpenBrace).end;
+    this.openNode(event);
+  }
+
+  private openNode(event: NodeStartEvent): void {
+    this.sawRoot = true;
+    this.open.push(event.type);
+    if (this.handler.onNodeStart?.(event) === false) this.skipNode(event);
+  }
+
+  private closeNode(type: string, depth: number, pos: number): void {
+    this.handler.onNodeEnd?.({ type, depth, pos });
+    if (this.singleRoot && depth === 0) this.done = true;
+  }
+
+  /**
+   * Jump past the body of a node the handler declined. If its closing "}" is
+   * not in the buffered text yet (a stream, or unbalanced input), fall back to
+   * parsing it with events muted so errors and chunking behave as usual.
+   */
+  private skipNode(event: NodeStartEvent): void {
+    const close = findBlockEnd(this.text, event.bodyStart - this.textBase);
+    if (close === -1) {
+      this.skipDepth = this.open.length;
+      this.handler = NO_EVENTS;
+      return;
+    }
+
+    // Tokens already queued for lookahead lie inside the skipped body
+    this.queue = [];
+    this.head = 0;
+    this.safeOffset = close + 1;
+    this.lexer = new EnfusionLexer(this.text, close + 1);
+    this.open.pop();
+    this.closeNode(event.type, event.depth, this.textBase + close);
+  }
+
+  private flushPendingProperty(): void {
+    const pending = this.pendingProperty;
+    if (!pending) return;
+    this.pendingProperty = null;
+    this.handler.onProperty?.(pending);
+  }
+}
+
+/** Run the event parser over a complete document. */
+export function parseEvents(
+  input: string,
+  handler: EnfusionEventHandler,
+  options: EnfusionEventParserOptions = {}
+): void {
+  new EnfusionEventParser(handler, options).end(input);
+}
+
+/**
+ * Run the event parser over a stream. Byte chunks are decoded as UTF-8 across
+ * chunk boundaries. With singleRoot, reading stops once the root node closes.
+ */
+export async function parseEventStream(
+  source: EnfusionTextSource,
+  handler: EnfusionEventHandler,
+  options: EnfusionEventParserOptions = {}
+): Promise<void> {
+  const parser = new EnfusionEventParser(handler, options);
+  const decoder = new TextDecoder("utf-8");
+  for await (const chunk of source) {
+    parser.write(typeof chunk === "string" ? chunk : decoder.decode(chunk, { stream: true }));
+    if (parser.finished) break;
+  }
+  parser.end(decoder.decode());
+}
+
+// ---------------------------------------------------------------------------
+// Layer scanning helpers
+// ---------------------------------------------------------------------------
+
+export interface LayerEntity {
+  className: string;
+  /** Instance name; "" for unnamed entities. */
+  name: string;
+  /** Prefab the entity instantiates ("" if none). */
+  prefab: string;
+  /** ID property, if set. */
+  id?: string;
+  /** coords property ('x y z'), if set. */
+  coords?: string;
+  /** Name (or class, if unnamed) of the entity this one is nested under. */
+  parent?: string;
+  /** Character offset of the entity's header. */
+  pos: number;
+}
+
+interface LayerFrame {
+  kind: "entity" | "group" | "children" | "other";
+  entity?: LayerEntity;
+  /** $grp header: id is the member class, inheritance the shared prefab. */
+  group?: NodeStartEvent;
+  /** Entity whose child list (or nested $grp) this frame is in. */
+  owner?: LayerEntity;
+}
+
+/**
+ * List the entities in a .layer/.ent stream without building a tree. Covers
+ * top-level entities (`Class [Name] : "prefab" { }`), $grp batches (one class
+ * and prefab shared by named or anonymous members) and child entities nested
+ * in an entity's anonymous `{ }` block. Components and other sub-objects are
+ * not reported.
+ */
+export async function listLayerEntities(source: EnfusionTextSource): Promise<LayerEntity[]> {
+  const entities: LayerEntity[] = [];
+  const stack: LayerFrame[] = [];
+  const label = (e: LayerEntity | undefined) => (e ? e.name || e.className : undefined);
+
+  await parseEventStream(source, {
+    onNodeStart(e) {
+      const parent = stack[stack.length - 1];
+      let frame: LayerFrame;
+
+      if (!parent || parent.kind === "children") {
+        if (e.type === "grp") {
+          // "$grp Class : prefab" — the lexer drops the "$"
+          frame = { kind: "group", group: e, owner: parent?.owner };
+        } else {
+          const entity: LayerEntity = { className: e.type, name: e.id ?? "", prefab: e.inheritance ?? "", pos: e.pos };
+          const parentName = label(parent?.owner);
+          if (parentName !== undefined) entity.parent = parentName;
+          entities.push(entity);
+          frame = { kind: "entity", entity };
+        }
+      } else if (parent.kind === "group") {
+        const entity: LayerEntity = {
+          className: parent.group!.id ?? "",
+          name: e.type,
+          prefab: parent.group!.inheritance ?? "",
+          pos: e.pos,
+        };
+        const parentName = label(parent.owner);
+        if (parentName !== undefined) entity.parent = parentName;
+        entities.push(entity);
+        frame = { kind: "entity", entity };
+      } else if (parent.kind === "entity" && e.type === "") {
+        frame = { kind: "children", owner: parent.entity };
+      } else {
+        frame = { kind: "other" };
+      }
+      stack.push(frame);
+    },
+    onProperty(e) {
+      const entity = stack[stack.length - 1]?.entity;
+      if (!entity) return;
+      if (e.key === "ID") entity.id = e.value;
+      else if (e.key === "coords") entity.coords = e.value;
+    },
+    onNodeEnd() {
+      stack.pop();
+    },
+  });
+
+  return entities;
+}
+
+/**
+ * Header of a stream's first node (type, ID, class and parent reference),
+ * read without consuming the rest of the stream. Throws like parse() for an
+ * empty stream or a malformed header.
+ */
+export async function readRootHeader(source: EnfusionTextSource): Promise<NodeStartEvent> {
+  let header: NodeStartEvent | null = null;
+  const parser = new EnfusionEventParser(
+    {
+      onNodeStart(e) {
+        header = e;
+        parser.stop();
+      },
+    },
+    { singleRoot: true }
+  );
+  const decoder = new TextDecoder("utf-8");
+  for await (const chunk of source) {
+    parser.write(typeof chunk === "string" ? chunk : decoder.decode(chunk, { stream: true }));
+    if (parser.finished) break;
+  }
+  parser.end(decoder.decode());
+  if (!header) throw new Error("Empty input");
+  return header;
+}
+
+export interface GuidRef {
+  /** 16 uppercase hex digits, without braces. */
+  guid: string;
+  /** Resource path after the GUID ("" for a bare {GUID}). */
+  path: string;
+  count: number;
+  /** Character offset of the first property, value or parent reference holding it. */
+  firstPos: number;
+}
+
+const GUID_REF = /\{([0-9A-Fa-f]{16})\}([^"\s{}]*)/g;
+
+/**
+ * Collect every {GUID}path resource reference in property values, standalone
+ * values and parent references, in order of first appearance. Node IDs (the
+ * quoted GUID after a component's class name) are identities, not references,
+ * and are skipped.
+ */
+export async function findGuidRefs(source: EnfusionTextSource): Promise<GuidRef[]> {
+  const refs = new Map<string, GuidRef>();
+  const scan = (text: string, pos: number) => {
+    if (text.indexOf("{") === -1) return;
+    for (const m of text.matchAll(GUID_REF)) {
+      const guid = m[1].toUpperCase();
+      const ref = refs.get(guid);
+      if (ref) {
+        ref.count++;
+        if (!ref.path && m[2]) ref.path = m[2];
+      } else {
+        refs.set(guid, { guid, path: m[2], count: 1, firstPos: pos });
+      }
+    }
+  };
+
+  await parseEventStream(source, {
+    onNodeStart(e) {
+      if (e.inheritance) scan(e.inheritance, e.pos);
+    },
+    onProperty(e) {
+      scan(e.value, e.pos);
+    },
+    onValue(e) {
+      scan(e.value, e.pos);
+    },
+  });
+
+  return [...refs.values()];
+}
@@ -0,0 +1,145 @@
+/**
+ * Lazily parsed Enfusion text documents.
+ *
+ * parseLazy() reads the root header and the root's own properties and values,
+ * but only records where each child block starts and ends: child bodies are
+ * skipped with a brace-depth scan (findBlockEnd) instead of being lexed. A
+ * child's properties, values and children are parsed the first time any of
+ * them is read, one level at a time.
+ *
+ * Callers that only look at header fields (workshop info, .gproj checks) pay
+ * for one cheap scan of the file rather than a full tree. Syntax errors inside
+ * a child surface when that child is first read, not from parseLazy(); use
+ * parse() when the whole file must be validated.
+ */
+
+import {
+  EnfusionEventParser,
+  type EnfusionEventHandler,
+  type NodeEndEvent,
+  type NodeStartEvent,
+  type PropertyEvent,
+  type ValueEvent,
+} from "./enfusion-events.js";
+import type { EnfusionNode, EnfusionProperty } from "./enfusion-text.js";
+
+/** Contents of a node, read in one pass over its body. */
+export interface LazyBody {
+  properties: EnfusionProperty[];
+  values: string[];
+  children: LazyEnfusionNode[];
+}
+
+/**
+ * Collects one level of a document: the properties, values and child headers
+ * of the node whose contents are at contentDepth. Child bodies are skipped.
+ */
+class LevelReader implements EnfusionEventHandler {
+  /** The node itself, when its header is part of the parsed text (the root). */
+  node: LazyEnfusionNode | undefined;
+  readonly body: LazyBody = { properties: [], values: [], children: [] };
+
+  private readonly source: string;
+  private readonly contentDepth: number;
+
+  constructor(source: string, contentDepth: number) {
+    this.source = source;
+    this.contentDepth = contentDepth;
+  }
+
+  onNodeStart(event: NodeStartEvent): boolean {
+    if (event.depth < this.contentDepth) {
+      // The root: its contents are what this reader collects
+      this.node = new LazyEnfusionNode(this.source, event, this.body);
+      return true;
+    }
+    this.body.children.push(new LazyEnfusionNode(this.source, event));
+    return false;
+  }
+
+  onProperty(event: PropertyEvent): void {
+    this.body.properties.push({ key: event.key, value: event.value });
+  }
+
+  onValue(event: ValueEvent): void {
+    this.body.values.push(event.value);
+  }
+
+  onNodeEnd(event: NodeEndEvent): void {
+    const children = this.body.children;
+    const node = event.depth < this.contentDepth ? this.node : children[children.length - 1];
+    node!.closeStart = event.pos;
+  }
+}
+
+/**
+ * An EnfusionNode whose contents are parsed on first access. Works with the
+ * enfusion-text helpers (getProperty, setProperty, serialize).
+ */
+export class LazyEnfusionNode implements EnfusionNode {
+  type: string;
+  id?: string;
+  className?: string;
+  inheritance?: string;
+  /** Offset of the type name (or of "{" for an anonymous block). */
+  readonly start: number;
+  /** Offset just past the opening "{". */
+  readonly bodyStart: number;
+  /** Offset of the closing "}". */
+  closeStart = -1;
+
+  private readonly source: string;
+  private body: LazyBody | undefined;
+
+  constructor(source: string, event: NodeStartEvent, body?: LazyBody) {
+    this.source = source;
+    this.body = body;
+    this.type = event.type;
+    if (event.id !== undefined) this.id = event.id;
+    if (event.className !== undefined) this.className = event.className;
+    if (event.inheritance !== undefined) this.inheritance = event.inheritance;
+    this.start = event.pos;
+    this.bodyStart = event.bodyStart;
+  }
+
+  /** Source text between the braces, exactly as written. */
+  get bodyText(): string {
+    return this.source.slice(this.bodyStart, this.closeStart);
+  }
+
+  /** True once the node's contents have been read. */
+  get parsed(): boolean {
+    return this.body !== undefined;
+  }
+
+  get properties(): EnfusionProperty[] {
+    return this.load().properties;
+  }
+
+  get values(): string[] {
+    return this.load().values;
+  }
+
+  get children(): LazyEnfusionNode[] {
+    return this.load().children;
+  }
+
+  private load(): LazyBody {
+    if (!this.body) {
+      const reader = new LevelReader(this.source, 0);
+      new EnfusionEventParser(reader, { offset: this.bodyStart }).end(this.bodyText);
+      this.body = reader.body;
+    }
+    return this.body;
+  }
+}
+
+/**
+ * Parse the root node of a document, deferring every child block. Same root
+ * selection and header errors as parse().
+ */
+export function parseLazy(input: string): LazyEnfusionNode {
+  const reader = new LevelReader(input, 1);
+  new EnfusionEventParser(reader, { singleRoot: true }).end(input);
+  return reader.node!;
+}
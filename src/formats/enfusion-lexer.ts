@@ -0,0 +1,216 @@
+/**
+ * Lexer for the Enfusion text serialization format, shared by the tree parser
+ * (enfusion-text.ts) and the streaming event parser (enfusion-events.ts).
+ */
+
+export enum TokenType {
+  String,     // "quoted string"
+  Identifier, // bare word (alphanumeric + _ + . + -)
+  OpenBrace,  // {
+  CloseBrace, // }
+  Colon,      // :
+}
+
+export interface Token {
+  type: TokenType;
+  value: string;
+  /** Offset of the first character (the opening quote for strings). */
+  pos: number;
+  /** Offset just past the last character (past the closing quote for strings). */
+  end: number;
+}
+
+const CH_TAB = 9;
+const CH_LF = 10;
+const CH_CR = 13;
+const CH_SPACE = 32;
+const CH_QUOTE = 34;
+const CH_SLASH = 47;
+const CH_COLON = 58;
+const CH_BACKSLASH = 92;
+const CH_OPEN_BRACE = 123;
+const CH_CLOSE_BRACE = 125;
+
+/** charCode -> 1 for identifier characters (letters, digits, _ . -). ASCII only, like the grammar. */
+const IDENT_CHARS = new Uint8Array(128);
+for (const ch of "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_.-") {
+  IDENT_CHARS[ch.charCodeAt(0)] = 1;
+}
+
+function isIdentChar(code: number): boolean {
+  return code < 128 && IDENT_CHARS[code] === 1;
+}
+
+/**
+ * Pull-based lexer: next() returns one token at a time (undefined at EOF) so
+ * the parser never materializes the whole token list. Quoted strings and bare
+ * words are sliced straight out of the input; escape sequences are only
+ * decoded when a string actually contains a backslash.
+ */
+export class EnfusionLexer {
+  private readonly input: string;
+  private readonly len: number;
+  private i: number;
+
+  /** Start lexing at `start` (used to resume after a skipped block). */
+  constructor(input: string, start = 0) {
+    this.input = input;
+    this.len = input.length;
+    this.i = start;
+  }
+
+  /** Index just past the last token returned (or skipped whitespace/comment at EOF). */
+  get offset(): number {
+    return this.i;
+  }
+
+  next(): Token | undefined {
+    const input = this.input;
+    const len = this.len;
+    let i = this.i;
+
+    while (i < len) {
+      const code = input.charCodeAt(i);
+
+      if (code === CH_SPACE || code === CH_LF || code === CH_TAB || code === CH_CR) {
+        i++;
+        continue;
+      }
+
+      // Single-line comment (// ...)
+      if (code === CH_SLASH && input.charCodeAt(i + 1) === CH_SLASH) {
+        const eol = input.indexOf("\n", i + 2);
+        i = eol === -1 ? len : eol;
+        continue;
+      }
+
+      if (code === CH_QUOTE) return this.readString(i);
+
+      if (code === CH_OPEN_BRACE) {
+        this.i = i + 1;
+        return { type: TokenType.OpenBrace, value: "{", pos: i, end: i + 1 };
+      }
+      if (code === CH_CLOSE_BRACE) {
+        this.i = i + 1;
+        return { type: TokenType.CloseBrace, value: "}", pos: i, end: i + 1 };
+      }
+      if (code === CH_COLON) {
+        this.i = i + 1;
+        return { type: TokenType.Colon, value: ":", pos: i, end: i + 1 };
+      }
+
+      if (isIdentChar(code)) {
+        const start = i;
+        i++;
+        while (i < len && isIdentChar(input.charCodeAt(i))) i++;
+        this.i = i;
+        return { type: TokenType.Identifier, value: input.slice(start, i), pos: start, end: i };
+      }
+
+      // Unknown character — skip
+      i++;
+    }
+
+    this.i = len;
+    return undefined;
+  }
+
+  private readString(start: number): Token {
+    const input = this.input;
+    const bodyStart = start + 1;
+    const close = input.indexOf('"', bodyStart);
+    const end = close === -1 ? this.len : close;
+    // Search only the candidate body: an indexOf over the rest of the input
+    // would make every string cost O(remaining length) in escape-free files
+    const value = input.slice(bodyStart, end);
+    const backslash = value.indexOf("\\");
+
+    // Fast path: no escapes before the closing quote
+    if (backslash === -1) {
+      this.i = close === -1 ? this.len : close + 1;
+      return { type: TokenType.String, value, pos: start, end: this.i };
+    }
+
+    return this.readEscapedString(start, bodyStart + backslash);
+  }
+
+  /** Slow path: decode escapes, copying the unescaped runs between them as slices. */
+  private readEscapedString(start: number, firstBackslash: number): Token {
+    const input = this.input;
+    const len = this.len;
+    const chunks: string[] = [];
+    let runStart = start + 1;
+    let i = firstBackslash;
+
+    while (i < len) {
+      const code = input.charCodeAt(i);
+      if (code === CH_QUOTE) break;
+      if (code !== CH_BACKSLASH || i + 1 >= len) {
+        i++;
+        continue;
+      }
+
+      if (i > runStart) chunks.push(input.slice(runStart, i));
+      const esc = input[i + 1];
+      switch (esc) {
+        case "n": chunks.push("\n"); break;
+        case "t": chunks.push("\t"); break;
+        case "r": chunks.push("\r"); break;
+        default: chunks.push(esc); break;
+      }
+      i += 2;
+      runStart = i;
+    }
+
+    if (i > runStart) chunks.push(input.slice(runStart, Math.min(i, len)));
+    this.i = i < len ? i + 1 : len; // skip closing quote
+    return { type: TokenType.String, value: chunks.join(""), pos: start, end: this.i };
+  }
+}
+
+/**
+ * Offset of the "}" closing a block whose body starts at `start`, or -1 if the
+ * input ends first. A plain charCode scan that only tracks brace depth, quoted
+ * strings and comments, so skipping a block costs far less than lexing it.
+ */
+export function findBlockEnd(input: string, start: number): number {
+  const len = input.length;
+  let depth = 1;
+  let i = start;
+
+  while (i < len) {
+    const code = input.charCodeAt(i);
+    if (code === CH_OPEN_BRACE) {
+      depth++;
+    } else if (code === CH_CLOSE_BRACE) {
+      if (--depth === 0) return i;
+    } else if (code === CH_QUOTE) {
+      i = skipString(input, i + 1);
+      if (i === -1) return -1;
+    } else if (code === CH_SLASH && input.charCodeAt(i + 1) === CH_SLASH) {
+      i = input.indexOf("\n", i + 2);
+      if (i === -1) return -1;
+    }
+    i++;
+  }
+  return -1;
+}
+
+/** Index of the quote closing a string whose body starts at `i`, or -1. Same escape rule as readEscapedString. */
+function skipString(input: string, i: number): number {
+  const len = input.length;
+  while (i < len) {
+    const code = input.charCodeAt(i);
+    if (code === CH_QUOTE) return i;
+    i += code === CH_BACKSLASH ? 2 : 1;
+  }
+  return -1;
+}
+
+/** Tokenize a whole document eagerly (tests and benchmarks; the parser pulls tokens lazily). */
+export function tokenize(input: string): Token[] {
+  const lexer = new EnfusionLexer(input);
+  const tokens: Token[] = [];
+  for (let tok = lexer.next(); tok; tok = lexer.next()) tokens.push(tok);
+  return tokens;
+}
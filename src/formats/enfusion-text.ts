@@ -6,11 +6,24 @@
  *   Document     = Node
  *   Node         = TypeName [GUID] [":" QuotedString] "{" Content* "}"
  *   Content      = Property | BareValue | Node
- *   Property     = Key (QuotedString | Number | Node)
+ *   Property     = Key (QuotedString | Number+ | Node)
  *   BareValue    = QuotedString (standalone value inside a block, e.g. dependency GUIDs)
  *   QuotedString = '"' chars '"'
+ *
+ * The lexer lives in enfusion-lexer.ts and the grammar in enfusion-events.ts,
+ * which also reads streams in bounded memory for files too large to hold as a tree.
  */
 
+import {
+  EnfusionEventParser,
+  type EnfusionEventHandler,
+  type NodeStartEvent,
+  type PropertyEvent,
+  type ValueEvent,
+} from "./enfusion-events.js";
+
+export { TokenType, EnfusionLexer, tokenize, type Token } from "./enfusion-lexer.js";
+
 /** A single property: key-value pair */
 export interface EnfusionProperty {
   key: string;
@@ -45,340 +58,38 @@ export interface EnfusionNode {
   rawContent?: string;
 }
 
-// ---------------------------------------------------------------------------
-// Tokenizer
-// ---------------------------------------------------------------------------
-
-enum TokenType {
-  String,     // "quoted string"
-  Identifier, // bare word (alphanumeric + _ + .)
-  OpenBrace,  // {
-  CloseBrace, // }
-  Colon,      // :
-}
-
-interface Token {
-  type: TokenType;
-  value: string;
-  pos: number;
-}
-
-function tokenize(input: string): Token[] {
-  const tokens: Token[] = [];
-  let i = 0;
-  const len = input.length;
-
-  while (i < len) {
-    const ch = input[i];
-
-    // Skip whitespace
-    if (ch === " " || ch === "\t" || ch === "\n" || ch === "\r") {
-      i++;
-      continue;
-    }
-
-    // Skip single-line comments (// ...)
-    if (ch === "/" && i + 1 < len && input[i + 1] === "/") {
-      while (i < len && input[i] !== "\n") i++;
-      continue;
-    }
-
-    // Quoted string
-    if (ch === '"') {
-      const start = i;
-      i++; // skip opening quote
-      let str = "";
-      while (i < len && input[i] !== '"') {
-        if (input[i] === "\\" && i + 1 < len) {
-          const esc = input[i + 1];
-          switch (esc) {
-            case "n": str += "\n"; break;
-            case "t": str += "\t"; break;
-            case "r": str += "\r"; break;
-            case "\\": str += "\\"; break;
-            case '"': str += '"'; break;
-            default: str += esc; break;
-          }
-          i += 2;
-        } else {
-          str += input[i];
-          i++;
-        }
-      }
-      if (i < len) i++; // skip closing quote
-      tokens.push({ type: TokenType.String, value: str, pos: start });
-      continue;
-    }
-
-    if (ch === "{") {
-      tokens.push({ type: TokenType.OpenBrace, value: "{", pos: i });
-      i++;
-      continue;
-    }
-
-    if (ch === "}") {
-      tokens.push({ type: TokenType.CloseBrace, value: "}", pos: i });
-      i++;
-      continue;
-    }
-
-    if (ch === ":") {
-      tokens.push({ type: TokenType.Colon, value: ":", pos: i });
-      i++;
-      continue;
-    }
-
-    // Identifier (bare word): letters, digits, underscore, dot, dash
-    if (/[a-zA-Z0-9_.\-]/.test(ch)) {
-      const start = i;
-      while (i < len && /[a-zA-Z0-9_.\-]/.test(input[i])) i++;
-      tokens.push({ type: TokenType.Identifier, value: input.substring(start, i), pos: start });
-      continue;
-    }
-
-    // Unknown character — skip
-    i++;
-  }
-
-  return tokens;
-}
-
 // ---------------------------------------------------------------------------
 // Parser
 // ---------------------------------------------------------------------------
 
-class Parser {
-  private tokens: Token[];
-  private pos: number;
-
-  constructor(tokens: Token[]) {
-    this.tokens = tokens;
-    this.pos = 0;
-  }
-
-  private peek(): Token | undefined {
-    return this.tokens[this.pos];
+/** Builds the EnfusionNode tree from parser events. */
+class TreeBuilder implements EnfusionEventHandler {
+  root: EnfusionNode | undefined;
+  private readonly stack: EnfusionNode[] = [];
+
+  onNodeStart(event: NodeStartEvent): void {
+    const node: EnfusionNode = { type: event.type, properties: [], values: [], children: [] };
+    if (event.id !== undefined) node.id = event.id;
+    if (event.className !== undefined) node.className = event.className;
+    if (event.inheritance !== undefined) node.inheritance = event.inheritance;
+
+    const parent = this.stack[this.stack.length - 1];
+    if (parent) parent.children.push(node);
+    else this.root = node;
+    this.stack.push(node);
   }
 
-  private advance(): Token {
-    return this.tokens[this.pos++];
-  }
-
-  private expect(type: TokenType): Token {
-    const tok = this.advance();
-    if (!tok || tok.type !== type) {
-      const got = tok ? `${TokenType[tok.type]}("${tok.value}") at pos ${tok.pos}` : "EOF";
-      throw new Error(`Expected ${TokenType[type]} but got ${got}`);
-    }
-    return tok;
+  onProperty(event: PropertyEvent): void {
+    this.stack[this.stack.length - 1].properties.push({ key: event.key, value: event.value });
   }
 
-  /**
-   * Parse the root node. An Enfusion document is a single top-level node.
-   */
-  parseDocument(): EnfusionNode {
-    const node = this.parseNode();
-    return node;
+  onValue(event: ValueEvent): void {
+    this.stack[this.stack.length - 1].values.push(event.value);
   }
 
-  /**
-   * Parse a node:
-   *   TypeName [GUID_STRING] [":" InheritanceString] "{" content* "}"
-   */
-  private parseNode(): EnfusionNode {
-    // Type name — can be Identifier or String (some types are quoted)
-    const typeTok = this.advance();
-    if (!typeTok || (typeTok.type !== TokenType.Identifier && typeTok.type !== TokenType.String)) {
-      const got = typeTok ? `${TokenType[typeTok.type]}("${typeTok.value}")` : "EOF";
-      throw new Error(`Expected type name but got ${got}`);
-    }
-
-    const node: EnfusionNode = {
-      type: typeTok.value,
-      properties: [],
-      values: [],
-      children: [],
-    };
-
-    // Optional bare-word after type name (e.g., "GameProjectConfig PC" or class qualifier)
-    let next = this.peek();
-    if (next && next.type === TokenType.Identifier) {
-      const saved = this.pos;
-      const bareId = this.advance();
-      const afterBare = this.peek();
-      if (afterBare && (afterBare.type === TokenType.OpenBrace || afterBare.type === TokenType.Colon)) {
-        // BareWord followed by { or : — it's a simple bare-word ID (e.g., "PC")
-        node.id = bareId.value;
-      } else if (afterBare && afterBare.type === TokenType.String) {
-        // BareWord followed by "String" — could be className + GUID or just bare ID before colon
-        const saved2 = this.pos;
-        const strTok = this.advance();
-        const afterStr = this.peek();
-        if (afterStr && (afterStr.type === TokenType.OpenBrace || afterStr.type === TokenType.Colon)) {
-          // Type BareWord "GUID" { — bare word is class qualifier, string is ID
-          node.className = bareId.value;
-          node.id = strTok.value;
-        } else {
-          // BareWord "String" not followed by { or : — bare word is just an ID
-          this.pos = saved2;
-          node.id = bareId.value;
-        }
-      } else {
-        this.pos = saved;
-      }
-    }
-
-    // Optional quoted GUID string after type name (when no bare-word was consumed)
-    next = this.peek();
-    if (next && next.type === TokenType.String && node.id === undefined) {
-      const saved = this.pos;
-      const strTok = this.advance();
-      const afterStr = this.peek();
-      if (afterStr && (afterStr.type === TokenType.OpenBrace || afterStr.type === TokenType.Colon)) {
-        node.id = strTok.value;
-      } else {
-        this.pos = saved;
-      }
-    }
-
-    // Optional inheritance: ":" QuotedString
-    next = this.peek();
-    if (next && next.type === TokenType.Colon) {
-      this.advance(); // consume ":"
-      const inhTok = this.expect(TokenType.String);
-      node.inheritance = inhTok.value;
-    }
-
-    // Opening brace
-    this.expect(TokenType.OpenBrace);
-
-    // Parse contents until closing brace
-    while (true) {
-      next = this.peek();
-      if (!next) {
-        throw new Error("Unexpected EOF, expected '}'");
-      }
-      if (next.type === TokenType.CloseBrace) {
-        this.advance();
-        break;
-      }
-
-      // What kind of content?
-      if (next.type === TokenType.Identifier) {
-        // Could be:
-        // 1. Property: Key "value"  or  Key Number
-        // 2. Property: Key SubNode  (Key TypeName "{" ... "}")
-        // 3. Child node: TypeName ["guid"] [":" "parent"] "{" ... "}"
-
-        // Look ahead to determine which case
-        const saved = this.pos;
-        const identTok = this.advance();
-        const after = this.peek();
-
-        if (!after || after.type === TokenType.CloseBrace) {
-          // Bare identifier at end of block — treat as a value
-          node.values.push(identTok.value);
-        } else if (after.type === TokenType.String) {
-          // Could be: Key "value" (property)
-          // Or: TypeName "guid" { ... } (child node with ID)
-          const saved2 = this.pos;
-          const strTok = this.advance();
-          const afterStr = this.peek();
-
-          if (afterStr && afterStr.type === TokenType.OpenBrace) {
-            // TypeName "guid" { ... } — child node with ID
-            this.pos = saved; // restore to before identifier
-            const child = this.parseNode();
-            node.children.push(child);
-          } else if (afterStr && afterStr.type === TokenType.Colon) {
-            // TypeName "guid" : "parent" { ... } — child node with ID + inheritance
-            this.pos = saved;
-            const child = this.parseNode();
-            node.children.push(child);
-          } else {
-            // Key "value" — simple property
-            node.properties.push({ key: identTok.value, value: strTok.value });
-          }
-        } else if (after.type === TokenType.Identifier) {
-          // Could be: Key SubNode  (e.g., "Configurations" "GameProjectConfig PC { ... }")
-          // Or property with bare value: Key BareValue
-          // Look further: if after the second identifier we see "{", it's a child node
-          const saved2 = this.pos;
-          const ident2 = this.advance();
-          const afterIdent2 = this.peek();
-
-          if (afterIdent2 && afterIdent2.type === TokenType.OpenBrace) {
-            // Key TypeName { ... } — this is a property whose value is a child node
-            // OR it's two identifiers before a brace (TypeName SubType { })
-            // In Enfusion: "GameProjectConfig PC { ... }" means type=GameProjectConfig, but "PC" is like an ID
-            // Let's treat it as: identTok is the key, and ident2 + { } is the value node
-            this.pos = saved2; // back to ident2
-            // But actually, in Enfusion:
-            //   Configurations {
-            //     GameProjectConfig PC { ... }
-            //   }
-            // "GameProjectConfig" is the type, "PC" is essentially an ID
-            // So we restore to identTok and parse a child node
-            this.pos = saved;
-            const child = this.parseNode();
-            node.children.push(child);
-          } else if (afterIdent2 && afterIdent2.type === TokenType.String) {
-            // Three tokens: Ident1 Ident2 "string" — could be node: Type SubId "guid" { }
-            const saved3 = this.pos;
-            const strTok = this.advance();
-            const afterStr = this.peek();
-            if (afterStr && afterStr.type === TokenType.OpenBrace) {
-              // TypeName SubType "guid" { ... }
-              this.pos = saved;
-              const child = this.parseNode();
-              node.children.push(child);
-            } else {
-              // Ident Ident "string" without brace — unusual
-              // Treat first ident as key, rest as value
-              this.pos = saved2;
-              node.properties.push({ key: identTok.value, value: ident2.value });
-            }
-          } else {
-            // Key BareValue — simple property with unquoted value
-            node.properties.push({ key: identTok.value, value: ident2.value });
-          }
-        } else if (after.type === TokenType.OpenBrace) {
-          // TypeName { ... } — child node with no ID
-          this.pos = saved;
-          const child = this.parseNode();
-          node.children.push(child);
-        } else if (after.type === TokenType.Colon) {
-          // TypeName : "parent" { ... } — child node with inheritance
-          this.pos = saved;
-          const child = this.parseNode();
-          node.children.push(child);
-        } else {
-          // Bare identifier followed by something unexpected
-          node.values.push(identTok.value);
-        }
-      } else if (next.type === TokenType.String) {
-        // Standalone quoted string (e.g., dependency GUIDs)
-        const strTok = this.advance();
-
-        // Check if this string is followed by "{" — meaning it's a type name
-        const after = this.peek();
-        if (after && after.type === TokenType.OpenBrace) {
-          // Quoted type name node (rare but possible)
-          if (this.pos > 0) this.pos--;
-          const child = this.parseNode();
-          node.children.push(child);
-        } else {
-          node.values.push(strTok.value);
-        }
-      } else {
-        // Skip unexpected tokens
-        this.advance();
-      }
-    }
-
-    return node;
+  onNodeEnd(): void {
+    this.stack.pop();
   }
-
 }
 
 // ---------------------------------------------------------------------------
@@ -386,7 +97,7 @@ class Parser {
 // ---------------------------------------------------------------------------
 
 /** Escape backslashes and double quotes in string values for serialization. */
-function escapeString(str: string): string {
+export function escapeString(str: string): string {
   return str
     .replace(/\\/g, "\\\\")
     .replace(/"/g, '\\"')
@@ -395,6 +106,22 @@ function escapeString(str: string): string {
     .replace(/\r/g, "\\r");
 }
 
+/**
+ * Format a property value as it appears after the key: bare (unquoted) for
+ * numbers, vectors, booleans, and bare identifiers (enums like Manual, Runtime,
+ * None), quoted and escaped otherwise.
+ */
+export function formatValue(value: string): string {
+  if (
+    /^-?\d+(\.\d+)?( -?\d+(\.\d+)?)*$/.test(value) ||
+    value === "true" || value === "false" ||
+    /^[A-Za-z_][A-Za-z0-9_]*$/.test(value)
+  ) {
+    return value;
+  }
+  return `"${escapeString(value)}"`;
+}
+
 function serializeNode(node: EnfusionNode, indent: number): string {
   const pad = " ".repeat(indent);
   const innerPad = " ".repeat(indent + 1);
@@ -448,24 +175,16 @@ function serializeNode(node: EnfusionNode, indent: number): string {
       })
       .join("\n");
 
-    return `${pad}${header} {\n${reindented}\n${pad}}`;
+    return `${pad}${header ? `${header} ` : ""}{\n${reindented}\n${pad}}`;
   }
 
-  parts.push(`${pad}${header} {`);
+  // Anonymous blocks (e.g. child entity lists) have no header
+  parts.push(`${pad}${header ? `${header} ` : ""}{`);
 
   // Properties
   for (const prop of node.properties) {
     if (typeof prop.value === "string") {
-      // Emit bare (unquoted) values for numbers, booleans, and bare identifiers (enums like Manual, Runtime, None)
-      if (
-        /^-?\d+(\.\d+)?$/.test(prop.value) ||
-        prop.value === "true" || prop.value === "false" ||
-        /^[A-Za-z_][A-Za-z0-9_]*$/.test(prop.value)
-      ) {
-        parts.push(`${innerPad}${prop.key} ${prop.value}`);
-      } else {
-        parts.push(`${innerPad}${prop.key} "${escapeString(prop.value)}"`);
-      }
+      parts.push(`${innerPad}${prop.key} ${formatValue(prop.value)}`);
     } else {
       // Value is a child node
       parts.push(serializeNode(prop.value, indent + 1));
@@ -494,12 +213,9 @@ function serializeNode(node: EnfusionNode, indent: number): string {
  * Parse Enfusion text serialization format into a node tree.
  */
 export function parse(input: string): EnfusionNode {
-  const tokens = tokenize(input);
-  if (tokens.length === 0) {
-    throw new Error("Empty input");
-  }
-  const parser = new Parser(tokens);
-  return parser.parseDocument();
+  const builder = new TreeBuilder();
+  new EnfusionEventParser(builder, { singleRoot: true }).end(input);
+  return builder.root!;
 }
 
 /**
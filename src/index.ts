@@ -13,8 +13,18 @@ const server = new McpServer({
   version: "0.7.1",
 });
 
-registerTools(server, config);
+const wbClient = registerTools(server, config);
 
 const transport = new StdioServerTransport();
 await server.connect(transport);
 logger.info("enfusion-mcp server started");
+
+// Release pooled Workbench sockets when the MCP client goes away or we are stopped
+const shutdown = (exit: boolean) => {
+  wbClient.close();
+  if (exit) process.exit(0);
+};
+server.server.onclose = () => shutdown(false);
+process.stdin.once("end", () => shutdown(false));
+process.once("SIGINT", () => shutdown(true));
+process.once("SIGTERM", () => shutdown(true));
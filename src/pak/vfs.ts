@@ -1,6 +1,7 @@
-import { openSync, readSync, closeSync, readdirSync, existsSync } from "node:fs";
+import { openSync, readSync, closeSync, readdirSync, existsSync, createReadStream } from "node:fs";
 import { join, extname } from "node:path";
-import { inflateRawSync } from "node:zlib";
+import { Readable } from "node:stream";
+import { inflateRawSync, createInflateRaw } from "node:zlib";
 import { parsePakIndex, type PakIndex, type PakDirEntry, type PakFileEntry } from "./reader.js";
 import { logger } from "../utils/logger.js";
 
@@ -175,11 +176,47 @@ export class PakVirtualFS {
     }
   }
 
+  /**
+   * Stream a file's decompressed bytes without holding the whole file in
+   * memory. Pair with parseEventStream() for large .layer/.ent files.
+   */
+  createReadStream(virtualPath: string): Readable {
+    const norm = normalizePath(virtualPath);
+    const ref = this.fileIndex.get(norm);
+    if (!ref) {
+      throw new Error(`File not found in pak: ${virtualPath}`);
+    }
+
+    const { pakPath, dataStart, entry } = ref;
+    const readLen = entry.compressed ? entry.compressedLen : entry.decompressedLen;
+    if (readLen === 0) return Readable.from([]);
+
+    const position = dataStart + entry.offset;
+    const raw = createReadStream(pakPath, { start: position, end: position + readLen - 1 });
+    if (!entry.compressed) return raw;
+
+    const inflate = createInflateRaw();
+    raw.on("error", (e) => inflate.destroy(e));
+    // A reader that stops early destroys the inflate stream; release the file too
+    inflate.on("close", () => raw.destroy());
+    return raw.pipe(inflate);
+  }
+
   /** Read a file as UTF-8 text. */
   readTextFile(virtualPath: string): string {
     return this.readFile(virtualPath).toString("utf-8");
   }
 
+  /**
+   * Identity of a file's stored bytes (archive, offset and length), for caches
+   * keyed on content that cannot be stat'ed. Returns null if not found.
+   */
+  fileVersion(virtualPath: string): string | null {
+    const ref = this.fileIndex.get(normalizePath(virtualPath));
+    if (!ref) return null;
+    return `${ref.pakPath}@${ref.dataStart + ref.entry.offset}:${ref.entry.compressedLen}:${ref.entry.decompressedLen}`;
+  }
+
   /** Get decompressed file size without reading/inflating. Returns -1 if not found. */
   fileSize(virtualPath: string): number {
     const norm = normalizePath(virtualPath);
@@ -36,6 +36,7 @@ import { registerWbLocalization } from "./tools/wb-localization.js";
 import { registerWbProjects } from "./tools/wb-projects.js";
 import { registerWbValidate } from "./tools/wb-validate.js";
 import { registerWbState } from "./tools/wb-state.js";
+import { registerWbSnapshot } from "./tools/wb-snapshot.js";
 import { registerGameBrowse } from "./tools/game-browse.js";
 import { registerGameRead } from "./tools/game-read.js";
 import { registerAssetSearch } from "./tools/asset-search.js";
@@ -49,7 +50,11 @@ import { registerWbKnowledge } from "./tools/wb-knowledge.js";
 import { registerBuildingSetup } from "./tools/building-setup.js";
 import type { Config } from "./config.js";
 
-export function registerTools(server: McpServer, config: Config): void {
+/**
+ * Register every tool, prompt and resource. Returns the shared Workbench
+ * client so the caller can release its pooled sockets on shutdown.
+ */
+export function registerTools(server: McpServer, config: Config): WorkbenchClient {
   const searchEngine = new SearchEngine(config.dataDir);
   const patterns = new PatternLibrary(config.patternsDir);
 
@@ -94,6 +99,7 @@ export function registerTools(server: McpServer, config: Config): void {
   registerWbProjects(server, wbClient);
   registerWbValidate(server, wbClient);
   registerWbState(server, wbClient);
+  registerWbSnapshot(server, wbClient);
   registerScenarioTools(server, wbClient);
   registerScenarioCreate(server, config);
 
@@ -116,4 +122,6 @@ export function registerTools(server: McpServer, config: Config): void {
   registerClassResource(server, searchEngine);
   registerPatternResource(server, patterns);
   registerGroupResource(server, searchEngine);
+
+  return wbClient;
 }
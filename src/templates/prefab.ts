@@ -37,7 +37,7 @@ export interface PrefabOptions {
   /** Description (used for m_sDisplayName if applicable) */
   description?: string;
   /**
-   * Pre-resolved ancestor components (from prefab-ancestry walkChain).
+   * Pre-resolved ancestor components (from prefab-ancestry resolvePrefab).
    * When provided, ancestry components take precedence over recipe overrides.
    * GUIDs are preserved so they act as override slots in the Enfusion delta model.
    */
@@ -1,7 +1,6 @@
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
 import {
-  readFileSync,
   writeFileSync,
   mkdirSync,
   existsSync,
@@ -12,11 +11,12 @@ import type { WorkbenchClient } from "../workbench/client.js";
 import { validateProjectPath } from "../utils/safe-path.js";
 import { resolveGameDataPath, findLooseFile, resolveAddonDir } from "../utils/game-paths.js";
 import { generateGuid } from "../formats/guid.js";
-import {
-  walkChain,
-  mergeAncestryComponents,
-  parseTopLevelComponents,
-} from "../utils/prefab-ancestry.js";
+import { EnfusionDocument } from "../formats/enfusion-cst.js";
+import { parseCache, type CachedDocument } from "../utils/parse-cache.js";
+import { resolvePrefab, prefabModel, topLevelOf } from "../utils/prefab-ancestry.js";
+import { getResourceResolver } from "../utils/resource-resolver.js";
+import { getPrefabGraph } from "../utils/prefab-graph.js";
+import { serialize } from "../formats/enfusion-text.js";
 
 export function registerGameDuplicate(
   server: McpServer,
@@ -149,9 +149,9 @@ export function registerGameDuplicate(
       }
 
       // Read source content
-      let rawContent: string;
+      let source: CachedDocument;
       try {
-        rawContent = readFileSync(sourceFile, "utf-8");
+        source = parseCache.readFile(sourceFile);
       } catch (e) {
         const msg = e instanceof Error ? e.message : String(e);
         return {
@@ -160,72 +160,67 @@ export function registerGameDuplicate(
         };
       }
 
+      // Edits are spliced into the source text so formatting and comments survive
+      let doc: EnfusionDocument;
+      try {
+        doc = EnfusionDocument.parse(source.text);
+      } catch (e) {
+        const msg = e instanceof Error ? e.message : String(e);
+        return {
+          content: [{ type: "text", text: `Failed to parse source file: ${msg}` }],
+          isError: true,
+        };
+      }
+      const root = doc.root;
+
       // Resolve ancestry and inject inherited components
       let ancestryNote = "";
-      let finalContent = rawContent;
 
       // Only apply ancestry for .et prefab files, not .conf
       if (bareSourcePath.endsWith(".et")) {
-        const { levels, warnings } = walkChain(bareSourcePath, config);
+        const { levels, warnings, components: resolved } = resolvePrefab(bareSourcePath, config);
 
         if (levels.length > 1) {
           try {
-            // Get merged components from full ancestry
-            const merged = mergeAncestryComponents(levels);
-
-            // Top-level component GUIDs per ancestor level (excludes nested sub-components)
-            const topLevelByDepth = new Map<number, Set<string>>();
-            for (const level of levels) {
-              const topMap = parseTopLevelComponents(level.rawContent);
-              topLevelByDepth.set(level.depth, new Set(topMap.keys()));
-            }
-
             // Existing top-level GUIDs in the leaf file
-            const existingGuids = new Set(parseTopLevelComponents(rawContent).keys());
+            const existingGuids = new Set(topLevelOf(prefabModel(source).components).keys());
 
             // Build list of components to inject (as raw text fragments)
             const injected: string[] = [];
             const fragments: string[] = [];
 
-            for (const [guid, { comp, source }] of merged) {
+            for (const [guid, comp] of resolved) {
               if (existingGuids.has(guid)) continue; // already declared in leaf
-              if (source.depth === levels.length - 1) continue; // it's in the leaf itself
+              // Only inject top-level components — nested sub-components travel inside them
+              if (!comp.topLevel) continue;
 
-              // Only inject top-level components — skip nested sub-components
-              if (!topLevelByDepth.get(source.depth)?.has(guid)) continue;
+              const owner = comp.declaredIn[comp.declaredIn.length - 1];
+              if (owner.depth === levels.length - 1) continue; // it's in the leaf itself
 
-              // Build raw text fragment preserving original content exactly
-              fragments.push(`  ${comp.typeName} "{${comp.guid}}" {${comp.rawBody}  }`);
-              injected.push(`${comp.typeName} (from [${source.depth}] ${source.path})`);
+              if (comp.declaredIn.length === 1) {
+                // Declared once: preserve the original content exactly
+                fragments.push(`  ${comp.typeName} "{${guid}}" {${owner.components.get(guid)!.rawBody}  }`);
+              } else {
+                // Overridden along the chain: emit the resolved values
+                fragments.push(indentBlock(serialize(comp.node), "  "));
+              }
+              const via = comp.declaredIn.length > 1 ? `, overridden in ${comp.declaredIn.length - 1} level(s)` : "";
+              injected.push(`${comp.typeName} (from [${owner.depth}] ${owner.path}${via})`);
             }
 
-            if (fragments.length > 0) {
-              // Insert fragments into the components block using string manipulation
-              // (avoids lossy parse/serialize round-trip)
-              const componentsMatch = /^([ \t]*components\s*\{)/m.exec(finalContent);
-              if (componentsMatch) {
-                // Insert after "components {" opening
-                const insertPos = componentsMatch.index + componentsMatch[0].length;
-                finalContent =
-                  finalContent.slice(0, insertPos) +
-                  "\n" + fragments.join("\n") +
-                  finalContent.slice(insertPos);
+            if (fragments.length > 0 && root) {
+              const components = doc.findChild(root, "components");
+              if (components) {
+                doc.insertText(components, fragments.join("\n"), "start");
               } else {
-                // No components block — insert one before the final closing brace
-                const lastBrace = finalContent.lastIndexOf("}");
-                finalContent =
-                  finalContent.slice(0, lastBrace) +
-                  " components {\n" + fragments.join("\n") + "\n }\n" +
-                  finalContent.slice(lastBrace);
+                // No components block — add one at the end of the root
+                doc.insertText(root, ` components {\n${fragments.join("\n")}\n }`, "end");
               }
             }
 
-            // If flatten, strip parent reference from the raw text
-            if (flatten) {
-              finalContent = finalContent.replace(
-                /^(\w+)\s*:\s*"[^"]*"\s*\{/m,
-                "$1 {"
-              );
+            // If flatten, strip the parent reference
+            if (flatten && root?.inheritance !== undefined) {
+              doc.setInheritance(root, undefined);
             }
 
             const levelCount = levels.length;
@@ -251,11 +246,16 @@ export function registerGameDuplicate(
 
       // Replace the ID field (entity GUID) with a fresh one so the duplicate is independent
       const newEntityId = generateGuid();
-      finalContent = finalContent.replace(/^(\s*ID\s+")[0-9A-Fa-f]{16}(")/m, `$1${newEntityId}$2`);
+      if (root && /^[0-9A-Fa-f]{16}$/.test(doc.getProperty(root, "ID") ?? "")) {
+        doc.setProperty(root, "ID", newEntityId);
+      }
+      const finalContent = doc.toString();
 
       try {
         mkdirSync(dirname(absDestPath), { recursive: true });
         writeFileSync(absDestPath, finalContent, "utf-8");
+        getResourceResolver(config).invalidateProject();
+        getPrefabGraph(config).invalidate();
       } catch (e) {
         const msg = e instanceof Error ? e.message : String(e);
         return {
@@ -334,3 +334,8 @@ export function registerGameDuplicate(
     }
   );
 }
+
+/** Prefix every line of a serialized block. */
+function indentBlock(text: string, pad: string): string {
+  return text.split("\n").map((line) => pad + line).join("\n");
+}
@@ -11,18 +11,16 @@ import {
   type ComponentDef,
 } from "../templates/prefab.js";
 import { recipeLoader } from "../templates/recipe-loader.js";
-import {
-  walkChain,
-  mergeAncestryComponents,
-  type AncestorLevel,
-} from "../utils/prefab-ancestry.js";
+import { resolvePrefab, type ResolvedPrefab } from "../utils/prefab-ancestry.js";
+import { getResourceResolver } from "../utils/resource-resolver.js";
+import { analyzePrefabImpact, getPrefabGraph, type PrefabImpact } from "../utils/prefab-graph.js";
+import { serialize } from "../formats/enfusion-text.js";
 import { validateFilename } from "../utils/safe-path.js";
 
 // ── Inspect helpers ────────────────────────────────────────────────────────────
 
 function formatReport(
-  levels: AncestorLevel[],
-  warnings: string[],
+  { levels, warnings, components }: ResolvedPrefab,
   includeRaw: boolean
 ): string {
   const lines: string[] = [];
@@ -38,23 +36,25 @@ function formatReport(
     for (const w of warnings) lines.push(`  WARNING: ${w}`);
   }
 
-  const merged = mergeAncestryComponents(levels);
-
   lines.push("");
   lines.push("=== Merged Components ===");
 
-  if (merged.size === 0) {
+  if (components.size === 0) {
     lines.push("  (no components found in chain)");
   }
 
-  for (const [, { comp, source }] of merged) {
+  for (const comp of components.values()) {
+    const source = comp.declaredIn[comp.declaredIn.length - 1];
     const isLeaf = source.depth === levels.length - 1;
-    const srcTag = isLeaf ? "← this file" : `inherited from [${source.depth}]: ${source.path}`;
+    let srcTag = isLeaf ? "← this file" : `inherited from [${source.depth}]: ${source.path}`;
+    if (comp.declaredIn.length > 1) {
+      srcTag += `  (values merged from ${comp.declaredIn.map((l) => `[${l.depth}]`).join(", ")})`;
+    }
     lines.push("");
     lines.push(`[${comp.typeName} {${comp.guid}}]  ${srcTag}`);
-    for (const bl of comp.rawBody.split("\n")) {
-      if (bl.trim()) lines.push(`  ${bl}`);
-    }
+    // Effective values: the serialized resolved node without its header and closing brace
+    const body = serialize(comp.node).split("\n").slice(1, -1);
+    for (const bl of body) lines.push(`  ${bl.slice(1)}`);
   }
 
   if (includeRaw) {
@@ -68,6 +68,49 @@ function formatReport(
   return lines.join("\n");
 }
 
+/** Descendants listed individually before the impact report summarizes. */
+const IMPACT_LIST_LIMIT = 50;
+
+function formatImpact({ node, ancestors, descendants, components, unread }: PrefabImpact): string {
+  const lines: string[] = [];
+
+  lines.push("=== Prefab ===");
+  lines.push(`  ${node.path}  [${node.entityClass}]  (${node.source})`);
+  if (ancestors.length > 0) {
+    lines.push(`  inherits: ${ancestors.map((a) => a.path).join(" → ")}`);
+  }
+
+  lines.push("");
+  lines.push(`=== Descendants (${descendants.length}) ===`);
+  if (descendants.length === 0) lines.push("  (no prefab inherits from this one)");
+  const bySource = new Map<string, number>();
+  for (const d of descendants) bySource.set(d.node.source, (bySource.get(d.node.source) ?? 0) + 1);
+  if (bySource.size > 0) {
+    lines.push(`  by source: ${[...bySource].map(([source, n]) => `${source} ${n}`).join(", ")}`);
+  }
+  for (const d of descendants.slice(0, IMPACT_LIST_LIMIT)) {
+    lines.push(`  ${"  ".repeat(d.depth - 1)}${d.node.path}  [${d.node.entityClass}]  (${d.node.source})`);
+  }
+  if (descendants.length > IMPACT_LIST_LIMIT) {
+    lines.push(`  ... ${descendants.length - IMPACT_LIST_LIMIT} more`);
+  }
+
+  if (components.length > 0 && descendants.length > 0) {
+    lines.push("");
+    lines.push("=== Component Overrides ===");
+    lines.push("  Changes to a component here reach every descendant except values these descendants set themselves:");
+    for (const comp of components) {
+      const n = comp.overriddenBy.length;
+      lines.push(`  ${comp.typeName} {${comp.guid}}: ${n === 0 ? "not overridden" : `overridden by ${n}`}`);
+      for (const path of comp.overriddenBy.slice(0, 10)) lines.push(`    ${path}`);
+      if (n > 10) lines.push(`    ... ${n - 10} more`);
+    }
+    if (unread > 0) lines.push(`  (${unread} deeper descendants not checked)`);
+  }
+
+  return lines.join("\n");
+}
+
 // ── Registration ──────────────────────────────────────────────────────────────
 
 export function registerPrefab(server: McpServer, config: Config): void {
@@ -79,6 +122,9 @@ export function registerPrefab(server: McpServer, config: Config): void {
         "action=create: Create a new Entity Template (.et) prefab file for an Arma Reforger mod. Generates a properly structured prefab with components in valid Enfusion text serialization format. " +
         "When parentPrefab is provided, automatically resolves the full ancestor chain and pre-populates inherited components (set includeAncestry=false to skip). " +
         "IMPORTANT: For 'interactive' and other visible prefabs, the MeshObject component MUST have its 'Object' property set to a base game .xob model path (e.g., '{5F4C4181F065B447}Assets/Props/Military/Barrels/BarrelGreen_01.xob') or the entity will be invisible in-game. Use api_search to find model paths.\n\n" +
+        "action=impact: List every prefab that inherits from a prefab (across the project, extracted data and game paks) " +
+        "and which of them override each of its components — what a change to a base prefab will affect. " +
+        "The inheritance graph is built in the background and cached on disk; the first call may take a while on a large install.\n\n" +
         "action=inspect: Inspect an Arma Reforger prefab (.et file) and its full inheritance chain. " +
         "Reads each ancestor prefab, parses all components, and returns a fully merged view " +
         "showing which ancestor each component comes from. " +
@@ -86,8 +132,9 @@ export function registerPrefab(server: McpServer, config: Config): void {
         "Use this to understand the complete component set of a prefab, including all " +
         "inherited values not visible in the prefab file itself.",
       inputSchema: {
-        action: z.enum(["create", "inspect"]).describe(
-          "Action to perform: 'create' to generate a new prefab file, 'inspect' to view the full inheritance chain of an existing prefab."
+        action: z.enum(["create", "inspect", "impact"]).describe(
+          "Action to perform: 'create' to generate a new prefab file, 'inspect' to view the full inheritance chain of an existing prefab, " +
+          "'impact' to list the prefabs that inherit from it."
         ),
         // create params
         name: z
@@ -154,7 +201,7 @@ export function registerPrefab(server: McpServer, config: Config): void {
           ),
         // inspect params
         path: z.string().optional().describe(
-          "(inspect) Relative prefab path, e.g. 'Prefabs/Weapons/Handguns/M9/Handgun_M9.et'. " +
+          "(inspect, impact) Relative prefab path, e.g. 'Prefabs/Weapons/Handguns/M9/Handgun_M9.et'. " +
           "A leading {GUID} prefix is accepted and stripped automatically."
         ),
         include_raw: z.boolean().default(false).describe(
@@ -169,6 +216,8 @@ export function registerPrefab(server: McpServer, config: Config): void {
     },
     async (params) => {
       const { action } = params;
+      // Start the inheritance graph early so impact queries find it built
+      getPrefabGraph(config, params.projectPath).warm();
 
       if (action === "create") {
         const { name, prefabType, variant, parentPrefab, components, description, includeAncestry, projectPath } = params;
@@ -207,10 +256,11 @@ export function registerPrefab(server: McpServer, config: Config): void {
           let ancestryNote = "";
 
           if (parentPrefab && includeAncestry) {
-            const { levels, warnings } = walkChain(parentPrefab, config, projectPath);
+            const { levels, warnings, components: resolved } = resolvePrefab(parentPrefab, config, projectPath);
             if (levels.length > 0) {
-              const merged = mergeAncestryComponents(levels);
-              ancestorComponents = Array.from(merged.values()).map(({ comp }) => ({
+              // Top-level only: nested sub-components are not valid entries of the components block
+              const topLevel = Array.from(resolved.values()).filter((comp) => comp.topLevel);
+              ancestorComponents = topLevel.map((comp) => ({
                 type: comp.typeName,
                 guid: comp.guid,
                 // Properties intentionally empty: components are listed as GUID-matched
@@ -264,6 +314,8 @@ export function registerPrefab(server: McpServer, config: Config): void {
             }
 
             writeFileSync(targetPath, content, "utf-8");
+            getResourceResolver(config, projectPath).invalidateProject();
+            getPrefabGraph(config, projectPath).invalidate();
 
             const variantTag = variant ? ` (variant: ${variant})` : "";
             return {
@@ -293,6 +345,29 @@ export function registerPrefab(server: McpServer, config: Config): void {
         }
       }
 
+      if (action === "impact") {
+        const { path: inputPath, projectPath } = params;
+        if (!inputPath) {
+          return {
+            content: [{ type: "text", text: "Error: 'path' is required for action=impact" }],
+            isError: true,
+          };
+        }
+        try {
+          const impact = await analyzePrefabImpact(inputPath, config, projectPath);
+          if (!impact) {
+            return {
+              content: [{ type: "text", text: `Prefab not found: ${inputPath}` }],
+              isError: true,
+            };
+          }
+          return { content: [{ type: "text", text: formatImpact(impact) }] };
+        } catch (e) {
+          const msg = e instanceof Error ? e.message : String(e);
+          return { content: [{ type: "text", text: `Error: ${msg}` }], isError: true };
+        }
+      }
+
       // action === "inspect"
       const { path: inputPath, include_raw, projectPath } = params;
 
@@ -304,7 +379,8 @@ export function registerPrefab(server: McpServer, config: Config): void {
           };
         }
 
-        const { levels, warnings } = walkChain(inputPath, config, projectPath);
+        const prefab = resolvePrefab(inputPath, config, projectPath);
+        const { levels, warnings } = prefab;
 
         if (levels.length === 0) {
           return {
@@ -320,7 +396,7 @@ export function registerPrefab(server: McpServer, config: Config): void {
         return {
           content: [{
             type: "text",
-            text: formatReport(levels, warnings, include_raw ?? false),
+            text: formatReport(prefab, include_raw ?? false),
           }],
         };
       } catch (e) {
@@ -1,19 +1,39 @@
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
+import { encodeComponentProperties } from "../workbench/bulk-create.js";
 import type { WorkbenchClient } from "../workbench/client.js";
 import { formatConnectionStatus, requireEditMode } from "../workbench/status.js";
 
+const MUTATING_COMPONENT_ACTIONS = new Set(["add", "remove", "bulkAdd", "bulkRemove"]);
+
+function formatBulkResult(action: string, componentClass: string, result: Record<string, unknown>): string {
+  const results = Array.isArray(result.results) ? (result.results as Record<string, unknown>[]) : [];
+  const lines = [`**${action} ${componentClass}** — ${result.status ?? "?"}\n`, String(result.message ?? "")];
+  const problems = results.filter((r) => r.status !== "ok" || r.message);
+  const okNames = results.filter((r) => r.status === "ok" && !r.message).map((r) => String(r.name));
+  if (okNames.length > 0) {
+    const shown = okNames.slice(0, 50).join(", ");
+    lines.push(`\n**Applied:** ${shown}${okNames.length > 50 ? `, ... (${okNames.length - 50} more)` : ""}`);
+  }
+  if (problems.length > 0) {
+    lines.push("\n**Other outcomes:**");
+    for (const r of problems.slice(0, 100)) lines.push(`- ${r.name || "(unnamed)"}: ${r.status} ${r.message ?? ""}`.trimEnd());
+    if (problems.length > 100) lines.push(`- ... ${problems.length - 100} more`);
+  }
+  return lines.join("\n");
+}
+
 export function registerWbComponent(server: McpServer, client: WorkbenchClient): void {
   server.registerTool(
     "wb_component",
     {
       description:
-        "Manage components on an entity in the World Editor. Add, remove, or list components attached to an entity. Add/remove only work in edit mode.",
+        "Manage components on entities in the World Editor. Add, remove, or list components attached to an entity, or bulkAdd/bulkRemove a component class across many entities (chosen by name list, current selection, class filter or prefab filter) in one undo step with per-entity outcomes. Add/remove only work in edit mode.",
       inputSchema: {
-        entityName: z.string().describe("Name of the target entity"),
+        entityName: z.string().optional().describe("Name of the target entity (add/remove/list)"),
         action: z
-          .enum(["add", "remove", "list"])
-          .describe("Action to perform: add a new component, remove an existing one, or list all components"),
+          .enum(["add", "remove", "list", "bulkAdd", "bulkRemove"])
+          .describe("Action to perform: add a new component, remove an existing one, list all components, or bulkAdd/bulkRemove across a selector"),
         componentClass: z
           .string()
           .optional()
@@ -22,16 +42,74 @@ export function registerWbComponent(server: McpServer, client: WorkbenchClient):
           .number()
           .optional()
           .describe("Component index for removal when multiple components of the same class exist"),
+        names: z.array(z.string()).optional().describe("bulk: explicit entity names"),
+        useSelection: z.boolean().default(false).describe("bulk: target the current World Editor selection"),
+        classFilter: z
+          .string()
+          .optional()
+          .describe("bulk: entity class substring. Narrows names/selection, or matches all entities when neither is given"),
+        prefabFilter: z
+          .string()
+          .optional()
+          .describe("bulk: prefab path substring (any ancestor). Narrows names/selection, or matches all entities"),
+        properties: z
+          .array(z.object({ property: z.string(), value: z.string() }))
+          .optional()
+          .describe("bulkAdd: initial values on the new component. property is relative to it, e.g. 'm_fRadius' or 'm_Settings.m_iCount'"),
+        skipExisting: z.boolean().default(true).describe("bulkAdd: skip entities that already have this component class"),
       },
     },
-    async ({ entityName, action, componentClass, componentIndex }) => {
-      if (action === "add" || action === "remove") {
+    async ({ entityName, action, componentClass, componentIndex, names, useSelection, classFilter, prefabFilter, properties, skipExisting }) => {
+      if (MUTATING_COMPONENT_ACTIONS.has(action)) {
         const modeErr = requireEditMode(client, `${action} component`);
         if (modeErr) {
           return { content: [{ type: "text" as const, text: modeErr + formatConnectionStatus(client) }] };
         }
       }
       try {
+        if (action === "bulkAdd" || action === "bulkRemove") {
+          if (!componentClass) {
+            return {
+              content: [{ type: "text" as const, text: `Error: \`componentClass\` is required for the "${action}" action.` }],
+              isError: true,
+            };
+          }
+          if (!names?.length && !useSelection && !classFilter && !prefabFilter) {
+            return {
+              content: [
+                {
+                  type: "text" as const,
+                  text: "Error: bulk actions need a selector — names, useSelection, classFilter or prefabFilter.",
+                },
+              ],
+              isError: true,
+            };
+          }
+
+          const result = await client.call<Record<string, unknown>>("EMCP_WB_Components", {
+            action,
+            componentClass,
+            names: (names ?? []).join("\n"),
+            useSelection,
+            classFilter: classFilter ?? "",
+            prefabFilter: prefabFilter ?? "",
+            properties: encodeComponentProperties(properties ?? []),
+            skipExisting,
+          });
+
+          return {
+            content: [{ type: "text" as const, text: formatBulkResult(action, componentClass, result) + formatConnectionStatus(client) }],
+            isError: result.status === "error",
+          };
+        }
+
+        if (!entityName) {
+          return {
+            content: [{ type: "text" as const, text: `Error: \`entityName\` is required for the "${action}" action.` }],
+            isError: true,
+          };
+        }
+
         if ((action === "add" || action === "remove") && !componentClass) {
           return {
             content: [
@@ -88,7 +166,7 @@ export function registerWbComponent(server: McpServer, client: WorkbenchClient):
           content: [
             {
               type: "text" as const,
-              text: `Error managing component on "${entityName}": ${msg}${formatConnectionStatus(client)}`,
+              text: `Error managing component on "${entityName ?? action}": ${msg}${formatConnectionStatus(client)}`,
             },
           ],
           isError: true,
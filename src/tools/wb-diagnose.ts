@@ -1,5 +1,6 @@
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import type { WorkbenchClient } from "../workbench/client.js";
+import { formatReadinessPhases } from "../workbench/readiness.js";
 
 export function registerWbDiagnose(server: McpServer, client: WorkbenchClient): void {
   server.registerTool(
@@ -83,6 +84,17 @@ export function registerWbDiagnose(server: McpServer, client: WorkbenchClient):
           break;
       }
 
+      // --- Launch readiness timings ---
+      if (r.lastLaunch) {
+        const l = r.lastLaunch;
+        lines.push("\n### Last Launch / Recovery");
+        lines.push(
+          `- **Result:** ${l.ready ? "READY" : `NOT READY (last probe: ${l.lastProbeError ?? "none"})`} after ${l.totalMs}ms, ${l.probes} probes`
+        );
+        lines.push(`- **Phases:** ${formatReadinessPhases(l)}`);
+        lines.push(l.logFile ? `- **Workbench log:** \`${l.logFile}\`` : "- **Workbench log:** not found (probe-only wait)");
+      }
+
       // --- Recommendations ---
       const problems: string[] = [];
       if (!r.bundledScripts.exists) {
@@ -2,6 +2,9 @@ import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
 import type { WorkbenchClient } from "../workbench/client.js";
 import { formatConnectionStatus, requireEditMode } from "../workbench/status.js";
+import { decodeEntityColumns, type ListedEntity } from "../workbench/columnar.js";
+import { encodeRecords } from "../workbench/records.js";
+import { bulkCreateEntities } from "../workbench/bulk-create.js";
 
 function formatEntityDetails(data: Record<string, unknown>): string {
   const lines: string[] = [];
@@ -35,27 +38,48 @@ function formatEntityDetails(data: Record<string, unknown>): string {
 
 function formatEntityList(data: Record<string, unknown>): string {
   const lines: string[] = [];
-  const entities = Array.isArray(data.entities) ? data.entities : [];
-  const total = typeof data.total === "number" ? data.total : entities.length;
+  const entities = decodeEntityColumns(data);
+  const nextCursor = typeof data.nextCursor === "string" ? data.nextCursor : "";
+
+  // Cursor pages carry no total (totalCount -1) — the server stops scanning at the page end
+  if (typeof data.totalCount === "number" && data.totalCount < 0) {
+    lines.push(`**Entities** (${entities.length} on this page)\n`);
+    for (const ent of entities) lines.push(formatListedEntity(ent));
+    lines.push(
+      nextCursor
+        ? `\n*More entities available. Pass cursor "${nextCursor}" for the next page.*`
+        : "\n*End of listing.*"
+    );
+    return lines.join("\n");
+  }
+
+  const total =
+    typeof data.totalCount === "number" ? data.totalCount : typeof data.total === "number" ? data.total : entities.length;
   const offset = typeof data.offset === "number" ? data.offset : 0;
 
   lines.push(`**Entities** (showing ${entities.length} of ${total}, offset ${offset})\n`);
 
   for (let i = 0; i < entities.length; i++) {
-    const ent = entities[i] as Record<string, unknown>;
-    const name = ent.name || "(unnamed)";
-    const prefab = ent.prefab ? ` [${ent.prefab}]` : "";
-    const pos = ent.position ? ` at ${ent.position}` : "";
-    lines.push(`${offset + i + 1}. **${name}**${prefab}${pos}`);
+    lines.push(`${offset + i + 1}. ${formatListedEntity(entities[i])}`);
   }
 
   if (total > offset + entities.length) {
-    lines.push(`\n*${total - offset - entities.length} more entities not shown. Use offset/limit to paginate.*`);
+    const hint = nextCursor ? ` or cursor "${nextCursor}"` : "";
+    lines.push(`\n*${total - offset - entities.length} more entities not shown. Use offset/limit${hint} to paginate.*`);
   }
 
   return lines.join("\n");
 }
 
+function formatListedEntity(ent: ListedEntity): string {
+  const name = ent.name || "(unnamed)";
+  const cls = ent.className ? ` (${ent.className})` : "";
+  const prefab = ent.prefab ? ` [${ent.prefab}]` : "";
+  const layer = ent.layerID !== undefined ? ` layer ${ent.layerID}` : "";
+  const pos = ent.position ? ` at ${ent.position}` : "";
+  return `**${name}**${cls}${prefab}${layer}${pos}`;
+}
+
 export function registerWbEntityTools(server: McpServer, client: WorkbenchClient): void {
   // wb_entity_create
   server.registerTool(
@@ -118,6 +142,79 @@ export function registerWbEntityTools(server: McpServer, client: WorkbenchClient
     }
   );
 
+  // wb_entity_bulk_create
+  server.registerTool(
+    "wb_entity_bulk_create",
+    {
+      description:
+        "Create many entities in one Workbench call and one undo step: each from a prefab with optional name, layer, position, rotation, parent (earlier in the batch or existing) and component properties. Use for layouts and scenario hierarchies instead of repeated wb_entity_create/wb_entity_modify calls. Only works in edit mode.",
+      inputSchema: {
+        entities: z
+          .array(
+            z.object({
+              prefab: z.string().describe("Prefab resource path"),
+              name: z.string().optional().describe("Entity name (required to be used as a parent or to set properties)"),
+              layerID: z.number().int().optional().describe("Target layer ID (default 0)"),
+              position: z.string().optional().describe("'x y z' — world position, or local to parent when parent is set"),
+              rotation: z.string().optional().describe("'pitch yaw roll' in degrees"),
+              parent: z.string().optional().describe("Parent entity name"),
+              properties: z
+                .array(
+                  z.object({
+                    property: z.string().describe("'Component.m_sProp', or 'm_sProp' for root entity properties"),
+                    value: z.string(),
+                  })
+                )
+                .optional(),
+            })
+          )
+          .min(1)
+          .max(2000)
+          .describe("Entities, created in order"),
+        atomic: z
+          .boolean()
+          .default(true)
+          .describe("If any entity fails to create or parent, remove everything created by this call"),
+      },
+    },
+    async ({ entities, atomic }) => {
+      const modeErr = requireEditMode(client, "bulk create entities");
+      if (modeErr) {
+        return { content: [{ type: "text" as const, text: modeErr + formatConnectionStatus(client) }] };
+      }
+      try {
+        const result = await bulkCreateEntities(client, entities, { atomic });
+
+        const lines = [`**Bulk Create** — ${result.message}\n`];
+        if (result.created.length > 0) {
+          lines.push("Created:", ...result.created.map((n) => `- ${n}`));
+        }
+        if (result.errors.length > 0) {
+          lines.push("", "**Errors:**");
+          for (const err of result.errors) {
+            lines.push(`- #${err.index} ${entities[err.index]?.name ?? entities[err.index]?.prefab ?? ""}: ${err.message}`);
+          }
+        }
+        if (result.propertyWarnings.length > 0) {
+          lines.push("", "**Property warnings:**", ...result.propertyWarnings.map((w) => `- ${w}`));
+        }
+        if (result.leftBehind.length > 0) {
+          lines.push("", "**Rollback could not delete** (still in the world):", ...result.leftBehind.map((n) => `- ${n}`));
+        }
+        return {
+          content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }],
+          isError: result.status === "error" ? true : undefined,
+        };
+      } catch (e) {
+        const msg = e instanceof Error ? e.message : String(e);
+        return {
+          content: [{ type: "text" as const, text: `Error in bulk create: ${msg}${formatConnectionStatus(client)}` }],
+          isError: true,
+        };
+      }
+    }
+  );
+
   // wb_entity_delete
   server.registerTool(
     "wb_entity_delete",
@@ -158,28 +255,71 @@ export function registerWbEntityTools(server: McpServer, client: WorkbenchClient
     "wb_entity_list",
     {
       description:
-        "List entities in the current world. Supports pagination and optional name filtering.",
+        "List entities in the current world. Filters by name, class, prefab ancestry, layer and bounding box run inside Workbench. Choose returned fields with `fields`. For walking a whole level, page with `cursor` (start with '*') — each page resumes where the last stopped.",
       inputSchema: {
         offset: z
           .number()
           .default(0)
-          .describe("Starting offset for pagination (default 0)"),
+          .describe("Starting offset for pagination (default 0). Ignored when cursor is set."),
         limit: z
           .number()
           .default(50)
           .describe("Maximum number of entities to return (default 50)"),
+        cursor: z
+          .string()
+          .optional()
+          .describe("Cursor paging: '*' for the first page, then the nextCursor from the previous page. Expires if entities are added or removed."),
         nameFilter: z
           .string()
           .optional()
           .describe("Filter entities by name substring (case-insensitive)"),
+        classFilter: z
+          .string()
+          .optional()
+          .describe("Filter by class name substring (case-insensitive)"),
+        prefabFilter: z
+          .string()
+          .optional()
+          .describe("Filter by prefab ancestry — substring of any prefab in the entity's inheritance chain (case-insensitive)"),
+        layerID: z.number().int().optional().describe("Only entities on this layer ID"),
+        bboxMin: z.string().optional().describe("Bounding box corner 'x y z' (with bboxMax)"),
+        bboxMax: z.string().optional().describe("Opposite bounding box corner 'x y z' (with bboxMin)"),
+        fields: z
+          .array(z.enum(["class", "position", "prefab", "layer"]))
+          .optional()
+          .describe("Columns to return besides the name (default: class, position). Fewer fields = faster on large levels."),
       },
     },
-    async ({ offset, limit, nameFilter }) => {
+    async ({ offset, limit, cursor, nameFilter, classFilter, prefabFilter, layerID, bboxMin, bboxMax, fields }) => {
       try {
-        const params: Record<string, unknown> = { offset, limit };
+        if ((bboxMin && !bboxMax) || (!bboxMin && bboxMax)) {
+          return {
+            content: [{ type: "text" as const, text: "Error: `bboxMin` and `bboxMax` must be given together." }],
+            isError: true,
+          };
+        }
+
+        // Columnar encoding avoids per-entity keys — decoded by formatEntityList
+        const params: Record<string, unknown> = { offset, limit, encoding: "columnar" };
+        if (cursor) params.cursor = cursor;
         if (nameFilter) params.nameFilter = nameFilter;
+        if (classFilter) params.classFilter = classFilter;
+        if (prefabFilter) params.prefabFilter = prefabFilter;
+        if (layerID !== undefined) params.layerID = String(layerID);
+        if (bboxMin && bboxMax) {
+          params.bboxMin = bboxMin;
+          params.bboxMax = bboxMax;
+        }
+        if (fields) params.fields = ["name", ...fields].join(",");
 
-        const result = await client.call<Record<string, unknown>>("EMCP_WB_ListEntities", params);
+        const result = await client.call<Record<string, unknown>>("EMCP_WB_ListEntities", params, { replaySafe: true });
+
+        if (result.status === "stale_cursor") {
+          return {
+            content: [{ type: "text" as const, text: `**Cursor expired**\n\n${result.message}${formatConnectionStatus(client)}` }],
+            isError: true,
+          };
+        }
 
         return {
           content: [{ type: "text" as const, text: formatEntityList(result) + formatConnectionStatus(client) }],
@@ -194,6 +334,78 @@ export function registerWbEntityTools(server: McpServer, client: WorkbenchClient
     }
   );
 
+  // wb_entity_query
+  server.registerTool(
+    "wb_entity_query",
+    {
+      description:
+        "Find entities by location in the World Editor: within a radius of a point, inside an axis-aligned box, or the k nearest to a point. Optional class and layer filters. Much faster than paging wb_entity_list and filtering positions.",
+      inputSchema: {
+        mode: z.enum(["radius", "box", "nearest"]).describe("radius: within radius of center; box: inside [min, max]; nearest: k closest to center"),
+        center: z.string().optional().describe("Center as 'x y z' (radius/nearest)"),
+        radius: z.number().positive().optional().describe("Search radius in meters (required for radius; optional cap for nearest)"),
+        min: z.string().optional().describe("Box corner as 'x y z' (box)"),
+        max: z.string().optional().describe("Opposite box corner as 'x y z' (box)"),
+        k: z.number().int().min(1).max(500).default(10).describe("Number of nearest entities (nearest)"),
+        classFilter: z.string().optional().describe("Only entities whose class name contains this (case-insensitive)"),
+        layerID: z.number().int().optional().describe("Only entities on this layer ID (see wb_layers)"),
+        horizontal: z.boolean().default(false).describe("Measure distance in XZ only and ignore Y for box bounds"),
+        limit: z.number().int().min(1).max(5000).default(200).describe("Maximum entities to return for radius/box (closest first)"),
+        refresh: z.boolean().default(false).describe("Force a rebuild of the spatial index (use after moving entities by hand in the editor)"),
+      },
+    },
+    async ({ mode, center, radius, min, max, k, classFilter, layerID, horizontal, limit, refresh }) => {
+      try {
+        if ((mode === "radius" || mode === "nearest") && !center) {
+          return {
+            content: [{ type: "text" as const, text: `Error: "center" is required for the "${mode}" mode.` }],
+            isError: true,
+          };
+        }
+        if (mode === "radius" && radius === undefined) {
+          return { content: [{ type: "text" as const, text: `Error: "radius" is required for the "radius" mode.` }], isError: true };
+        }
+        if (mode === "box" && (!min || !max)) {
+          return { content: [{ type: "text" as const, text: `Error: "min" and "max" are required for the "box" mode.` }], isError: true };
+        }
+
+        // Floats travel as strings — RegV float ignores JSON integers
+        const params: Record<string, unknown> = { mode, k, horizontal, limit, refresh };
+        if (center) params.center = center;
+        if (radius !== undefined) params.radius = String(radius);
+        if (min) params.min = min;
+        if (max) params.max = max;
+        if (classFilter) params.classFilter = classFilter;
+        if (layerID !== undefined) params.layerID = String(layerID);
+
+        const result = await client.call<Record<string, unknown>>("EMCP_WB_SpatialQuery", params, { replaySafe: true });
+        // Sorted by distance in Workbench, so a truncated radius/box page holds the closest matches
+        const entities = Array.isArray(result.entities) ? (result.entities as Record<string, unknown>[]) : [];
+
+        const total = typeof result.totalCount === "number" ? result.totalCount : entities.length;
+        const lines = [`**Spatial Query (${mode})** — ${entities.length} of ${total} entities\n`];
+        for (let i = 0; i < entities.length; i++) {
+          const e = entities[i];
+          const dist = typeof e.distance === "number" ? ` — ${e.distance.toFixed(1)} m` : "";
+          lines.push(`${i + 1}. **${e.name || "(unnamed)"}** (${e.className}) at ${e.position}${dist}`);
+        }
+        if (total > entities.length) {
+          lines.push(`\n*${total - entities.length} more not shown. Raise limit or narrow the query.*`);
+        }
+        if (result.kClamped === true) {
+          lines.push(`\n*k ${k} exceeds limit ${limit}; returned the ${limit} nearest. Raise limit for more.*`);
+        }
+        return { content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }] };
+      } catch (e) {
+        const msg = e instanceof Error ? e.message : String(e);
+        return {
+          content: [{ type: "text" as const, text: `Error querying entities: ${msg}${formatConnectionStatus(client)}` }],
+          isError: true,
+        };
+      }
+    }
+  );
+
   // wb_entity_inspect
   server.registerTool(
     "wb_entity_inspect",
@@ -229,7 +441,7 @@ export function registerWbEntityTools(server: McpServer, client: WorkbenchClient
           };
         }
 
-        const result = await client.call<Record<string, unknown>>("EMCP_WB_GetEntity", params);
+        const result = await client.call<Record<string, unknown>>("EMCP_WB_GetEntity", params, { replaySafe: true });
 
         const label = name || `index ${index}`;
         return {
@@ -398,6 +610,78 @@ export function registerWbEntityTools(server: McpServer, client: WorkbenchClient
     }
   );
 
+  // wb_entity_bulk_modify
+  server.registerTool(
+    "wb_entity_bulk_modify",
+    {
+      description:
+        "Apply many entity edits (move, rotate, rename, reparent, setProperty, clearProperty) in one Workbench call and one undo step. Returns a status per operation. Prefer this over repeated wb_entity_modify calls when editing more than a few entities. Only works in edit mode.",
+      inputSchema: {
+        ops: z
+          .array(
+            z.object({
+              name: z.string().describe("Name of the entity to modify"),
+              action: z
+                .enum(["move", "rotate", "rename", "reparent", "setProperty", "clearProperty"])
+                .describe("Modification action, same semantics as wb_entity_modify"),
+              value: z
+                .string()
+                .optional()
+                .describe("'x y z' for move/rotate, new name for rename, parent name for reparent, property value for setProperty"),
+              propertyPath: z.string().optional().describe("Component property path for setProperty/clearProperty"),
+              propertyKey: z.string().optional().describe("Property key for setProperty/clearProperty"),
+            })
+          )
+          .min(1)
+          .max(5000)
+          .describe("Operations, applied in order"),
+        stopOnError: z
+          .boolean()
+          .default(false)
+          .describe("Skip the remaining operations after the first failure (already-applied operations are kept)"),
+      },
+    },
+    async ({ ops, stopOnError }) => {
+      const modeErr = requireEditMode(client, "bulk modify entities");
+      if (modeErr) {
+        return { content: [{ type: "text" as const, text: modeErr + formatConnectionStatus(client) }] };
+      }
+      try {
+        const payload = encodeRecords(
+          ops.map((op) => [op.action, op.name, op.value, op.propertyPath, op.propertyKey])
+        );
+
+        const result = await client.call<Record<string, unknown>>("EMCP_WB_BulkModifyEntity", {
+          ops: payload,
+          stopOnError,
+        });
+
+        const results = Array.isArray(result.results) ? (result.results as Record<string, unknown>[]) : [];
+        const failed = results.filter((r) => r.status !== "ok");
+        const skipped = results.filter((r) => r.status === "skipped").length;
+        const lines = [
+          `**Bulk Modify** — ${result.okCount ?? 0} ok, ${result.errorCount ?? 0} failed, ${skipped} skipped (${ops.length} ops, one undo step)`,
+        ];
+        if (failed.length > 0) {
+          lines.push("", "| # | Entity | Action | Status | Message |", "|---|---|---|---|---|");
+          for (const r of failed) {
+            lines.push(`| ${r.index} | ${r.name || "(unnamed)"} | ${r.action} | ${r.status} | ${r.message || ""} |`);
+          }
+        }
+        return {
+          content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }],
+          isError: result.status === "error" ? true : undefined,
+        };
+      } catch (e) {
+        const msg = e instanceof Error ? e.message : String(e);
+        return {
+          content: [{ type: "text" as const, text: `Error in bulk modify: ${msg}${formatConnectionStatus(client)}` }],
+          isError: true,
+        };
+      }
+    }
+  );
+
   // wb_entity_select
   server.registerTool(
     "wb_entity_select",
@@ -430,11 +714,12 @@ export function registerWbEntityTools(server: McpServer, client: WorkbenchClient
 
         const params: Record<string, unknown> = { action };
         if (name) params.name = name;
+        if (action === "getSelected") params.encoding = "columnar";
 
         const result = await client.call<Record<string, unknown>>("EMCP_WB_SelectEntity", params);
 
         if (action === "getSelected") {
-          const selected = Array.isArray(result.selected) ? result.selected : [];
+          const selected = decodeEntityColumns(result, "selectedEntities");
           if (selected.length === 0) {
             return {
               content: [{ type: "text" as const, text: `**No entities selected.**${formatConnectionStatus(client)}` }],
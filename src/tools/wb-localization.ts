@@ -1,6 +1,13 @@
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
 import type { WorkbenchClient } from "../workbench/client.js";
+import {
+  exportLocalizationTable,
+  importLocalizationRows,
+  parseCsv,
+  toCsv,
+  type LocalizationRow,
+} from "../workbench/localization.js";
 import { formatConnectionStatus, requireEditMode } from "../workbench/status.js";
 
 export function registerWbLocalization(server: McpServer, client: WorkbenchClient): void {
@@ -8,12 +15,12 @@ export function registerWbLocalization(server: McpServer, client: WorkbenchClien
     "wb_localization",
     {
       description:
-        "Manage localization entries in the Workbench Localization Editor. Insert, delete, or modify string table entries, or get the full localization table.",
+        "Manage localization entries in the Workbench Localization Editor. Insert, delete, or modify string table entries, or get the full localization table. For many rows use exportTable (whole table as CSV or JSON) and importRows (upsert a CSV/JSON table in one undo step — only rows that differ from the current table are sent).",
       inputSchema: {
         action: z
-          .enum(["insert", "delete", "modify", "getTable", "listLanguages"])
+          .enum(["insert", "delete", "modify", "getTable", "listLanguages", "exportTable", "importRows"])
           .describe(
-            "Action: insert (add new entry), delete (remove entry), modify (update entry), getTable (list all entries), listLanguages (list available language columns)"
+            "Action: insert (add new entry), delete (remove entry), modify (update entry), getTable (list all entries), listLanguages (list available language columns), exportTable (dump table), importRows (bulk upsert)"
           ),
         itemId: z
           .string()
@@ -27,12 +34,27 @@ export function registerWbLocalization(server: McpServer, client: WorkbenchClien
           .string()
           .optional()
           .describe("Value to set for insert/modify"),
+        format: z.enum(["csv", "json"]).default("csv").describe("exportTable output format"),
+        columns: z
+          .array(z.string())
+          .optional()
+          .describe("exportTable: property columns (default Id, en_us, target, comment; ['*'] = all)"),
+        rows: z
+          .array(z.record(z.string(), z.string()))
+          .optional()
+          .describe("importRows: items as objects, e.g. [{ Id: 'MyMod_Title', en_us: 'Title', comment: '' }]"),
+        csv: z.string().optional().describe("importRows: CSV table with a header row whose first column is Id (alternative to rows)"),
+        deleteMissing: z
+          .boolean()
+          .default(false)
+          .describe("importRows: delete items that exist in the table but not in the import (refused when the import is empty)"),
+        dryRun: z.boolean().default(false).describe("importRows: report what would change without writing"),
       },
     },
-    async ({ action, itemId, property, value }) => {
+    async ({ action, itemId, property, value, format, columns, rows, csv, deleteMissing, dryRun }) => {
       try {
         // Mutating actions require edit mode
-        const MUTATING_ACTIONS = ["insert", "delete", "modify"];
+        const MUTATING_ACTIONS = dryRun ? ["insert", "delete", "modify"] : ["insert", "delete", "modify", "importRows"];
         if (MUTATING_ACTIONS.includes(action)) {
           const modeErr = requireEditMode(client, `${action} localization entry`);
           if (modeErr) {
@@ -40,6 +62,57 @@ export function registerWbLocalization(server: McpServer, client: WorkbenchClien
           }
         }
 
+        if (action === "exportTable") {
+          const table = await exportLocalizationTable(client, columns?.join(",") ?? "");
+          const body =
+            format === "json" ? JSON.stringify(table.rows, null, 2) : toCsv(table.columns, table.rows);
+          return {
+            content: [
+              {
+                type: "text" as const,
+                text: `**Localization Table** (${table.rows.length} of ${table.tableItemCount} items)\n\n\`\`\`${format}\n${body}\n\`\`\`${formatConnectionStatus(client)}`,
+              },
+            ],
+          };
+        }
+
+        if (action === "importRows") {
+          const desired: LocalizationRow[] = rows ?? (csv !== undefined ? parseCsv(csv) : []);
+          if (desired.length === 0) {
+            const text =
+              rows === undefined && csv === undefined
+                ? "Error: `rows` or `csv` is required for the importRows action."
+                : "Error: the import has no rows (empty `rows` or a header-only `csv`); nothing to import.";
+            return {
+              content: [{ type: "text" as const, text }],
+              isError: true,
+            };
+          }
+
+          const { diff, result } = await importLocalizationRows(client, desired, { deleteMissing, dryRun });
+          const lines = [
+            dryRun ? "**Localization Import (dry run)**\n" : "**Localization Import**\n",
+            `- **Rows in import:** ${desired.length}`,
+            `- **Changed/new:** ${diff.changed.length}`,
+            `- **Already up to date:** ${diff.unchanged}`,
+          ];
+          if (diff.deleteIds.length > 0) lines.push(`- **To delete:** ${diff.deleteIds.length}`);
+          if (dryRun && diff.changed.length > 0) {
+            lines.push("", ...diff.changed.slice(0, 50).map((r) => `- ${r.Id}`));
+            if (diff.changed.length > 50) lines.push(`- ... ${diff.changed.length - 50} more`);
+          }
+          if (result) {
+            lines.push("", result.message);
+            for (const err of result.errors.slice(0, 50)) lines.push(`- ${err.id || "(no id)"}: ${err.message}`);
+          } else if (!dryRun) {
+            lines.push("", "Nothing to send — table already matches.");
+          }
+          return {
+            content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }],
+            isError: result?.status === "error",
+          };
+        }
+
         if ((action === "insert" || action === "delete" || action === "modify") && !itemId) {
           return {
             content: [
@@ -8,7 +8,7 @@ export function registerWbResources(server: McpServer, client: WorkbenchClient):
     "wb_resources",
     {
       description:
-        "Manage Workbench resources. Register new resources, rebuild resource databases, get resource info, or open a resource in its editor.",
+        "Manage Workbench resources. Register new resources, rebuild resource databases, get resource info, open a resource in its editor, or browse Workbench's resource database (project + dependency addons) by folder, extension and name filter with paging.",
       inputSchema: {
         action: z
           .enum(["register", "rebuild", "getInfo", "open", "browse"])
@@ -17,16 +17,28 @@ export function registerWbResources(server: McpServer, client: WorkbenchClient):
           ),
         path: z
           .string()
+          .optional()
           .describe(
-            "Resource path or path prefix. Required for all actions. For browse: use a prefix like 'Prefabs/Characters/' to find matching resources."
+            "Resource path or path prefix. Required for all actions except browse. For browse: root folder like 'Prefabs/Characters' ('' = all addons)."
           ),
         buildRuntime: z
           .boolean()
           .optional()
           .describe("Build runtime data during register/rebuild (slower but ensures assets are ready)"),
+        extensions: z
+          .array(z.string())
+          .optional()
+          .describe("browse: file extensions without dot, e.g. ['et'] or ['c', 'conf']"),
+        filter: z.string().optional().describe("browse: case-insensitive substring of the resource path"),
+        offset: z.number().int().min(0).default(0).describe("browse: index of the first result (use nextOffset from the previous page)"),
+        limit: z.number().int().min(1).max(2000).default(200).describe("browse: page size"),
+        refresh: z
+          .boolean()
+          .default(false)
+          .describe("browse: re-run the search instead of using the per-session cache (after adding files outside register/rebuild)"),
       },
     },
-    async ({ action, path, buildRuntime }) => {
+    async ({ action, path, buildRuntime, extensions, filter, offset, limit, refresh }) => {
       try {
         // Mutating actions require edit mode
         if (action === "register" || action === "rebuild") {
@@ -37,26 +49,55 @@ export function registerWbResources(server: McpServer, client: WorkbenchClient):
         }
 
         if (action === "browse") {
-          const result = await client.call<Record<string, unknown>>("EMCP_WB_Resources", { action, path });
+          const result = await client.call<Record<string, unknown>>("EMCP_WB_Resources", {
+            action,
+            path: path ?? "",
+            extensions: (extensions ?? []).join(","),
+            filter: filter ?? "",
+            offset,
+            limit,
+            refresh,
+          });
+          if (result.status === "error") {
+            return {
+              content: [{ type: "text" as const, text: `Error browsing resources: ${result.message}${formatConnectionStatus(client)}` }],
+              isError: true,
+            };
+          }
+
           const entries = Array.isArray(result.entries) ? result.entries : [];
           const total = typeof result.entryCount === "number" ? result.entryCount : entries.length;
+          const query = [path && `under \`${path}\``, extensions?.length && `*.${extensions.join("/*.")}`, filter && `"${filter}"`]
+            .filter(Boolean)
+            .join(", ");
 
           if (entries.length === 0) {
             return {
-              content: [{ type: "text" as const, text: `**No resources found** matching \`${path}\`\n\n${result.message || ""}${formatConnectionStatus(client)}` }],
+              content: [{ type: "text" as const, text: `**No resources found** ${query}\n\n${result.message || ""}${formatConnectionStatus(client)}` }],
             };
           }
-          const lines = [`**Resources matching \`${path}\`** (${entries.length} of ${total})\n`];
+          const first = Number(result.offset ?? offset);
+          const lines = [
+            `**Resources ${query}** (${first + 1}-${first + entries.length} of ${total}${result.cached ? ", cached" : ""})\n`,
+          ];
           for (const entry of entries) {
             const e = entry as Record<string, unknown>;
-            lines.push(`- \`${e.path}\` *(${e.type || "?"})*`);
+            lines.push(`- \`${e.resourceName || e.path}\` *(${e.type || "?"})*`);
           }
-          if (total > entries.length) {
-            lines.push(`\n*${total - entries.length} more not shown (cap 200).*`);
+          const nextOffset = Number(result.nextOffset ?? -1);
+          if (nextOffset >= 0) {
+            lines.push(`\n*${total - nextOffset} more — call again with offset=${nextOffset}.*`);
           }
           return { content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }] };
         }
 
+        if (!path) {
+          return {
+            content: [{ type: "text" as const, text: `Error: \`path\` is required for the "${action}" action.` }],
+            isError: true,
+          };
+        }
+
         if (action === "getInfo") {
           // Use built-in GetResourceInfo handler
           const result = await client.call<Record<string, unknown>>("GetResourceInfo", {
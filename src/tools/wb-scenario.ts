@@ -1,7 +1,8 @@
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
-import type { WorkbenchClient } from "../workbench/client.js";
+import { WorkbenchError, type WorkbenchClient } from "../workbench/client.js";
 import { requireEditMode, formatConnectionStatus } from "../workbench/status.js";
+import { bulkCreateEntities, type BulkCreateResult, type BulkEntitySpec } from "../workbench/bulk-create.js";
 
 const SF = "Prefabs/Systems/ScenarioFramework/Components";
 
@@ -35,39 +36,42 @@ const SLOT_AI_PREFAB = `{8D43830F02C3F114}${SF}/SlotAI.et`;
 // Shared helpers for WB scenario tools
 // ---------------------------------------------------------------------------
 
-/** Delete all entities in the placed list (best-effort cleanup on failure). */
-async function cleanupEntities(client: WorkbenchClient, placed: string[]): Promise<string[]> {
-  const cleaned: string[] = [];
-  for (const entityName of placed) {
-    try {
-      await client.call("EMCP_WB_DeleteEntity", { name: entityName });
-      cleaned.push(entityName);
-    } catch { /* Entity might not exist */ }
+/** A scenario batch that failed in Workbench, with what its rollback reported. */
+class ScenarioBatchError extends Error {
+  constructor(message: string, readonly result: BulkCreateResult) {
+    super(message);
+    this.name = "ScenarioBatchError";
   }
-  return cleaned;
 }
 
-/** Set a component property via WB API. Collects warnings for properties that can't be set. */
-async function setEntityProp(
-  client: WorkbenchClient,
-  warnings: string[],
-  entityName: string,
-  componentDotProp: string,
-  value: string,
-): Promise<void> {
-  const dot = componentDotProp.lastIndexOf(".");
-  const propertyPath = dot === -1 ? "" : componentDotProp.slice(0, dot);
-  let propertyKey    = dot === -1 ? componentDotProp : componentDotProp.slice(dot + 1);
-  // Strip surrounding quotes from property key (Enfusion file format uses "faction affiliation" style keys)
-  if (propertyKey.startsWith('"') && propertyKey.endsWith('"')) {
-    propertyKey = propertyKey.slice(1, -1);
+/** Create the whole entity set in one call and undo step; fails as a unit (see rollbackNote). */
+async function createScenarioEntities(client: WorkbenchClient, specs: BulkEntitySpec[]): Promise<BulkCreateResult> {
+  const result = await bulkCreateEntities(client, specs, { atomic: true });
+  if (result.errors.length > 0 || result.status === "error") {
+    const detail = result.errors.map((e) => `${specs[e.index]?.name ?? `#${e.index}`}: ${e.message}`).join("; ");
+    throw new ScenarioBatchError(detail ? `${result.message}. ${detail}` : result.message, result);
+  }
+  return result;
+}
+
+/** What a failed scenario_create left in the world, from the handler's rollback report. */
+function rollbackNote(e: unknown): string {
+  if (e instanceof ScenarioBatchError) {
+    const { result } = e;
+    if (result.leftBehind.length > 0) {
+      return `Rollback incomplete — still in the world: ${result.leftBehind.join(", ")}. Delete them or use Undo in Workbench.`;
+    }
+    if (result.rolledBack) {
+      return `Rolled back ${result.rolledBackCount} created entit${result.rolledBackCount === 1 ? "y" : "ies"} — nothing was left in the world.`;
+    }
+    if (result.created.length > 0) return `Left in the world: ${result.created.join(", ")}.`;
+    return "No entities were created.";
   }
-  const res = await client.call<Record<string, unknown>>("EMCP_WB_ModifyEntity", {
-    action: "setProperty", name: entityName, propertyPath, propertyKey, value,
-  });
-  if (res.status !== "ok") {
-    warnings.push(`  ${entityName} ${componentDotProp} = ${value}  (${String(res.message ?? "failed")})`);
+  // The call may have run in Workbench without an answer reaching us
+  if (e instanceof WorkbenchError && (e.code === "TIMEOUT" || e.code === "PROTOCOL_ERROR")) {
+    return "Workbench did not answer — the batch may have run. Check the World Editor hierarchy (Undo reverts it as one step).";
   }
+  return "No entities were created.";
 }
 
 /** Resolve position — use provided value, or query current camera position. */
@@ -77,7 +81,11 @@ async function resolvePosition(
   toolName: string,
 ): Promise<{ position: string } | { error: string }> {
   if (position) return { position };
-  const camRes = await client.call<{ status: string; position?: string; message?: string }>("EMCP_WB_GetCameraPos", {});
+  const camRes = await client.call<{ status: string; position?: string; message?: string }>(
+    "EMCP_WB_GetCameraPos",
+    {},
+    { replaySafe: true }
+  );
   if (camRes.status === "ok" && camRes.position) {
     return { position: camRes.position };
   }
@@ -94,7 +102,7 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
   const CONFLICT_SPAWN_PREFAB  = "{E7F4D5562F48DDE4}Prefabs/MP/Spawning/SpawnPoint_Base.et";
 
   // Faction-specific patrol prefabs (faction affiliation pre-baked — no property setting needed)
-  // FIA has a known faction-specific GUID; US/USSR use base + property set via fixed setEntityProp
+  // FIA has a known faction-specific GUID; US/USSR use base + property set via the bulk create properties
   const PATROL_PREFAB_BY_FACTION: Record<string, string> = {
     FIA: "{9273AB931008C271}Prefabs/Systems/AmbientPatrol/AmbientPatrolSpawnpoint_FIA.et",
   };
@@ -222,9 +230,6 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
           slot:      `${taskName}_Slot`,
           slotAI:    `${taskName}_SlotAI`,
         };
-        const placed: string[] = [];
-        const propWarnings: string[] = [];
-
         const posResult = await resolvePosition(client, position, "scenario_create");
         if ("error" in posResult) {
           return { content: [{ type: "text" as const, text: posResult.error }] };
@@ -232,51 +237,47 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
         const resolvedPosition = posResult.position;
 
         try {
-          // 1. Place Area at position
-          await client.call("EMCP_WB_CreateEntity", { prefab: AREA_PREFAB, name: names.area, position: resolvedPosition });
-          placed.push(names.area);
-
-          // 2-5. Place children at world origin, reparent with transformChildToParentSpace=false
-          // so their local coords stay 0 0 0 (at parent's origin).
-          await client.call("EMCP_WB_CreateEntity", { prefab: p.layerTask, name: names.layerTask });
-          placed.push(names.layerTask);
-          await client.call("EMCP_WB_ModifyEntity", { action: "reparent", name: names.layerTask, value: names.area });
-
+          // Children are parented with local coords 0 0 0 (at the parent's origin).
           // SlotKill/SlotClearArea/SlotDestroy must be a DIRECT child of LayerTask (not inside Layer_AI).
           // GetSlotTask() only searches direct children of LayerTask for SCR_ScenarioFrameworkSlotTask.
-          await client.call("EMCP_WB_CreateEntity", { prefab: p.slot, name: names.slot });
-          placed.push(names.slot);
-          await client.call("EMCP_WB_ModifyEntity", { action: "reparent", name: names.slot, value: names.layerTask });
-
-          await client.call("EMCP_WB_CreateEntity", { prefab: LAYER_PREFAB, name: names.layerAI });
-          placed.push(names.layerAI);
-          await client.call("EMCP_WB_ModifyEntity", { action: "reparent", name: names.layerAI, value: names.layerTask });
-
-          await client.call("EMCP_WB_CreateEntity", { prefab: SLOT_AI_PREFAB, name: names.slotAI });
-          placed.push(names.slotAI);
-          await client.call("EMCP_WB_ModifyEntity", { action: "reparent", name: names.slotAI, value: names.layerAI });
-
-          // 6. Wire properties — Area trigger (m_fAreaRadius confirmed from game sample layers)
-          await setEntityProp(client, propWarnings, names.area, "SCR_ScenarioFrameworkArea.m_fAreaRadius", String(triggerRadius));
-
-          // 7. Wire properties — LayerTask title/description/faction
-          await setEntityProp(client, propWarnings, names.layerTask, `${p.layerComp}.m_sTaskTitle`, taskName);
-          await setEntityProp(client, propWarnings, names.layerTask, `${p.layerComp}.m_sTaskDescription`, description);
+          const layerTaskProps = [
+            { property: `${p.layerComp}.m_sTaskTitle`, value: taskName },
+            { property: `${p.layerComp}.m_sTaskDescription`, value: description },
+          ];
           if (faction) {
-            await setEntityProp(client, propWarnings, names.layerTask, `${p.layerComp}.m_sFactionKey`, faction);
+            layerTaskProps.push({ property: `${p.layerComp}.m_sFactionKey`, value: faction });
           }
 
-          // 8. Wire Slot — what to spawn / kill
-          // targetPrefab must be a character prefab for kill type (group prefab causes NULL pointer crash in SCR_TaskKill.OnGroupEmpty)
-          await setEntityProp(client, propWarnings, names.slot, `${p.slotComp}.m_sObjectToSpawn`, targetPrefab);
-          // Give the target a wait waypoint so it stands in place
-          await setEntityProp(client, propWarnings, names.slot, `${p.slotComp}.m_sWPToSpawn`, "{531EC45063C1F57B}Prefabs/AI/Waypoints/AIWaypoint_Wait.et");
-          // Activate only when player enters the area trigger (not on mission start)
-          await setEntityProp(client, propWarnings, names.slot, `${p.slotComp}.m_eActivationType`, "ON_TRIGGER_ACTIVATION");
-
-          // 9. Wire SlotAI — group to spawn, also trigger-activated
-          await setEntityProp(client, propWarnings, names.slotAI, "SCR_ScenarioFrameworkSlotAI.m_sObjectToSpawn", aiGroupPrefab);
-          await setEntityProp(client, propWarnings, names.slotAI, "SCR_ScenarioFrameworkSlotAI.m_eActivationType", "ON_TRIGGER_ACTIVATION");
+          const result = await createScenarioEntities(client, [
+            {
+              prefab: AREA_PREFAB, name: names.area, position: resolvedPosition,
+              // Area trigger (m_fAreaRadius confirmed from game sample layers)
+              properties: [{ property: "SCR_ScenarioFrameworkArea.m_fAreaRadius", value: String(triggerRadius) }],
+            },
+            { prefab: p.layerTask, name: names.layerTask, parent: names.area, properties: layerTaskProps },
+            {
+              prefab: p.slot, name: names.slot, parent: names.layerTask,
+              properties: [
+                // targetPrefab must be a character prefab for kill type (group prefab causes NULL pointer crash in SCR_TaskKill.OnGroupEmpty)
+                { property: `${p.slotComp}.m_sObjectToSpawn`, value: targetPrefab },
+                // Give the target a wait waypoint so it stands in place
+                { property: `${p.slotComp}.m_sWPToSpawn`, value: "{531EC45063C1F57B}Prefabs/AI/Waypoints/AIWaypoint_Wait.et" },
+                // Activate only when player enters the area trigger (not on mission start)
+                { property: `${p.slotComp}.m_eActivationType`, value: "ON_TRIGGER_ACTIVATION" },
+              ],
+            },
+            { prefab: LAYER_PREFAB, name: names.layerAI, parent: names.layerTask },
+            {
+              prefab: SLOT_AI_PREFAB, name: names.slotAI, parent: names.layerAI,
+              // Group to spawn, also trigger-activated
+              properties: [
+                { property: "SCR_ScenarioFrameworkSlotAI.m_sObjectToSpawn", value: aiGroupPrefab },
+                { property: "SCR_ScenarioFrameworkSlotAI.m_eActivationType", value: "ON_TRIGGER_ACTIVATION" },
+              ],
+            },
+          ]);
+          const placed = result.created;
+          const propWarnings = result.propertyWarnings.map((w) => `  ${w}`);
 
           const lines = [
             `**Objective created: ${taskName}**`,
@@ -318,7 +319,6 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
 
         } catch (e) {
           const msg = e instanceof Error ? e.message : String(e);
-          const cleaned = await cleanupEntities(client, placed);
           return {
             content: [{
               type: "text" as const,
@@ -326,9 +326,7 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
                 `**scenario_create (objective) failed**`,
                 `Error: ${msg}`,
                 ``,
-                cleaned.length > 0
-                  ? `Cleaned up ${cleaned.length} entities: ${cleaned.join(", ")}`
-                  : "No entities needed cleanup.",
+                rollbackNote(e),
               ].join("\n") + formatConnectionStatus(client),
             }],
             isError: true,
@@ -354,9 +352,6 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
           };
         }
 
-        const placed: string[] = [];
-        const propWarnings: string[] = [];
-
         const posResult = await resolvePosition(client, position, "scenario_create");
         if ("error" in posResult) {
           return { content: [{ type: "text" as const, text: posResult.error }] };
@@ -375,43 +370,49 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
         };
 
         try {
-          // 1. Place base entity
-          await client.call("EMCP_WB_CreateEntity", { prefab: CONFLICT_BASE_PREFAB, name: names.base, position: resolvedPosition });
-          placed.push(names.base);
+          const factionProp = { property: 'SCR_FactionAffiliationComponent."faction affiliation"', value: baseFaction };
 
-          // 2. Wire base properties
-          await setEntityProp(client, propWarnings, names.base, "SCR_CampaignMilitaryBaseComponent.m_sBaseName", baseName);
-          await setEntityProp(client, propWarnings, names.base, 'SCR_FactionAffiliationComponent."faction affiliation"', baseFaction);
+          // 1. Base entity and its properties
+          const baseProps = [
+            { property: "SCR_CampaignMilitaryBaseComponent.m_sBaseName", value: baseName },
+            factionProp,
+          ];
           if (baseType === "MOB") {
-            await setEntityProp(client, propWarnings, names.base, "SCR_CampaignMilitaryBaseComponent.m_bCanBeHQ", "1");
-            await setEntityProp(client, propWarnings, names.base, "SCR_CampaignMilitaryBaseComponent.m_bDisableWhenUnusedAsHQ", "1");
-            await setEntityProp(client, propWarnings, names.base, "SCR_CoverageRadioComponent.m_bIsSource", "1");
-            await setEntityProp(client, propWarnings, names.base, "SCR_CampaignSeizingComponent.Enabled", "0");
+            baseProps.push(
+              { property: "SCR_CampaignMilitaryBaseComponent.m_bCanBeHQ", value: "1" },
+              { property: "SCR_CampaignMilitaryBaseComponent.m_bDisableWhenUnusedAsHQ", value: "1" },
+              { property: "SCR_CoverageRadioComponent.m_bIsSource", value: "1" },
+              { property: "SCR_CampaignSeizingComponent.Enabled", value: "0" },
+            );
           }
+          const specs: BulkEntitySpec[] = [
+            { prefab: CONFLICT_BASE_PREFAB, name: names.base, position: resolvedPosition, properties: baseProps },
+          ];
 
-          // 3. Place patrol spawnpoints around base
+          // 2. Patrol spawnpoints around base
           // Use faction-specific prefab where available (faction pre-baked), otherwise base + property set
           const patrolPrefab = PATROL_PREFAB_BY_FACTION[baseFaction] ?? CONFLICT_PATROL_PREFAB_DEFAULT;
           const needsFactionProp = !(baseFaction in PATROL_PREFAB_BY_FACTION);
           const count = Math.min(Math.max(patrolCount, 0), 6);
-          const patrolNames: string[] = [];
           for (let i = 0; i < count; i++) {
             const [ox, oz] = PATROL_OFFSETS[i]!;
-            const patrolPos = `${px + ox} ${py} ${pz + oz}`;
-            const patrolName = `${baseName}_Patrol_${i + 1}`;
-            await client.call("EMCP_WB_CreateEntity", { prefab: patrolPrefab, name: patrolName, position: patrolPos });
-            placed.push(patrolName);
-            patrolNames.push(patrolName);
-            if (needsFactionProp) {
-              await setEntityProp(client, propWarnings, patrolName, 'SCR_FactionAffiliationComponent."faction affiliation"', baseFaction);
-            }
+            specs.push({
+              prefab: patrolPrefab,
+              name: `${baseName}_Patrol_${i + 1}`,
+              position: `${px + ox} ${py} ${pz + oz}`,
+              properties: needsFactionProp ? [factionProp] : undefined,
+            });
           }
 
-          // 4. Place spawn point
-          await client.call("EMCP_WB_CreateEntity", { prefab: CONFLICT_SPAWN_PREFAB, name: names.spawnPoint, position: resolvedPosition });
-          placed.push(names.spawnPoint);
-          // m_sFaction is a root entity property on SCR_SpawnPoint, not inside a component
-          await setEntityProp(client, propWarnings, names.spawnPoint, "m_sFaction", baseFaction);
+          // 3. Spawn point — m_sFaction is a root entity property on SCR_SpawnPoint, not inside a component
+          specs.push({
+            prefab: CONFLICT_SPAWN_PREFAB, name: names.spawnPoint, position: resolvedPosition,
+            properties: [{ property: "m_sFaction", value: baseFaction }],
+          });
+
+          const result = await createScenarioEntities(client, specs);
+          const placed = result.created;
+          const propWarnings = result.propertyWarnings.map((w) => `  ${w}`);
 
           const lines = [
             `**Conflict base created: ${baseName}**`,
@@ -449,7 +450,6 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
 
         } catch (e) {
           const msg = e instanceof Error ? e.message : String(e);
-          const cleaned = await cleanupEntities(client, placed);
           return {
             content: [{
               type: "text" as const,
@@ -457,9 +457,7 @@ export function registerScenarioTools(server: McpServer, client: WorkbenchClient
                 `**scenario_create (base) failed**`,
                 `Error: ${msg}`,
                 ``,
-                cleaned.length > 0
-                  ? `Cleaned up ${cleaned.length} entities: ${cleaned.join(", ")}`
-                  : "No entities needed cleanup.",
+                rollbackNote(e),
               ].join("\n") + formatConnectionStatus(client),
             }],
             isError: true,
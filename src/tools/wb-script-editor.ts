@@ -1,19 +1,54 @@
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
 import type { WorkbenchClient } from "../workbench/client.js";
+import {
+  applyScriptPatch,
+  getScriptRange,
+  replaceScriptRange,
+  setScriptContent,
+  splitLines,
+  type ScriptWriteResult,
+} from "../workbench/script-range.js";
 import { formatConnectionStatus, requireEditMode } from "../workbench/status.js";
 
+function formatWrite(label: string, result: ScriptWriteResult, client: WorkbenchClient) {
+  const ok = result.status === "ok";
+  const lines = [
+    ok ? `**${label}**` : `**${label} ${result.status === "conflict" ? "rejected (conflict)" : "failed"}**`,
+    "",
+    result.message,
+    `- **Lines:** ${result.linesCount}`,
+    `- **Content hash:** ${result.contentHash}`,
+  ];
+  return {
+    content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }],
+    isError: !ok,
+  };
+}
+
 export function registerWbScriptEditor(server: McpServer, client: WorkbenchClient): void {
   server.registerTool(
     "wb_script_editor",
     {
       description:
-        "Interact with the Workbench Script Editor. Get the current file, read/write individual lines, insert new lines, remove lines, or get the total line count.",
+        "Interact with the Workbench Script Editor. Get the current file, read/write individual lines, insert new lines, remove lines, or get the total line count. For more than a few lines use the block actions: getRange (read many lines + content hash), replaceRange (replace a line block), applyPatch (several hunks at once), setContent (replace the whole file, only changed lines are touched). Pass the contentHash from a read as expectedHash to refuse the write if the file changed meanwhile.",
       inputSchema: {
         action: z
-          .enum(["getCurrentFile", "getLine", "setLine", "insertLine", "removeLine", "getLinesCount", "openFile"])
+          .enum([
+            "getCurrentFile",
+            "getLine",
+            "setLine",
+            "insertLine",
+            "removeLine",
+            "getLinesCount",
+            "openFile",
+            "getRange",
+            "replaceRange",
+            "applyPatch",
+            "setContent",
+          ])
           .describe(
-            "Action: getCurrentFile (path of open file), getLine (read line N), setLine (overwrite line N), insertLine (insert before line N), removeLine (delete line N), getLinesCount (total lines), openFile (open file by path)"
+            "Action: getCurrentFile (path of open file), getLine (read line N), setLine (overwrite line N), insertLine (insert before line N), removeLine (delete line N), getLinesCount (total lines), openFile (open file by path), getRange/replaceRange/applyPatch/setContent (block operations)"
           ),
         line: z
           .number()
@@ -27,12 +62,42 @@ export function registerWbScriptEditor(server: McpServer, client: WorkbenchClien
           .string()
           .optional()
           .describe("File path for openFile action (e.g., 'Scripts/Game/MyScript.c')"),
+        startLine: z
+          .number()
+          .int()
+          .min(0)
+          .optional()
+          .describe("getRange/replaceRange: first line of the block, 0-based (default 0)"),
+        count: z
+          .number()
+          .int()
+          .min(0)
+          .optional()
+          .describe("getRange/replaceRange: number of lines in the block (default: to end of file)"),
+        content: z
+          .string()
+          .optional()
+          .describe("replaceRange: new lines for the block; setContent: full new file content"),
+        hunks: z
+          .array(
+            z.object({
+              line: z.number().int().min(0).describe("0-based first line to replace, against the file before the patch"),
+              removeCount: z.number().int().min(0).describe("Lines to remove at line (0 = pure insert)"),
+              content: z.string().describe("Replacement lines ('' = delete only)"),
+            })
+          )
+          .optional()
+          .describe("applyPatch: ascending, non-overlapping hunks"),
+        expectedHash: z
+          .string()
+          .optional()
+          .describe("replaceRange/applyPatch/setContent: contentHash from an earlier read; the write is refused if the file changed"),
       },
     },
-    async ({ action, line, text, path }) => {
+    async ({ action, line, text, path, startLine, count, content, hunks, expectedHash }) => {
       try {
         // Mutating actions require edit mode
-        const MUTATING_ACTIONS = ["setLine", "insertLine", "removeLine"];
+        const MUTATING_ACTIONS = ["setLine", "insertLine", "removeLine", "replaceRange", "applyPatch", "setContent"];
         if (MUTATING_ACTIONS.includes(action)) {
           const modeErr = requireEditMode(client, `${action} in script editor`);
           if (modeErr) {
@@ -68,6 +133,49 @@ export function registerWbScriptEditor(server: McpServer, client: WorkbenchClien
           };
         }
 
+        if (action === "getRange") {
+          const range = await getScriptRange(client, startLine ?? 0, count ?? -1);
+          const last = range.start + range.lines.length - 1;
+          return {
+            content: [
+              {
+                type: "text" as const,
+                text: `**Lines ${range.start}-${last}** of ${range.linesCount} (hash ${range.contentHash})\n\`\`\`\n${range.lines.join("\n")}\n\`\`\`${formatConnectionStatus(client)}`,
+              },
+            ],
+          };
+        }
+
+        if (action === "replaceRange" || action === "setContent") {
+          if (content === undefined) {
+            return {
+              content: [{ type: "text" as const, text: `Error: \`content\` is required for the "${action}" action.` }],
+              isError: true,
+            };
+          }
+          if (action === "setContent") {
+            const result = await setScriptContent(client, content, expectedHash ?? "");
+            return formatWrite(result.changed ? "File content replaced" : "File content unchanged", result, client);
+          }
+          const result = await replaceScriptRange(client, startLine ?? 0, count ?? -1, splitLines(content), expectedHash ?? "");
+          return formatWrite("Range replaced", result, client);
+        }
+
+        if (action === "applyPatch") {
+          if (!hunks?.length) {
+            return {
+              content: [{ type: "text" as const, text: `Error: \`hunks\` is required for the "applyPatch" action.` }],
+              isError: true,
+            };
+          }
+          const result = await applyScriptPatch(
+            client,
+            hunks.map((h) => ({ line: h.line, removeCount: h.removeCount, lines: splitLines(h.content) })),
+            expectedHash ?? ""
+          );
+          return formatWrite(`Patch applied (${hunks.length} hunks)`, result, client);
+        }
+
         if (action === "openFile" && !path) {
           return {
             content: [
@@ -0,0 +1,140 @@
+import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
+import { z } from "zod";
+import type { WorkbenchClient } from "../workbench/client.js";
+import { LevelSnapshot, type SnapshotEntity } from "../workbench/snapshot.js";
+import { formatConnectionStatus } from "../workbench/status.js";
+
+function formatSnapshotEntity(e: SnapshotEntity, withProps: boolean): string[] {
+  const lines = [`- **${e.name || "(unnamed)"}** (${e.class}) pos ${e.position || "?"}${e.parent ? ` parent ${e.parent}` : ""}`];
+  if (e.prefab) lines.push(`  prefab: ${e.prefab}`);
+  if (withProps) {
+    for (const [k, v] of Object.entries(e.props)) lines.push(`  ${k} = ${v}`);
+    for (const c of e.components) {
+      lines.push(`  [${c.class}]`);
+      for (const [k, v] of Object.entries(c.props)) lines.push(`    ${k} = ${v}`);
+    }
+  } else if (e.components.length > 0) {
+    lines.push(`  components: ${e.components.map((c) => c.class).join(", ")}`);
+  }
+  return lines;
+}
+
+export function registerWbSnapshot(server: McpServer, client: WorkbenchClient): void {
+  // Last loaded snapshot; analysis runs against it until the next export/load
+  let snapshot: LevelSnapshot | undefined;
+
+  server.registerTool(
+    "wb_snapshot",
+    {
+      description:
+        "Export the whole open level (every entity with class, prefab, layer, transform, components and property values) to a JSON-lines file in one Workbench call, then query it locally. Use this instead of many wb_entity_inspect calls for level-wide analysis. Actions: export (dump and load), load (load an existing export file), query (filter entities), stats (counts grouped by class/prefab/component/layer/parent), get (one entity with all properties).",
+      inputSchema: {
+        action: z.enum(["export", "load", "query", "stats", "get"]).describe("Snapshot action"),
+        fileName: z
+          .string()
+          .optional()
+          .describe("export: file name inside the Workbench profile's EnfusionMCP folder (default snapshot.jsonl)"),
+        path: z.string().optional().describe("load: absolute path of an export file"),
+        onlySetProperties: z
+          .boolean()
+          .default(true)
+          .describe("export: only write properties set on the instance itself, not values inherited from the prefab"),
+        skipProperties: z.boolean().default(false).describe("export: write structure and transforms only"),
+        name: z.string().optional().describe("get: entity name"),
+        className: z.string().optional().describe("query/stats: entity class substring"),
+        prefab: z.string().optional().describe("query/stats: prefab path substring"),
+        component: z.string().optional().describe("query/stats: component class substring"),
+        property: z.string().optional().describe("query/stats: property name the entity or one of its components must have"),
+        value: z.string().optional().describe("query/stats: with property, substring of its value"),
+        layer: z.number().int().optional().describe("query/stats: layer ID"),
+        parent: z.string().optional().describe("query/stats: parent entity name ('' for root entities)"),
+        bboxMin: z.object({ x: z.number(), z: z.number() }).optional().describe("query/stats: XZ box corner"),
+        bboxMax: z.object({ x: z.number(), z: z.number() }).optional().describe("query/stats: opposite XZ box corner"),
+        groupBy: z
+          .enum(["class", "prefab", "component", "layer", "parent"])
+          .default("class")
+          .describe("stats: grouping key"),
+        limit: z.number().int().min(1).max(5000).default(100).describe("query/stats: max rows to print"),
+      },
+    },
+    async ({ action, fileName, path, onlySetProperties, skipProperties, name, groupBy, limit, ...filter }) => {
+      try {
+        if (action === "export" || action === "load") {
+          let filePath = path;
+          let exportMessage = "";
+          if (action === "export") {
+            const res = await client.call<Record<string, unknown>>("EMCP_WB_ExportSnapshot", {
+              fileName: fileName ?? "",
+              onlySetProperties,
+              skipProperties,
+            });
+            if (res.status !== "ok") {
+              return {
+                content: [{ type: "text" as const, text: `Error exporting snapshot: ${res.message ?? "unknown error"}${formatConnectionStatus(client)}` }],
+                isError: true,
+              };
+            }
+            filePath = String(res.path ?? "");
+            exportMessage = String(res.message ?? "");
+          }
+
+          if (!filePath) {
+            return {
+              content: [{ type: "text" as const, text: "load requires path (absolute path of an export file)" }],
+              isError: true,
+            };
+          }
+
+          snapshot = await LevelSnapshot.fromFile(filePath);
+          const lines = [
+            `**Snapshot loaded** from ${filePath}`,
+            `- Entities: ${snapshot.entities.length}${snapshot.header.entityCount ? ` (header: ${snapshot.header.entityCount})` : ""}`,
+          ];
+          if (snapshot.header.generation) lines.push(`- Generation: ${snapshot.header.generation}`);
+          if (snapshot.skippedLines > 0) lines.push(`- Skipped ${snapshot.skippedLines} malformed lines`);
+          if (exportMessage) lines.push(`\n${exportMessage}`);
+          return { content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }] };
+        }
+
+        if (!snapshot) {
+          return {
+            content: [{ type: "text" as const, text: "No snapshot loaded. Run wb_snapshot with action=export (or load) first." }],
+            isError: true,
+          };
+        }
+
+        if (action === "get") {
+          const entity = name ? snapshot.byName.get(name) : undefined;
+          if (!entity) {
+            return {
+              content: [{ type: "text" as const, text: `Entity not found in snapshot: ${name ?? "(no name given)"}` }],
+              isError: true,
+            };
+          }
+          return { content: [{ type: "text" as const, text: formatSnapshotEntity(entity, true).join("\n") }] };
+        }
+
+        const matches = snapshot.query(filter);
+
+        if (action === "stats") {
+          const rows = snapshot.countBy(groupBy, matches);
+          const lines = [`**${matches.length} entities by ${groupBy}** (${rows.length} groups)\n`];
+          for (const [key, count] of rows.slice(0, limit)) lines.push(`- ${count} × ${key}`);
+          if (rows.length > limit) lines.push(`\n... ${rows.length - limit} more groups`);
+          return { content: [{ type: "text" as const, text: lines.join("\n") }] };
+        }
+
+        const lines = [`**${matches.length} matching entities** (of ${snapshot.entities.length})\n`];
+        for (const e of matches.slice(0, limit)) lines.push(...formatSnapshotEntity(e, false));
+        if (matches.length > limit) lines.push(`\n... ${matches.length - limit} more (raise limit or narrow the filter)`);
+        return { content: [{ type: "text" as const, text: lines.join("\n") }] };
+      } catch (e) {
+        const msg = e instanceof Error ? e.message : String(e);
+        return {
+          content: [{ type: "text" as const, text: `Error in wb_snapshot: ${msg}${formatConnectionStatus(client)}` }],
+          isError: true,
+        };
+      }
+    }
+  );
+}
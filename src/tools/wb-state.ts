@@ -1,5 +1,7 @@
+import { z } from "zod";
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import type { WorkbenchClient } from "../workbench/client.js";
+import { collapseChanges, fetchChanges } from "../workbench/journal.js";
 import { formatConnectionStatus } from "../workbench/status.js";
 
 export function registerWbState(server: McpServer, client: WorkbenchClient): void {
@@ -12,7 +14,7 @@ export function registerWbState(server: McpServer, client: WorkbenchClient): voi
     },
     async () => {
       try {
-        const result = await client.call<Record<string, unknown>>("EMCP_WB_GetState");
+        const result = await client.call<Record<string, unknown>>("EMCP_WB_GetState", {}, { replaySafe: true });
 
         const lines: string[] = ["**Workbench State**\n"];
 
@@ -52,4 +54,80 @@ export function registerWbState(server: McpServer, client: WorkbenchClient): voi
       }
     }
   );
+
+  server.registerTool(
+    "wb_changes",
+    {
+      description:
+        "Poll the Workbench change journal for what changed since a sequence number, instead of re-listing the level. Covers creates, deletes, renames, moves, rotations, reparents and property edits made through MCP tools, plus creates/deletes/moves made in the editor GUI (detected by a rate-limited scan). Start with since=-1 to get the current seq and epoch, then pass nextSince and epoch back on each poll.",
+      inputSchema: {
+        since: z
+          .number()
+          .int()
+          .min(-1)
+          .default(0)
+          .describe("Last seq already seen. 0 = everything still in the journal, -1 = no events, just the current seq"),
+        epoch: z
+          .string()
+          .optional()
+          .describe("Journal epoch returned with since; a different current epoch means Workbench restarted or recompiled and reports a reset"),
+        limit: z.number().int().min(1).max(5000).default(500).describe("Max events to return"),
+        collapse: z
+          .boolean()
+          .default(false)
+          .describe("Fold events into one net change per entity (last move wins, renames chained, create+delete dropped)"),
+        forceDiff: z.boolean().default(false).describe("Rescan for GUI edits now instead of honoring the 1s rate limit"),
+      },
+    },
+    async ({ since, epoch, limit, collapse, forceDiff }) => {
+      try {
+        const page = await fetchChanges(client, { since, epoch, limit, forceDiff });
+        if (page.status !== "ok") {
+          return {
+            content: [{ type: "text" as const, text: `Error polling changes: ${page.message}${formatConnectionStatus(client)}` }],
+            isError: true,
+          };
+        }
+
+        const lines: string[] = [`**Changes** (seq ${since} -> ${page.nextSince}, latest ${page.latestSeq})\n`];
+
+        if (page.reset) {
+          lines.push(
+            (epoch && epoch !== page.epoch) || since > page.latestSeq
+              ? `Journal restarted (script recompile or Workbench restart) since seq ${since}. Resync with wb_entity_list, then poll with since=${page.latestSeq}, epoch=${page.epoch}.`
+              : `Journal no longer holds events after seq ${since} (oldest kept: ${page.oldestSeq}). Resync with wb_entity_list, then poll with since=${page.latestSeq}, epoch=${page.epoch}.`
+          );
+        } else if (page.events.length === 0) {
+          lines.push(since < 0 ? `Journal is at seq ${page.latestSeq}.` : "No changes.");
+        } else if (collapse) {
+          for (const d of collapseChanges(page.events)) {
+            const parts: string[] = [];
+            if (d.created) parts.push("created");
+            if (d.deleted) parts.push("deleted");
+            if (d.previousName) parts.push(`renamed from ${d.previousName}`);
+            if (d.position) parts.push(`pos ${d.position}`);
+            if (d.rotation) parts.push(`rot ${d.rotation}`);
+            if (d.parent) parts.push(`parent ${d.parent}`);
+            for (const p of d.properties) parts.push(p);
+            lines.push(`- **${d.name}**: ${parts.join("; ") || "modified"}`);
+          }
+        } else {
+          for (const e of page.events) {
+            lines.push(`- #${e.seq} ${e.type} **${e.name}**${e.detail ? ` ${e.detail}` : ""}`);
+          }
+        }
+
+        if (page.hasMore) lines.push(`\nMore changes pending — poll again with since=${page.nextSince}, epoch=${page.epoch}.`);
+        else lines.push(`\nNext poll: since=${page.nextSince}, epoch=${page.epoch}`);
+
+        return { content: [{ type: "text" as const, text: lines.join("\n") + formatConnectionStatus(client) }] };
+      } catch (e) {
+        const msg = e instanceof Error ? e.message : String(e);
+        return {
+          content: [{ type: "text" as const, text: `Error polling changes: ${msg}${formatConnectionStatus(client)}` }],
+          isError: true,
+        };
+      }
+    }
+  );
 }
@@ -2,17 +2,165 @@ import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
 import type { WorkbenchClient } from "../workbench/client.js";
 import { formatConnectionStatus } from "../workbench/status.js";
+import { encodeRecords } from "../workbench/records.js";
+import { TerrainTileCache, type HeightGrid } from "../workbench/terrain-cache.js";
+
+/** Largest sample set rendered inline; bigger results are summarized plus packed JSON. */
+const INLINE_SAMPLE_LIMIT = 200;
+
+/** Workbench's hard sample cap (EMCP_WB_Terrain HARD_MAX_SAMPLES). */
+const MAX_SAMPLES = 262_144;
+
+function numberArray(value: unknown): number[] {
+  return Array.isArray(value) ? value.map(Number) : [];
+}
+
+function heightStats(heights: number[]): string {
+  if (heights.length === 0) return "no samples";
+  let min = Infinity;
+  let max = -Infinity;
+  let sum = 0;
+  for (const h of heights) {
+    if (h < min) min = h;
+    if (h > max) max = h;
+    sum += h;
+  }
+  return `min ${min.toFixed(2)}, max ${max.toFixed(2)}, mean ${(sum / heights.length).toFixed(2)}`;
+}
+
+interface SampleArgs {
+  mode: "points" | "grid" | "polyline";
+  points?: { x: number; z: number }[];
+  min?: { x: number; z: number };
+  max?: { x: number; z: number };
+  step: number;
+  maxSamples: number;
+  exact: boolean;
+}
+
+async function sampleTerrain(client: WorkbenchClient, tileCache: TerrainTileCache, args: SampleArgs) {
+  const { mode, points, min, max, step, maxSamples, exact } = args;
+  const text = (body: string, isError?: boolean) => ({
+    content: [{ type: "text" as const, text: body + formatConnectionStatus(client) }],
+    ...(isError ? { isError: true } : {}),
+  });
+
+  if (mode === "points" && !exact) {
+    if (!points || points.length === 0) return text("Error: `points` is required for points sampling.", true);
+    const { heights, tilesFetched, tilesCached, pointsFetched } = await tileCache.sample(points);
+    const lines = [
+      `**Terrain Samples** — ${heights.length} points (${heightStats(heights)})`,
+      `Tiles: ${tilesFetched} fetched, ${tilesCached} from cache (${tileCache.size} held); ${pointsFetched} scattered points sampled directly\n`,
+    ];
+    if (heights.length <= INLINE_SAMPLE_LIMIT) {
+      points.forEach((p, i) => lines.push(`- (${p.x}, ${p.z}) → ${heights[i].toFixed(3)}`));
+    } else {
+      lines.push("```json", JSON.stringify({ heights: heights.map((h) => +h.toFixed(3)) }), "```");
+    }
+    return text(lines.join("\n"));
+  }
+
+  const params: Record<string, unknown> = { action: "sample", mode, maxSamples, step: String(step) };
+  if (mode === "grid") {
+    if (!min || !max) return text("Error: `min` and `max` are required for grid sampling.", true);
+    // Coarsening handles large grids, but a step this small for the span is almost certainly a mistake
+    const perAxis = Math.max(Math.abs(max.x - min.x), Math.abs(max.z - min.z)) / step;
+    if (perAxis > MAX_SAMPLES) {
+      return text(`Error: step ${step} m is too small for this area (${Math.round(perAxis)} samples per axis, limit ${MAX_SAMPLES}).`, true);
+    }
+    params.min = `${min.x} ${min.z}`;
+    params.max = `${max.x} ${max.z}`;
+  } else {
+    const minPoints = mode === "polyline" ? 2 : 1;
+    if (!points || points.length < minPoints) {
+      return text(`Error: \`points\` needs at least ${minPoints} entr${minPoints === 1 ? "y" : "ies"} for ${mode} sampling.`, true);
+    }
+    params.points = encodeRecords(points.map((p) => [p.x, p.z]));
+  }
+
+  const result = await client.call<Record<string, unknown>>("EMCP_WB_Terrain", params);
+  const heights = numberArray(result.heights);
+
+  if (mode === "grid") {
+    const stepUsed = Number(result.stepUsed);
+    const lines = [
+      `**Terrain Heightfield** — ${result.cols} x ${result.rows} samples at ${stepUsed} m from (${result.originX}, ${result.originZ}) (${heightStats(heights)})`,
+    ];
+    if (stepUsed > step) lines.push(`Step coarsened from ${step} m to stay under maxSamples (${maxSamples}).`);
+    lines.push(
+      "\nRow-major heights (z outer, x inner):",
+      "```json",
+      JSON.stringify({
+        originX: result.originX,
+        originZ: result.originZ,
+        step: stepUsed,
+        cols: result.cols,
+        rows: result.rows,
+        heights: heights.map((h) => +h.toFixed(3)),
+      }),
+      "```"
+    );
+    return text(lines.join("\n"));
+  }
+
+  const positions = numberArray(result.positions);
+  const lines = [`**Terrain Samples (${mode})** — ${heights.length} samples (${heightStats(heights)})\n`];
+  if (heights.length <= INLINE_SAMPLE_LIMIT) {
+    for (let i = 0; i < heights.length; i++) {
+      const px = mode === "polyline" ? positions[i * 2] : points![i].x;
+      const pz = mode === "polyline" ? positions[i * 2 + 1] : points![i].z;
+      lines.push(`- (${+px.toFixed(2)}, ${+pz.toFixed(2)}) → ${heights[i].toFixed(3)}`);
+    }
+  } else {
+    lines.push("```json", JSON.stringify({ positions, heights: heights.map((h) => +h.toFixed(3)) }), "```");
+  }
+  return text(lines.join("\n"));
+}
 
 export function registerWbTerrain(server: McpServer, client: WorkbenchClient): void {
+  // Tiles and scattered points for the cache both go through the batch sample action
+  const tileCache = new TerrainTileCache(
+    async (minX, minZ, maxX, maxZ, step): Promise<HeightGrid> => {
+      const result = await client.call<Record<string, unknown>>("EMCP_WB_Terrain", {
+        action: "sample",
+        mode: "grid",
+        min: `${minX} ${minZ}`,
+        max: `${maxX} ${maxZ}`,
+        step: String(step),
+      });
+      if (result.status === "error") throw new Error(String(result.message));
+      return {
+        originX: Number(result.originX),
+        originZ: Number(result.originZ),
+        step: Number(result.stepUsed),
+        cols: Number(result.cols),
+        rows: Number(result.rows),
+        heights: numberArray(result.heights),
+      };
+    },
+    {
+      fetchPoints: async (points) => {
+        const result = await client.call<Record<string, unknown>>("EMCP_WB_Terrain", {
+          action: "sample",
+          mode: "points",
+          points: encodeRecords(points.map((p) => [p.x, p.z])),
+          maxSamples: Math.min(Math.max(points.length, 3), MAX_SAMPLES),
+        });
+        if (result.status === "error") throw new Error(String(result.message));
+        return numberArray(result.heights);
+      },
+    }
+  );
+
   server.registerTool(
     "wb_terrain",
     {
       description:
-        "Query terrain information. Get the terrain height at a world coordinate or get the world bounds (min/max extents).",
+        "Query terrain information. Get the terrain height at a world coordinate, sample many heights in one call (point list, grid heightfield, or along a polyline), or get the world bounds (min/max extents). Dense point queries are served from a local tile cache after the first query in an area; scattered points are sampled in one batched call.",
       inputSchema: {
         action: z
-          .enum(["getHeight", "getBounds"])
-          .describe("Action: getHeight (sample terrain Y at x,z) or getBounds (world extents)"),
+          .enum(["getHeight", "getBounds", "sample"])
+          .describe("Action: getHeight (sample terrain Y at x,z), getBounds (world extents), or sample (batch heights)"),
         x: z
           .number()
           .optional()
@@ -21,10 +169,39 @@ export function registerWbTerrain(server: McpServer, client: WorkbenchClient): v
           .number()
           .optional()
           .describe("World Z coordinate (required for getHeight)"),
+        mode: z
+          .enum(["points", "grid", "polyline"])
+          .default("points")
+          .describe("sample mode: points (height per point), grid (heightfield over min..max), polyline (heights every step meters along points)"),
+        points: z
+          .array(z.object({ x: z.number(), z: z.number() }))
+          .max(100_000)
+          .optional()
+          .describe("Points for points/polyline sampling"),
+        min: z.object({ x: z.number(), z: z.number() }).optional().describe("Grid corner (grid)"),
+        max: z.object({ x: z.number(), z: z.number() }).optional().describe("Opposite grid corner (grid)"),
+        step: z.number().positive().default(1).describe("Sample spacing in meters (grid/polyline)"),
+        maxSamples: z
+          .number()
+          .int()
+          .min(3)
+          .max(MAX_SAMPLES)
+          .default(16_384)
+          .describe("Resolution cap — grid and polyline coarsen step to stay under it"),
+        exact: z
+          .boolean()
+          .default(false)
+          .describe("points mode: sample every point in Workbench instead of interpolating cached 1 m tiles"),
+        refreshCache: z.boolean().default(false).describe("Drop cached terrain tiles first (after sculpting or switching worlds)"),
       },
     },
-    async ({ action, x, z: zCoord }) => {
+    async ({ action, x, z: zCoord, mode, points, min, max, step, maxSamples, exact, refreshCache }) => {
       try {
+        if (action === "sample") {
+          if (refreshCache) tileCache.clear();
+          return await sampleTerrain(client, tileCache, { mode, points, min, max, step, maxSamples, exact });
+        }
+
         if (action === "getHeight" && (x === undefined || zCoord === undefined)) {
           return {
             content: [
@@ -59,6 +236,8 @@ export function registerWbTerrain(server: McpServer, client: WorkbenchClient): v
 
         // getBounds
         const lines = ["**World Bounds**\n"];
+        if (result.boundsMin !== undefined) lines.push(`- **Min:** ${result.boundsMin}`);
+        if (result.boundsMax !== undefined) lines.push(`- **Max:** ${result.boundsMax}`);
         if (result.minX !== undefined) lines.push(`- **Min X:** ${result.minX}`);
         if (result.minZ !== undefined) lines.push(`- **Min Z:** ${result.minZ}`);
         if (result.maxX !== undefined) lines.push(`- **Max X:** ${result.maxX}`);
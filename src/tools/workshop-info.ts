@@ -1,9 +1,10 @@
 import type { McpServer } from "@modelcontextprotocol/sdk/server/mcp.js";
 import { z } from "zod";
-import { readFileSync, existsSync, readdirSync } from "node:fs";
+import { existsSync, readdirSync } from "node:fs";
 import { resolve, join } from "node:path";
 import type { Config } from "../config.js";
-import { parse, type EnfusionNode } from "../formats/enfusion-text.js";
+import type { EnfusionNode } from "../formats/enfusion-text.js";
+import { parseCache } from "../utils/parse-cache.js";
 
 export function registerWorkshopInfo(server: McpServer, config: Config): void {
   server.registerTool(
@@ -58,8 +59,8 @@ export function registerWorkshopInfo(server: McpServer, config: Config): void {
           };
         }
 
-        const raw = readFileSync(gprojPath, "utf-8");
-        const root = parse(raw);
+        // Only a few top-level fields are read; child blocks are skipped until accessed
+        const root = parseCache.readFile(gprojPath).lazy;
 
         const id = getProperty(root, "ID") || "(unknown)";
         const guid = getProperty(root, "GUID") || "(unknown)";
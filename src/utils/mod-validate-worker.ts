@@ -0,0 +1,11 @@
+/**
+ * Worker thread for the mod validator's analysis stage: receives batches of
+ * FileJobs and answers with their FileFacts, in order.
+ */
+
+import { parentPort } from "node:worker_threads";
+import { analyzeFiles, type FileJob } from "./mod-validator.js";
+
+parentPort?.on("message", (jobs: FileJob[]) => {
+  parentPort!.postMessage(analyzeFiles(jobs));
+});
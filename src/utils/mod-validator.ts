@@ -0,0 +1,739 @@
+/**
+ * The `mod validate` pipeline.
+ *
+ * One directory walk collects the files the enabled checks need. Each file is
+ * then read and parsed exactly once into FileFacts, the small serializable
+ * summary the checks look at (a script's class declarations, a config's parse
+ * error and class names, ...). On large projects that stage runs on a pool of
+ * worker threads. The checks are visitors over the facts and run on the main
+ * thread in walk order, so the report never depends on which worker finished
+ * first.
+ *
+ * The pool needs the compiled worker script next to this module. When running
+ * from TypeScript sources (tests, tsx) it is missing and files are analyzed
+ * inline instead, through the shared parse cache.
+ *
+ * With a ValidationCache, facts and per-file issues are kept between runs:
+ * only files whose content changed are re-read, and only they and the files
+ * referencing a class they declare are re-checked.
+ */
+
+import { createHash } from "node:crypto";
+import { existsSync, readdirSync, readFileSync, statSync } from "node:fs";
+import { availableParallelism } from "node:os";
+import { extname, join, resolve } from "node:path";
+import { fileURLToPath } from "node:url";
+import { Worker } from "node:worker_threads";
+import type { SearchEngine } from "../index/search-engine.js";
+import { getProperty, parse, type EnfusionNode } from "../formats/enfusion-text.js";
+import { logger } from "./logger.js";
+import { parseCache } from "./parse-cache.js";
+import { ValidationCache } from "./validation-cache.js";
+
+export interface ValidationIssue {
+  level: "error" | "warning" | "info";
+  message: string;
+}
+
+export type CheckName = "structure" | "gproj" | "scripts" | "prefabs" | "configs" | "references" | "naming";
+
+export const ALL_CHECKS: CheckName[] = ["structure", "gproj", "scripts", "prefabs", "configs", "references", "naming"];
+
+export type FileKind = "script" | "prefab" | "config";
+
+const KIND_BY_EXT: Record<string, FileKind> = { ".c": "script", ".et": "prefab", ".conf": "config" };
+
+/** One file for the analysis stage. */
+export interface FileJob {
+  path: string;
+  /** Project-relative path with forward slashes, as shown in issues. */
+  rel: string;
+  kind: FileKind;
+}
+
+/**
+ * What the checks need to know about one file. `hash` identifies the content
+ * ("" if unreadable); `error` is the read or parse failure, if any.
+ */
+export type FileFacts =
+  | {
+      kind: "script";
+      rel: string;
+      hash: string;
+      error?: string;
+      hasClass: boolean;
+      /** Name in the first class declaration. */
+      className?: string;
+      /** Base class in the first declaration that has one. */
+      parentClass?: string;
+      /** Every class the script declares or mods. */
+      declared: string[];
+    }
+  | { kind: "prefab"; rel: string; hash: string; error?: string }
+  | {
+      kind: "config";
+      rel: string;
+      hash: string;
+      error?: string;
+      rootType?: string;
+      /** Capitalized type names of every node below the root, depth first. */
+      childClasses: string[];
+    };
+
+/** An Enfusion text file's content, parsed on demand (throws on syntax errors). */
+export interface TextSource {
+  text: string;
+  tree(): EnfusionNode;
+}
+
+/** Reads an Enfusion text file; throws on read errors. */
+export type SourceReader = (path: string) => TextSource;
+
+const readFromDisk: SourceReader = (path) => {
+  const text = readFileSync(path, "utf-8");
+  return { text, tree: () => parse(text) };
+};
+
+function contentHash(text: string): string {
+  return createHash("sha1").update(text).digest("base64");
+}
+
+/** Script source with comments and string literals blanked out (line breaks kept), so declaration patterns only see code. */
+function scriptCode(text: string): string {
+  return text.replace(/\/\/[^\n]*|\/\*[\s\S]*?(?:\*\/|$)|"(?:[^"\\\n]|\\.)*"?/g, (m) => m.replace(/[^\n]/g, " "));
+}
+
+function errorMessage(e: unknown): string {
+  return e instanceof Error ? e.message : String(e);
+}
+
+function collectClasses(node: EnfusionNode, out: string[]): void {
+  for (const child of node.children || []) {
+    if (child.type && /^[A-Z]/.test(child.type)) out.push(child.type);
+    collectClasses(child, out);
+  }
+}
+
+/** Read and summarize one file. Never throws: failures are recorded in `error`. */
+export function analyzeFile(job: FileJob, read: SourceReader = readFromDisk): FileFacts {
+  const { path, rel, kind } = job;
+
+  if (kind === "script") {
+    let content: string;
+    try {
+      content = readFileSync(path, "utf-8");
+    } catch (e) {
+      return { kind, rel, hash: "", error: errorMessage(e), hasClass: false, declared: [] };
+    }
+    const code = scriptCode(content);
+    const declared = [...code.matchAll(/\bclass\s+(\w+)/g)].map((m) => m[1]);
+    const facts: FileFacts = {
+      kind,
+      rel,
+      hash: contentHash(content),
+      hasClass: /\b(class|modded\s+class)\s+\w+/.test(code),
+      declared,
+    };
+    const decl = code.match(/(?:modded\s+)?class\s+(\w+)/);
+    if (decl) facts.className = decl[1];
+    const derived = code.match(/(?:modded\s+)?class\s+\w+\s*:\s*(\w+)/);
+    if (derived) facts.parentClass = derived[1];
+    return facts;
+  }
+
+  let source: TextSource;
+  try {
+    source = read(path);
+  } catch (e) {
+    return kind === "prefab"
+      ? { kind, rel, hash: "", error: errorMessage(e) }
+      : { kind, rel, hash: "", error: errorMessage(e), childClasses: [] };
+  }
+  const hash = contentHash(source.text);
+
+  if (kind === "prefab") {
+    try {
+      source.tree(); // Just verify it parses
+      return { kind, rel, hash };
+    } catch (e) {
+      return { kind, rel, hash, error: errorMessage(e) };
+    }
+  }
+
+  try {
+    const root = source.tree();
+    const childClasses: string[] = [];
+    collectClasses(root, childClasses);
+    return { kind, rel, hash, rootType: root.type, childClasses };
+  } catch (e) {
+    return { kind, rel, hash, error: errorMessage(e), childClasses: [] };
+  }
+}
+
+export function analyzeFiles(jobs: FileJob[], read: SourceReader = readFromDisk): FileFacts[] {
+  return jobs.map((job) => analyzeFile(job, read));
+}
+
+/** Classes a file's issues depend on, lower case: a script's base class, a config's node types. */
+function referencedClasses(facts: FileFacts): string[] {
+  if (facts.kind === "script") return facts.parentClass ? [facts.parentClass.toLowerCase()] : [];
+  if (facts.kind === "config") {
+    const types = facts.rootType ? [facts.rootType, ...facts.childClasses] : facts.childClasses;
+    return types.map((t) => t.toLowerCase());
+  }
+  return [];
+}
+
+function declaredClasses(facts: FileFacts | undefined): string[] {
+  return facts?.kind === "script" ? facts.declared.map((c) => c.toLowerCase()) : [];
+}
+
+// ─── Walk ──────────────────────────────────────────────────────────────────────
+
+export interface ProjectFiles {
+  /** .gproj file names in the project root. */
+  gprojFiles: string[];
+  /** Files of the requested kinds, in walk order. */
+  files: FileJob[];
+}
+
+/** List the project once: root .gproj files plus every file of the given kinds (dot-entries skipped). */
+export function walkProject(projectPath: string, kinds: ReadonlySet<FileKind>): ProjectFiles {
+  const gprojFiles = readdirSync(projectPath).filter((f) => extname(f).toLowerCase() === ".gproj");
+  const files: FileJob[] = [];
+  if (kinds.size === 0) return { gprojFiles, files };
+
+  const walk = (current: string, relDir: string) => {
+    try {
+      for (const entry of readdirSync(current, { withFileTypes: true })) {
+        if (entry.name.startsWith(".")) continue;
+        const rel = relDir ? `${relDir}/${entry.name}` : entry.name;
+        if (entry.isDirectory()) {
+          walk(join(current, entry.name), rel);
+          continue;
+        }
+        const kind = KIND_BY_EXT[extname(entry.name).toLowerCase()];
+        if (kind && kinds.has(kind)) files.push({ path: join(current, entry.name), rel, kind });
+      }
+    } catch {
+      // Skip directories we can't read
+    }
+  };
+  walk(projectPath, "");
+  return { gprojFiles, files };
+}
+
+// ─── Worker pool ───────────────────────────────────────────────────────────────
+
+/** Compiled worker entry; absent when running from TypeScript sources. */
+const WORKER_SCRIPT = new URL("./mod-validate-worker.js", import.meta.url);
+
+/** Below this many files, thread startup costs more than parallel parsing saves. */
+const POOL_MIN_FILES = 200;
+
+/** Batches per worker, so a slow batch does not leave the other workers idle. */
+const BATCHES_PER_WORKER = 4;
+
+/** The parts of a worker_threads Worker the pool uses. */
+export type PoolWorker = Pick<Worker, "postMessage" | "on" | "ref" | "unref">;
+
+interface PoolTask {
+  jobs: FileJob[];
+  resolve: (facts: FileFacts[]) => void;
+  reject: (e: Error) => void;
+}
+
+/**
+ * Fixed set of analysis threads, reused across validations. Idle workers do
+ * not keep the process alive. `spawn` starts one worker running
+ * mod-validate-worker; it is a parameter so tests can stand in for threads.
+ */
+export class AnalysisPool {
+  readonly size: number;
+  private readonly spawnWorker: () => PoolWorker;
+  private readonly idle: PoolWorker[] = [];
+  private readonly busy = new Map<PoolWorker, PoolTask>();
+  private readonly queue: PoolTask[] = [];
+  private started = 0;
+
+  constructor(size: number, spawn: () => PoolWorker) {
+    this.size = size;
+    this.spawnWorker = spawn;
+  }
+
+  /** Analyze jobs across the pool; results are in job order. */
+  async analyze(jobs: FileJob[]): Promise<FileFacts[]> {
+    const batchSize = Math.ceil(jobs.length / (this.size * BATCHES_PER_WORKER));
+    const batches: FileJob[][] = [];
+    for (let i = 0; i < jobs.length; i += batchSize) batches.push(jobs.slice(i, i + batchSize));
+
+    const results = await Promise.all(
+      batches.map((batch) =>
+        this.submit(batch).catch((e) => {
+          logger.debug(`Validation worker failed, analyzing batch inline: ${e}`);
+          return analyzeFiles(batch, inlineReader);
+        })
+      )
+    );
+    return results.flat();
+  }
+
+  private submit(jobs: FileJob[]): Promise<FileFacts[]> {
+    return new Promise((resolve, reject) => {
+      this.queue.push({ jobs, resolve, reject });
+      this.dispatch();
+    });
+  }
+
+  private dispatch(): void {
+    while (this.queue.length > 0) {
+      const worker = this.idle.pop() ?? this.spawn();
+      if (!worker) return;
+      const task = this.queue.shift()!;
+      this.busy.set(worker, task);
+      worker.ref();
+      worker.postMessage(task.jobs);
+    }
+  }
+
+  private spawn(): PoolWorker | null {
+    if (this.started >= this.size) return null;
+    this.started++;
+    const worker = this.spawnWorker();
+    worker.on("message", (facts: FileFacts[]) => {
+      const task = this.busy.get(worker);
+      this.busy.delete(worker);
+      worker.unref();
+      this.idle.push(worker);
+      task?.resolve(facts);
+      this.dispatch();
+    });
+    worker.on("error", (e: Error) => this.retire(worker, e));
+    worker.on("exit", (code: number) => this.retire(worker, new Error(`Validation worker exited with code ${code}`)));
+    return worker;
+  }
+
+  /** Drop a dead worker and fail its task; a replacement is started on demand. */
+  private retire(worker: PoolWorker, error: Error): void {
+    const i = this.idle.indexOf(worker);
+    if (i !== -1) this.idle.splice(i, 1);
+    const task = this.busy.get(worker);
+    if (!task && i === -1) return; // Already retired
+    this.busy.delete(worker);
+    this.started--;
+    task?.reject(error);
+    this.dispatch();
+  }
+}
+
+let pool: AnalysisPool | null | undefined;
+
+function getPool(): AnalysisPool | null {
+  if (pool === undefined) {
+    const size = Math.min(Math.max(availableParallelism() - 1, 1), 8);
+    pool =
+      existsSync(fileURLToPath(WORKER_SCRIPT)) && size > 1 ? new AnalysisPool(size, () => new Worker(WORKER_SCRIPT)) : null;
+  }
+  return pool;
+}
+
+/** Inline analysis shares parsed trees with the other tools through the parse cache. */
+const inlineReader: SourceReader = (path) => {
+  const doc = parseCache.readFile(path);
+  return { text: doc.text, tree: () => doc.tree };
+};
+
+// ─── Checks ────────────────────────────────────────────────────────────────────
+
+export interface CheckContext {
+  projectPath: string;
+  gprojFiles: string[];
+  searchEngine?: SearchEngine;
+  /** Lower-case names of the classes the project's scripts declare. */
+  projectClasses: Set<string>;
+}
+
+/**
+ * A check over the facts of the file kinds it asks for. Per-file issues come
+ * from check(), which may only depend on the file's own facts, the API index
+ * and the project's declared classes, so results can be cached per file.
+ * Project-wide checks use visit() and report from finish().
+ */
+interface CheckVisitor {
+  kinds: FileKind[];
+  /** Needs ctx.projectClasses (scripts are walked even if not otherwise checked). */
+  usesProjectClasses?: boolean;
+  check?(file: FileFacts): ValidationIssue[];
+  visit?(file: FileFacts): void;
+  finish?(): ValidationIssue[];
+}
+
+/** Known to the API index or declared by one of the project's scripts. */
+function isKnownClass(ctx: CheckContext, name: string): boolean {
+  return !!ctx.searchEngine?.hasClass(name) || ctx.projectClasses.has(name.toLowerCase());
+}
+
+const MODULE_DIRS = ["Scripts/Game/", "Scripts/GameLib/", "Scripts/WorkbenchGame/"];
+
+function structureCheck(ctx: CheckContext): CheckVisitor {
+  return {
+    kinds: [],
+    finish() {
+      const issues: ValidationIssue[] = [];
+      if (ctx.gprojFiles.length === 0) {
+        issues.push({ level: "error", message: "No .gproj file found in project root" });
+      } else if (ctx.gprojFiles.length > 1) {
+        issues.push({ level: "warning", message: `Multiple .gproj files found: ${ctx.gprojFiles.join(", ")}` });
+      }
+
+      // Check standard directories
+      const expectedDirs = ["Scripts/Game"];
+      for (const dir of expectedDirs) {
+        if (!existsSync(resolve(ctx.projectPath, dir))) {
+          issues.push({ level: "warning", message: `Missing expected directory: ${dir}` });
+        }
+      }
+      return issues;
+    },
+  };
+}
+
+function gprojCheck(ctx: CheckContext): CheckVisitor {
+  return {
+    kinds: [],
+    finish() {
+      const issues: ValidationIssue[] = [];
+      for (const filename of ctx.gprojFiles) {
+        const filepath = resolve(ctx.projectPath, filename);
+        try {
+          // Header fields and the Dependencies list only; Configurations stay unparsed
+          const node = parseCache.readFile(filepath).lazy;
+
+          if (node.type !== "GameProject") {
+            issues.push({ level: "error", message: `${filename}: Root node is "${node.type}", expected "GameProject"` });
+          }
+
+          const id = getProperty(node, "ID");
+          if (!id) {
+            issues.push({ level: "error", message: `${filename}: Missing ID field` });
+          }
+
+          const guid = getProperty(node, "GUID");
+          if (!guid) {
+            issues.push({ level: "error", message: `${filename}: Missing GUID field` });
+          } else if (typeof guid === "string" && !/^[0-9A-Fa-f]{16}$/.test(guid)) {
+            issues.push({ level: "warning", message: `${filename}: GUID "${guid}" is not a valid 16-char hex string` });
+          }
+
+          const deps = node.children.find((c) => c.type === "Dependencies");
+          if (!deps) {
+            issues.push({ level: "error", message: `${filename}: Missing Dependencies block — mod won't load` });
+          } else if (!deps.values.includes("58D0FB3206B6F859")) {
+            issues.push({ level: "error", message: `${filename}: Missing base game dependency (58D0FB3206B6F859)` });
+          }
+        } catch (e) {
+          issues.push({ level: "error", message: `${filename}: Failed to parse — ${errorMessage(e)}` });
+        }
+      }
+      return issues;
+    },
+  };
+}
+
+function scriptsCheck(): CheckVisitor {
+  return {
+    kinds: ["script"],
+    check(file) {
+      if (file.kind !== "script") return [];
+      const { rel } = file;
+      // Check if script is in a valid module folder
+      if (!MODULE_DIRS.some((dir) => rel.startsWith(dir))) {
+        return [{
+          level: "error",
+          message: `${rel}: Script is outside a valid module folder (Scripts/Game/, Scripts/GameLib/, Scripts/WorkbenchGame/) — it will be silently ignored`,
+        }];
+      }
+      if (file.error !== undefined) return [{ level: "warning", message: `${rel}: Could not read file` }];
+      // Basic syntax check: look for class declaration
+      if (!file.hasClass) return [{ level: "warning", message: `${rel}: No class declaration found` }];
+      return [];
+    },
+  };
+}
+
+function prefabsCheck(): CheckVisitor {
+  return {
+    kinds: ["prefab"],
+    check(file) {
+      if (file.kind !== "prefab" || file.error === undefined) return [];
+      return [{ level: "error", message: `${file.rel}: Invalid prefab format — ${file.error}` }];
+    },
+  };
+}
+
+function configsCheck(ctx: CheckContext): CheckVisitor {
+  return {
+    kinds: ["config"],
+    usesProjectClasses: true,
+    check(file) {
+      if (file.kind !== "config") return [];
+      const { rel } = file;
+      if (file.error !== undefined) {
+        return [{ level: "error", message: `${rel}: Invalid config format — ${file.error}` }];
+      }
+      if (!ctx.searchEngine) return [];
+
+      // Check node types against the API index and the project's own classes
+      const issues: ValidationIssue[] = [];
+      if (file.rootType && !isKnownClass(ctx, file.rootType)) {
+        issues.push({
+          level: "warning",
+          message: `${rel}: Root class "${file.rootType}" not found in API index — may be from another mod or misspelled.`,
+        });
+      }
+      for (const type of file.childClasses) {
+        if (!isKnownClass(ctx, type)) {
+          issues.push({ level: "warning", message: `${rel}: Class "${type}" not found in API index.` });
+        }
+      }
+      return issues;
+    },
+  };
+}
+
+function referencesCheck(ctx: CheckContext): CheckVisitor {
+  return {
+    kinds: ["script"],
+    usesProjectClasses: true,
+    check(file) {
+      if (file.kind !== "script" || !ctx.searchEngine || !file.parentClass) return [];
+      if (isKnownClass(ctx, file.parentClass)) return [];
+      return [{
+        level: "warning",
+        message: `${file.rel}: Extends "${file.parentClass}" which is not in the API index (may be from another mod)`,
+      }];
+    },
+  };
+}
+
+function namingCheck(): CheckVisitor {
+  const prefixes = new Map<string, number>();
+  return {
+    kinds: ["script"],
+    visit(file) {
+      if (file.kind !== "script" || !file.className) return;
+      // Extract prefix (part before first underscore)
+      const prefixMatch = file.className.match(/^([A-Z]+)_/);
+      if (prefixMatch) {
+        const prefix = prefixMatch[1];
+        prefixes.set(prefix, (prefixes.get(prefix) || 0) + 1);
+      }
+    },
+    finish() {
+      const issues: ValidationIssue[] = [];
+      if (prefixes.size <= 1) return issues;
+
+      // Find the most common prefix
+      let maxPrefix = "";
+      let maxCount = 0;
+      for (const [prefix, count] of prefixes) {
+        if (count > maxCount) {
+          maxPrefix = prefix;
+          maxCount = count;
+        }
+      }
+      for (const [prefix, count] of prefixes) {
+        if (prefix !== maxPrefix) {
+          issues.push({
+            level: "info",
+            message: `${count} class(es) use prefix "${prefix}_" instead of the most common prefix "${maxPrefix}_"`,
+          });
+        }
+      }
+      return issues;
+    },
+  };
+}
+
+type CheckFactory = (ctx: CheckContext) => CheckVisitor;
+
+const CHECKS: Record<CheckName, CheckFactory> = {
+  structure: structureCheck,
+  gproj: gprojCheck,
+  scripts: scriptsCheck,
+  prefabs: prefabsCheck,
+  configs: configsCheck,
+  references: referencesCheck,
+  naming: namingCheck,
+};
+
+// ─── Entry point ───────────────────────────────────────────────────────────────
+
+export interface ValidateOptions {
+  checks?: CheckName[];
+  /** API index for the configs and references checks; those report nothing without it. */
+  searchEngine?: SearchEngine;
+  /** Use the worker pool when there are enough files (default true). */
+  parallel?: boolean;
+  /** Pool to analyze on instead of the shared one, whatever the file count (tests). */
+  pool?: AnalysisPool;
+  /** Reuse and update the project's on-disk validation cache (default false). */
+  cache?: boolean;
+}
+
+export interface ValidationResult {
+  /** Issues grouped by check, in the order the checks were requested. */
+  issues: ValidationIssue[];
+  /** Checks that reported nothing. */
+  passed: CheckName[];
+  /** Files walked. */
+  files: number;
+  /** Files read and parsed this run (all of them without the cache). */
+  analyzed: number;
+  /** Files whose per-file issues were computed this run rather than taken from the cache. */
+  rechecked: number;
+  /** Whether the worker pool was used. */
+  parallel: boolean;
+}
+
+/** Stat signature (mtime:size), or null if the file is gone. */
+function statVersion(path: string): string | null {
+  try {
+    const st = statSync(path);
+    return `${st.mtimeMs}:${st.size}`;
+  } catch {
+    return null;
+  }
+}
+
+const apiFingerprints = new WeakMap<SearchEngine, string>();
+
+/**
+ * Identity of the API index the cached issues were computed against: a hash
+ * of its class names, the only thing the checks ask it about. A count would
+ * miss an index update that renames as many classes as it adds.
+ */
+function apiFingerprint(searchEngine: SearchEngine | undefined): string {
+  if (!searchEngine) return "none";
+  let fingerprint = apiFingerprints.get(searchEngine);
+  if (!fingerprint) {
+    const names = searchEngine.getAllClassNames().map((n) => n.toLowerCase());
+    fingerprint = `classes:${contentHash([...new Set(names)].sort().join("\n"))}`;
+    apiFingerprints.set(searchEngine, fingerprint);
+  }
+  return fingerprint;
+}
+
+/** Run the requested checks over a project directory. */
+export async function validateMod(projectPath: string, options: ValidateOptions = {}): Promise<ValidationResult> {
+  const enabled = options.checks ?? ALL_CHECKS;
+  const ctx: CheckContext = { projectPath, gprojFiles: [], searchEngine: options.searchEngine, projectClasses: new Set() };
+  const visitors = enabled.map((name) => CHECKS[name](ctx));
+
+  // Walk once for every file kind any enabled check visits
+  const kinds = new Set(visitors.flatMap((v) => v.kinds));
+  if (visitors.some((v) => v.usesProjectClasses)) kinds.add("script");
+  const { gprojFiles, files } = walkProject(projectPath, kinds);
+  ctx.gprojFiles = gprojFiles;
+
+  const cache = options.cache ? ValidationCache.open(projectPath, apiFingerprint(options.searchEngine)) : null;
+
+  // Reuse the facts of files whose stat signature is unchanged; analyze the rest
+  const facts: FileFacts[] = new Array(files.length);
+  const versions: Array<string | null> = files.map((job) => (cache ? statVersion(job.path) : null));
+  const stale: number[] = [];
+  files.forEach((job, i) => {
+    const entry = cache?.get(job.rel);
+    if (entry && versions[i] !== null && entry.version === versions[i] && entry.facts.kind === job.kind) {
+      facts[i] = entry.facts;
+    } else {
+      stale.push(i);
+    }
+  });
+
+  const jobs = stale.map((i) => files[i]);
+  const workers =
+    options.parallel === false
+      ? null
+      : (options.pool ?? (jobs.length >= POOL_MIN_FILES ? getPool() : null));
+  const analyzed = workers ? await workers.analyze(jobs) : analyzeFiles(jobs, inlineReader);
+
+  // Content changes (a touched file with the same hash is not one) and the classes they add or remove
+  const changed = new Set<string>();
+  const changedClasses = new Set<string>();
+  stale.forEach((fileIndex, j) => {
+    const fresh = analyzed[j];
+    facts[fileIndex] = fresh;
+    if (!cache) return;
+    const entry = cache.get(fresh.rel);
+    const version = versions[fileIndex] ?? "";
+    if (entry && entry.facts.kind === fresh.kind && entry.facts.hash === fresh.hash && fresh.hash !== "") {
+      cache.set(fresh.rel, { ...entry, version });
+      return;
+    }
+    changed.add(fresh.rel);
+    for (const name of declaredClasses(entry?.facts)) changedClasses.add(name);
+    for (const name of declaredClasses(fresh)) changedClasses.add(name);
+    cache.set(fresh.rel, { version, facts: fresh, issues: {} });
+  });
+  if (cache) {
+    // Files of the walked kinds that no longer exist
+    const walked = new Set(files.map((f) => f.rel));
+    for (const [rel, entry] of cache.entries()) {
+      if (walked.has(rel) || !kinds.has(entry.facts.kind)) continue;
+      for (const name of declaredClasses(entry.facts)) changedClasses.add(name);
+      cache.delete(rel);
+    }
+
+    // Checks not enabled this run, and files not walked, would otherwise keep
+    // issues computed against the old classes on the next run that visits them
+    if (changedClasses.size > 0) {
+      for (const [rel, entry] of cache.entries()) {
+        if (referencedClasses(entry.facts).some((name) => changedClasses.has(name))) cache.clearIssues(rel);
+      }
+    }
+  }
+
+  for (const file of facts) {
+    for (const name of declaredClasses(file)) ctx.projectClasses.add(name);
+  }
+
+  // Changed files plus everything referencing a class they declared or declare now
+  const recheck = (file: FileFacts) =>
+    !cache || changed.has(file.rel) || referencedClasses(file).some((name) => changedClasses.has(name));
+
+  const issues: ValidationIssue[] = [];
+  const passed: CheckName[] = [];
+  const rechecked = new Set<string>();
+  visitors.forEach((visitor, i) => {
+    const name = enabled[i];
+    const found: ValidationIssue[] = [];
+    for (const file of facts) {
+      if (!visitor.kinds.includes(file.kind)) continue;
+      if (visitor.check) {
+        const entry = cache?.get(file.rel);
+        let fileIssues = entry && !recheck(file) ? entry.issues[name] : undefined;
+        if (!fileIssues) {
+          fileIssues = visitor.check(file);
+          rechecked.add(file.rel);
+          if (entry) cache!.setIssues(file.rel, name, fileIssues);
+        }
+        found.push(...fileIssues);
+      }
+      visitor.visit?.(file);
+    }
+    if (visitor.finish) found.push(...visitor.finish());
+    if (found.length === 0) passed.push(name);
+    issues.push(...found);
+  });
+
+  cache?.save();
+  return {
+    issues,
+    passed,
+    files: files.length,
+    analyzed: jobs.length,
+    rechecked: rechecked.size,
+    parallel: workers !== null,
+  };
+}
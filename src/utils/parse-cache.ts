@@ -0,0 +1,182 @@
+/**
+ * Process-wide cache of Enfusion text documents.
+ *
+ * prefab inspection, game_duplicate, mod validation, workshop_info and the
+ * ancestry walker read many of the same .et/.conf/.gproj files within one
+ * session. They go through this cache instead of calling readFileSync() and
+ * parse() themselves. Disk entries are keyed by resolved path and revalidated
+ * with a stat on every lookup: a different mtime or size reloads the file.
+ * Pak entries have no mtime and are keyed by their location in the archive.
+ *
+ * The parsed forms (full tree and lazy root) are built on first use and shared
+ * by every caller, so treat them as read-only; parse the text with
+ * EnfusionDocument to edit it. Memory is bounded by an approximate byte budget
+ * with least-recently-used eviction.
+ */
+
+import { readFileSync, statSync } from "node:fs";
+import { resolve } from "node:path";
+import { parse, type EnfusionNode } from "../formats/enfusion-text.js";
+import { parseLazy, type LazyEnfusionNode } from "../formats/enfusion-lazy.js";
+
+/** Rough retained size of a parsed form per source character (objects, arrays and sliced strings). */
+const PARSED_BYTES_PER_CHAR = 6;
+
+const DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+
+/** Called when a document builds a parsed form, with the bytes it added. */
+type GrowListener = (delta: number) => void;
+
+export interface ParseCacheStats {
+  entries: number;
+  bytes: number;
+  maxBytes: number;
+  hits: number;
+  misses: number;
+  evictions: number;
+}
+
+/** One cached file: its text plus parsed forms built on demand. Parse errors are cached too. */
+export class CachedDocument {
+  readonly key: string;
+  readonly text: string;
+  /** Approximate retained size in bytes (UTF-16 text plus any parsed forms). */
+  bytes: number;
+  /** Stat signature (mtime:size) or pak location the entry was loaded from. */
+  readonly version: string;
+
+  private treeResult: EnfusionNode | Error | undefined;
+  private lazyResult: LazyEnfusionNode | Error | undefined;
+  private readonly onGrow: GrowListener;
+
+  constructor(key: string, version: string, text: string, onGrow: GrowListener) {
+    this.key = key;
+    this.version = version;
+    this.text = text;
+    this.bytes = text.length * 2;
+    this.onGrow = onGrow;
+  }
+
+  /** Full tree from parse(). Throws the parse error (every time) for malformed files. */
+  get tree(): EnfusionNode {
+    if (this.treeResult === undefined) this.treeResult = this.build(() => parse(this.text));
+    if (this.treeResult instanceof Error) throw this.treeResult;
+    return this.treeResult;
+  }
+
+  /** Root from parseLazy(), for callers that only read header fields. */
+  get lazy(): LazyEnfusionNode {
+    if (this.lazyResult === undefined) this.lazyResult = this.build(() => parseLazy(this.text));
+    if (this.lazyResult instanceof Error) throw this.lazyResult;
+    return this.lazyResult;
+  }
+
+  private build<T>(fn: () => T): T | Error {
+    let result: T | Error;
+    try {
+      result = fn();
+    } catch (e) {
+      result = e instanceof Error ? e : new Error(String(e));
+    }
+    const delta = result instanceof Error ? 0 : this.text.length * PARSED_BYTES_PER_CHAR;
+    this.bytes += delta;
+    this.onGrow(delta);
+    return result;
+  }
+}
+
+export class EnfusionParseCache {
+  private readonly entries = new Map<string, CachedDocument>();
+  private readonly maxBytes: number;
+  private bytes = 0;
+  private hits = 0;
+  private misses = 0;
+  private evictions = 0;
+
+  constructor(options: { maxBytes?: number } = {}) {
+    this.maxBytes = options.maxBytes ?? DEFAULT_MAX_BYTES;
+  }
+
+  /**
+   * Read a file from disk, reusing the cached entry while its mtime and size
+   * are unchanged. Throws like readFileSync() when the file is missing.
+   */
+  readFile(path: string): CachedDocument {
+    const key = resolve(path);
+    const st = statSync(key);
+    return this.lookup(key, `${st.mtimeMs}:${st.size}`, () => readFileSync(key, "utf-8"));
+  }
+
+  /**
+   * Entry for text from a non-file source (e.g. a pak archive). `version`
+   * must change whenever the content can, such as the archive and offset.
+   */
+  load(key: string, version: string, read: () => string): CachedDocument {
+    return this.lookup(key, version, read);
+  }
+
+  /** Drop one path (or pak key), or everything. */
+  invalidate(key?: string): void {
+    if (key === undefined) {
+      this.entries.clear();
+      this.bytes = 0;
+      return;
+    }
+    const resolved = this.entries.has(key) ? key : resolve(key);
+    const entry = this.entries.get(resolved);
+    if (!entry) return;
+    this.entries.delete(resolved);
+    this.bytes -= entry.bytes;
+  }
+
+  stats(): ParseCacheStats {
+    return {
+      entries: this.entries.size,
+      bytes: this.bytes,
+      maxBytes: this.maxBytes,
+      hits: this.hits,
+      misses: this.misses,
+      evictions: this.evictions,
+    };
+  }
+
+  private lookup(key: string, version: string, read: () => string): CachedDocument {
+    const cached = this.entries.get(key);
+    if (cached) {
+      this.entries.delete(key);
+      if (cached.version === version) {
+        // Refresh LRU position
+        this.entries.set(key, cached);
+        this.hits++;
+        return cached;
+      }
+      this.bytes -= cached.bytes;
+    }
+
+    this.misses++;
+    const doc: CachedDocument = new CachedDocument(key, version, read(), (delta) => {
+      // Growth of an entry that was evicted or replaced meanwhile is not counted
+      if (this.entries.get(key) !== doc) return;
+      this.bytes += delta;
+      this.evict(key);
+    });
+    this.entries.set(key, doc);
+    this.bytes += doc.bytes;
+    this.evict(key);
+    return doc;
+  }
+
+  /** Evict least-recently-used entries until under budget, never the one just used. */
+  private evict(keep: string): void {
+    for (const [key, entry] of this.entries) {
+      if (this.bytes <= this.maxBytes) return;
+      if (key === keep) continue;
+      this.entries.delete(key);
+      this.bytes -= entry.bytes;
+      this.evictions++;
+    }
+  }
+}
+
+/** The shared cache every tool reads Enfusion text files through. */
+export const parseCache = new EnfusionParseCache();
@@ -1,17 +1,23 @@
 // src/utils/prefab-ancestry.ts
-import { readFileSync, existsSync, readdirSync } from "node:fs";
-import { join } from "node:path";
 import type { Config } from "../config.js";
-import { PakVirtualFS } from "../pak/vfs.js";
-import { resolveGameDataPath, findLooseFile } from "./game-paths.js";
 import { logger } from "./logger.js";
+import { getResourceResolver } from "./resource-resolver.js";
+import { parseCache, type CachedDocument } from "./parse-cache.js";
+import { parseLazy, type LazyEnfusionNode } from "../formats/enfusion-lazy.js";
+import type { EnfusionNode, EnfusionProperty } from "../formats/enfusion-text.js";
 
 // ── Types ─────────────────────────────────────────────────────────────────────
 
 export interface ParsedComponent {
   guid: string;
+  /** Component class: the class qualifier if present (`Key Class "{GUID}"`), else the type name. */
   typeName: string;
+  /** Text between the component's braces, exactly as written. */
   rawBody: string;
+  /** Direct child of the components block (false for sub-components nested in another one). */
+  topLevel?: boolean;
+  /** Parsed declaration, for override-aware merging. */
+  node?: EnfusionNode;
 }
 
 export interface AncestorLevel {
@@ -27,6 +33,34 @@ export interface MergedComponent {
   source: AncestorLevel;
 }
 
+/** Structured view of one prefab file. */
+export interface PrefabModel {
+  entityClass: string;
+  parentPath: string | null;
+  /** Every GUID-identified component in the components block, nested ones included, in document order. */
+  components: Map<string, ParsedComponent>;
+  /** Parse error, if the file is malformed (components is then empty). */
+  error?: string;
+}
+
+/** A component with every ancestor's declaration applied, oldest first. */
+export interface ResolvedComponent {
+  guid: string;
+  typeName: string;
+  topLevel: boolean;
+  /** Effective declaration: later levels override properties by key and nested objects by GUID or type. */
+  node: EnfusionNode;
+  /** Levels that declare this component, oldest first; the last one is the deepest override. */
+  declaredIn: AncestorLevel[];
+}
+
+export interface ResolvedPrefab {
+  levels: AncestorLevel[];
+  warnings: string[];
+  /** Resolved components by GUID, in the order they are first declared along the chain. */
+  components: Map<string, ResolvedComponent>;
+}
+
 // ── Helpers ───────────────────────────────────────────────────────────────────
 
 export function stripGuid(ref: string): string {
@@ -45,103 +79,105 @@ export function parseParentPath(content: string): { entityClass: string; parentP
   return { entityClass: m3 ? m3[1] : "Unknown", parentPath: null };
 }
 
-function extractComponentsBlock(content: string): string {
-  const m = /^[ \t]*components\s*\{/m.exec(content);
-  if (!m || m.index === undefined) return "";
-  const openPos = content.indexOf("{", m.index + m[0].length - 1);
-  let depth = 1;
-  let i = openPos + 1;
-  while (i < content.length && depth > 0) {
-    if (content[i] === "{") depth++;
-    else if (content[i] === "}") depth--;
-    i++;
-  }
-  return content.slice(openPos + 1, i - 1);
-}
+const GUID_ID = /^\{([0-9A-Fa-f]{16})\}$/;
 
-export function parseComponents(content: string): Map<string, ParsedComponent> {
-  const result = new Map<string, ParsedComponent>();
-  const block = extractComponentsBlock(content);
-  if (!block) return result;
-
-  const re = /^[ \t]*(\w+)\s+"\{([0-9A-Fa-f]{16})\}"(?:[^{"\\]|"[^"]*")*\{/gm;
-  let match: RegExpExecArray | null;
-
-  while ((match = re.exec(block)) !== null) {
-    const typeName = match[1];
-    const guid = match[2];
-    const openBrace = block.indexOf("{", match.index + match[0].length - 1);
-    let depth = 1;
-    let i = openBrace + 1;
-    while (i < block.length && depth > 0) {
-      if (block[i] === "{") depth++;
-      else if (block[i] === "}") depth--;
-      i++;
+/** Collect GUID-identified nodes under `node`, depth first, in document order. */
+function collectComponents(node: LazyEnfusionNode, topLevel: boolean, out: Map<string, ParsedComponent>): void {
+  for (const child of node.children) {
+    const m = child.id !== undefined ? GUID_ID.exec(child.id) : null;
+    if (m) {
+      out.set(m[1], {
+        guid: m[1],
+        typeName: child.className ?? child.type,
+        rawBody: child.bodyText,
+        topLevel,
+        node: child,
+      });
     }
-    const rawBody = block.slice(openBrace + 1, i - 1);
-    result.set(guid, { guid, typeName, rawBody });
+    // Anything nested (sub-components, objects in arrays) is below the top level
+    collectComponents(child, false, out);
   }
-
-  return result;
 }
 
-export function readEtFile(path: string, config: Config, projectPath?: string): string | null {
-  const bare = stripGuid(path);
+/** Build the component model from a parsed root. Throws on syntax errors inside the components block. */
+function buildModel(root: LazyEnfusionNode): PrefabModel {
+  const components = new Map<string, ParsedComponent>();
+  const block = root.children.find((c) => c.type === "components");
+  if (block) collectComponents(block, true, components);
+  return {
+    entityClass: root.type,
+    parentPath: root.inheritance ? stripGuid(root.inheritance) : null,
+    components,
+  };
+}
 
-  // 1. Mod project — check direct path and all addon subdirs
-  const base = projectPath || config.projectPath;
-  if (base) {
-    const direct = join(base, bare);
-    if (existsSync(direct)) {
-      try { return readFileSync(direct, "utf-8"); } catch (e) { logger.debug(`Failed to read ${direct}: ${e}`); }
-    }
-    try {
-      for (const entry of readdirSync(base, { withFileTypes: true })) {
-        if (!entry.isDirectory()) continue;
-        const candidate = join(base, entry.name, bare);
-        if (existsSync(candidate)) {
-          try { return readFileSync(candidate, "utf-8"); } catch (e) { logger.debug(`Failed to read ${candidate}: ${e}`); }
-        }
-      }
-    } catch (e) { logger.debug(`Cannot read addon dir ${base}: ${e}`); }
+function modelFromText(content: string, read: () => LazyEnfusionNode): PrefabModel {
+  try {
+    return buildModel(read());
+  } catch (e) {
+    const msg = e instanceof Error ? e.message : String(e);
+    return { ...parseParentPath(content), components: new Map(), error: msg };
   }
+}
 
-  // 2. Extracted files
-  if (config.extractedPath) {
-    const found = findLooseFile(config.extractedPath, bare);
-    if (found) {
-      try { return readFileSync(found, "utf-8"); } catch (e) { logger.debug(`Failed to read extracted ${found}: ${e}`); }
-    }
-  }
+/** Models per cached file; dropped together with the parse cache entry when the file changes. */
+const models = new WeakMap<CachedDocument, PrefabModel>();
 
-  // 3. Loose game data
-  const gameDataPath = resolveGameDataPath(config.gamePath);
-  if (gameDataPath) {
-    const found = findLooseFile(gameDataPath, bare);
-    if (found) {
-      try { return readFileSync(found, "utf-8"); } catch (e) { logger.debug(`Failed to read loose ${found}: ${e}`); }
-    }
+/** Component model of a cached prefab, built once per file version. */
+export function prefabModel(doc: CachedDocument): PrefabModel {
+  let model = models.get(doc);
+  if (!model) {
+    model = modelFromText(doc.text, () => doc.lazy);
+    models.set(doc, model);
   }
+  return model;
+}
 
-  // 4. Pak VFS
-  const pakVfs = PakVirtualFS.get(config.gamePath);
-  if (pakVfs && pakVfs.exists(bare)) {
-    try { return pakVfs.readTextFile(bare); } catch (e) { logger.debug(`Failed to read pak ${bare}: ${e}`); }
+/** Every GUID-identified component in the components block (nested sub-components included). */
+export function parseComponents(content: string): Map<string, ParsedComponent> {
+  return modelFromText(content, () => parseLazy(content)).components;
+}
+
+/**
+ * Find a prefab by resource path (project addons, extracted data, loose game
+ * data, then paks) and return it through the shared parse cache. Locations
+ * come from the resource resolver's path index, not per-call directory probes.
+ */
+export function readEtDocument(path: string, config: Config, projectPath?: string): CachedDocument | null {
+  const bare = stripGuid(path);
+  const hit = getResourceResolver(config, projectPath).resolve(bare);
+  if (!hit) return null;
+
+  try {
+    if (hit.kind === "file") return parseCache.readFile(hit.path);
+    const { vfs, path: pakPath } = hit;
+    const version = vfs.fileVersion(pakPath);
+    if (!version) return null;
+    return parseCache.load(`pak:${pakPath.toLowerCase()}`, version, () => vfs.readTextFile(pakPath));
+  } catch (e) {
+    logger.debug(`Failed to read ${hit.kind === "file" ? hit.path : `pak ${hit.path}`}: ${e}`);
+    return null;
   }
+}
 
-  return null;
+export function readEtFile(path: string, config: Config, projectPath?: string): string | null {
+  return readEtDocument(path, config, projectPath)?.text ?? null;
 }
 
 // ── Chain walker ──────────────────────────────────────────────────────────────
 
 const MAX_DEPTH = 20;
 
-export function walkChain(
-  startPath: string,
-  config: Config,
-  projectPath?: string
-): { levels: AncestorLevel[]; warnings: string[] } {
+interface Chain {
+  levels: AncestorLevel[];
+  warnings: string[];
+  /** Cache entry behind each level, same order. */
+  docs: CachedDocument[];
+}
+
+function readChain(startPath: string, config: Config, projectPath?: string): Chain {
   const levels: AncestorLevel[] = [];
+  const docs: CachedDocument[] = [];
   const warnings: string[] = [];
   const visited = new Set<string>();
 
@@ -152,35 +188,47 @@ export function walkChain(
       warnings.push(`Cycle detected: ${bare}`);
       return;
     }
-    if (levels.length >= MAX_DEPTH) {
+    // Levels are pushed on the way back up, so count the files entered so far
+    if (visited.size >= MAX_DEPTH) {
       warnings.push(`Chain truncated at depth ${MAX_DEPTH}`);
       return;
     }
     visited.add(key);
 
-    const content = readEtFile(bare, config, projectPath);
-    if (!content) {
+    const doc = readEtDocument(bare, config, projectPath);
+    if (!doc) {
       warnings.push(`Could not read: ${bare}`);
       return;
     }
 
-    const { entityClass, parentPath } = parseParentPath(content);
+    const model = prefabModel(doc);
+    if (model.error) warnings.push(`Could not parse ${bare}: ${model.error}`);
 
     // Recurse to parent first so oldest ancestor ends up at index 0
-    if (parentPath) visit(parentPath);
+    if (model.parentPath) visit(model.parentPath);
 
     levels.push({
       path: bare,
       depth: -1,
-      entityClass,
-      components: parseComponents(content),
-      rawContent: content,
+      entityClass: model.entityClass,
+      components: model.components,
+      rawContent: doc.text,
     });
+    docs.push(doc);
   }
 
   visit(startPath);
   levels.forEach((l, i) => { l.depth = i; });
 
+  return { levels, warnings, docs };
+}
+
+export function walkChain(
+  startPath: string,
+  config: Config,
+  projectPath?: string
+): { levels: AncestorLevel[]; warnings: string[] } {
+  const { levels, warnings } = readChain(startPath, config, projectPath);
   return { levels, warnings };
 }
 
@@ -190,41 +238,11 @@ export function walkChain(
  * WeaponComponent or UserActionContext inside ActionsManagerComponent.
  */
 export function parseTopLevelComponents(content: string): Map<string, ParsedComponent> {
-  const result = new Map<string, ParsedComponent>();
-  const block = extractComponentsBlock(content);
-  if (!block) return result;
-
-  let i = 0;
-  const len = block.length;
-
-  while (i < len) {
-    // Skip whitespace / newlines between top-level entries
-    while (i < len && (block[i] === " " || block[i] === "\t" || block[i] === "\n" || block[i] === "\r")) i++;
-    if (i >= len) break;
-
-    // Try to match a component declaration at this position:  TypeName "{16HEX}"... {
-    const m = /^(\w+)\s+"\{([0-9A-Fa-f]{16})\}"(?:[^{"\\]|"[^"]*")*\{/.exec(block.slice(i));
-    if (m) {
-      const typeName = m[1];
-      const guid = m[2];
-      const openBrace = i + m[0].length - 1; // m[0] ends with "{"
-      let depth = 1;
-      let j = openBrace + 1;
-      while (j < len && depth > 0) {
-        if (block[j] === "{") depth++;
-        else if (block[j] === "}") depth--;
-        j++;
-      }
-      const rawBody = block.slice(openBrace + 1, j - 1);
-      result.set(guid, { guid, typeName, rawBody });
-      i = j; // jump past this component's closing brace entirely
-    } else {
-      // Non-component line (property, comment, etc.) — skip to end of line
-      while (i < len && block[i] !== "\n") i++;
-    }
-  }
+  return topLevelOf(parseComponents(content));
+}
 
-  return result;
+export function topLevelOf(components: Map<string, ParsedComponent>): Map<string, ParsedComponent> {
+  return new Map([...components].filter(([, comp]) => comp.topLevel));
 }
 
 // ── Merge ─────────────────────────────────────────────────────────────────────
@@ -244,3 +262,122 @@ export function mergeAncestryComponents(levels: AncestorLevel[]): Map<string, Me
   }
   return merged;
 }
+
+/** Identity of a nested object when overlaying: its GUID, else type and name. */
+function overlayKey(node: EnfusionNode): string {
+  return node.id !== undefined && GUID_ID.test(node.id) ? node.id : `${node.type} ${node.id ?? ""}`;
+}
+
+/**
+ * Apply an override declaration on top of an inherited one, the way Enfusion
+ * resolves prefab inheritance: properties replace by key (new keys are
+ * appended), a non-empty value list replaces the inherited list, and nested
+ * objects are overlaid recursively when they match by GUID or by type and name.
+ */
+export function overlayNode(base: EnfusionNode, override: EnfusionNode): EnfusionNode {
+  const properties: EnfusionProperty[] = base.properties.map((p) => ({ ...p }));
+  for (const prop of override.properties) {
+    const i = properties.findIndex((p) => p.key === prop.key);
+    if (i === -1) properties.push({ ...prop });
+    else properties[i] = { ...prop };
+  }
+
+  const children = base.children.map(plainCopy);
+  for (const child of override.children) {
+    const key = overlayKey(child);
+    const i = children.findIndex((c) => overlayKey(c) === key);
+    if (i === -1) children.push(plainCopy(child));
+    else children[i] = overlayNode(children[i], child);
+  }
+
+  const node: EnfusionNode = {
+    type: override.type,
+    properties,
+    values: override.values.length > 0 ? [...override.values] : [...base.values],
+    children,
+  };
+  const id = override.id ?? base.id;
+  const className = override.className ?? base.className;
+  if (id !== undefined) node.id = id;
+  if (className !== undefined) node.className = className;
+  return node;
+}
+
+/** Detached copy of a (possibly lazy) node, so resolved trees never alias cached ones. */
+function plainCopy(src: EnfusionNode): EnfusionNode {
+  const node: EnfusionNode = {
+    type: src.type,
+    properties: src.properties.map((p) => ({ ...p })),
+    values: [...src.values],
+    children: src.children.map(plainCopy),
+  };
+  if (src.id !== undefined) node.id = src.id;
+  if (src.className !== undefined) node.className = src.className;
+  if (src.inheritance !== undefined) node.inheritance = src.inheritance;
+  return node;
+}
+
+/** Override-aware merge of every component along a chain, oldest level first. */
+export function resolveComponents(levels: AncestorLevel[]): Map<string, ResolvedComponent> {
+  const resolved = new Map<string, ResolvedComponent>();
+  for (const level of levels) {
+    for (const [guid, comp] of level.components) {
+      if (!comp.node) continue;
+      const prev = resolved.get(guid);
+      if (prev) {
+        prev.node = overlayNode(prev.node, comp.node);
+        prev.typeName = comp.typeName;
+        prev.topLevel ||= comp.topLevel ?? false;
+        prev.declaredIn.push(level);
+      } else {
+        resolved.set(guid, {
+          guid,
+          typeName: comp.typeName,
+          topLevel: comp.topLevel ?? false,
+          node: plainCopy(comp.node),
+          declaredIn: [level],
+        });
+      }
+    }
+  }
+  return resolved;
+}
+
+const MAX_RESOLVED = 256;
+
+/** Resolved prefabs by leaf path, valid while every level is still the same cache entry. */
+const resolvedPrefabs = new Map<string, { docs: CachedDocument[]; prefab: ResolvedPrefab }>();
+
+/**
+ * Walk a prefab's chain and resolve its components. The result is computed
+ * once and reused until any file in the chain changes (the walk itself only
+ * stats files; parsing and models come from the parse cache). Treat the
+ * returned objects as read-only.
+ */
+export function resolvePrefab(startPath: string, config: Config, projectPath?: string): ResolvedPrefab {
+  const chain = readChain(startPath, config, projectPath);
+  const key = `${projectPath || config.projectPath}|${stripGuid(startPath).toLowerCase()}`;
+
+  const cached = resolvedPrefabs.get(key);
+  if (
+    cached &&
+    cached.docs.length === chain.docs.length &&
+    cached.docs.every((doc, i) => doc === chain.docs[i])
+  ) {
+    resolvedPrefabs.delete(key);
+    resolvedPrefabs.set(key, cached);
+    return cached.prefab;
+  }
+
+  const prefab: ResolvedPrefab = {
+    levels: chain.levels,
+    warnings: chain.warnings,
+    components: resolveComponents(chain.levels),
+  };
+  resolvedPrefabs.delete(key);
+  resolvedPrefabs.set(key, { docs: chain.docs, prefab });
+  while (resolvedPrefabs.size > MAX_RESOLVED) {
+    resolvedPrefabs.delete(resolvedPrefabs.keys().next().value as string);
+  }
+  return prefab;
+}
@@ -0,0 +1,391 @@
+/**
+ * Inheritance graph of every prefab the tools can see: project addons, the
+ * extracted library, loose game data and the pak archives.
+ *
+ * Each .et file contributes one edge, from its root header's parent
+ * reference (`Class : "{GUID}Parent.et" {`) to that parent. Only the header is
+ * read (streamed, stopping at the first "{"), and the graph is persisted so a
+ * new session only re-reads prefabs whose file stat or pak location changed.
+ * A reverse index answers "which prefabs inherit from X" without scanning.
+ *
+ * Building is asynchronous and meant to run in the background: warm() starts
+ * it, ready() waits for a result no older than a given age.
+ */
+
+import { createHash } from "node:crypto";
+import { createReadStream } from "node:fs";
+import { mkdir, readFile, rename, stat, writeFile } from "node:fs/promises";
+import { homedir } from "node:os";
+import { dirname, join } from "node:path";
+import type { Readable } from "node:stream";
+import type { Config } from "../config.js";
+import { readRootHeader } from "../formats/enfusion-events.js";
+import { logger } from "./logger.js";
+import {
+  getResourceResolver,
+  resourceKey,
+  type ResolvedResource,
+  type ResourceResolver,
+  type ResourceSource,
+} from "./resource-resolver.js";
+import { prefabModel, readEtDocument, stripGuid } from "./prefab-ancestry.js";
+
+export interface PrefabGraphNode {
+  /** Resource path without GUID, e.g. "Prefabs/Weapons/Rifles/AK74/Rifle_AK74.et". */
+  path: string;
+  entityClass: string;
+  /** Parent resource path without GUID; null for a root prefab. */
+  parent: string | null;
+  source: ResourceSource;
+  /** File stat signature (mtime:size) or pak location the header was read from. */
+  version: string;
+}
+
+export interface PrefabDescendant {
+  node: PrefabGraphNode;
+  /** 1 for direct children. */
+  depth: number;
+}
+
+export interface PrefabGraphStats {
+  prefabs: number;
+  /** Headers read this run (new or changed files). */
+  read: number;
+  /** Entries carried over unchanged from the previous run or the persisted graph. */
+  reused: number;
+  /** Files whose header could not be read or parsed. */
+  failed: number;
+  ms: number;
+}
+
+export interface PrefabGraphOptions {
+  /** Where to persist the graph; null keeps it in memory only. */
+  cacheFile?: string | null;
+}
+
+/** Persisted form: one tuple per prefab to keep large graphs compact. */
+interface GraphFile {
+  format: number;
+  nodes: Array<[path: string, entityClass: string, parent: string | null, source: ResourceSource, version: string]>;
+}
+
+const FORMAT_VERSION = 1;
+
+/** Headers read at once; file and pak reads go through the libuv thread pool. */
+const READ_CONCURRENCY = 8;
+
+const DEFAULT_MAX_AGE_MS = 30_000;
+
+/** Stat signature of a file, or archive location of a pak entry (null if gone). */
+async function resourceVersion(resource: ResolvedResource): Promise<string | null> {
+  if (resource.kind === "pak") return resource.vfs.fileVersion(resource.path);
+  const st = await stat(resource.path);
+  return `${st.mtimeMs}:${st.size}`;
+}
+
+function openResource(resource: ResolvedResource): Readable {
+  if (resource.kind === "pak") return resource.vfs.createReadStream(resource.path);
+  return createReadStream(resource.path, { highWaterMark: 4096 });
+}
+
+/** Run fn over items with at most `limit` calls in flight. */
+async function forEachLimit<T>(items: T[], limit: number, fn: (item: T) => Promise<void>): Promise<void> {
+  let next = 0;
+  const worker = async () => {
+    while (next < items.length) await fn(items[next++]);
+  };
+  await Promise.all(Array.from({ length: Math.min(limit, items.length) }, worker));
+}
+
+export class PrefabGraph {
+  private readonly resolver: ResourceResolver;
+  private readonly cacheFile: string | null;
+  private nodes = new Map<string, PrefabGraphNode>();
+  /** Parent key -> keys of prefabs that name it as parent, sorted by path. */
+  private childIndex = new Map<string, string[]>();
+  private building: Promise<PrefabGraphStats> | null = null;
+  private builtAt = 0;
+  private loaded = false;
+
+  constructor(resolver: ResourceResolver, options: PrefabGraphOptions = {}) {
+    this.resolver = resolver;
+    this.cacheFile = options.cacheFile ?? null;
+  }
+
+  /** Number of prefabs in the graph. */
+  get size(): number {
+    return this.nodes.size;
+  }
+
+  /**
+   * Build the graph, or bring it up to date: only new and changed files are
+   * read. Concurrent calls share one run.
+   */
+  build(): Promise<PrefabGraphStats> {
+    if (!this.building) {
+      this.building = this.run().finally(() => {
+        this.building = null;
+      });
+    }
+    return this.building;
+  }
+
+  /** Start a build in the background if the graph was never built (or was invalidated). */
+  warm(): void {
+    if (this.builtAt > 0 || this.building) return;
+    this.build().catch((e) => logger.warn(`Prefab graph build failed: ${e}`));
+  }
+
+  /** Wait for a graph at most maxAgeMs old, refreshing it first if needed. */
+  async ready(maxAgeMs = DEFAULT_MAX_AGE_MS): Promise<void> {
+    if (this.building) await this.building;
+    if (this.builtAt === 0 || Date.now() - this.builtAt > maxAgeMs) await this.build();
+  }
+
+  /** Mark the graph stale (e.g. after writing prefabs); the next ready() refreshes it. */
+  invalidate(): void {
+    this.builtAt = 0;
+  }
+
+  get(path: string): PrefabGraphNode | undefined {
+    return this.nodes.get(resourceKey(stripGuid(path)));
+  }
+
+  /** Parent chain, nearest parent first. Stops at a parent that is not in the graph or at a cycle. */
+  ancestors(path: string): PrefabGraphNode[] {
+    const chain: PrefabGraphNode[] = [];
+    const seen = new Set<string>();
+    let node = this.get(path);
+    while (node?.parent) {
+      const key = resourceKey(node.parent);
+      if (seen.has(key)) break;
+      seen.add(key);
+      node = this.nodes.get(key);
+      if (node) chain.push(node);
+    }
+    return chain;
+  }
+
+  /** Prefabs that name `path` as their parent. */
+  children(path: string): PrefabGraphNode[] {
+    const keys = this.childIndex.get(resourceKey(stripGuid(path))) ?? [];
+    return keys.map((key) => this.nodes.get(key)!);
+  }
+
+  /** Every prefab inheriting from `path`, breadth first (nearest generations first). */
+  descendants(path: string, maxDepth = Infinity): PrefabDescendant[] {
+    const out: PrefabDescendant[] = [];
+    const seen = new Set<string>([resourceKey(stripGuid(path))]);
+    let frontier = [...seen];
+    for (let depth = 1; depth <= maxDepth && frontier.length > 0; depth++) {
+      const next: string[] = [];
+      for (const key of frontier) {
+        for (const child of this.childIndex.get(key) ?? []) {
+          if (seen.has(child)) continue;
+          seen.add(child);
+          out.push({ node: this.nodes.get(child)!, depth });
+          next.push(child);
+        }
+      }
+      frontier = next;
+    }
+    return out;
+  }
+
+  private async run(): Promise<PrefabGraphStats> {
+    const start = Date.now();
+    if (!this.loaded) {
+      this.loaded = true;
+      if (this.nodes.size === 0) await this.load();
+    }
+
+    const previous = this.nodes;
+    const next = new Map<string, PrefabGraphNode>();
+    const listed = this.resolver.list(".et");
+    let read = 0;
+    let reused = 0;
+    let failed = 0;
+
+    await forEachLimit(listed, READ_CONCURRENCY, async ({ path, resource }) => {
+      const key = resourceKey(path);
+      try {
+        const version = await resourceVersion(resource);
+        if (!version) {
+          failed++;
+          return;
+        }
+        const old = previous.get(key);
+        if (old && old.version === version && old.source === resource.source) {
+          next.set(key, old);
+          reused++;
+          return;
+        }
+        const header = await readRootHeader(openResource(resource));
+        next.set(key, {
+          path,
+          entityClass: header.type,
+          parent: header.inheritance ? stripGuid(header.inheritance) : null,
+          source: resource.source,
+          version,
+        });
+        read++;
+      } catch (e) {
+        failed++;
+        logger.debug(`Prefab graph: cannot read header of ${path}: ${e}`);
+      }
+    });
+
+    const changed = read > 0 || next.size !== previous.size;
+    this.nodes = next;
+    this.reindex();
+    this.builtAt = Date.now();
+    if (changed) await this.save();
+
+    const stats: PrefabGraphStats = { prefabs: next.size, read, reused, failed, ms: Date.now() - start };
+    logger.info(
+      `Prefab graph: ${stats.prefabs} prefabs (${read} read, ${reused} unchanged, ${failed} unreadable) in ${stats.ms}ms`
+    );
+    return stats;
+  }
+
+  private reindex(): void {
+    const index = new Map<string, string[]>();
+    for (const [key, node] of this.nodes) {
+      if (!node.parent) continue;
+      const parentKey = resourceKey(node.parent);
+      let children = index.get(parentKey);
+      if (!children) {
+        children = [];
+        index.set(parentKey, children);
+      }
+      children.push(key);
+    }
+    for (const children of index.values()) children.sort();
+    this.childIndex = index;
+  }
+
+  private async load(): Promise<void> {
+    if (!this.cacheFile) return;
+    try {
+      const file = JSON.parse(await readFile(this.cacheFile, "utf-8")) as GraphFile;
+      if (file.format !== FORMAT_VERSION) return;
+      for (const [path, entityClass, parent, source, version] of file.nodes) {
+        this.nodes.set(resourceKey(path), { path, entityClass, parent, source, version });
+      }
+    } catch (e) {
+      // Missing or corrupt: rebuild from scratch
+      if ((e as NodeJS.ErrnoException).code !== "ENOENT") logger.debug(`Ignoring prefab graph cache: ${e}`);
+    }
+  }
+
+  private async save(): Promise<void> {
+    if (!this.cacheFile) return;
+    const file: GraphFile = {
+      format: FORMAT_VERSION,
+      nodes: [...this.nodes.values()].map((n) => [n.path, n.entityClass, n.parent, n.source, n.version]),
+    };
+    try {
+      await mkdir(dirname(this.cacheFile), { recursive: true });
+      // Write then rename, so a crash never leaves a truncated cache
+      const tmp = `${this.cacheFile}.${process.pid}.tmp`;
+      await writeFile(tmp, JSON.stringify(file), "utf-8");
+      await rename(tmp, this.cacheFile);
+    } catch (e) {
+      logger.warn(`Failed to save prefab graph to ${this.cacheFile}: ${e}`);
+    }
+  }
+}
+
+// ── Impact analysis ───────────────────────────────────────────────────────────
+
+export interface ComponentImpact {
+  guid: string;
+  typeName: string;
+  /** Descendants that redeclare the component: their own values win over changes made here. */
+  overriddenBy: string[];
+}
+
+export interface PrefabImpact {
+  node: PrefabGraphNode;
+  /** Nearest parent first. */
+  ancestors: PrefabGraphNode[];
+  descendants: PrefabDescendant[];
+  /** Components declared in the prefab itself, with the descendants that override each. */
+  components: ComponentImpact[];
+  /** Descendants not opened for the component check (beyond maxRead). */
+  unread: number;
+}
+
+/** Descendants opened for the component check by default. */
+const DEFAULT_IMPACT_READS = 200;
+
+/**
+ * What depends on a prefab: every descendant, plus, for each component it
+ * declares, the descendants that redeclare that component. A change to the
+ * prefab reaches every descendant except for values those overrides set.
+ * Returns null if the prefab is not in the graph.
+ */
+export async function analyzePrefabImpact(
+  path: string,
+  config: Config,
+  projectPath?: string,
+  options: { maxRead?: number } = {}
+): Promise<PrefabImpact | null> {
+  const graph = getPrefabGraph(config, projectPath);
+  await graph.ready();
+  const node = graph.get(path);
+  if (!node) return null;
+
+  const descendants = graph.descendants(path);
+  const components: ComponentImpact[] = [];
+  const doc = readEtDocument(node.path, config, projectPath);
+  if (doc) {
+    for (const comp of prefabModel(doc).components.values()) {
+      components.push({ guid: comp.guid, typeName: comp.typeName, overriddenBy: [] });
+    }
+  }
+
+  const maxRead = options.maxRead ?? DEFAULT_IMPACT_READS;
+  const toRead = components.length > 0 ? descendants.slice(0, maxRead) : [];
+  for (const { node: child } of toRead) {
+    const childDoc = readEtDocument(child.path, config, projectPath);
+    if (!childDoc) continue;
+    const declared = prefabModel(childDoc).components;
+    for (const comp of components) {
+      if (declared.has(comp.guid)) comp.overriddenBy.push(child.path);
+    }
+  }
+
+  return {
+    node,
+    ancestors: graph.ancestors(path),
+    descendants,
+    components,
+    unread: components.length > 0 ? descendants.length - toRead.length : 0,
+  };
+}
+
+// ── Shared instances ──────────────────────────────────────────────────────────
+
+const graphs = new Map<ResourceResolver, PrefabGraph>();
+
+/** Persisted graph location for a set of resource roots. */
+function graphCacheFile(resolver: ResourceResolver): string {
+  const { projectPath, extractedPath, gamePath } = resolver.roots;
+  const id = createHash("sha1")
+    .update(`${projectPath ?? ""}|${extractedPath ?? ""}|${gamePath}`)
+    .digest("hex")
+    .slice(0, 16);
+  return join(homedir(), ".enfusion-mcp", "cache", `prefab-graph-${id}.json`);
+}
+
+/** Shared graph over the same roots as getResourceResolver(config, projectPath). */
+export function getPrefabGraph(config: Config, projectPath?: string): PrefabGraph {
+  const resolver = getResourceResolver(config, projectPath);
+  let graph = graphs.get(resolver);
+  if (!graph) {
+    graph = new PrefabGraph(resolver, { cacheFile: graphCacheFile(resolver) });
+    graphs.set(resolver, graph);
+  }
+  return graph;
+}
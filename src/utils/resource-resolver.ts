@@ -0,0 +1,333 @@
+/**
+ * Case-insensitive index of resource paths across everywhere a prefab can
+ * live: the project's addons, the extracted library, loose game data and the
+ * pak archives.
+ *
+ * Each directory root is scanned once into a hash map, so a lookup is one
+ * probe per root instead of existsSync() calls over every addon and DataXXX
+ * folder. A root is rescanned, at most once per revalidation interval, when
+ * a file below it was added, removed or renamed:
+ *   - the project is tracked in full: by a recursive fs.watch on macOS and
+ *     Windows, where it is one native watch, and by re-checking every
+ *     directory's mtime elsewhere (Linux emulates recursive watches with one
+ *     inotify watch per directory, which large trees exhaust)
+ *   - the extracted library and game data only change when they are
+ *     re-extracted or the game updates, so only the mtimes of their root and
+ *     addon/DataXXX folders are checked; invalidate() covers the rest
+ * Edits to a file's content don't change the index; the parse cache
+ * revalidates those.
+ */
+
+import { readdirSync, statSync, watch, type FSWatcher } from "node:fs";
+import { join } from "node:path";
+import type { Config } from "../config.js";
+import { PakVirtualFS } from "../pak/vfs.js";
+import { resolveGameDataPath } from "./game-paths.js";
+
+/** Where a resource was found, in precedence order. */
+export type ResourceSource = "project" | "extracted" | "game" | "pak";
+
+export type ResolvedResource =
+  | { kind: "file"; path: string; source: ResourceSource }
+  | { kind: "pak"; path: string; source: ResourceSource; vfs: PakVirtualFS };
+
+export interface ListedResource {
+  /** Path relative to an addon root, in its on-disk (or in-archive) case. */
+  path: string;
+  resource: ResolvedResource;
+}
+
+export interface ResourceRoots {
+  /** Addons folder: files resolve at its top level or inside any addon subfolder. */
+  projectPath?: string;
+  /** Extracted library: top level or any DataXXX subfolder. */
+  extractedPath?: string;
+  /** Game install; loose data and paks are found under its addons folder. */
+  gamePath: string;
+}
+
+const DEFAULT_REVALIDATE_MS = 2000;
+
+/** Selects first-level folders by name. */
+type DirFilter = (name: string) => boolean;
+
+/** Lookup key: forward slashes, no leading/trailing slash, lower case. */
+export function resourceKey(resourcePath: string): string {
+  return resourcePath.replace(/\\/g, "/").replace(/^\/+|\/+$/g, "").replace(/\/+/g, "/").toLowerCase();
+}
+
+/**
+ * Files under one root directory, by relative path and by path below a
+ * first-level folder. Values are root-relative paths in their on-disk case
+ * (shared between both maps) rather than absolute paths, to keep large
+ * extracted libraries cheap to hold.
+ */
+class DirIndex {
+  readonly source: ResourceSource;
+  private readonly root: string;
+  /** First-level folders whose contents also resolve without the folder name. */
+  private readonly nestedDir: DirFilter;
+  private direct = new Map<string, string>();
+  private nested = new Map<string, string>();
+  /** Track changes anywhere below the root, not just in its first two levels. */
+  private readonly wholeTree: boolean;
+  private direct = new Map<string, string>();
+  private nested = new Map<string, string>();
+  /** mtime of each tracked directory (-1 if the root was missing), for when there is no watcher. */
+  private dirs = new Map<string, number>();
+  private watcher: FSWatcher | null = null;
+  /** Set by the watcher when an entry was added, removed or renamed. */
+  private dirty = false;
+  /** Rescan on the next lookup, regardless of the revalidation interval. */
+  stale = false;
+
+  constructor(source: ResourceSource, root: string, nestedDir: DirFilter, wholeTree: boolean) {
+    this.source = source;
+    this.root = root;
+    this.nestedDir = nestedDir;
+    this.wholeTree = wholeTree;
+  }
+
+  /** Absolute path for a lookup key, if indexed. */
+  lookup(key: string): string | undefined {
+    const rel = this.direct.get(key) ?? this.nested.get(key);
+    return rel === undefined ? undefined : join(this.root, rel);
+  }
+
+  /**
+   * Every file as [resource path, absolute path], in lookup precedence: files
+   * outside the strippable folders first, then the first copy below them.
+   */
+  files(): Array<[string, string]> {
+    const files: Array<[string, string]> = [];
+    for (const rel of this.direct.values()) {
+      const slash = rel.indexOf("/");
+      if (slash === -1 || !this.nestedDir(rel.slice(0, slash))) files.push([rel, join(this.root, rel)]);
+    }
+    for (const [below, rel] of this.nested) {
+      files.push([rel.slice(rel.length - below.length), join(this.root, rel)]);
+    }
+    return files;
+  }
+
+  build(): void {
+    this.close();
+    this.direct = new Map();
+    this.nested = new Map();
+    this.dirs = new Map();
+    this.dirty = false;
+    this.stale = false;
+    this.scan(this.root, "", null);
+    this.watch();
+  }
+
+  /** True if an entry was added, removed or renamed since build(). */
+  changed(): boolean {
+    if (this.dirty) return true;
+    if (this.watcher) return false;
+    for (const [dir, mtime] of this.dirs) {
+      let current = -1;
+      try {
+        current = statSync(dir).mtimeMs;
+      } catch {
+        // Missing: -1
+      }
+      if (current !== mtime) return true;
+    }
+    return false;
+  }
+
+  close(): void {
+    this.watcher?.close();
+    this.watcher = null;
+  }
+
+  private watch(): void {
+    if (!this.wholeTree || process.platform === "linux") return;
+    if (this.dirs.get(this.root) === -1) return; // Missing root: the mtime check notices it appearing
+    try {
+      const watcher = watch(this.root, { recursive: true, persistent: false }, (event, name) => {
+        // Content edits leave the index alone; dot-entries are never indexed
+        if (event === "rename" && !(name && /(^|[\\/])\./.test(name))) this.dirty = true;
+      });
+      watcher.on("error", () => {
+        // e.g. the root was removed: rescan, which retries the watch
+        watcher.close();
+        if (this.watcher === watcher) this.watcher = null;
+        this.dirty = true;
+      });
+      this.watcher = watcher;
+    } catch {
+      // Recursive watch unsupported here: changed() falls back to directory mtimes
+    }
+  }
+
+  /** `nestedPrefix` is the relative path of the first-level folder this directory is under, if strippable. */
+  private scan(dir: string, rel: string, nestedPrefix: string | null): void {
+    let entries;
+    try {
+      const tracked = this.wholeTree || !rel.includes("/");
+      if (tracked) this.dirs.set(dir, statSync(dir).mtimeMs);
+      entries = readdirSync(dir, { withFileTypes: true });
+    } catch {
+      if (rel === "") this.dirs.set(dir, -1);
+      return;
+    }
+    // Sorted so the first addon/DataXXX folder to hold a path wins deterministically
+    entries.sort((a, b) => (a.name < b.name ? -1 : a.name > b.name ? 1 : 0));
+
+    for (const entry of entries) {
+      if (entry.name.startsWith(".")) continue;
+      const childRel = rel ? `${rel}/${entry.name}` : entry.name;
+      if (entry.isDirectory()) {
+        const prefix = rel === "" && this.nestedDir(entry.name) ? `${childRel}/` : nestedPrefix;
+        this.scan(join(dir, entry.name), childRel, prefix);
+      } else {
+        const key = childRel.toLowerCase();
+        this.direct.set(key, childRel);
+        if (nestedPrefix) {
+          const below = key.slice(nestedPrefix.length);
+          if (!this.nested.has(below)) this.nested.set(below, childRel);
+        }
+      }
+    }
+  }
+}
+
+export class ResourceResolver {
+  readonly roots: ResourceRoots;
+  private readonly revalidateMs: number;
+  private layers: DirIndex[] | null = null;
+  private checkedAt = 0;
+  private pakVfs: PakVirtualFS | null = null;
+  /** Lower-case pak path -> path as stored in the archive. */
+  private pakIndex = new Map<string, string>();
+
+  constructor(roots: ResourceRoots, options: { revalidateMs?: number } = {}) {
+    this.roots = roots;
+    this.revalidateMs = options.revalidateMs ?? DEFAULT_REVALIDATE_MS;
+  }
+
+  /**
+   * Find a resource by its path relative to an addon root (no GUID prefix).
+   * Precedence: project addons, extracted library, loose game data, paks.
+   */
+  resolve(resourcePath: string): ResolvedResource | null {
+    const layers = this.ensureLayers();
+    const key = resourceKey(resourcePath);
+
+    for (const layer of layers) {
+      const hit = layer.lookup(key);
+      if (hit) return { kind: "file", path: hit, source: layer.source };
+    }
+
+    const vfs = this.ensurePakIndex();
+    const pakPath = this.pakIndex.get(key);
+    return vfs && pakPath ? { kind: "pak", path: pakPath, source: "pak", vfs } : null;
+  }
+
+  /**
+   * Every resource whose path ends with `extension` (e.g. ".et"), once per
+   * path, located where resolve() would find it.
+   */
+  list(extension: string): ListedResource[] {
+    const suffix = extension.toLowerCase();
+    const seen = new Set<string>();
+    const listed: ListedResource[] = [];
+
+    for (const layer of this.ensureLayers()) {
+      for (const [path, abs] of layer.files()) {
+        const key = resourceKey(path);
+        if (!key.endsWith(suffix) || seen.has(key)) continue;
+        seen.add(key);
+        const resource: ResolvedResource = { kind: "file", path: abs, source: layer.source };
+        listed.push({ path, resource });
+      }
+    }
+
+    const vfs = this.ensurePakIndex();
+    if (vfs) {
+      for (const [key, path] of this.pakIndex) {
+        if (!key.endsWith(suffix) || seen.has(key)) continue;
+        seen.add(key);
+        const resource: ResolvedResource = { kind: "pak", path, source: "pak", vfs };
+        listed.push({ path, resource });
+      }
+    }
+    return listed;
+  }
+
+  /** Rescan everything on the next lookup, including the pak index. */
+  invalidate(): void {
+    for (const layer of this.layers ?? []) layer.close();
+    this.layers = null;
+    this.pakVfs = null;
+  }
+
+  /**
+   * Rescan only the project addons on the next lookup, e.g. after writing a
+   * prefab into the project. The extracted library, game data and paks are
+   * left alone.
+   */
+  invalidateProject(): void {
+    for (const layer of this.layers ?? []) if (layer.source === "project") layer.stale = true;
+  }
+
+  private ensureLayers(): DirIndex[] {
+    if (!this.layers) {
+      const { projectPath, extractedPath, gamePath } = this.roots;
+      const isDataDir = (name: string) => name.startsWith("Data");
+      const layers: DirIndex[] = [];
+      if (projectPath) layers.push(new DirIndex("project", projectPath, () => true, true));
+      if (extractedPath) layers.push(new DirIndex("extracted", extractedPath, isDataDir, false));
+      const gameDataPath = resolveGameDataPath(gamePath);
+      if (gameDataPath) layers.push(new DirIndex("game", gameDataPath, isDataDir, false));
+      for (const layer of layers) layer.build();
+      this.layers = layers;
+      this.checkedAt = Date.now();
+      return layers;
+    }
+
+    const now = Date.now();
+    const revalidate = now - this.checkedAt >= this.revalidateMs;
+    if (revalidate) this.checkedAt = now;
+    for (const layer of this.layers) {
+      if (layer.stale || (revalidate && layer.changed())) layer.build();
+    }
+    return this.layers;
+  }
+
+  private ensurePakIndex(): PakVirtualFS | null {
+    const vfs = PakVirtualFS.get(this.roots.gamePath);
+    if (vfs !== this.pakVfs) {
+      // New or rebuilt VFS (PakVirtualFS.invalidate())
+      this.pakVfs = vfs;
+      this.pakIndex = new Map();
+      if (vfs) {
+        for (const path of vfs.allFilePaths()) {
+          const key = resourceKey(path);
+          if (!this.pakIndex.has(key)) this.pakIndex.set(key, path);
+        }
+      }
+    }
+    return vfs;
+  }
+}
+
+const resolvers = new Map<string, ResourceResolver>();
+
+/** Shared resolver for a config and optional project override. */
+export function getResourceResolver(config: Config, projectPath?: string): ResourceResolver {
+  const roots: ResourceRoots = {
+    projectPath: projectPath || config.projectPath || undefined,
+    extractedPath: config.extractedPath,
+    gamePath: config.gamePath,
+  };
+  const key = `${roots.projectPath ?? ""}|${roots.extractedPath ?? ""}|${roots.gamePath}`;
+  let resolver = resolvers.get(key);
+  if (!resolver) {
+    resolver = new ResourceResolver(roots);
+    resolvers.set(key, resolver);
+  }
+  return resolver;
+}
@@ -0,0 +1,125 @@
+/**
+ * Per-project store for incremental mod validation: the facts extracted from
+ * each file (content hash, declared and referenced classes) and the issues
+ * each per-file check reported for it, keyed by project-relative path.
+ *
+ * Lives in the project's hidden `.enfusion-mcp` folder, which the validator's
+ * walk skips like every dot-entry. Entries are revalidated by stat signature
+ * and content hash in validateMod(); this module only loads and saves them.
+ * Issues depend on the API index, so they are dropped (facts are kept) when
+ * the index fingerprint differs from the one they were computed against.
+ */
+
+import { mkdirSync, readFileSync, renameSync, writeFileSync } from "node:fs";
+import { dirname, join } from "node:path";
+import { logger } from "./logger.js";
+import type { CheckName, FileFacts, ValidationIssue } from "./mod-validator.js";
+
+export interface ValidationCacheEntry {
+  /** Stat signature (mtime:size) the facts were read at. */
+  version: string;
+  facts: FileFacts;
+  /** Issues of the per-file checks that ran since the file last changed. */
+  issues: Partial<Record<CheckName, ValidationIssue[]>>;
+}
+
+interface CacheFile {
+  format: number;
+  api: string;
+  files: Record<string, ValidationCacheEntry>;
+}
+
+const FORMAT_VERSION = 1;
+
+export class ValidationCache {
+  readonly file: string;
+  private api = "";
+  private files = new Map<string, ValidationCacheEntry>();
+  private dirty = false;
+
+  private constructor(file: string) {
+    this.file = file;
+  }
+
+  /**
+   * The project's cache, loaded from disk on first use and then held in
+   * memory. Stored issues are discarded if `api` (the API index fingerprint)
+   * changed.
+   */
+  static open(projectPath: string, api: string): ValidationCache {
+    let cache = caches.get(projectPath);
+    if (!cache) {
+      cache = new ValidationCache(join(projectPath, ".enfusion-mcp", "validation-cache.json"));
+      cache.load();
+      caches.set(projectPath, cache);
+    }
+    if (cache.api !== api) {
+      for (const entry of cache.files.values()) entry.issues = {};
+      cache.api = api;
+      cache.dirty = true;
+    }
+    return cache;
+  }
+
+  get(rel: string): ValidationCacheEntry | undefined {
+    return this.files.get(rel);
+  }
+
+  entries(): IterableIterator<[string, ValidationCacheEntry]> {
+    return this.files.entries();
+  }
+
+  set(rel: string, entry: ValidationCacheEntry): void {
+    this.files.set(rel, entry);
+    this.dirty = true;
+  }
+
+  setIssues(rel: string, check: CheckName, issues: ValidationIssue[]): void {
+    const entry = this.files.get(rel);
+    if (!entry) return;
+    entry.issues[check] = issues;
+    this.dirty = true;
+  }
+
+  /** Forget every check's issues for a file, so the next run that visits it rechecks it. */
+  clearIssues(rel: string): void {
+    const entry = this.files.get(rel);
+    if (!entry || Object.keys(entry.issues).length === 0) return;
+    entry.issues = {};
+    this.dirty = true;
+  }
+
+  delete(rel: string): void {
+    if (this.files.delete(rel)) this.dirty = true;
+  }
+
+  /** Write to disk if anything changed since the last load or save. */
+  save(): void {
+    if (!this.dirty) return;
+    const file: CacheFile = { format: FORMAT_VERSION, api: this.api, files: Object.fromEntries(this.files) };
+    try {
+      mkdirSync(dirname(this.file), { recursive: true });
+      // Write then rename, so a crash never leaves a truncated cache
+      const tmp = `${this.file}.${process.pid}.tmp`;
+      writeFileSync(tmp, JSON.stringify(file), "utf-8");
+      renameSync(tmp, this.file);
+      this.dirty = false;
+    } catch (e) {
+      logger.warn(`Failed to save validation cache to ${this.file}: ${e}`);
+    }
+  }
+
+  private load(): void {
+    try {
+      const file = JSON.parse(readFileSync(this.file, "utf-8")) as CacheFile;
+      if (file.format !== FORMAT_VERSION) return;
+      this.api = file.api;
+      this.files = new Map(Object.entries(file.files));
+    } catch (e) {
+      // Missing or corrupt: validate from scratch
+      if ((e as NodeJS.ErrnoException).code !== "ENOENT") logger.debug(`Ignoring validation cache: ${e}`);
+    }
+  }
+}
+
+const caches = new Map<string, ValidationCache>();
@@ -0,0 +1,122 @@
+/**
+ * Client side of EMCP_WB_BulkCreateEntity: create, parent and configure a set
+ * of entities in a single Workbench call and undo step.
+ */
+
+import type { WorkbenchClient } from "./client.js";
+import { encodeEscapedRecords, encodeRecords } from "./records.js";
+
+export interface BulkEntityProperty {
+  /** "Component.m_sProp", or just "m_sProp" for root entity properties. Quoted keys ("faction affiliation") are unquoted. */
+  property: string;
+  value: string;
+}
+
+export interface BulkEntitySpec {
+  prefab: string;
+  name?: string;
+  layerID?: number;
+  /** 'x y z' — world position, or local to parent when parent is set. */
+  position?: string;
+  /** 'pitch yaw roll' in degrees. */
+  rotation?: string;
+  /** Name of an entity earlier in the batch or already in the world. */
+  parent?: string;
+  properties?: BulkEntityProperty[];
+}
+
+export interface BulkCreateResult {
+  status: string;
+  /** Parallel to the specs: created name, or "" where that entity failed. */
+  names: string[];
+  created: string[];
+  errors: { index: number; message: string }[];
+  propertyWarnings: string[];
+  rolledBack: boolean;
+  /** Entities the atomic rollback deleted. */
+  rolledBackCount: number;
+  /** Entities the atomic rollback failed to delete; they are still in the world. */
+  leftBehind: string[];
+  message: string;
+}
+
+/** Split "Component.prop" into the propertyPath/propertyKey pair EMCP handlers expect. */
+export function splitPropertyPath(componentDotProp: string): { propertyPath: string; propertyKey: string } {
+  const dot = componentDotProp.lastIndexOf(".");
+  const propertyPath = dot === -1 ? "" : componentDotProp.slice(0, dot);
+  let propertyKey = dot === -1 ? componentDotProp : componentDotProp.slice(dot + 1);
+  // Strip surrounding quotes from property key (Enfusion file format uses "faction affiliation" style keys)
+  if (propertyKey.startsWith('"') && propertyKey.endsWith('"')) {
+    propertyKey = propertyKey.slice(1, -1);
+  }
+  return { propertyPath, propertyKey };
+}
+
+/**
+ * Encode the initial properties of an EMCP_WB_Components bulkAdd as
+ * 'propertyPath\tpropertyKey\tvalue' records, path relative to the new
+ * component. Escaped like bulk-create properties, so free-text values may
+ * hold tabs and newlines.
+ */
+export function encodeComponentProperties(properties: ReadonlyArray<BulkEntityProperty>): string {
+  return encodeEscapedRecords(
+    properties.map((p) => {
+      const { propertyPath, propertyKey } = splitPropertyPath(p.property);
+      return [propertyPath, propertyKey, p.value];
+    })
+  );
+}
+
+/**
+ * Encode specs into the entities/properties record payloads of
+ * EMCP_WB_BulkCreateEntity. Property values are free text (task descriptions),
+ * so that payload is escaped rather than rejecting tabs and newlines.
+ */
+export function encodeBulkCreate(specs: ReadonlyArray<BulkEntitySpec>): { entities: string; properties: string } {
+  const entities = encodeRecords(
+    specs.map((s) => [s.prefab, s.name, s.layerID, s.position, s.rotation, s.parent])
+  );
+
+  const propertyRows: string[][] = [];
+  for (const spec of specs) {
+    if (!spec.properties?.length) continue;
+    if (!spec.name) {
+      throw new Error(`Entity from ${spec.prefab} has properties but no name to target them`);
+    }
+    for (const prop of spec.properties) {
+      const { propertyPath, propertyKey } = splitPropertyPath(prop.property);
+      propertyRows.push([spec.name, propertyPath, propertyKey, prop.value]);
+    }
+  }
+
+  return { entities, properties: encodeEscapedRecords(propertyRows) };
+}
+
+/** Create all specs in one call. With atomic, any create/parent failure leaves nothing behind. */
+export async function bulkCreateEntities(
+  client: WorkbenchClient,
+  specs: ReadonlyArray<BulkEntitySpec>,
+  options: { atomic?: boolean } = {}
+): Promise<BulkCreateResult> {
+  const { entities, properties } = encodeBulkCreate(specs);
+  const res = await client.call<Record<string, unknown>>("EMCP_WB_BulkCreateEntity", {
+    entities,
+    properties,
+    atomic: options.atomic ?? false,
+  });
+
+  const names = Array.isArray(res.names) ? res.names.map(String) : [];
+  return {
+    status: String(res.status ?? "error"),
+    names,
+    created: names.filter((n) => n !== ""),
+    errors: Array.isArray(res.errors)
+      ? (res.errors as Record<string, unknown>[]).map((e) => ({ index: Number(e.index), message: String(e.message ?? "") }))
+      : [],
+    propertyWarnings: Array.isArray(res.propertyWarnings) ? res.propertyWarnings.map(String) : [],
+    rolledBack: res.rolledBack === true,
+    rolledBackCount: Number(res.rolledBackCount ?? 0),
+    leftBehind: Array.isArray(res.leftBehind) ? res.leftBehind.map(String) : [],
+    message: String(res.message ?? ""),
+  };
+}
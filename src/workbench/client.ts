@@ -2,7 +2,10 @@
  * TCP client for the Workbench NET API.
  *
  * Each rawCall() opens a fresh TCP connection, sends one request, reads the
- * response, and closes the socket (protocol requirement).
+ * response, and closes the socket (protocol requirement). With a pool size
+ * configured, the connect phase is done ahead of time by a ConnectionPool and
+ * rawCall() only writes the request; it falls back to a fresh connection when
+ * no pooled socket is usable.
  *
  * call() wraps rawCall() with auto-launch: if Workbench isn't running,
  * it installs handler scripts, launches the exe, waits for the NET API,
@@ -15,6 +18,8 @@ import { join, resolve, dirname } from "node:path";
 import { fileURLToPath } from "node:url";
 import { spawn, execSync } from "node:child_process";
 import { encodeRequest, decodeResponse } from "./protocol.js";
+import { ConnectionPool } from "./connection-pool.js";
+import { waitForReady, formatReadinessPhases, type ProbeOutcome, type ReadinessReport } from "./readiness.js";
 import { logger } from "../utils/logger.js";
 import type { Config } from "../config.js";
 import { generateGproj } from "../templates/gproj.js";
@@ -26,14 +31,13 @@ const MAX_RESPONSE_SIZE = 10 * 1024 * 1024;
 const WORKBENCH_EXE = "ArmaReforgerWorkbenchSteamDiag.exe";
 const WORKBENCH_SUBDIR = "Workbench";
 const HANDLER_FOLDER = "EnfusionMCP";
-const LAUNCH_POLL_INTERVAL_MS = 3_000;
 const LAUNCH_TIMEOUT_MS = 90_000;
+/** Per-probe timeout while waiting for Workbench to become ready. */
+const READINESS_PROBE_TIMEOUT_MS = 1_500;
 /** Delay after killing Workbench before relaunching, to let the port release. */
 const KILL_SETTLE_MS = 3_000;
 /** How long to wait for Workbench to recompile handler scripts after installation. */
 const HANDLER_RECOMPILE_TIMEOUT_MS = 30_000;
-/** Interval between polls while waiting for handler script recompilation. */
-const HANDLER_RECOMPILE_POLL_MS = 2_000;
 
 export type WorkbenchMode = "edit" | "play" | "unknown";
 
@@ -49,6 +53,8 @@ export interface DiagnosticReport {
   /** Result of the NET API probe. */
   netApi: "up_with_handlers" | "up_no_handlers" | "refused" | "timeout" | "error";
   netApiError?: string;
+  /** Phase timings of the most recent launch/recovery wait, if any happened this session. */
+  lastLaunch: ReadinessReport | null;
 }
 
 export interface WorkbenchState {
@@ -62,6 +68,12 @@ export interface WorkbenchCallOptions {
   timeout?: number;
   /** Skip auto-launch on connection failure (used internally by ping). */
   skipAutoLaunch?: boolean;
+  /**
+   * The handler only reads Workbench state. Once a request has been written
+   * Workbench may already have run it, so only replay-safe calls are resent
+   * after a pooled socket drops mid-call; creates, deletes and edits are not.
+   */
+  replaySafe?: boolean;
 }
 
 export class WorkbenchError extends Error {
@@ -79,21 +91,42 @@ export class WorkbenchError extends Error {
   }
 }
 
+/**
+ * A pooled socket that was found dead before the request was written, or that
+ * dropped without a response to a replay-safe call. Either way resending cannot
+ * apply anything twice, so rawCall() retries it on a fresh connection.
+ */
+class PooledSocketDroppedError extends WorkbenchError {
+  constructor(message: string) {
+    super(message, "PROTOCOL_ERROR");
+  }
+}
+
 export class WorkbenchClient {
   private launchPromise: Promise<void> | null = null;
   private _state: WorkbenchState = { connected: false, mode: "unknown", lastUpdated: 0 };
+  private readonly pool: ConnectionPool | null;
+  private _lastLaunch: ReadinessReport | null = null;
 
   /** Current cached connection state. Updated after every successful call. */
   get state(): Readonly<WorkbenchState> {
     return this._state;
   }
 
+  /** Readiness timings from the most recent launch or handler recovery. */
+  get lastLaunch(): Readonly<ReadinessReport> | null {
+    return this._lastLaunch;
+  }
+
   constructor(
     private readonly host: string,
     private readonly port: number,
     private readonly config?: Config,
     private readonly clientId: string = DEFAULT_CLIENT_ID
-  ) {}
+  ) {
+    const poolSize = config?.workbenchPoolSize ?? 0;
+    this.pool = poolSize > 0 ? new ConnectionPool(host, port, poolSize) : null;
+  }
 
   /**
    * Call a Workbench NET API function.
@@ -149,7 +182,7 @@ export class WorkbenchClient {
    */
   async refreshState(): Promise<WorkbenchState> {
     try {
-      await this.call<Record<string, unknown>>("EMCP_WB_GetState");
+      await this.call<Record<string, unknown>>("EMCP_WB_GetState", {}, { replaySafe: true });
       return { ...this._state };
     } catch {
       this._state = { connected: false, mode: "unknown", lastUpdated: Date.now() };
@@ -194,7 +227,7 @@ export class WorkbenchClient {
    */
   async ping(): Promise<boolean> {
     try {
-      await this.rawCall("EMCP_WB_Ping", {}, { timeout: 3000, skipAutoLaunch: true });
+      await this.rawCall("EMCP_WB_Ping", {}, { timeout: 3000, skipAutoLaunch: true, replaySafe: true });
       return true;
     } catch {
       return false;
@@ -297,7 +330,7 @@ export class WorkbenchClient {
     let netApi: DiagnosticReport["netApi"] = "refused";
     let netApiError: string | undefined;
     try {
-      await this.rawCall("EMCP_WB_Ping", {}, { timeout: 3000, skipAutoLaunch: true });
+      await this.rawCall("EMCP_WB_Ping", {}, { timeout: 3000, skipAutoLaunch: true, replaySafe: true });
       netApi = "up_with_handlers";
     } catch (err) {
       if (err instanceof WorkbenchError) {
@@ -328,6 +361,7 @@ export class WorkbenchClient {
       installedMods,
       netApi,
       netApiError,
+      lastLaunch: this._lastLaunch,
     };
   }
 
@@ -349,6 +383,11 @@ export class WorkbenchClient {
     }
   }
 
+  /** Release pooled sockets. Safe to call when pooling is disabled. */
+  close(): void {
+    this.pool?.close();
+  }
+
   toString(): string {
     return `WorkbenchClient(${this.host}:${this.port})`;
   }
@@ -396,16 +435,13 @@ export class WorkbenchClient {
 
     // Wait for Workbench to detect the new files and recompile scripts.
     // Workbench watches its script directories and recompiles automatically.
-    // Poll with our custom EMCP_WB_Ping handler — it only succeeds once
+    // Probe with our custom EMCP_WB_Ping handler — it only succeeds once
     // the handler scripts are compiled and registered.
     logger.info("Handler scripts installed. Waiting for Workbench to recompile...");
-    const deadline = Date.now() + HANDLER_RECOMPILE_TIMEOUT_MS;
-    while (Date.now() < deadline) {
-      await new Promise((r) => setTimeout(r, HANDLER_RECOMPILE_POLL_MS));
-      if (await this.ping()) {
-        logger.info("Handler scripts compiled and loaded.");
-        return;
-      }
+    const report = await this.waitUntilReady(HANDLER_RECOMPILE_TIMEOUT_MS, true);
+    if (report.ready) {
+      logger.info(`Handler scripts compiled and loaded (${formatReadinessPhases(report)}).`);
+      return;
     }
 
     throw new WorkbenchError(
@@ -492,24 +528,16 @@ export class WorkbenchClient {
     });
     proc.unref();
 
-    // 5. Wait for NET API — track the last error type so the timeout message is actionable
-    const deadline = Date.now() + LAUNCH_TIMEOUT_MS;
-    let lastErrorCode: WorkbenchError["code"] | undefined;
-    while (Date.now() < deadline) {
-      try {
-        await this.rawCall("EMCP_WB_Ping", {}, { timeout: 3000, skipAutoLaunch: true });
-        this._state.connected = true;
-        this._state.lastUpdated = Date.now();
-        logger.info("Workbench NET API is responding.");
-        return;
-      } catch (err) {
-        if (err instanceof WorkbenchError) {
-          lastErrorCode = err.code;
-          logger.debug(`Workbench poll (${err.code}): ${err.message}`);
-        }
-      }
-      await new Promise((r) => setTimeout(r, LAUNCH_POLL_INTERVAL_MS));
+    // 5. Wait for NET API — backoff probe woken early by Workbench log markers.
+    //    The last error type is kept so the timeout message is actionable.
+    const report = await this.waitUntilReady(LAUNCH_TIMEOUT_MS, false);
+    if (report.ready) {
+      this._state.connected = true;
+      this._state.lastUpdated = Date.now();
+      logger.info(`Workbench NET API is responding (${formatReadinessPhases(report)}).`);
+      return;
     }
+    const lastErrorCode = report.lastProbeError;
 
     // Build a specific diagnostic based on what was failing at timeout.
     // CONNECTION_REFUSED = NET API port never opened → NET API likely disabled.
@@ -534,6 +562,41 @@ export class WorkbenchClient {
     );
   }
 
+  /**
+   * Wait for EMCP_WB_Ping to answer, recording phase timings for wb_diagnose.
+   * Tails the Workbench console log (next to the addons directory) when it can be located.
+   * attached = Workbench was already running, so tail its newest log instead of a new one.
+   */
+  private async waitUntilReady(timeoutMs: number, attached: boolean): Promise<ReadinessReport> {
+    const logsDir = this.config?.projectPath ? join(dirname(this.config.projectPath), "logs") : undefined;
+    const report = await waitForReady({
+      probe: () => this.probeHandlers(),
+      timeoutMs,
+      logsDir,
+      attached,
+    });
+    this._lastLaunch = report;
+    return report;
+  }
+
+  /** Single readiness probe: "ready" if EMCP_WB_Ping answers, otherwise the error code. */
+  private async probeHandlers(): Promise<ProbeOutcome> {
+    try {
+      await this.rawCall(
+        "EMCP_WB_Ping",
+        {},
+        { timeout: READINESS_PROBE_TIMEOUT_MS, skipAutoLaunch: true, replaySafe: true }
+      );
+      return "ready";
+    } catch (err) {
+      if (err instanceof WorkbenchError) {
+        logger.debug(`Workbench probe (${err.code}): ${err.message}`);
+        return err.code;
+      }
+      return "PROTOCOL_ERROR";
+    }
+  }
+
   private findWorkbenchExe(): string | null {
     if (!this.config) return null;
     const subPath = join(this.config.workbenchPath, WORKBENCH_SUBDIR, WORKBENCH_EXE);
@@ -680,12 +743,40 @@ export class WorkbenchClient {
   }
 
   /**
-   * Raw TCP call — no auto-launch, no retry.
+   * Raw TCP call — no auto-launch. Uses a pre-connected socket when the pool
+   * has one; the only retry is for a pooled socket that was dead before the
+   * request went out, or that dropped during a replay-safe call.
    */
-  private rawCall<T = Record<string, unknown>>(
+  private async rawCall<T = Record<string, unknown>>(
     apiFunc: string,
     params: Record<string, unknown> = {},
     options: WorkbenchCallOptions = {}
+  ): Promise<T> {
+    const pooled = this.pool?.acquire() ?? null;
+    if (pooled) {
+      try {
+        const result = await this.sendRequest<T>(apiFunc, params, options, pooled);
+        this.pool?.refill();
+        return result;
+      } catch (err) {
+        if (!(err instanceof PooledSocketDroppedError)) throw err;
+        logger.debug(`Pooled socket dropped for "${apiFunc}", retrying on a fresh connection`);
+      }
+    }
+    const result = await this.sendRequest<T>(apiFunc, params, options, null);
+    this.pool?.refill();
+    return result;
+  }
+
+  /**
+   * Send one request over a single-use socket and read the response.
+   * Opens a fresh connection unless an already-connected pooled socket is given.
+   */
+  private sendRequest<T = Record<string, unknown>>(
+    apiFunc: string,
+    params: Record<string, unknown>,
+    options: WorkbenchCallOptions,
+    pooledSocket: Socket | null
   ): Promise<T> {
     const timeout = options.timeout ?? DEFAULT_TIMEOUT_MS;
     const requestBuf = encodeRequest(this.clientId, apiFunc, params);
@@ -695,7 +786,13 @@ export class WorkbenchClient {
       let totalBytes = 0;
       let settled = false;
 
-      const socket = new Socket();
+      const socket = pooledSocket ?? new Socket();
+
+      // A pooled socket failing without a response byte is only safe to retry for replay-safe calls
+      const protocolError = (message: string): WorkbenchError =>
+        pooledSocket && totalBytes === 0 && options.replaySafe
+          ? new PooledSocketDroppedError(message)
+          : new WorkbenchError(message, "PROTOCOL_ERROR");
 
       const timer = setTimeout(() => {
         if (!settled) {
@@ -729,12 +826,7 @@ export class WorkbenchClient {
             )
           );
         } else {
-          reject(
-            new WorkbenchError(
-              `Connection error: ${err.message}`,
-              "PROTOCOL_ERROR"
-            )
-          );
+          reject(protocolError(`Connection error: ${err.message}`));
         }
       });
 
@@ -765,10 +857,7 @@ export class WorkbenchClient {
         const responseBuf = Buffer.concat(chunks);
         if (responseBuf.length === 0) {
           reject(
-            new WorkbenchError(
-              `Empty response from Workbench for "${apiFunc}" — connection closed without data`,
-              "PROTOCOL_ERROR"
-            )
+            protocolError(`Empty response from Workbench for "${apiFunc}" — connection closed without data`)
           );
           return;
         }
@@ -796,24 +885,14 @@ export class WorkbenchClient {
         cleanup();
 
         if (hadError) {
-          reject(
-            new WorkbenchError(
-              `Connection to Workbench closed with error for "${apiFunc}"`,
-              "PROTOCOL_ERROR"
-            )
-          );
+          reject(protocolError(`Connection to Workbench closed with error for "${apiFunc}"`));
           return;
         }
 
         // No end event + no error = unusual. Try to decode what we have.
         const responseBuf = Buffer.concat(chunks);
         if (responseBuf.length === 0) {
-          reject(
-            new WorkbenchError(
-              `Connection closed without response for "${apiFunc}"`,
-              "PROTOCOL_ERROR"
-            )
-          );
+          reject(protocolError(`Connection closed without response for "${apiFunc}"`));
           return;
         }
 
@@ -832,6 +911,20 @@ export class WorkbenchClient {
         }
       });
 
+      if (pooledSocket) {
+        // Closed between acquire() and now: nothing was written, so any call can be retried
+        if (pooledSocket.destroyed || !pooledSocket.writable) {
+          settled = true;
+          cleanup();
+          socket.destroy();
+          reject(new PooledSocketDroppedError(`Pooled socket closed before "${apiFunc}" was sent`));
+          return;
+        }
+        logger.debug(`Using pre-connected socket to ${this.host}:${this.port}, calling "${apiFunc}"`);
+        socket.end(requestBuf);
+        return;
+      }
+
       socket.connect(this.port, this.host, () => {
         logger.debug(
           `Connected to Workbench at ${this.host}:${this.port}, calling "${apiFunc}"`
@@ -0,0 +1,81 @@
+/**
+ * Decoder for the columnar response encoding used by list-style handlers
+ * (EMCP_WB_ListEntities, EMCP_WB_SelectEntity getSelected).
+ *
+ * Columnar layout (request with `encoding: "columnar"`):
+ *   classNames: string[]   — dictionary of distinct class names
+ *   names:      string[]   — one entry per entity
+ *   classIndex?: number[]  — index into classNames, parallel to names
+ *   positions?: number[]   — flat x,y,z triples, parallel to names
+ *   prefabs?:   string[]   — direct prefab resource, parallel to names
+ *   layerIDs?:  number[]   — layer ID, parallel to names
+ *
+ * Optional columns are absent when the request's field projection left them out.
+ *
+ * Responses without `encoding: "columnar"` are passed through unchanged so
+ * callers work against older handler scripts as well.
+ */
+
+export interface ListedEntity {
+  name: string;
+  className: string;
+  /** World position as "x y z" (only present when the handler sent positions). */
+  position?: string;
+  prefab?: string;
+  layerID?: number;
+  /** Extra keys from object-encoded responses (e.g. prefab) are passed through. */
+  [key: string]: unknown;
+}
+
+/** True if a handler response uses the columnar layout. */
+export function isColumnar(data: Record<string, unknown>): boolean {
+  return data.encoding === "columnar" && Array.isArray(data.names);
+}
+
+/**
+ * Expand a columnar list response into one object per entity.
+ * Object-encoded responses return their existing array under `objectsKey`.
+ */
+export function decodeEntityColumns(
+  data: Record<string, unknown>,
+  objectsKey = "entities"
+): ListedEntity[] {
+  if (!isColumnar(data)) {
+    const objects = data[objectsKey];
+    return Array.isArray(objects) ? (objects as ListedEntity[]) : [];
+  }
+
+  const names = data.names as unknown[];
+  const dict = Array.isArray(data.classNames) ? (data.classNames as unknown[]) : [];
+  const classIndex = Array.isArray(data.classIndex) ? (data.classIndex as unknown[]) : null;
+  const positions = Array.isArray(data.positions) ? (data.positions as unknown[]) : null;
+  const prefabs = Array.isArray(data.prefabs) ? (data.prefabs as unknown[]) : null;
+  const layerIDs = Array.isArray(data.layerIDs) ? (data.layerIDs as unknown[]) : null;
+
+  for (const [label, column] of [["class indices", classIndex], ["prefabs", prefabs], ["layer IDs", layerIDs]] as const) {
+    if (column && column.length !== names.length) {
+      throw new Error(`Malformed columnar response: ${names.length} names but ${column.length} ${label}`);
+    }
+  }
+  if (positions && positions.length !== names.length * 3) {
+    throw new Error(
+      `Malformed columnar response: expected ${names.length * 3} position values, got ${positions.length}`
+    );
+  }
+
+  const out: ListedEntity[] = new Array(names.length);
+  for (let i = 0; i < names.length; i++) {
+    const idx = classIndex ? Number(classIndex[i]) : -1;
+    const entity: ListedEntity = {
+      name: String(names[i] ?? ""),
+      className: idx >= 0 && idx < dict.length ? String(dict[idx]) : "",
+    };
+    if (positions) {
+      entity.position = `${positions[i * 3]} ${positions[i * 3 + 1]} ${positions[i * 3 + 2]}`;
+    }
+    if (prefabs) entity.prefab = String(prefabs[i] ?? "");
+    if (layerIDs) entity.layerID = Number(layerIDs[i]);
+    out[i] = entity;
+  }
+  return out;
+}
@@ -0,0 +1,133 @@
+/**
+ * Warm pool of pre-connected sockets to the Workbench NET API.
+ *
+ * The NET API closes the connection after every response, so a socket can
+ * never carry more than one request and a true keep-alive channel is not
+ * possible. What can be reused is the connect phase: the pool keeps a few
+ * sockets already connected so the next call only has to write its request.
+ *
+ * Pooled sockets are single-use. A socket that the server closed while idle,
+ * or that has been idle longer than maxIdleMs, is discarded on acquire and the
+ * caller falls back to a fresh per-call connection.
+ */
+
+import { Socket } from "node:net";
+import { logger } from "../utils/logger.js";
+
+/** Discard idle sockets older than this — Workbench may reap idle connections. */
+const DEFAULT_MAX_IDLE_MS = 5_000;
+/** Timeout for a background pre-connect attempt. */
+const PRECONNECT_TIMEOUT_MS = 2_000;
+
+interface IdleSocket {
+  socket: Socket;
+  connectedAt: number;
+  alive: boolean;
+}
+
+export class ConnectionPool {
+  private idle: IdleSocket[] = [];
+  private pending = 0;
+  private closed = false;
+
+  constructor(
+    private readonly host: string,
+    private readonly port: number,
+    private readonly size: number,
+    private readonly maxIdleMs: number = DEFAULT_MAX_IDLE_MS
+  ) {}
+
+  /** Number of live idle sockets currently held. */
+  get idleCount(): number {
+    return this.idle.filter((s) => s.alive).length;
+  }
+
+  /**
+   * Take a connected socket out of the pool, or null if none is usable.
+   * The caller owns the returned socket and must end/destroy it.
+   */
+  acquire(): Socket | null {
+    const now = Date.now();
+    while (this.idle.length > 0) {
+      const entry = this.idle.shift()!;
+      if (!entry.alive || now - entry.connectedAt > this.maxIdleMs) {
+        entry.socket.destroy();
+        continue;
+      }
+      entry.socket.removeAllListeners();
+      entry.socket.ref();
+      return entry.socket;
+    }
+    return null;
+  }
+
+  /**
+   * Top the pool back up to its target size in the background.
+   * Connect failures are ignored — calls simply fall back to fresh connections.
+   */
+  refill(): void {
+    const now = Date.now();
+    this.idle = this.idle.filter((entry) => {
+      if (entry.alive && now - entry.connectedAt <= this.maxIdleMs) return true;
+      entry.socket.destroy();
+      return false;
+    });
+    while (!this.closed && this.idle.length + this.pending < this.size) {
+      this.preconnect();
+    }
+  }
+
+  /** Destroy all idle sockets and stop refilling. */
+  close(): void {
+    this.closed = true;
+    for (const entry of this.idle) entry.socket.destroy();
+    this.idle = [];
+  }
+
+  private preconnect(): void {
+    this.pending++;
+    const socket = new Socket();
+    // Idle pooled sockets must not keep the process alive
+    socket.unref();
+
+    let settled = false;
+    const timer = setTimeout(() => socket.destroy(), PRECONNECT_TIMEOUT_MS);
+    timer.unref();
+
+    // destroy() on timeout emits "close" without "error", so listen for both
+    const fail = () => {
+      if (settled) return;
+      settled = true;
+      clearTimeout(timer);
+      this.pending--;
+      socket.destroy();
+    };
+    socket.once("error", fail);
+    socket.once("close", fail);
+
+    socket.connect(this.port, this.host, () => {
+      if (settled) return;
+      settled = true;
+      clearTimeout(timer);
+      this.pending--;
+      socket.removeListener("error", fail);
+      socket.removeListener("close", fail);
+      if (this.closed) {
+        socket.destroy();
+        return;
+      }
+
+      const entry: IdleSocket = { socket, connectedAt: Date.now(), alive: true };
+      const markDead = () => {
+        entry.alive = false;
+      };
+      socket.on("error", markDead);
+      socket.on("end", markDead);
+      socket.on("close", markDead);
+      // Data before a request was sent means the server is not in a usable state
+      socket.on("data", markDead);
+      this.idle.push(entry);
+      logger.debug(`Pre-connected socket to ${this.host}:${this.port} (${this.idle.length}/${this.size} idle)`);
+    });
+  }
+}
@@ -0,0 +1,154 @@
+/**
+ * Client side of EMCP_WB_GetChanges: delta polling over the Workbench change
+ * journal, plus folding a run of events into their net effect per entity.
+ */
+
+import type { WorkbenchClient } from "./client.js";
+
+export type ChangeType = "create" | "delete" | "rename" | "move" | "rotate" | "reparent" | "property" | "component";
+
+export interface ChangeEvent {
+  seq: number;
+  type: ChangeType | string;
+  /** Entity name at the time of the event (the old name for rename). */
+  name: string;
+  /** create/move: 'x y z'; rename: new name; rotate: angles; reparent: parent; property: 'path.key = value'; component: '+Class' / '-Class'. */
+  detail: string;
+}
+
+export interface ChangesPage {
+  status: string;
+  events: ChangeEvent[];
+  /** Journal lifetime id; pass it back with nextSince. It changes when the journal restarts. */
+  epoch: string;
+  latestSeq: number;
+  oldestSeq: number;
+  /** Pass as since on the next poll. */
+  nextSince: number;
+  /**
+   * The journal dropped events after since, or restarted since the cursor's
+   * epoch (script recompile, Workbench restart); resync from a full listing,
+   * then poll from latestSeq with the new epoch.
+   */
+  reset: boolean;
+  hasMore: boolean;
+  diffRan: boolean;
+  message: string;
+}
+
+/** Net effect on one entity over a run of events. */
+export interface EntityDelta {
+  /** Current name (after any renames). */
+  name: string;
+  /** Name before the run, if it existed and was renamed. */
+  previousName?: string;
+  created: boolean;
+  deleted: boolean;
+  /** Last 'x y z' from create or move. */
+  position?: string;
+  rotation?: string;
+  parent?: string;
+  /** Property and component changes in order ('path.key = value', 'path.key cleared', '+Class', '-Class'). */
+  properties: string[];
+  lastSeq: number;
+}
+
+export async function fetchChanges(
+  client: WorkbenchClient,
+  options: { since?: number; epoch?: string; limit?: number; forceDiff?: boolean; skipDiff?: boolean } = {}
+): Promise<ChangesPage> {
+  const res = await client.call<Record<string, unknown>>(
+    "EMCP_WB_GetChanges",
+    {
+      since: options.since ?? 0,
+      epoch: options.epoch ?? "",
+      limit: options.limit ?? 0,
+      forceDiff: options.forceDiff ?? false,
+      skipDiff: options.skipDiff ?? false,
+    },
+    { replaySafe: true }
+  );
+
+  const events = Array.isArray(res.events)
+    ? (res.events as Record<string, unknown>[]).map((e) => ({
+        seq: Number(e.seq),
+        type: String(e.type ?? ""),
+        name: String(e.name ?? ""),
+        detail: String(e.detail ?? ""),
+      }))
+    : [];
+
+  return {
+    status: String(res.status ?? "error"),
+    events,
+    epoch: String(res.epoch ?? ""),
+    latestSeq: Number(res.latestSeq ?? 0),
+    oldestSeq: Number(res.oldestSeq ?? 0),
+    nextSince: Number(res.nextSince ?? 0),
+    reset: res.reset === true,
+    hasMore: res.hasMore === true,
+    diffRan: res.diffRan === true,
+    message: String(res.message ?? ""),
+  };
+}
+
+/**
+ * Fold events (oldest first) into one delta per entity. Renames are chained so
+ * a moved-then-renamed entity is one delta; an entity created and deleted
+ * within the run disappears entirely.
+ */
+export function collapseChanges(events: ReadonlyArray<ChangeEvent>): EntityDelta[] {
+  const byName = new Map<string, EntityDelta>();
+  const order: EntityDelta[] = [];
+
+  const deltaFor = (name: string, seq: number): EntityDelta => {
+    let delta = byName.get(name);
+    if (!delta) {
+      delta = { name, created: false, deleted: false, properties: [], lastSeq: seq };
+      byName.set(name, delta);
+      order.push(delta);
+    }
+    delta.lastSeq = seq;
+    return delta;
+  };
+
+  for (const ev of events) {
+    switch (ev.type) {
+      case "create": {
+        // A delete drops the name from byName, so re-creating it starts a fresh delta
+        const delta = deltaFor(ev.name, ev.seq);
+        delta.created = true;
+        if (ev.detail) delta.position = ev.detail;
+        break;
+      }
+      case "delete": {
+        deltaFor(ev.name, ev.seq).deleted = true;
+        byName.delete(ev.name);
+        break;
+      }
+      case "rename": {
+        const delta = deltaFor(ev.name, ev.seq);
+        byName.delete(ev.name);
+        if (!delta.created && delta.previousName === undefined) delta.previousName = ev.name;
+        delta.name = ev.detail;
+        byName.set(ev.detail, delta);
+        break;
+      }
+      case "move":
+        deltaFor(ev.name, ev.seq).position = ev.detail;
+        break;
+      case "rotate":
+        deltaFor(ev.name, ev.seq).rotation = ev.detail;
+        break;
+      case "reparent":
+        deltaFor(ev.name, ev.seq).parent = ev.detail;
+        break;
+      case "property":
+      case "component":
+        deltaFor(ev.name, ev.seq).properties.push(ev.detail);
+        break;
+    }
+  }
+
+  return order.filter((d) => !(d.created && d.deleted));
+}
@@ -0,0 +1,187 @@
+/**
+ * Client side of the EMCP_WB_Localization bulk actions (exportTable,
+ * importRows), plus CSV conversion and a diff that keeps imports down to the
+ * rows that actually change.
+ */
+
+import type { WorkbenchClient } from "./client.js";
+import { encodeEscapedRecords } from "./records.js";
+
+/** One string-table item keyed by property name; Id is required. */
+export type LocalizationRow = Record<string, string>;
+
+export interface LocalizationTable {
+  columns: string[];
+  rows: LocalizationRow[];
+  tableItemCount: number;
+}
+
+export interface LocalizationDiff {
+  /** Rows that are new or differ in at least one imported column. */
+  changed: LocalizationRow[];
+  unchanged: number;
+  /** Ids present in the current table but not in the import (only with deleteMissing). */
+  deleteIds: string[];
+}
+
+export interface LocalizationImportResult {
+  status: string;
+  inserted: number;
+  modified: number;
+  unchanged: number;
+  deleted: number;
+  errors: { id: string; message: string }[];
+  message: string;
+}
+
+/** Parse RFC 4180 CSV (quoted fields, "" escapes, line breaks inside quotes). First row is the header. */
+export function parseCsv(text: string): LocalizationRow[] {
+  const records: string[][] = [];
+  let row: string[] = [];
+  let field = "";
+  let quoted = false;
+
+  for (let i = 0; i < text.length; i++) {
+    const ch = text[i];
+    if (quoted) {
+      if (ch === '"') {
+        if (text[i + 1] === '"') {
+          field += '"';
+          i++;
+        } else {
+          quoted = false;
+        }
+      } else {
+        field += ch;
+      }
+    } else if (ch === '"') {
+      quoted = true;
+    } else if (ch === ",") {
+      row.push(field);
+      field = "";
+    } else if (ch === "\n" || ch === "\r") {
+      if (ch === "\r" && text[i + 1] === "\n") i++;
+      row.push(field);
+      records.push(row);
+      row = [];
+      field = "";
+    } else {
+      field += ch;
+    }
+  }
+  if (field !== "" || row.length > 0) {
+    row.push(field);
+    records.push(row);
+  }
+
+  const nonEmpty = records.filter((r) => r.length > 1 || r[0] !== "");
+  if (nonEmpty.length === 0) return [];
+  const [header, ...body] = nonEmpty;
+  return body.map((r) => Object.fromEntries(header.map((col, c) => [col.trim(), r[c] ?? ""])));
+}
+
+function csvField(value: string): string {
+  return /[",\r\n]/.test(value) ? `"${value.replace(/"/g, '""')}"` : value;
+}
+
+export function toCsv(columns: ReadonlyArray<string>, rows: ReadonlyArray<LocalizationRow>): string {
+  const lines = [columns.map(csvField).join(",")];
+  for (const row of rows) lines.push(columns.map((c) => csvField(row[c] ?? "")).join(","));
+  return lines.join("\n");
+}
+
+/** Columns to import: Id first, then every other key used by any row. */
+export function importColumns(rows: ReadonlyArray<LocalizationRow>): string[] {
+  const columns = new Set<string>(["Id"]);
+  for (const row of rows) for (const key of Object.keys(row)) columns.add(key);
+  return [...columns];
+}
+
+/**
+ * Compare desired rows to the current table on the given columns. A column
+ * missing from a desired row is left alone rather than cleared. deleteMissing
+ * with no desired rows is refused: an empty rows list or header-only CSV would
+ * otherwise wipe the whole table.
+ */
+export function diffLocalizationRows(
+  current: ReadonlyArray<LocalizationRow>,
+  desired: ReadonlyArray<LocalizationRow>,
+  columns: ReadonlyArray<string>,
+  options: { deleteMissing?: boolean } = {}
+): LocalizationDiff {
+  if (options.deleteMissing && desired.length === 0) {
+    throw new Error("deleteMissing with an empty import would delete every localization item; import at least one row");
+  }
+
+  const currentById = new Map(current.map((r) => [r.Id, r]));
+  const desiredIds = new Set<string>();
+  const changed: LocalizationRow[] = [];
+  let unchanged = 0;
+
+  for (const row of desired) {
+    if (!row.Id) throw new Error("Every localization row needs an Id");
+    if (desiredIds.has(row.Id)) throw new Error(`Duplicate localization Id in import: ${row.Id}`);
+    desiredIds.add(row.Id);
+
+    const existing = currentById.get(row.Id);
+    const differs = !existing || columns.some((c) => c !== "Id" && row[c] !== undefined && row[c] !== (existing[c] ?? ""));
+    if (differs) changed.push(row);
+    else unchanged++;
+  }
+
+  const deleteIds = options.deleteMissing ? current.map((r) => r.Id).filter((id) => id && !desiredIds.has(id)) : [];
+  return { changed, unchanged, deleteIds };
+}
+
+export async function exportLocalizationTable(client: WorkbenchClient, columns = ""): Promise<LocalizationTable> {
+  const res = await client.call<Record<string, unknown>>("EMCP_WB_Localization", { action: "exportTable", columns, limit: 0 });
+  if (res.status !== "ok") throw new Error(String(res.message ?? "exportTable failed"));
+  const rows = Array.isArray(res.rows)
+    ? (res.rows as Record<string, unknown>[]).map((r) => Object.fromEntries(Object.entries(r).map(([k, v]) => [k, String(v ?? "")])))
+    : [];
+  return {
+    columns: Array.isArray(res.columns) ? res.columns.map(String) : [],
+    rows,
+    tableItemCount: Number(res.tableItemCount ?? rows.length),
+  };
+}
+
+/**
+ * Import rows in one Workbench call, sending only rows that differ from the
+ * current table. Columns absent from a row are sent as the current value so the
+ * handler leaves them untouched.
+ */
+export async function importLocalizationRows(
+  client: WorkbenchClient,
+  desired: ReadonlyArray<LocalizationRow>,
+  options: { deleteMissing?: boolean; dryRun?: boolean } = {}
+): Promise<{ diff: LocalizationDiff; result?: LocalizationImportResult }> {
+  const columns = importColumns(desired);
+  const current = await exportLocalizationTable(client, columns.join(","));
+  const diff = diffLocalizationRows(current.rows, desired, columns, options);
+
+  if (options.dryRun || (diff.changed.length === 0 && diff.deleteIds.length === 0)) return { diff };
+
+  const currentById = new Map(current.rows.map((r) => [r.Id, r]));
+  const res = await client.call<Record<string, unknown>>("EMCP_WB_Localization", {
+    action: "importRows",
+    columns: columns.join("\t"),
+    rows: encodeEscapedRecords(diff.changed.map((row) => columns.map((c) => row[c] ?? currentById.get(row.Id)?.[c] ?? ""))),
+    deleteIds: diff.deleteIds.join("\n"),
+  });
+
+  return {
+    diff,
+    result: {
+      status: String(res.status ?? "error"),
+      inserted: Number(res.insertedCount ?? 0),
+      modified: Number(res.modifiedCount ?? 0),
+      unchanged: Number(res.unchangedCount ?? 0),
+      deleted: Number(res.deletedCount ?? 0),
+      errors: Array.isArray(res.errors)
+        ? (res.errors as Record<string, unknown>[]).map((e) => ({ id: String(e.id ?? ""), message: String(e.message ?? "") }))
+        : [],
+      message: String(res.message ?? ""),
+    },
+  };
+}
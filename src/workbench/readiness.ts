@@ -0,0 +1,282 @@
+/**
+ * Launch readiness detection for Workbench.
+ *
+ * Instead of pinging on a fixed interval, waitForReady() combines two signals:
+ *   1. An exponential-backoff probe (short first interval, capped growth).
+ *   2. A tail of the Workbench console log. When the WorkbenchGame script
+ *      module finishes compiling, the next probe runs immediately instead of
+ *      waiting out the current backoff interval.
+ *
+ * Readiness is only ever declared by a successful probe — the log is a hint
+ * that shortens waits, never a substitute for the handler answering.
+ */
+
+import { closeSync, existsSync, openSync, readSync, readdirSync, statSync, watch, type FSWatcher } from "node:fs";
+import { join } from "node:path";
+import { logger } from "../utils/logger.js";
+
+/** First probe delay after launch. */
+const PROBE_INITIAL_MS = 100;
+/** Backoff growth factor between probes. */
+const PROBE_BACKOFF_FACTOR = 1.6;
+/** Upper bound for the delay between probes. */
+const PROBE_MAX_INTERVAL_MS = 2_000;
+/** Fallback poll interval for the log tail when fs.watch events don't arrive. */
+const LOG_POLL_MS = 250;
+/** Log directories modified this long before launch still count (clock skew, slow FS). */
+const LOG_DIR_GRACE_MS = 5_000;
+
+/**
+ * A console.log line: optional timestamp, padded category, optional level,
+ * then the message, e.g. "12:00:03.512 SCRIPT       : Compiling Game scripts"
+ * or "ENGINE    (E): Addon 'SampleMod' dependency '' can't be added".
+ */
+const LOG_LINE = /^\s*(?:[\d:.]+\s+)?([A-Z][A-Z_]*)\s*(?:\((\w)\))?\s*:\s?(.*)$/;
+/** Logged when a script module starts compiling; our handlers live in WorkbenchGame. */
+const COMPILE_START = /^Compiling WorkbenchGame scripts/;
+/** Logged when a script module fails to compile. */
+const COMPILE_FAILED = /^Can't compile "WorkbenchGame" script module/;
+
+/** Result of a single probe — "ready" or the WorkbenchError code that came back. */
+export type ProbeOutcome = "ready" | "CONNECTION_REFUSED" | "TIMEOUT" | "PROTOCOL_ERROR" | "API_ERROR" | "LAUNCH_FAILED";
+
+export interface ReadinessPhases {
+  /** ms from start until the Workbench console log for this session was found. */
+  logFound?: number;
+  /** ms until the log showed the WorkbenchGame scripts compiled. */
+  scriptsCompiled?: number;
+  /** ms until the first probe got past CONNECTION_REFUSED (port open). */
+  portOpen?: number;
+  /** ms until EMCP_WB_Ping answered. */
+  handlersReady?: number;
+}
+
+export interface ReadinessReport {
+  ready: boolean;
+  startedAt: number;
+  totalMs: number;
+  probes: number;
+  phases: ReadinessPhases;
+  /** Error code of the last failed probe (useful for timeout diagnostics). */
+  lastProbeError?: Exclude<ProbeOutcome, "ready">;
+  logFile?: string;
+}
+
+export interface ReadinessOptions {
+  /** Runs one probe; must not throw. */
+  probe: () => Promise<ProbeOutcome>;
+  timeoutMs: number;
+  /** Workbench "logs" directory containing logs_<timestamp>/console.log folders. */
+  logsDir?: string;
+  /** Time the launch started (defaults to now). Older log folders are ignored. */
+  startedAt?: number;
+  /**
+   * Workbench was already running rather than launched by the caller. Its
+   * session log can be hours old, so the newest log is tailed from its current
+   * end instead of requiring a folder created after startedAt.
+   */
+  attached?: boolean;
+}
+
+/**
+ * Tails the Workbench console.log of the current session and reports when the
+ * WorkbenchGame module finishes compiling. Nothing logs the end of a compile,
+ * so it counts as finished at the first line from another category after
+ * "Compiling WorkbenchGame scripts", unless a "Can't compile" error came
+ * first. Uses fs.watch where available with a poll fallback.
+ */
+class WorkbenchLogTail {
+  private file: string | null = null;
+  private offset = 0;
+  private partial = "";
+  private watcher: FSWatcher | null = null;
+  private timer: NodeJS.Timeout | null = null;
+  private compiling = false;
+  private seenCompile = false;
+
+  /**
+   * @param since Ignore log folders older than this, or null to take the newest
+   *   log and skip what it already holds (Workbench was already running).
+   */
+  constructor(
+    private readonly logsDir: string,
+    private readonly since: number | null,
+    private readonly onEvent: (event: "logFound" | "scriptsCompiled", file: string) => void
+  ) {}
+
+  start(): void {
+    this.timer = setInterval(() => this.tick(), LOG_POLL_MS);
+    this.timer.unref();
+    this.tick();
+  }
+
+  stop(): void {
+    if (this.timer) clearInterval(this.timer);
+    this.timer = null;
+    this.watcher?.close();
+    this.watcher = null;
+  }
+
+  private tick(): void {
+    try {
+      if (!this.file) {
+        this.file = this.since === null ? this.findNewestLog() : this.findSessionLog(this.since);
+        if (!this.file) return;
+        if (this.since === null) this.offset = statSync(this.file).size;
+        this.onEvent("logFound", this.file);
+        try {
+          this.watcher = watch(this.file, () => this.readNew());
+          this.watcher.on("error", () => {
+            this.watcher?.close();
+            this.watcher = null;
+          });
+        } catch {
+          // fs.watch unsupported here — the poll interval keeps tailing
+        }
+      }
+      this.readNew();
+    } catch (e) {
+      logger.debug(`Workbench log tail: ${e}`);
+    }
+  }
+
+  /** Newest log whose folder was created after `since` — the session we launched. */
+  private findSessionLog(since: number): string | null {
+    return this.findLog((dir) => {
+      const mtime = statSync(dir).mtimeMs;
+      return mtime < since - LOG_DIR_GRACE_MS ? null : mtime;
+    });
+  }
+
+  /** The console.log written most recently — the running session's. */
+  private findNewestLog(): string | null {
+    return this.findLog((dir) => statSync(join(dir, "console.log")).mtimeMs);
+  }
+
+  private findLog(rank: (dir: string) => number | null): string | null {
+    if (!existsSync(this.logsDir)) return null;
+    let best: { path: string; rank: number } | null = null;
+    for (const entry of readdirSync(this.logsDir, { withFileTypes: true })) {
+      if (!entry.isDirectory()) continue;
+      const dir = join(this.logsDir, entry.name);
+      const candidate = join(dir, "console.log");
+      if (!existsSync(candidate)) continue;
+      const r = rank(dir);
+      if (r === null) continue;
+      if (!best || r > best.rank) best = { path: candidate, rank: r };
+    }
+    return best?.path ?? null;
+  }
+
+  private readNew(): void {
+    if (!this.file) return;
+    const size = statSync(this.file).size;
+    if (size <= this.offset) return;
+
+    const fd = openSync(this.file, "r");
+    try {
+      const buf = Buffer.alloc(size - this.offset);
+      readSync(fd, buf, 0, buf.length, this.offset);
+      this.offset = size;
+      const text = this.partial + buf.toString("utf-8");
+      const lines = text.split(/\r?\n/);
+      this.partial = lines.pop() ?? "";
+      for (const line of lines) this.scanLine(line);
+    } finally {
+      closeSync(fd);
+    }
+  }
+
+  private scanLine(line: string): void {
+    if (this.seenCompile) return;
+    const m = LOG_LINE.exec(line);
+    if (!m) return;
+    const [, category, , message] = m;
+
+    if (category === "SCRIPT") {
+      if (COMPILE_START.test(message)) this.compiling = true;
+      else if (COMPILE_FAILED.test(message)) this.compiling = false;
+      return;
+    }
+    if (this.compiling) {
+      this.compiling = false;
+      this.seenCompile = true;
+      this.onEvent("scriptsCompiled", this.file!);
+    }
+  }
+}
+
+/**
+ * Wait until the probe succeeds or the timeout elapses. Never throws —
+ * callers inspect `ready` and `lastProbeError` on the returned report.
+ */
+export async function waitForReady(options: ReadinessOptions): Promise<ReadinessReport> {
+  const startedAt = options.startedAt ?? Date.now();
+  const deadline = startedAt + options.timeoutMs;
+  const report: ReadinessReport = { ready: false, startedAt, totalMs: 0, probes: 0, phases: {} };
+  const elapsed = () => Date.now() - startedAt;
+
+  // Sleep that a log marker can cut short
+  let wake: (() => void) | null = null;
+  const sleep = (ms: number) =>
+    new Promise<void>((resolve) => {
+      const timer = setTimeout(done, ms);
+      function done() {
+        clearTimeout(timer);
+        wake = null;
+        resolve();
+      }
+      wake = done;
+    });
+
+  const tail = options.logsDir
+    ? new WorkbenchLogTail(options.logsDir, options.attached ? null : startedAt, (event, file) => {
+        if (report.phases[event] === undefined) report.phases[event] = elapsed();
+        report.logFile = file;
+        logger.debug(`Workbench log: ${event} after ${report.phases[event]}ms`);
+        if (event !== "logFound") wake?.();
+      })
+    : null;
+  tail?.start();
+
+  try {
+    let interval = PROBE_INITIAL_MS;
+    while (Date.now() < deadline) {
+      report.probes++;
+      const outcome = await options.probe();
+      if (outcome === "ready") {
+        report.ready = true;
+        report.phases.portOpen ??= elapsed();
+        report.phases.handlersReady = elapsed();
+        return report;
+      }
+      report.lastProbeError = outcome;
+      if (outcome !== "CONNECTION_REFUSED" && report.phases.portOpen === undefined) {
+        report.phases.portOpen = elapsed();
+      }
+
+      const remaining = deadline - Date.now();
+      if (remaining <= 0) break;
+      await sleep(Math.min(interval, remaining));
+      interval = Math.min(interval * PROBE_BACKOFF_FACTOR, PROBE_MAX_INTERVAL_MS);
+    }
+    return report;
+  } finally {
+    tail?.stop();
+    report.totalMs = elapsed();
+  }
+}
+
+/** One-line summary of a readiness report's phase timings, e.g. for logs. */
+export function formatReadinessPhases(report: ReadinessReport): string {
+  const order: Array<[keyof ReadinessPhases, string]> = [
+    ["logFound", "log found"],
+    ["scriptsCompiled", "scripts compiled"],
+    ["portOpen", "port open"],
+    ["handlersReady", "handlers ready"],
+  ];
+  const parts = order
+    .filter(([key]) => report.phases[key] !== undefined)
+    .map(([key, label]) => `${label} ${report.phases[key]}ms`);
+  return parts.length > 0 ? parts.join(", ") : "no phases reached";
+}
@@ -0,0 +1,56 @@
+/**
+ * Encoder for batched request payloads sent to bulk Workbench handlers.
+ *
+ * Enfusion JsonApiStruct requests only carry scalar fields, so a list of
+ * records travels as one string: records separated by "\n", fields by "\t".
+ * Decoded on the Enforce side by EMCP_WB_Records.Parse().
+ */
+
+const RECORD_SEPARATOR = "\n";
+const FIELD_SEPARATOR = "\t";
+
+/**
+ * Encode rows of string fields into a record payload.
+ * @throws Error if any field contains a tab or newline (no escaping on the wire).
+ */
+export function encodeRecords(rows: ReadonlyArray<ReadonlyArray<string | number | undefined>>): string {
+  return rows
+    .map((row, r) =>
+      row
+        .map((field, f) => {
+          const value = field === undefined ? "" : String(field);
+          if (value.includes(FIELD_SEPARATOR) || value.includes(RECORD_SEPARATOR) || value.includes("\r")) {
+            throw new Error(`Record ${r} field ${f} contains a tab or newline, which cannot be sent in a batch`);
+          }
+          return value;
+        })
+        .join(FIELD_SEPARATOR)
+    )
+    .join(RECORD_SEPARATOR);
+}
+
+/** Escape a free-text field for encodeEscapedRecords (\\, tab, newline, CR). */
+export function escapeField(value: string): string {
+  return value.replace(/\\/g, "\\\\").replace(/\t/g, "\\t").replace(/\n/g, "\\n").replace(/\r/g, "\\r");
+}
+
+/** Inverse of escapeField (mirrors EMCP_WB_Records.Unescape). */
+export function unescapeField(value: string): string {
+  return value.replace(/\\(.)/g, (_m, code: string) => (code === "t" ? "\t" : code === "n" ? "\n" : code === "r" ? "\r" : code));
+}
+
+/**
+ * Like encodeRecords, but for free text: fields are escaped instead of
+ * rejected. The handler must decode each field with EMCP_WB_Records.Unescape().
+ */
+export function encodeEscapedRecords(rows: ReadonlyArray<ReadonlyArray<string | number | undefined>>): string {
+  return encodeRecords(rows.map((row) => row.map((field) => (field === undefined ? "" : escapeField(String(field))))));
+}
+
+/** Decode a record payload (the inverse of encodeRecords, used for responses and tests). */
+export function decodeRecords(payload: string): string[][] {
+  return payload
+    .split(RECORD_SEPARATOR)
+    .filter((line) => line.length > 0)
+    .map((line) => line.split(FIELD_SEPARATOR));
+}
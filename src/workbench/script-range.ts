@@ -0,0 +1,174 @@
+/**
+ * Client side of the EMCP_WB_ScriptEditor range actions (getRange,
+ * replaceRange, applyPatch): block reads and writes against the file open in
+ * the Workbench Script Editor, guarded by the handler's content hash.
+ */
+
+import type { WorkbenchClient } from "./client.js";
+import { encodeRecords } from "./records.js";
+
+/** Replace removeCount lines at line (0-based, against the current file) with lines. */
+export interface ScriptHunk {
+  line: number;
+  removeCount: number;
+  lines: string[];
+}
+
+export interface ScriptRange {
+  lines: string[];
+  start: number;
+  linesCount: number;
+  contentHash: string;
+}
+
+export interface ScriptWriteResult {
+  status: string;
+  linesCount: number;
+  contentHash: string;
+  message: string;
+}
+
+/** Split text into lines, accepting \n and \r\n. "" is zero lines. */
+export function splitLines(text: string): string[] {
+  if (text === "") return [];
+  return text.split("\n").map((l) => (l.endsWith("\r") ? l.slice(0, -1) : l));
+}
+
+/**
+ * Smallest single hunk turning oldLines into newLines (common prefix and
+ * suffix trimmed), or null if they are equal. Keeps whole-file writes to the
+ * lines that actually changed, which is what the editor spends time on.
+ */
+export function diffToHunk(oldLines: ReadonlyArray<string>, newLines: ReadonlyArray<string>): ScriptHunk | null {
+  let prefix = 0;
+  const maxPrefix = Math.min(oldLines.length, newLines.length);
+  while (prefix < maxPrefix && oldLines[prefix] === newLines[prefix]) prefix++;
+
+  if (prefix === oldLines.length && prefix === newLines.length) return null;
+
+  let suffix = 0;
+  const maxSuffix = maxPrefix - prefix;
+  while (
+    suffix < maxSuffix &&
+    oldLines[oldLines.length - 1 - suffix] === newLines[newLines.length - 1 - suffix]
+  ) {
+    suffix++;
+  }
+
+  return {
+    line: prefix,
+    removeCount: oldLines.length - prefix - suffix,
+    lines: newLines.slice(prefix, newLines.length - suffix),
+  };
+}
+
+/**
+ * Encode hunks into the applyPatch payload: numeric headers as records, all
+ * inserted lines joined into one text block.
+ * @throws Error if hunks overlap, are not ascending, or a line contains a newline.
+ */
+export function encodePatch(hunks: ReadonlyArray<ScriptHunk>): { hunks: string; text: string } {
+  let prevEnd = 0;
+  const inserted: string[] = [];
+  for (const [i, h] of hunks.entries()) {
+    if (h.line < prevEnd || h.removeCount < 0) {
+      throw new Error(`Hunk ${i} at line ${h.line} overlaps the previous hunk or is not in ascending order`);
+    }
+    for (const l of h.lines) {
+      if (l.includes("\n") || l.includes("\r")) throw new Error(`Hunk ${i} has a line containing a newline`);
+    }
+    inserted.push(...h.lines);
+    prevEnd = h.line + h.removeCount;
+  }
+  return {
+    hunks: encodeRecords(hunks.map((h) => [h.line, h.removeCount, h.lines.length])),
+    text: inserted.join("\n"),
+  };
+}
+
+function writeResult(res: Record<string, unknown>): ScriptWriteResult {
+  return {
+    status: String(res.status ?? "error"),
+    linesCount: Number(res.linesCount ?? 0),
+    contentHash: String(res.contentHash ?? ""),
+    message: String(res.message ?? ""),
+  };
+}
+
+/** Read count lines from line (count omitted = to end of file). */
+export async function getScriptRange(client: WorkbenchClient, line = 0, count = -1): Promise<ScriptRange> {
+  const res = await client.call<Record<string, unknown>>("EMCP_WB_ScriptEditor", { action: "getRange", line, count });
+  if (res.status !== "ok") throw new Error(String(res.message ?? "getRange failed"));
+  const rangeCount = Number(res.rangeCount ?? 0);
+  return {
+    // "" with rangeCount 1 is one empty line, not zero lines
+    lines: rangeCount === 0 ? [] : String(res.rangeText ?? "").split("\n"),
+    start: Number(res.rangeStart ?? line),
+    linesCount: Number(res.linesCount ?? 0),
+    contentHash: String(res.contentHash ?? ""),
+  };
+}
+
+export async function replaceScriptRange(
+  client: WorkbenchClient,
+  line: number,
+  count: number,
+  lines: ReadonlyArray<string>,
+  expectedHash = ""
+): Promise<ScriptWriteResult> {
+  const res = await client.call<Record<string, unknown>>("EMCP_WB_ScriptEditor", {
+    action: "replaceRange",
+    line,
+    count,
+    text: lines.join("\n"),
+    newCount: lines.length,
+    expectedHash,
+  });
+  return writeResult(res);
+}
+
+export async function applyScriptPatch(
+  client: WorkbenchClient,
+  hunks: ReadonlyArray<ScriptHunk>,
+  expectedHash = ""
+): Promise<ScriptWriteResult> {
+  const payload = encodePatch(hunks);
+  const res = await client.call<Record<string, unknown>>("EMCP_WB_ScriptEditor", {
+    action: "applyPatch",
+    hunks: payload.hunks,
+    text: payload.text,
+    expectedHash,
+  });
+  return writeResult(res);
+}
+
+/**
+ * Replace the whole open file with content: one read, then one patch covering
+ * only the changed block. With expectedHash, the write is refused if the file
+ * differs from the version the caller based content on.
+ */
+export async function setScriptContent(
+  client: WorkbenchClient,
+  content: string,
+  expectedHash = ""
+): Promise<ScriptWriteResult & { changed: boolean }> {
+  const current = await getScriptRange(client);
+  if (expectedHash && expectedHash !== current.contentHash) {
+    return {
+      status: "conflict",
+      linesCount: current.linesCount,
+      contentHash: current.contentHash,
+      message: `File changed since it was read (expected ${expectedHash}, now ${current.contentHash}); re-read and retry`,
+      changed: false,
+    };
+  }
+
+  const hunk = diffToHunk(current.lines, splitLines(content));
+  if (!hunk) {
+    return { status: "ok", linesCount: current.linesCount, contentHash: current.contentHash, message: "No changes", changed: false };
+  }
+
+  // Guard against an edit landing between our read and the patch
+  const result = await applyScriptPatch(client, [hunk], current.contentHash);
+  return { ...result, changed: result.status === "ok" };
+}
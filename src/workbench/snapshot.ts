@@ -0,0 +1,177 @@
+/**
+ * Local index over a level snapshot written by EMCP_WB_ExportSnapshot.
+ *
+ * The export is one JSON object per line (header first, then one line per
+ * entity). Loading it once lets analysis run against an in-memory index instead
+ * of one EMCP_WB_GetEntity round trip per entity.
+ */
+
+import { createReadStream } from "node:fs";
+import { createInterface } from "node:readline";
+
+export interface SnapshotComponent {
+  class: string;
+  props: Record<string, string>;
+}
+
+export interface SnapshotEntity {
+  name: string;
+  class: string;
+  prefab: string;
+  layer: number;
+  parent: string;
+  /** 'x y z' from the entity source; local to parent when parent is set. */
+  position: string;
+  rotation: string;
+  props: Record<string, string>;
+  components: SnapshotComponent[];
+}
+
+export interface SnapshotHeader {
+  entityCount: number;
+  generation: string;
+}
+
+export interface SnapshotQuery {
+  /** Case-insensitive substring of the entity class. */
+  className?: string;
+  /** Case-insensitive substring of the direct prefab path. */
+  prefab?: string;
+  /** Case-insensitive substring of any component class. */
+  component?: string;
+  /** Property name (entity or component); matches when the entity has it. */
+  property?: string;
+  /** With property: case-insensitive substring of its value. */
+  value?: string;
+  layer?: number;
+  parent?: string;
+  /** XZ box on the entity's own coords (parented entities use local coords). */
+  bboxMin?: { x: number; z: number };
+  bboxMax?: { x: number; z: number };
+}
+
+export type SnapshotGroupBy = "class" | "prefab" | "component" | "layer" | "parent";
+
+function parseVector(str: string): [number, number, number] {
+  const parts = str.trim().split(/\s+/).map(Number);
+  return [parts[0] || 0, parts[1] || 0, parts[2] || 0];
+}
+
+function hasProperty(entity: SnapshotEntity, property: string, value: string | undefined): boolean {
+  const matches = (props: Record<string, string>): boolean => {
+    if (!Object.prototype.hasOwnProperty.call(props, property)) return false;
+    return value === undefined || props[property].toLowerCase().includes(value);
+  };
+  return matches(entity.props) || entity.components.some((c) => matches(c.props));
+}
+
+export class LevelSnapshot {
+  readonly entities: SnapshotEntity[] = [];
+  readonly byName = new Map<string, SnapshotEntity>();
+  header: SnapshotHeader = { entityCount: 0, generation: "" };
+  source = "";
+  /** Lines that were not valid JSON (e.g. a truncated final line). */
+  skippedLines = 0;
+
+  /** Feed one line of the export. */
+  addLine(line: string): void {
+    if (!line.trim()) return;
+    let obj: Record<string, unknown>;
+    try {
+      obj = JSON.parse(line) as Record<string, unknown>;
+    } catch {
+      this.skippedLines++;
+      return;
+    }
+
+    if (obj.type === "header") {
+      this.header = { entityCount: Number(obj.entityCount ?? 0), generation: String(obj.generation ?? "") };
+      return;
+    }
+
+    const entity: SnapshotEntity = {
+      name: String(obj.name ?? ""),
+      class: String(obj.class ?? ""),
+      prefab: String(obj.prefab ?? ""),
+      layer: Number(obj.layer ?? 0),
+      parent: String(obj.parent ?? ""),
+      position: String(obj.position ?? ""),
+      rotation: String(obj.rotation ?? ""),
+      props: (obj.props as Record<string, string>) ?? {},
+      components: Array.isArray(obj.components)
+        ? (obj.components as Record<string, unknown>[]).map((c) => ({
+            class: String(c.class ?? ""),
+            props: (c.props as Record<string, string>) ?? {},
+          }))
+        : [],
+    };
+    this.entities.push(entity);
+    if (entity.name && !this.byName.has(entity.name)) this.byName.set(entity.name, entity);
+  }
+
+  static fromText(text: string, source = ""): LevelSnapshot {
+    const snapshot = new LevelSnapshot();
+    snapshot.source = source;
+    for (const line of text.split("\n")) snapshot.addLine(line);
+    return snapshot;
+  }
+
+  /** Stream a snapshot file line by line (exports of large worlds run to hundreds of MB). */
+  static async fromFile(path: string): Promise<LevelSnapshot> {
+    const snapshot = new LevelSnapshot();
+    snapshot.source = path;
+    const lines = createInterface({ input: createReadStream(path, { encoding: "utf-8" }), crlfDelay: Infinity });
+    for await (const line of lines) snapshot.addLine(line);
+    return snapshot;
+  }
+
+  query(q: SnapshotQuery): SnapshotEntity[] {
+    const className = q.className?.toLowerCase();
+    const prefab = q.prefab?.toLowerCase();
+    const component = q.component?.toLowerCase();
+    const value = q.value?.toLowerCase();
+
+    return this.entities.filter((e) => {
+      if (className && !e.class.toLowerCase().includes(className)) return false;
+      if (prefab && !e.prefab.toLowerCase().includes(prefab)) return false;
+      if (q.layer !== undefined && e.layer !== q.layer) return false;
+      if (q.parent !== undefined && e.parent !== q.parent) return false;
+      if (component && !e.components.some((c) => c.class.toLowerCase().includes(component))) return false;
+      if (q.property && !hasProperty(e, q.property, value)) return false;
+      if (q.bboxMin || q.bboxMax) {
+        const [x, , z] = parseVector(e.position);
+        if (q.bboxMin && (x < q.bboxMin.x || z < q.bboxMin.z)) return false;
+        if (q.bboxMax && (x > q.bboxMax.x || z > q.bboxMax.z)) return false;
+      }
+      return true;
+    });
+  }
+
+  /** Count entities per key, largest first. component counts each entity once per distinct component class. */
+  countBy(groupBy: SnapshotGroupBy, entities: ReadonlyArray<SnapshotEntity> = this.entities): [string, number][] {
+    const counts = new Map<string, number>();
+    const bump = (key: string) => counts.set(key, (counts.get(key) ?? 0) + 1);
+
+    for (const e of entities) {
+      switch (groupBy) {
+        case "class":
+          bump(e.class);
+          break;
+        case "prefab":
+          bump(e.prefab || "(no prefab)");
+          break;
+        case "layer":
+          bump(String(e.layer));
+          break;
+        case "parent":
+          bump(e.parent || "(root)");
+          break;
+        case "component":
+          for (const cls of new Set(e.components.map((c) => c.class))) bump(cls);
+          break;
+      }
+    }
+
+    return [...counts.entries()].sort((a, b) => b[1] - a[1] || a[0].localeCompare(b[0]));
+  }
+}
@@ -0,0 +1,193 @@
+/**
+ * Client-side cache of terrain height tiles.
+ *
+ * Placement tools ask for the ground height of many nearby points. Instead of
+ * one EMCP_WB_Terrain round trip per point, heights are fetched a tile at a
+ * time with the batch "sample" grid action and kept in memory; later queries in
+ * the same area are answered locally by bilinear interpolation between samples.
+ *
+ * A tile costs tileSamples^2 samples, so it is only fetched once it is hit
+ * densely: when the uncached points asked for in it, counted across queries,
+ * reach denseTilePoints. With a point fetcher, points in tiles below that go to
+ * Workbench in one batched points call per query; their heights are not kept,
+ * but they count towards fetching the tile, so an area queried repeatedly ends
+ * up cached.
+ *
+ * With the default 1 m sample step this is finer than Enfusion terrain grids,
+ * so interpolated heights match GetTerrainSurfaceY to within rounding. Terrain
+ * edits are not observed — call clear() after sculpting or switching worlds.
+ */
+
+/** A sampled height grid as returned by the EMCP_WB_Terrain "sample" grid action. */
+export interface HeightGrid {
+  originX: number;
+  originZ: number;
+  step: number;
+  cols: number;
+  rows: number;
+  /** Row-major: z outer, x inner. */
+  heights: ArrayLike<number>;
+}
+
+/** Fetch a grid covering [minX, maxX] x [minZ, maxZ] at the given step. */
+export type GridFetcher = (minX: number, minZ: number, maxX: number, maxZ: number, step: number) => Promise<HeightGrid>;
+
+/** Fetch the exact height of each point, in order, in one call. */
+export type PointFetcher = (points: ReadonlyArray<{ x: number; z: number }>) => Promise<number[]>;
+
+export interface TerrainTileCacheOptions {
+  /** Sample spacing in meters (default 1). */
+  step?: number;
+  /** Samples per tile edge; a tile spans tileSamples * step meters (default 64). */
+  tileSamples?: number;
+  /** Tiles kept before least-recently-used eviction (default 64, ~2 MB). */
+  maxTiles?: number;
+  /** Uncached points asked for in one tile, across queries, before the tile is fetched (default 16). */
+  denseTilePoints?: number;
+  /**
+   * Batch fetcher for points in sparsely hit tiles. Without one, every
+   * uncached tile a query touches is fetched.
+   */
+  fetchPoints?: PointFetcher;
+}
+
+export interface SampleResult {
+  heights: number[];
+  tilesFetched: number;
+  tilesCached: number;
+  /** Points sampled directly through the point fetcher. */
+  pointsFetched: number;
+}
+
+/** Bilinear height at (x, z), clamped to the grid edges. */
+export function interpolateHeight(grid: HeightGrid, x: number, z: number): number {
+  const fx = (x - grid.originX) / grid.step;
+  const fz = (z - grid.originZ) / grid.step;
+  const maxCol = Math.max(grid.cols - 2, 0);
+  const maxRow = Math.max(grid.rows - 2, 0);
+  const c = Math.min(Math.max(Math.floor(fx), 0), maxCol);
+  const r = Math.min(Math.max(Math.floor(fz), 0), maxRow);
+  const c1 = Math.min(c + 1, grid.cols - 1);
+  const r1 = Math.min(r + 1, grid.rows - 1);
+  const tx = Math.min(Math.max(fx - c, 0), 1);
+  const tz = Math.min(Math.max(fz - r, 0), 1);
+
+  const h = grid.heights;
+  const h00 = h[r * grid.cols + c];
+  const h10 = h[r * grid.cols + c1];
+  const h01 = h[r1 * grid.cols + c];
+  const h11 = h[r1 * grid.cols + c1];
+  return (h00 * (1 - tx) + h10 * tx) * (1 - tz) + (h01 * (1 - tx) + h11 * tx) * tz;
+}
+
+export class TerrainTileCache {
+  private readonly tiles = new Map<string, HeightGrid>();
+  /** Uncached tile -> points sampled directly in it so far, oldest tile first. */
+  private readonly misses = new Map<string, number>();
+  private readonly step: number;
+  private readonly tileSamples: number;
+  private readonly maxTiles: number;
+  private readonly denseTilePoints: number;
+  private readonly fetchPoints: PointFetcher | null;
+
+  constructor(
+    private readonly fetchGrid: GridFetcher,
+    options: TerrainTileCacheOptions = {}
+  ) {
+    this.step = options.step ?? 1;
+    this.tileSamples = options.tileSamples ?? 64;
+    this.maxTiles = options.maxTiles ?? 64;
+    this.denseTilePoints = options.denseTilePoints ?? 16;
+    this.fetchPoints = options.fetchPoints ?? null;
+  }
+
+  /** Number of tiles currently held. */
+  get size(): number {
+    return this.tiles.size;
+  }
+
+  /** Drop all tiles (after terrain edits or a world change). */
+  clear(): void {
+    this.tiles.clear();
+    this.misses.clear();
+  }
+
+  /**
+   * Heights for each point: cached tiles answer locally, densely hit tiles are
+   * fetched and cached, and the remaining points are fetched in one batch.
+   */
+  async sample(points: ReadonlyArray<{ x: number; z: number }>): Promise<SampleResult> {
+    const span = this.step * this.tileSamples;
+    const keys = points.map((p) => `${Math.floor(p.x / span)}:${Math.floor(p.z / span)}`);
+
+    // Uncached points per tile, in first-seen order
+    let tilesCached = 0;
+    const missing = new Map<string, number[]>();
+    keys.forEach((key, i) => {
+      const cached = this.tiles.get(key);
+      if (cached) {
+        if (!missing.has(key)) {
+          // Refresh LRU position (once per query)
+          this.tiles.delete(key);
+          this.tiles.set(key, cached);
+          missing.set(key, []);
+          tilesCached++;
+        }
+        return;
+      }
+      let indices = missing.get(key);
+      if (!indices) missing.set(key, (indices = []));
+      indices.push(i);
+    });
+
+    let tilesFetched = 0;
+    const scattered: number[] = [];
+    for (const [key, indices] of missing) {
+      if (indices.length === 0) continue;
+      const hits = (this.misses.get(key) ?? 0) + indices.length;
+      if (this.fetchPoints && hits < this.denseTilePoints) {
+        this.misses.delete(key);
+        this.misses.set(key, hits);
+        scattered.push(...indices);
+        continue;
+      }
+      this.misses.delete(key);
+      const [tx, tz] = key.split(":").map(Number);
+      const minX = tx * span;
+      const minZ = tz * span;
+      // One extra sample on the far edges so points near the border can interpolate
+      const grid = await this.fetchGrid(minX, minZ, minX + span, minZ + span, this.step);
+      if (grid.cols * grid.rows !== grid.heights.length || grid.cols < 1 || grid.rows < 1) {
+        throw new Error(`Malformed terrain tile: ${grid.cols}x${grid.rows} grid with ${grid.heights.length} heights`);
+      }
+      this.tiles.set(key, { ...grid, heights: Float64Array.from(grid.heights) });
+      tilesFetched++;
+    }
+
+    const direct = new Map<number, number>();
+    if (scattered.length > 0) {
+      scattered.sort((a, b) => a - b);
+      const fetched = await this.fetchPoints!(scattered.map((i) => points[i]));
+      if (fetched.length !== scattered.length) {
+        throw new Error(`Malformed terrain points: ${fetched.length} heights for ${scattered.length} points`);
+      }
+      scattered.forEach((pointIndex, j) => direct.set(pointIndex, fetched[j]));
+    }
+
+    const heights = points.map((p, i) => direct.get(i) ?? interpolateHeight(this.tiles.get(keys[i])!, p.x, p.z));
+    this.evict();
+    return { heights, tilesFetched, tilesCached, pointsFetched: scattered.length };
+  }
+
+  private evict(): void {
+    while (this.tiles.size > this.maxTiles) {
+      const oldest = this.tiles.keys().next().value as string;
+      this.tiles.delete(oldest);
+    }
+    // Miss counts are small; keep a few times as many as tiles
+    while (this.misses.size > this.maxTiles * 4) {
+      const oldest = this.misses.keys().next().value as string;
+      this.misses.delete(oldest);
+    }
+  }
+}
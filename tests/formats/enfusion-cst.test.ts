@@ -0,0 +1,127 @@
+import { describe, it, expect } from "vitest";
+import { EnfusionDocument } from "../../src/formats/enfusion-cst.js";
+
+const PREFAB = `// Hand-edited prefab
+GenericEntity : "{1A2B3C4D5E6F7081}Prefabs/Base.et" {
+ ID "1234567890123456"
+ components {
+  MeshObject "{A1B2C3D4E5F60718}" {
+   Object "{0123456789ABCDEF}Assets/Box.xob" // keep this comment
+  }
+ }
+ coords 1   2 3
+}
+`;
+
+describe("EnfusionDocument", () => {
+  it("reproduces the source exactly when unedited", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    expect(doc.toString()).toBe(PREFAB);
+    expect(doc.changed).toBe(false);
+    const crlf = PREFAB.replace(/\n/g, "\r\n");
+    expect(EnfusionDocument.parse(crlf).toString()).toBe(crlf);
+  });
+
+  it("records spans for nodes and properties", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    const root = doc.root!;
+    const coords = root.properties.find((p) => p.key === "coords")!;
+    expect(PREFAB.slice(coords.start, coords.end)).toBe("coords 1   2 3");
+    expect(coords.value).toBe("1 2 3");
+    const mesh = doc.findChild(doc.findChild(root, "components")!, "MeshObject")!;
+    expect(PREFAB.slice(mesh.start, mesh.closeStart + 1)).toMatch(/^MeshObject "\{A1B2C3D4E5F60718\}" \{[\s\S]*\}$/);
+  });
+
+  it("splices an existing value in place, keeping its quoting", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    doc.setProperty(doc.root!, "ID", "9999999999999999");
+    doc.setProperty(doc.root!, "ID", "8888888888888888");
+    expect(doc.edits).toEqual([{ start: PREFAB.indexOf('"1234'), end: PREFAB.indexOf('"1234') + 18, text: '"8888888888888888"' }]);
+    expect(doc.toString()).toBe(PREFAB.replace('"1234567890123456"', '"8888888888888888"'));
+    expect(doc.getProperty(doc.root!, "ID")).toBe("8888888888888888");
+  });
+
+  it("adds new properties after the last one with sibling indentation", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    const mesh = doc.findChild(doc.findChild(doc.root!, "components")!, "MeshObject")!;
+    doc.setProperty(mesh, "Materials", "None");
+    doc.setProperty(doc.root!, "angleY", "90");
+    doc.setProperty(doc.root!, "angleY", "45");
+    expect(doc.toString()).toBe(
+      PREFAB.replace("// keep this comment\n", "// keep this comment\n   Materials None\n").replace(" coords 1   2 3\n", " coords 1   2 3\n angleY 45\n")
+    );
+  });
+
+  it("removes properties and nodes with their lines", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    const components = doc.findChild(doc.root!, "components")!;
+    doc.setProperty(components.children[0], "Object", "x.xob");
+    doc.removeNode(components);
+    expect(doc.removeProperty(doc.root!, "coords")).toBe(true);
+    expect(doc.removeProperty(doc.root!, "missing")).toBe(false);
+    expect(doc.toString()).toBe(`// Hand-edited prefab
+GenericEntity : "{1A2B3C4D5E6F7081}Prefabs/Base.et" {
+ ID "1234567890123456"
+}
+`);
+  });
+
+  it("sets, replaces and strips parent references", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    doc.setInheritance(doc.root!, undefined);
+    expect(doc.toString().split("\n")[1]).toBe("GenericEntity {");
+
+    const bare = EnfusionDocument.parse("Thing {\n}\n");
+    bare.setInheritance(bare.root!, "{AAAAAAAAAAAAAAAA}P.et");
+    expect(bare.toString()).toBe('Thing : "{AAAAAAAAAAAAAAAA}P.et" {\n}\n');
+  });
+
+  it("inserts raw child text at the start or end of a body", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    doc.insertText(doc.findChild(doc.root!, "components")!, '  Hierarchy "{B1B2C3D4E5F60718}" {\n  }', "start");
+    doc.insertText(doc.root!, " {\n  Child {\n  }\n }", "end");
+    expect(doc.toString()).toBe(
+      PREFAB.replace(" components {\n", ' components {\n  Hierarchy "{B1B2C3D4E5F60718}" {\n  }\n').replace(
+        " coords 1   2 3\n}",
+        " coords 1   2 3\n {\n  Child {\n  }\n }\n}"
+      )
+    );
+  });
+
+  it("refuses edits inside a removed node", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    const components = doc.findChild(doc.root!, "components")!;
+    doc.removeNode(components);
+    expect(() => doc.setProperty(components.children[0], "Object", "x.xob")).toThrow(/overlaps/);
+  });
+
+  it("leaves the model unchanged when an edit is refused", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    const components = doc.findChild(doc.root!, "components")!;
+    const mesh = components.children[0];
+    doc.removeNode(components);
+    const edits = doc.edits;
+
+    expect(() => doc.setProperty(mesh, "Object", "x.xob")).toThrow(/overlaps/);
+    expect(() => doc.removeProperty(mesh, "Object")).toThrow(/overlaps/);
+    expect(mesh.properties.map((p) => [p.key, p.value])).toEqual([["Object", "{0123456789ABCDEF}Assets/Box.xob"]]);
+    expect(() => doc.setInheritance(mesh, "{AAAAAAAAAAAAAAAA}P.et")).toThrow(/inside a pending edit/);
+    expect(mesh.inheritance).toBeUndefined();
+    expect(doc.edits).toEqual(edits);
+  });
+
+  it("refuses inserts inside a removed node", () => {
+    const doc = EnfusionDocument.parse(PREFAB);
+    const components = doc.findChild(doc.root!, "components")!;
+    const mesh = components.children[0];
+    doc.removeNode(components);
+    expect(() => doc.setProperty(mesh, "Materials", "x.emat")).toThrow(/inside a pending edit/);
+    expect(mesh.properties.map((p) => p.key)).toEqual(["Object"]);
+    expect(() => doc.insertText(components, "  Child {\n  }")).toThrow(/inside a pending edit/);
+    expect(() => doc.insertText(mesh, "   Child {\n   }", "start")).toThrow(/inside a pending edit/);
+    // Edits outside the removed lines still apply
+    doc.setProperty(doc.root!, "Flags", "2");
+    expect(doc.toString()).not.toContain("components");
+    expect(doc.toString()).toContain(" Flags 2");
+  });
+});
@@ -0,0 +1,158 @@
+import { describe, it, expect } from "vitest";
+import {
+  EnfusionEventParser,
+  parseEvents,
+  listLayerEntities,
+  findGuidRefs,
+  readRootHeader,
+  type EnfusionEventHandler,
+} from "../../src/formats/enfusion-events.js";
+import { parse } from "../../src/formats/enfusion-text.js";
+
+const LAYER = `SCR_GameModeCampaign GameMode1 : "{1A2B3C4D5E6F7081}Prefabs/MP/Campaign/CampaignMP.et" {
+ ID "5D3E8C2A1B4F6E7D"
+ coords 0 12.5 -3
+ components {
+  SCR_MapDescriptorComponent "{A1B2C3D4E5F60718}" {
+   m_Icon "{2B3C4D5E6F708192}UI/Icons/base.edds"
+  }
+ }
+ {
+  SCR_Iron_CaptureAndHoldSpawnProtectionArea : "{3C4D5E6F70819203}Prefabs/Area.et" {
+   coords 0 0 0
+  }
+ }
+}
+$grp GenericEntity : "{4D5E6F7081920314}Prefabs/Vegetation/Tree.et" {
+ Tree_1 {
+  coords 1 2 3
+ }
+ {
+  coords 4 5 6
+ }
+}
+`;
+
+function record(): { handler: EnfusionEventHandler; events: string[] } {
+  const events: string[] = [];
+  return {
+    events,
+    handler: {
+      onNodeStart: (e) => events.push(`start ${e.type}|${e.id ?? ""}|${e.inheritance ?? ""}@${e.depth}`),
+      onProperty: (e) => events.push(`prop ${e.key}=${e.value}@${e.depth}`),
+      onValue: (e) => events.push(`value ${e.value}@${e.depth}`),
+      onNodeEnd: (e) => events.push(`end ${e.type}@${e.depth}`),
+    },
+  };
+}
+
+async function* chunks(text: string, size: number): AsyncGenerator<Uint8Array> {
+  const bytes = Buffer.from(text, "utf-8");
+  for (let i = 0; i < bytes.length; i += size) yield bytes.subarray(i, i + size);
+}
+
+describe("EnfusionEventParser", () => {
+  it("emits the same events however the input is chunked", () => {
+    const whole = record();
+    parseEvents(LAYER, whole.handler);
+
+    for (const size of [1, 2, 7, 64]) {
+      const split = record();
+      const parser = new EnfusionEventParser(split.handler);
+      for (let i = 0; i < LAYER.length; i += size) parser.write(LAYER.slice(i, i + size));
+      parser.end();
+      expect(split.events).toEqual(whole.events);
+    }
+
+    expect(whole.events.slice(0, 4)).toEqual([
+      "start SCR_GameModeCampaign|GameMode1|{1A2B3C4D5E6F7081}Prefabs/MP/Campaign/CampaignMP.et@0",
+      "prop ID=5D3E8C2A1B4F6E7D@1",
+      "prop coords=0 12.5 -3@1",
+      "start components||@1",
+    ]);
+    expect(whole.events).toContain("start ||@1");
+  });
+
+  it("reports node positions in the whole document", () => {
+    const starts: number[] = [];
+    const parser = new EnfusionEventParser({ onNodeStart: (e) => starts.push(e.pos) });
+    parser.write("A {\n B");
+    parser.write(" { } }");
+    parser.end();
+    expect(starts).toEqual([0, 5]);
+  });
+
+  it("stops after the root node in singleRoot mode", () => {
+    const { handler, events } = record();
+    const parser = new EnfusionEventParser(handler, { singleRoot: true });
+    parser.write('Root { Key "v" } Trailing { A B C D E F');
+    expect(parser.finished).toBe(true);
+    parser.end("}");
+    expect(events).toEqual(["start Root||@0", "prop Key=v@1", "end Root@0"]);
+  });
+
+  it("throws on unclosed blocks and empty singleRoot input", () => {
+    expect(() => parseEvents("A { B {", {})).toThrow("Unexpected EOF, expected '}'");
+    expect(() => parseEvents("// nothing", {}, { singleRoot: true })).toThrow("Empty input");
+  });
+
+  it("keeps parse() building vectors, named children and anonymous blocks", () => {
+    const root = parse('Ent { coords 1 2 3\n { Child Named : "P.et" { } }\n Flag }');
+    expect(root.properties).toEqual([{ key: "coords", value: "1 2 3" }]);
+    expect(root.values).toEqual(["Flag"]);
+    expect(root.children[0].type).toBe("");
+    expect(root.children[0].children[0]).toMatchObject({ type: "Child", id: "Named", inheritance: "P.et" });
+  });
+});
+
+describe("layer helpers", () => {
+  it("lists entities, $grp members and nested children from a byte stream", async () => {
+    const entities = await listLayerEntities(chunks(LAYER, 5));
+    expect(entities.map(({ pos: _pos, ...e }) => e)).toEqual([
+      {
+        className: "SCR_GameModeCampaign",
+        name: "GameMode1",
+        prefab: "{1A2B3C4D5E6F7081}Prefabs/MP/Campaign/CampaignMP.et",
+        id: "5D3E8C2A1B4F6E7D",
+        coords: "0 12.5 -3",
+      },
+      {
+        className: "SCR_Iron_CaptureAndHoldSpawnProtectionArea",
+        name: "",
+        prefab: "{3C4D5E6F70819203}Prefabs/Area.et",
+        coords: "0 0 0",
+        parent: "GameMode1",
+      },
+      { className: "GenericEntity", name: "Tree_1", prefab: "{4D5E6F7081920314}Prefabs/Vegetation/Tree.et", coords: "1 2 3" },
+      { className: "GenericEntity", name: "", prefab: "{4D5E6F7081920314}Prefabs/Vegetation/Tree.et", coords: "4 5 6" },
+    ]);
+  });
+
+  it("finds GUID references but not component IDs", async () => {
+    const refs = await findGuidRefs(chunks(LAYER + 'X { Other "{1a2b3c4d5e6f7081}" }', 3));
+    expect(refs.map((r) => [r.guid, r.path, r.count])).toEqual([
+      ["1A2B3C4D5E6F7081", "Prefabs/MP/Campaign/CampaignMP.et", 2],
+      ["2B3C4D5E6F708192", "UI/Icons/base.edds", 1],
+      ["3C4D5E6F70819203", "Prefabs/Area.et", 1],
+      ["4D5E6F7081920314", "Prefabs/Vegetation/Tree.et", 1],
+    ]);
+  });
+
+  it("reads the root header without pulling the rest of the stream", async () => {
+    let pulled = 0;
+    async function* counted(): AsyncGenerator<Uint8Array> {
+      for await (const chunk of chunks(LAYER, 16)) {
+        pulled++;
+        yield chunk;
+      }
+    }
+    const header = await readRootHeader(counted());
+    expect([header.type, header.id, header.inheritance]).toEqual([
+      "SCR_GameModeCampaign",
+      "GameMode1",
+      "{1A2B3C4D5E6F7081}Prefabs/MP/Campaign/CampaignMP.et",
+    ]);
+    expect(pulled).toBeLessThan(10);
+    await expect(readRootHeader(chunks("", 4))).rejects.toThrow("Empty input");
+  });
+});
@@ -0,0 +1,99 @@
+import { describe, it, expect } from "vitest";
+import { parseLazy } from "../../src/formats/enfusion-lazy.js";
+import { parse, getProperty, type EnfusionNode } from "../../src/formats/enfusion-text.js";
+import { EnfusionEventParser, parseEvents } from "../../src/formats/enfusion-events.js";
+import { findBlockEnd } from "../../src/formats/enfusion-lexer.js";
+
+const GPROJ = `GameProject {
+ ID "MyMod"
+ GUID "5D3E8C2A1B4F6E7D"
+ TITLE "My \\"Mod\\" {beta}"
+ Dependencies {
+  "58D0FB3206B6F859"
+ }
+ Configurations {
+  GameProjectConfig PC {
+   // Platform block { with a stray brace in a comment
+   Name "PC }"
+   coords 1 2 3
+  }
+  GameProjectConfig XBOX_ONE {
+  }
+ }
+ Flag
+}
+`;
+
+/** Plain copy of a node tree, forcing every lazy level. */
+function toPlain(node: EnfusionNode): EnfusionNode {
+  const plain: EnfusionNode = {
+    type: node.type,
+    properties: node.properties.map((p) => ({ ...p })),
+    values: [...node.values],
+    children: node.children.map(toPlain),
+  };
+  if (node.id !== undefined) plain.id = node.id;
+  if (node.className !== undefined) plain.className = node.className;
+  if (node.inheritance !== undefined) plain.inheritance = node.inheritance;
+  return plain;
+}
+
+describe("parseLazy", () => {
+  it("matches parse() once every level is read", () => {
+    expect(toPlain(parseLazy(GPROJ))).toEqual(parse(GPROJ));
+  });
+
+  it("reads root properties without parsing child blocks", () => {
+    const root = parseLazy(GPROJ);
+    expect(getProperty(root, "ID")).toBe("MyMod");
+    expect(getProperty(root, "TITLE")).toBe('My "Mod" {beta}');
+    expect(root.values).toEqual(["Flag"]);
+
+    const configs = root.children.find((c) => c.type === "Configurations")!;
+    expect(configs.parsed).toBe(false);
+    expect(GPROJ.slice(configs.start, configs.closeStart + 1)).toMatch(/^Configurations \{[\s\S]*\n \}$/);
+
+    const pc = configs.children[0];
+    expect(configs.parsed).toBe(true);
+    expect(pc.parsed).toBe(false);
+    expect(pc.id).toBe("PC");
+    expect(getProperty(pc, "Name")).toBe("PC }");
+  });
+
+  it("defers syntax errors inside a child until it is read", () => {
+    const root = parseLazy('Root { A "1" Broken { X : 5 } B "2" }');
+    expect(getProperty(root, "B")).toBe("2");
+    expect(() => root.children[0].properties).toThrow(/Expected String/);
+    expect(() => parseLazy("Root { Open {")).toThrow("Unexpected EOF, expected '}'");
+  });
+});
+
+describe("node skipping", () => {
+  it("finds the closing brace past strings, escapes and comments", () => {
+    const text = 'A { "}" "\\"}" // }\n { } } tail';
+    expect(findBlockEnd(text, 3)).toBe(text.indexOf("} tail"));
+    expect(findBlockEnd('A { "unterminated }', 3)).toBe(-1);
+  });
+
+  it("reports only the end of a skipped node, chunked or not", () => {
+    const text = 'A { Skip { X "}" Inner { Y 1 } } Z 2 }';
+    const run = (chunked: boolean) => {
+      const events: string[] = [];
+      const parser = new EnfusionEventParser({
+        onNodeStart: (e) => {
+          events.push(`start ${e.type}`);
+          return e.type !== "Skip";
+        },
+        onProperty: (e) => events.push(`prop ${e.key}`),
+        onNodeEnd: (e) => events.push(`end ${e.type}@${e.pos}`),
+      });
+      if (chunked) for (const ch of text) parser.write(ch);
+      parser.end(chunked ? "" : text);
+      return events;
+    };
+    const whole = run(false);
+    expect(whole).toEqual(["start A", "start Skip", `end Skip@${text.indexOf("} Z")}`, "prop Z", `end A@${text.length - 1}`]);
+    expect(run(true)).toEqual(whole);
+    expect(() => parseEvents("A { B { C {", { onNodeStart: () => false })).toThrow("Unexpected EOF");
+  });
+});
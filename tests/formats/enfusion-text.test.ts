@@ -1,5 +1,5 @@
 import { describe, it, expect } from "vitest";
-import { parse, serialize, createNode, setProperty, getProperty } from "../../src/formats/enfusion-text.js";
+import { parse, serialize, createNode, setProperty, getProperty, tokenize, TokenType } from "../../src/formats/enfusion-text.js";
 import { generateGuid } from "../../src/formats/guid.js";
 
 describe("generateGuid", () => {
@@ -15,6 +15,30 @@ describe("generateGuid", () => {
   });
 });
 
+describe("enfusion-text lexer", () => {
+  it("slices plain strings and identifiers with their positions", () => {
+    const tokens = tokenize('Key "a b" {\n x-1.5 : }');
+    expect(tokens.map((t) => [t.type, t.value, t.pos])).toEqual([
+      [TokenType.Identifier, "Key", 0],
+      [TokenType.String, "a b", 4],
+      [TokenType.OpenBrace, "{", 10],
+      [TokenType.Identifier, "x-1.5", 13],
+      [TokenType.Colon, ":", 19],
+      [TokenType.CloseBrace, "}", 21],
+    ]);
+  });
+
+  it("decodes escapes only inside strings that contain them", () => {
+    const tokens = tokenize('"say \\"hi\\"\\t\\\\x\\q" "plain"');
+    expect(tokens.map((t) => t.value)).toEqual(['say "hi"\t\\xq', "plain"]);
+  });
+
+  it("skips comments and unknown characters, and runs unterminated strings to EOF", () => {
+    expect(tokenize("// header\nA # B").map((t) => t.value)).toEqual(["A", "B"]);
+    expect(tokenize('A "open \\').map((t) => t.value)).toEqual(["A", "open \\"]);
+  });
+});
+
 describe("enfusion-text parser", () => {
   it("parses minimal .gproj", () => {
     const input = `GameProject {
@@ -200,6 +200,18 @@ describe("PakVirtualFS", () => {
     expect(buf.toString("utf-8")).toBe('GenericEntity { ID "box" }');
   });
 
+  it("streams compressed and uncompressed files", async () => {
+    const vfs = PakVirtualFS.get(GAME_DIR)!;
+    const read = async (path: string) => {
+      const parts: Buffer[] = [];
+      for await (const chunk of vfs.createReadStream(path)) parts.push(chunk as Buffer);
+      return Buffer.concat(parts).toString("utf-8");
+    };
+    expect(await read("Prefabs/box.et")).toBe('GenericEntity { ID "box" }');
+    expect(await read("Configs/game.conf")).toBe("GameConfig { mode coop }");
+    expect(() => vfs.createReadStream("no/such/file.et")).toThrow("File not found in pak");
+  });
+
   it("throws on nonexistent file read", () => {
     const vfs = PakVirtualFS.get(GAME_DIR)!;
     expect(() => vfs.readFile("no/such/file.c")).toThrow("File not found in pak");
@@ -0,0 +1,230 @@
+import { describe, it, expect, afterAll } from "vitest";
+import { EventEmitter } from "node:events";
+import { mkdirSync, writeFileSync, rmSync, existsSync, utimesSync } from "node:fs";
+import { resolve, join, dirname } from "node:path";
+import {
+  AnalysisPool,
+  analyzeFile,
+  analyzeFiles,
+  validateMod,
+  walkProject,
+  type FileJob,
+  type PoolWorker,
+} from "../../src/utils/mod-validator.js";
+import type { SearchEngine } from "../../src/index/search-engine.js";
+
+const TEST_DIR = resolve(import.meta.dirname, "../../tmp-test-mod-validator");
+const INCREMENTAL_DIR = resolve(import.meta.dirname, "../../tmp-test-mod-validator-incremental");
+const POOL_DIR = resolve(import.meta.dirname, "../../tmp-test-mod-validator-pool");
+
+const FILES: Record<string, string> = {
+  "TestMod.gproj": `GameProject {
+ ID "TestMod"
+ GUID "AAAAAAAAAAAAAAAA"
+ Dependencies {
+  "58D0FB3206B6F859"
+ }
+}`,
+  "Scripts/Game/TM_Good.c": "class TM_Good : ScriptComponent\n{\n}\n",
+  "Scripts/Game/XY_Other.c": "modded class XY_Other : MissingBase\n{\n}\n",
+  "Scripts/Game/Empty.c": "// nothing here\n",
+  "Stray.c": "class TM_Stray\n{\n}\n",
+  "Prefabs/Good.et": 'GenericEntity {\n ID "BBBBBBBBBBBBBBBB"\n}\n',
+  "Prefabs/Broken.et": "GenericEntity {\n",
+  "Configs/Test.conf": "SCR_Config {\n Entries {\n  SCR_Entry {\n  }\n  Unknown_Entry {\n  }\n }\n}\n",
+  ".hidden/Ignored.c": "nope",
+};
+
+function write(root: string, path: string, content: string): void {
+  const full = join(root, path);
+  mkdirSync(dirname(full), { recursive: true });
+  writeFileSync(full, content, "utf-8");
+}
+
+for (const [path, content] of Object.entries(FILES)) write(TEST_DIR, path, content);
+
+function fakeIndex(classes: string[]): SearchEngine {
+  const known = new Set(classes.map((c) => c.toLowerCase()));
+  return {
+    hasClass: (name: string) => known.has(name.toLowerCase()),
+    getAllClassNames: () => classes,
+  } as unknown as SearchEngine;
+}
+
+const searchEngine = fakeIndex(["ScriptComponent", "SCR_Config", "SCR_Entry"]);
+
+afterAll(() => {
+  rmSync(TEST_DIR, { recursive: true, force: true });
+  rmSync(INCREMENTAL_DIR, { recursive: true, force: true });
+  rmSync(POOL_DIR, { recursive: true, force: true });
+});
+
+/** Stands in for a worker thread: answers each batch after a random delay, or fails it. */
+class FakeWorker extends EventEmitter {
+  private readonly fail: boolean;
+
+  constructor(fail: boolean) {
+    super();
+    this.fail = fail;
+  }
+
+  postMessage(jobs: FileJob[]): void {
+    setTimeout(() => {
+      if (this.fail) this.emit("error", new Error("worker crashed"));
+      else this.emit("message", analyzeFiles(jobs));
+    }, Math.random() * 10);
+  }
+
+  ref(): void {}
+  unref(): void {}
+}
+
+describe("mod validator", () => {
+  it("walks the project once for the kinds the checks need", () => {
+    const { gprojFiles, files } = walkProject(TEST_DIR, new Set(["script", "config"]));
+    expect(gprojFiles).toEqual(["TestMod.gproj"]);
+    expect(files.map((f) => f.rel).sort()).toEqual([
+      "Configs/Test.conf",
+      "Scripts/Game/Empty.c",
+      "Scripts/Game/TM_Good.c",
+      "Scripts/Game/XY_Other.c",
+      "Stray.c",
+    ]);
+  });
+
+  it("summarizes scripts and configs into facts", () => {
+    const script = analyzeFile({ path: join(TEST_DIR, "Scripts/Game/XY_Other.c"), rel: "a.c", kind: "script" });
+    expect(script.hash).toHaveLength(28);
+    expect({ ...script, hash: "" }).toEqual({
+      kind: "script",
+      rel: "a.c",
+      hash: "",
+      hasClass: true,
+      className: "XY_Other",
+      parentClass: "MissingBase",
+      declared: ["XY_Other"],
+    });
+    expect(analyzeFile({ path: join(TEST_DIR, "Configs/Test.conf"), rel: "t.conf", kind: "config" })).toMatchObject({
+      kind: "config",
+      rel: "t.conf",
+      rootType: "SCR_Config",
+      childClasses: ["Entries", "SCR_Entry", "Unknown_Entry"],
+    });
+    write(TEST_DIR, "Scripts/Game/TM_Noisy.c", [
+      "// class TM_Commented : Old",
+      "/* class TM_Block",
+      "   : Older */",
+      'class TM_Real : ScriptComponent { string s = "class TM_Quoted \\" x"; }',
+    ].join("\n"));
+    const noisy = analyzeFile({ path: join(TEST_DIR, "Scripts/Game/TM_Noisy.c"), rel: "n.c", kind: "script" });
+    rmSync(join(TEST_DIR, "Scripts/Game/TM_Noisy.c"));
+    expect(noisy).toMatchObject({ declared: ["TM_Real"], className: "TM_Real", parentClass: "ScriptComponent" });
+    const missing = analyzeFile({ path: join(TEST_DIR, "nope.et"), rel: "nope.et", kind: "prefab" });
+    expect(missing.error).toMatch(/ENOENT/);
+  });
+
+  it("runs every check over the shared facts", async () => {
+    const result = await validateMod(TEST_DIR, { searchEngine });
+    const messages = result.issues.map((i) => `${i.level}: ${i.message}`);
+
+    expect(messages).toContain(
+      "error: Stray.c: Script is outside a valid module folder (Scripts/Game/, Scripts/GameLib/, Scripts/WorkbenchGame/) — it will be silently ignored"
+    );
+    expect(messages).toContain("warning: Scripts/Game/Empty.c: No class declaration found");
+    expect(messages.filter((m) => m.startsWith("error: Prefabs/Broken.et: Invalid prefab format"))).toHaveLength(1);
+    expect(messages).toContain('warning: Configs/Test.conf: Class "Entries" not found in API index.');
+    expect(messages).toContain('warning: Configs/Test.conf: Class "Unknown_Entry" not found in API index.');
+    expect(messages).toContain(
+      'warning: Scripts/Game/XY_Other.c: Extends "MissingBase" which is not in the API index (may be from another mod)'
+    );
+    expect(messages).toContain('info: 1 class(es) use prefix "XY_" instead of the most common prefix "TM_"');
+    expect(result.passed).toEqual(["structure", "gproj"]);
+    expect(result.files).toBe(7);
+  });
+
+  it("only reads the files the requested checks visit", async () => {
+    const result = await validateMod(TEST_DIR, { checks: ["prefabs"] });
+    expect(result.files).toBe(2);
+    expect(result.passed).toEqual([]);
+    expect(result.issues).toHaveLength(1);
+  });
+
+  it("rechecks only changed files and the files referencing their classes", async () => {
+    write(INCREMENTAL_DIR, "TestMod.gproj", FILES["TestMod.gproj"]);
+    write(INCREMENTAL_DIR, "Scripts/Game/TM_Base.c", "class TM_Base : ScriptComponent\n{\n}\n");
+    write(INCREMENTAL_DIR, "Scripts/Game/TM_Child.c", "class TM_Child : TM_Base\n{\n}\n");
+    write(INCREMENTAL_DIR, "Scripts/Game/TM_Other.c", "class TM_Other : ScriptComponent\n{\n}\n");
+    write(INCREMENTAL_DIR, "Configs/Base.conf", "TM_Base {\n}\n");
+    const options = { searchEngine, cache: true };
+
+    // Classes declared by the mod itself count as known
+    const first = await validateMod(INCREMENTAL_DIR, options);
+    expect(first.issues).toEqual([]);
+    expect(first).toMatchObject({ files: 4, analyzed: 4, rechecked: 4 });
+    expect(existsSync(join(INCREMENTAL_DIR, ".enfusion-mcp", "validation-cache.json"))).toBe(true);
+
+    expect(await validateMod(INCREMENTAL_DIR, options)).toMatchObject({ issues: [], analyzed: 0, rechecked: 0 });
+
+    // Touched but unchanged: re-read, nothing rechecked
+    const later = new Date(Date.now() + 5000);
+    utimesSync(join(INCREMENTAL_DIR, "Scripts/Game/TM_Other.c"), later, later);
+    expect(await validateMod(INCREMENTAL_DIR, options)).toMatchObject({ analyzed: 1, rechecked: 0 });
+
+    // Renaming the base class affects the child script and the config, not TM_Other.c
+    write(INCREMENTAL_DIR, "Scripts/Game/TM_Base.c", "class TM_Base2 : ScriptComponent\n{\n}\n");
+    const edited = await validateMod(INCREMENTAL_DIR, options);
+    expect(edited).toMatchObject({ analyzed: 1, rechecked: 3 });
+    expect(edited.issues.map((i) => i.message)).toEqual([
+      'Configs/Base.conf: Root class "TM_Base" not found in API index — may be from another mod or misspelled.',
+      'Scripts/Game/TM_Child.c: Extends "TM_Base" which is not in the API index (may be from another mod)',
+    ]);
+
+    // An index with the same class count but different classes invalidates the cached issues
+    const swapped = fakeIndex(["ScriptComponent", "TM_Base", "SCR_Other"]);
+    const reindexed = await validateMod(INCREMENTAL_DIR, { searchEngine: swapped, cache: true });
+    expect(reindexed).toMatchObject({ analyzed: 0, rechecked: 4 });
+    expect(reindexed.issues.map((i) => i.message)).toEqual([]);
+  });
+
+  it("rechecks dependents in a later full run after a class changed in a partial run", async () => {
+    const dir = join(INCREMENTAL_DIR, "partial");
+    write(dir, "TestMod.gproj", FILES["TestMod.gproj"]);
+    write(dir, "Scripts/Game/TM_Base.c", "class TM_Base : ScriptComponent\n{\n}\n");
+    write(dir, "Scripts/Game/TM_Child.c", "class TM_Child : TM_Base\n{\n}\n");
+    write(dir, "Configs/Base.conf", "TM_Base {\n}\n");
+    expect((await validateMod(dir, { searchEngine, cache: true })).issues).toEqual([]);
+
+    write(dir, "Scripts/Game/TM_Base.c", "class TM_Base2 : ScriptComponent\n{\n}\n");
+    await validateMod(dir, { searchEngine, cache: true, checks: ["scripts"] });
+
+    const full = await validateMod(dir, { searchEngine, cache: true });
+    expect(full.issues.map((i) => i.message)).toEqual([
+      'Configs/Base.conf: Root class "TM_Base" not found in API index — may be from another mod or misspelled.',
+      'Scripts/Game/TM_Child.c: Extends "TM_Base" which is not in the API index (may be from another mod)',
+    ]);
+  });
+
+  it("reports the same issues on a worker pool as the serial walk", async () => {
+    write(POOL_DIR, "TestMod.gproj", FILES["TestMod.gproj"]);
+    for (let i = 0; i < 30; i++) {
+      write(POOL_DIR, `Scripts/Game/TM_Class${i}.c`, `class TM_Class${i} : ${i % 3 === 0 ? "Missing" : "ScriptComponent"}\n{\n}\n`);
+      write(POOL_DIR, `Prefabs/P${i}.et`, i % 4 === 0 ? "GenericEntity {\n" : 'GenericEntity {\n ID "BBBBBBBBBBBBBBBB"\n}\n');
+      write(POOL_DIR, `Configs/C${i}.conf`, i % 5 === 0 ? "Unknown_Root {\n}\n" : "SCR_Config {\n}\n");
+    }
+    write(POOL_DIR, "Scripts/Game/XY_Odd.c", "class XY_Odd\n{\n}\n");
+
+    const serial = await validateMod(POOL_DIR, { searchEngine, parallel: false });
+    expect(serial.parallel).toBe(false);
+    expect(serial.issues.length).toBeGreaterThan(0);
+
+    // The first worker fails its batch, which is then analyzed inline
+    let spawned = 0;
+    const pool = new AnalysisPool(3, () => new FakeWorker(spawned++ === 0) as unknown as PoolWorker);
+    const pooled = await validateMod(POOL_DIR, { searchEngine, pool });
+    expect(pooled.parallel).toBe(true);
+    expect(pooled.issues).toEqual(serial.issues);
+    expect(pooled.passed).toEqual(serial.passed);
+    expect(spawned).toBeGreaterThan(1);
+    expect(spawned).toBeLessThanOrEqual(4);
+  });
+});
@@ -0,0 +1,76 @@
+import { describe, it, expect, afterAll } from "vitest";
+import { mkdirSync, writeFileSync, rmSync, utimesSync } from "node:fs";
+import { resolve, join } from "node:path";
+import { EnfusionParseCache } from "../../src/utils/parse-cache.js";
+
+const TEST_DIR = resolve(import.meta.dirname, "../../tmp-test-parse-cache");
+
+function write(name: string, content: string, mtime?: number): string {
+  mkdirSync(TEST_DIR, { recursive: true });
+  const path = join(TEST_DIR, name);
+  writeFileSync(path, content, "utf-8");
+  if (mtime !== undefined) utimesSync(path, mtime, mtime);
+  return path;
+}
+
+afterAll(() => rmSync(TEST_DIR, { recursive: true, force: true }));
+
+describe("EnfusionParseCache", () => {
+  it("reuses parsed documents until the file's mtime or size changes", () => {
+    const cache = new EnfusionParseCache();
+    const path = write("a.et", 'GenericEntity {\n ID "1"\n}\n', 1000);
+
+    const first = cache.readFile(path);
+    expect(first.tree.type).toBe("GenericEntity");
+    expect(cache.readFile(join(TEST_DIR, ".", "a.et"))).toBe(first);
+    expect(cache.readFile(path).tree).toBe(first.tree);
+
+    write("a.et", 'GenericEntity {\n ID "2"\n}\n', 2000);
+    const second = cache.readFile(path);
+    expect(second).not.toBe(first);
+    expect(second.lazy.properties).toEqual([{ key: "ID", value: "2" }]);
+    expect(cache.stats()).toMatchObject({ entries: 1, hits: 2, misses: 2 });
+  });
+
+  it("caches parse errors", () => {
+    const cache = new EnfusionParseCache();
+    const doc = cache.readFile(write("bad.conf", "Root { Open {"));
+    expect(() => doc.tree).toThrow("Unexpected EOF");
+    expect(() => cache.readFile(join(TEST_DIR, "bad.conf")).tree).toThrow("Unexpected EOF");
+  });
+
+  it("evicts least-recently-used entries over the byte budget", () => {
+    // Each 100-char file holds 200 bytes of text and 600 more once parsed
+    const cache = new EnfusionParseCache({ maxBytes: 1000 });
+    const body = (n: number) => `E${n} {\n ${"x".repeat(92)}\n}`;
+    const [a, b, c] = [1, 2, 3].map((n) => write(`lru${n}.et`, body(n)));
+
+    cache.readFile(a);
+    cache.readFile(b);
+    cache.readFile(a); // a is now most recently used
+    cache.readFile(c);
+    expect(cache.stats()).toMatchObject({ entries: 3, bytes: 600, evictions: 0 });
+
+    cache.readFile(c).tree; // grows c to 800 bytes: b, the least recent, is dropped
+    expect(cache.stats()).toMatchObject({ entries: 2, bytes: 1000, evictions: 1 });
+    cache.readFile(a).tree; // a grows too: c goes, never the entry being used
+    expect(cache.stats()).toMatchObject({ entries: 1, bytes: 800, evictions: 2 });
+    expect(cache.readFile(a).tree.type).toBe("E1");
+    expect(cache.stats().misses).toBe(3);
+  });
+
+  it("keys non-file sources by version", () => {
+    const cache = new EnfusionParseCache();
+    let reads = 0;
+    const read = () => {
+      reads++;
+      return "Pak { }";
+    };
+    cache.load("pak:x.et", "data.pak@10:7", read);
+    cache.load("pak:x.et", "data.pak@10:7", read);
+    cache.load("pak:x.et", "data.pak@20:7", read);
+    expect(reads).toBe(2);
+    cache.invalidate("pak:x.et");
+    expect(cache.stats()).toMatchObject({ entries: 0, bytes: 0 });
+  });
+});
@@ -3,7 +3,9 @@ import {
   stripGuid,
   parseParentPath,
   parseComponents,
+  parseTopLevelComponents,
   mergeAncestryComponents,
+  resolveComponents,
   type AncestorLevel,
 } from "../../src/utils/prefab-ancestry.js";
 
@@ -70,6 +72,88 @@ describe("parseComponents", () => {
   });
 });
 
+describe("parseComponents with nesting", () => {
+  const content = `GenericEntity {
+ components {
+  WeaponComponent "{AAAAAAAAAAAAAAAA}" {
+   Name "brace } in a string {"
+   components {
+    SightsComponent "{BBBBBBBBBBBBBBBB}" {
+    }
+   }
+   Attributes SCR_ItemAttributeCollection "{CCCCCCCCCCCCCCCC}" {
+   }
+  }
+ }
+}`;
+
+  it("finds nested and class-qualified components with exact bodies", () => {
+    const comps = parseComponents(content);
+    expect([...comps.keys()]).toEqual(["AAAAAAAAAAAAAAAA", "BBBBBBBBBBBBBBBB", "CCCCCCCCCCCCCCCC"]);
+    expect(comps.get("AAAAAAAAAAAAAAAA")!.rawBody).toContain('Name "brace } in a string {"');
+    expect(comps.get("AAAAAAAAAAAAAAAA")!.rawBody.trimEnd().endsWith("}")).toBe(true);
+    expect(comps.get("CCCCCCCCCCCCCCCC")!.typeName).toBe("SCR_ItemAttributeCollection");
+  });
+
+  it("returns only direct children for parseTopLevelComponents", () => {
+    expect([...parseTopLevelComponents(content).keys()]).toEqual(["AAAAAAAAAAAAAAAA"]);
+  });
+
+  it("returns an empty map for malformed files", () => {
+    expect(parseComponents("GenericEntity { components { A \"{AAAAAAAAAAAAAAAA}\" {").size).toBe(0);
+  });
+});
+
+describe("resolveComponents", () => {
+  function level(depth: number, content: string): AncestorLevel {
+    return { path: `level${depth}.et`, depth, entityClass: "GenericEntity", components: parseComponents(content), rawContent: content };
+  }
+
+  it("overlays properties and nested objects along the chain", () => {
+    const base = level(0, `GenericEntity {
+ components {
+  MeshObject "{AAAAAAAAAAAAAAAA}" {
+   Object "base.xob"
+   Materials "m"
+   Settings {
+    A 1
+    B 2
+   }
+  }
+  RigidBody "{BBBBBBBBBBBBBBBB}" {
+   Mass 10
+  }
+ }
+}`);
+    const child = level(1, `GenericEntity : "level0.et" {
+ components {
+  MeshObject "{AAAAAAAAAAAAAAAA}" {
+   Object "child.xob"
+   Settings {
+    B 3
+   }
+   Extra 1
+  }
+ }
+}`);
+
+    const resolved = resolveComponents([base, child]);
+    const mesh = resolved.get("AAAAAAAAAAAAAAAA")!;
+    expect(mesh.declaredIn.map((l) => l.depth)).toEqual([0, 1]);
+    expect(mesh.node.properties).toEqual([
+      { key: "Object", value: "child.xob" },
+      { key: "Materials", value: "m" },
+      { key: "Extra", value: "1" },
+    ]);
+    expect(mesh.node.children[0].properties).toEqual([
+      { key: "A", value: "1" },
+      { key: "B", value: "3" },
+    ]);
+    expect(resolved.get("BBBBBBBBBBBBBBBB")!.declaredIn).toEqual([base]);
+    expect(resolved.get("BBBBBBBBBBBBBBBB")!.topLevel).toBe(true);
+  });
+});
+
 describe("mergeAncestryComponents", () => {
   function makeLevel(depth: number, components: Record<string, string>): AncestorLevel {
     const compMap = new Map(
@@ -0,0 +1,72 @@
+import { describe, it, expect, afterAll } from "vitest";
+import { mkdirSync, writeFileSync, rmSync, existsSync } from "node:fs";
+import { resolve, join, dirname } from "node:path";
+import { ResourceResolver } from "../../src/utils/resource-resolver.js";
+import { PrefabGraph } from "../../src/utils/prefab-graph.js";
+
+const TEST_DIR = resolve(import.meta.dirname, "../../tmp-test-prefab-graph");
+const PROJECT = join(TEST_DIR, "project");
+const EXTRACTED = join(TEST_DIR, "extracted");
+const CACHE_FILE = join(TEST_DIR, "cache", "graph.json");
+
+function prefab(root: string, path: string, entityClass: string, parent?: string): void {
+  const file = join(root, path);
+  mkdirSync(dirname(file), { recursive: true });
+  const header = parent ? `${entityClass} : "{0123456789ABCDEF}${parent}" {` : `${entityClass} {`;
+  writeFileSync(file, `${header}\n ID "5D3E8C2A1B4F6E7D"\n}\n`, "utf-8");
+}
+
+// Base ← Rifle ← Rifle_AK ← Rifle_AK_Mod (project), Base ← Pistol
+prefab(join(EXTRACTED, "Data001"), "Prefabs/Weapons/Weapon_Base.et", "GenericEntity");
+prefab(join(EXTRACTED, "Data001"), "Prefabs/Weapons/Rifle_Base.et", "GenericEntity", "Prefabs/Weapons/Weapon_Base.et");
+prefab(join(EXTRACTED, "Data001"), "Prefabs/Weapons/Pistol_Base.et", "GenericEntity", "Prefabs/Weapons/Weapon_Base.et");
+prefab(join(EXTRACTED, "Data002"), "Prefabs/Weapons/Rifle_AK.et", "GenericEntity", "Prefabs/Weapons/Rifle_Base.et");
+prefab(join(PROJECT, "MyMod"), "Prefabs/Weapons/Rifle_AK_Mod.et", "GenericEntity", "Prefabs/Weapons/Rifle_AK.et");
+
+const roots = { projectPath: PROJECT, extractedPath: EXTRACTED, gamePath: join(TEST_DIR, "game") };
+
+afterAll(() => rmSync(TEST_DIR, { recursive: true, force: true }));
+
+describe("PrefabGraph", () => {
+  it("answers ancestor, child and descendant queries", async () => {
+    const graph = new PrefabGraph(new ResourceResolver(roots));
+    const stats = await graph.build();
+    expect(stats).toMatchObject({ prefabs: 5, read: 5, reused: 0, failed: 0 });
+
+    expect(graph.ancestors("{AAAAAAAAAAAAAAAA}Prefabs/Weapons/Rifle_AK_Mod.et").map((n) => n.path)).toEqual([
+      "Prefabs/Weapons/Rifle_AK.et",
+      "Prefabs/Weapons/Rifle_Base.et",
+      "Prefabs/Weapons/Weapon_Base.et",
+    ]);
+    expect(graph.children("prefabs/weapons/weapon_base.et").map((n) => n.path)).toEqual([
+      "Prefabs/Weapons/Pistol_Base.et",
+      "Prefabs/Weapons/Rifle_Base.et",
+    ]);
+    expect(graph.descendants("Prefabs/Weapons/Weapon_Base.et").map((d) => [d.node.path, d.depth, d.node.source])).toEqual([
+      ["Prefabs/Weapons/Pistol_Base.et", 1, "extracted"],
+      ["Prefabs/Weapons/Rifle_Base.et", 1, "extracted"],
+      ["Prefabs/Weapons/Rifle_AK.et", 2, "extracted"],
+      ["Prefabs/Weapons/Rifle_AK_Mod.et", 3, "project"],
+    ]);
+    expect(graph.descendants("Prefabs/Weapons/Weapon_Base.et", 1)).toHaveLength(2);
+  });
+
+  it("persists the graph and re-reads only changed prefabs", async () => {
+    const first = new PrefabGraph(new ResourceResolver(roots), { cacheFile: CACHE_FILE });
+    await first.build();
+    expect(existsSync(CACHE_FILE)).toBe(true);
+
+    // A new session loads the saved graph and only stats files
+    const second = new PrefabGraph(new ResourceResolver(roots), { cacheFile: CACHE_FILE });
+    expect(await second.build()).toMatchObject({ prefabs: 5, read: 0, reused: 5 });
+
+    // Reparent the mod's rifle onto the pistol base
+    prefab(join(PROJECT, "MyMod"), "Prefabs/Weapons/Rifle_AK_Mod.et", "GenericEntity", "Prefabs/Weapons/Pistol_Base.et");
+    const third = new PrefabGraph(new ResourceResolver(roots), { cacheFile: CACHE_FILE });
+    expect(await third.build()).toMatchObject({ prefabs: 5, read: 1, reused: 4 });
+    expect(third.children("Prefabs/Weapons/Pistol_Base.et").map((n) => n.path)).toEqual([
+      "Prefabs/Weapons/Rifle_AK_Mod.et",
+    ]);
+    expect(third.descendants("Prefabs/Weapons/Rifle_AK.et")).toEqual([]);
+  });
+});
@@ -0,0 +1,90 @@
+import { describe, it, expect, afterAll } from "vitest";
+import { mkdirSync, writeFileSync, rmSync } from "node:fs";
+import { resolve, join, dirname } from "node:path";
+import { ResourceResolver } from "../../src/utils/resource-resolver.js";
+
+const TEST_DIR = resolve(import.meta.dirname, "../../tmp-test-resource-resolver");
+const PROJECT = join(TEST_DIR, "project");
+const EXTRACTED = join(TEST_DIR, "extracted");
+const GAME = join(TEST_DIR, "game");
+
+function write(path: string): string {
+  mkdirSync(dirname(path), { recursive: true });
+  writeFileSync(path, "GenericEntity {\n}\n", "utf-8");
+  return path;
+}
+
+afterAll(() => rmSync(TEST_DIR, { recursive: true, force: true }));
+
+describe("ResourceResolver", () => {
+  const roots = { projectPath: PROJECT, extractedPath: EXTRACTED, gamePath: GAME };
+
+  it("resolves case-insensitively inside addon and DataXXX folders", () => {
+    const inAddon = write(join(PROJECT, "MyMod", "Prefabs", "Weapons", "Rifle.et"));
+    const inData = write(join(EXTRACTED, "Data006", "Prefabs", "Props", "Crate.et"));
+    const resolver = new ResourceResolver(roots);
+
+    expect(resolver.resolve("prefabs/weapons/rifle.et")).toEqual({ kind: "file", path: inAddon, source: "project" });
+    expect(resolver.resolve("Prefabs\\Props\\Crate.et")).toEqual({ kind: "file", path: inData, source: "extracted" });
+    expect(resolver.resolve("Data006/Prefabs/Props/Crate.et")).toEqual({ kind: "file", path: inData, source: "extracted" });
+    expect(resolver.resolve("Prefabs/Props/Missing.et")).toBeNull();
+  });
+
+  it("prefers the project over extracted data and loose game data", () => {
+    write(join(GAME, "addons", "data", "Data001", "Prefabs", "Shared.et"));
+    write(join(EXTRACTED, "Data001", "Prefabs", "Shared.et"));
+    const override = write(join(PROJECT, "MyMod", "Prefabs", "Shared.et"));
+    const loose = write(join(GAME, "addons", "data", "Data001", "Prefabs", "GameOnly.et"));
+    const resolver = new ResourceResolver(roots);
+
+    expect(resolver.resolve("Prefabs/Shared.et")).toEqual({ kind: "file", path: override, source: "project" });
+    expect(resolver.resolve("Prefabs/GameOnly.et")).toEqual({ kind: "file", path: loose, source: "game" });
+  });
+
+  it("picks up added files once a directory changes, or after invalidate()", async () => {
+    const resolver = new ResourceResolver(roots, { revalidateMs: 0 });
+    expect(resolver.resolve("Prefabs/New.et")).toBeNull();
+    const added = write(join(PROJECT, "MyMod", "Prefabs", "New.et"));
+    // Watch events arrive asynchronously
+    for (let i = 0; i < 100 && !resolver.resolve("Prefabs/New.et"); i++) await new Promise((r) => setTimeout(r, 20));
+    expect(resolver.resolve("Prefabs/New.et")).toEqual({ kind: "file", path: added, source: "project" });
+
+    const throttled = new ResourceResolver(roots, { revalidateMs: 60_000 });
+    expect(throttled.resolve("Prefabs/Later.et")).toBeNull();
+    const later = write(join(PROJECT, "OtherMod", "Prefabs", "Later.et"));
+    expect(throttled.resolve("Prefabs/Later.et")).toBeNull();
+    throttled.invalidate();
+    expect(throttled.resolve("Prefabs/Later.et")).toEqual({ kind: "file", path: later, source: "project" });
+  });
+
+  it("tracks only the top folders of the extracted library", () => {
+    const resolver = new ResourceResolver(roots, { revalidateMs: 0 });
+    const fresh = write(join(EXTRACTED, "Data009", "Prefabs", "Fresh.et"));
+    expect(resolver.resolve("Prefabs/Fresh.et")).toEqual({ kind: "file", path: fresh, source: "extracted" });
+    const deep = write(join(EXTRACTED, "Data009", "Prefabs", "Deep", "Deep.et"));
+    expect(resolver.resolve("Prefabs/Deep/Deep.et")).toBeNull();
+    resolver.invalidate();
+    expect(resolver.resolve("Prefabs/Deep/Deep.et")).toEqual({ kind: "file", path: deep, source: "extracted" });
+  });
+
+  it("invalidateProject() rescans only the project", () => {
+    const resolver = new ResourceResolver(roots, { revalidateMs: 60_000 });
+    expect(resolver.resolve("Prefabs/Written.et")).toBeNull();
+    const written = write(join(PROJECT, "MyMod", "Prefabs", "Written.et"));
+    write(join(EXTRACTED, "Data002", "Prefabs", "Extracted.et"));
+    resolver.invalidateProject();
+    expect(resolver.resolve("Prefabs/Written.et")).toEqual({ kind: "file", path: written, source: "project" });
+    expect(resolver.resolve("Prefabs/Extracted.et")).toBeNull();
+    resolver.invalidate();
+  });
+
+  it("lists each resource once, where resolve() finds it", () => {
+    const resolver = new ResourceResolver(roots);
+    const listed = resolver.list(".et");
+    const paths = listed.map((r) => r.path);
+    expect(new Set(paths.map((p) => p.toLowerCase())).size).toBe(paths.length);
+    for (const { path, resource } of listed) expect(resolver.resolve(path)).toEqual(resource);
+    expect(listed.find((r) => r.path === "Prefabs/Shared.et")?.resource.source).toBe("project");
+    expect(paths).toContain("Prefabs/Props/Crate.et");
+  });
+});
@@ -0,0 +1,70 @@
+import { describe, it, expect } from "vitest";
+import { encodeBulkCreate, encodeComponentProperties, splitPropertyPath } from "../../src/workbench/bulk-create.js";
+import { decodeRecords, unescapeField } from "../../src/workbench/records.js";
+
+describe("splitPropertyPath", () => {
+  it("splits component path from key", () => {
+    expect(splitPropertyPath("SCR_ScenarioFrameworkArea.m_fAreaRadius")).toEqual({
+      propertyPath: "SCR_ScenarioFrameworkArea",
+      propertyKey: "m_fAreaRadius",
+    });
+  });
+
+  it("treats a bare key as a root entity property", () => {
+    expect(splitPropertyPath("m_sFaction")).toEqual({ propertyPath: "", propertyKey: "m_sFaction" });
+  });
+
+  it("unquotes quoted keys", () => {
+    expect(splitPropertyPath('SCR_FactionAffiliationComponent."faction affiliation"').propertyKey).toBe(
+      "faction affiliation"
+    );
+  });
+});
+
+describe("encodeBulkCreate", () => {
+  it("encodes entity and property records in field order", () => {
+    const { entities, properties } = encodeBulkCreate([
+      { prefab: "{A}Area.et", name: "Obj_Area", position: "1 2 3", properties: [{ property: "Area.m_fRadius", value: "50" }] },
+      { prefab: "{B}Layer.et", name: "Obj_Layer", parent: "Obj_Area", layerID: 2 },
+    ]);
+    expect(decodeRecords(entities)).toEqual([
+      ["{A}Area.et", "Obj_Area", "", "1 2 3", "", ""],
+      ["{B}Layer.et", "Obj_Layer", "2", "", "", "Obj_Area"],
+    ]);
+    expect(decodeRecords(properties)).toEqual([["Obj_Area", "Area", "m_fRadius", "50"]]);
+  });
+
+  it("escapes free-text property values instead of rejecting them", () => {
+    const description = "Clear the village.\nThen hold\tthe bridge.";
+    const { properties } = encodeBulkCreate([
+      { prefab: "{A}Task.et", name: "Obj_Task", properties: [{ property: "Task.m_sTaskDescription", value: description }] },
+    ]);
+    const rows = decodeRecords(properties);
+    expect(rows).toHaveLength(1);
+    expect(rows[0].map(unescapeField)).toEqual(["Obj_Task", "Task", "m_sTaskDescription", description]);
+  });
+
+  it("requires a name to target properties", () => {
+    expect(() => encodeBulkCreate([{ prefab: "{A}X.et", properties: [{ property: "m_x", value: "1" }] }])).toThrow(
+      /no name/
+    );
+  });
+});
+
+describe("encodeComponentProperties", () => {
+  it("splits paths relative to the component and escapes free-text values", () => {
+    const payload = encodeComponentProperties([
+      { property: "m_fRadius", value: "25" },
+      { property: "m_Settings.m_sText", value: "Line one\nLine\ttwo \\ done" },
+    ]);
+    const rows = decodeRecords(payload);
+    expect(rows).toHaveLength(2);
+    expect(rows[0]).toEqual(["", "m_fRadius", "25"]);
+    expect(rows[1].slice(0, 2)).toEqual(["m_Settings", "m_sText"]);
+    expect(unescapeField(rows[1][2])).toBe("Line one\nLine\ttwo \\ done");
+  });
+
+  it("encodes no properties as an empty payload", () => {
+    expect(encodeComponentProperties([])).toBe("");
+  });
+});
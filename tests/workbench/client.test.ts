@@ -1,6 +1,7 @@
 import { describe, it, expect, beforeEach, afterEach } from "vitest";
 import { createServer, type Server, type Socket } from "node:net";
 import { WorkbenchClient, WorkbenchError } from "../../src/workbench/client.js";
+import type { Config } from "../../src/config.js";
 import {
   decodePascalString,
   decodeInt32LE,
@@ -254,3 +255,137 @@ describe("WorkbenchClient", () => {
     expect(state.mode).toBe("unknown");
   });
 });
+
+describe("WorkbenchClient connection pool", () => {
+  /**
+   * Mock NET API server that tolerates pooled sockets: connections closed
+   * without a request are ignored, and accepted sockets are tracked so the
+   * test can simulate Workbench dropping idle connections.
+   */
+  function createPoolingMock() {
+    const sockets = new Set<Socket>();
+    let requests = 0;
+    let drop = false;
+    const server = createServer((socket: Socket) => {
+      sockets.add(socket);
+      socket.on("error", () => {});
+      socket.on("close", () => sockets.delete(socket));
+      const chunks: Buffer[] = [];
+      socket.on("data", (chunk) => chunks.push(chunk));
+      socket.on("end", () => {
+        const buf = Buffer.concat(chunks);
+        if (buf.length === 0) return;
+        requests++;
+        // Simulate Workbench closing the connection after reading the request
+        if (drop) {
+          drop = false;
+          socket.destroy();
+          return;
+        }
+        socket.end(Buffer.concat([encodePascalString("Ok"), encodePascalString(JSON.stringify({ n: requests }))]));
+      });
+    });
+    server.listen(0);
+    const addr = server.address();
+    const port = addr && typeof addr !== "string" ? addr.port : 0;
+    return {
+      port,
+      sockets,
+      get requests() {
+        return requests;
+      },
+      /** Close the next request's connection without answering. */
+      dropNext: () => {
+        drop = true;
+      },
+      close: () => {
+        for (const s of sockets) s.destroy();
+        return new Promise<void>((res) => server.close(() => res()));
+      },
+    };
+  }
+
+  const poolConfig = (size: number) => ({ workbenchPoolSize: size }) as unknown as Config;
+  const waitForIdle = async (client: WorkbenchClient, count: number) => {
+    const pool = (client as unknown as { pool: { idleCount: number } }).pool;
+    for (let i = 0; i < 100 && pool.idleCount < count; i++) {
+      await new Promise((r) => setTimeout(r, 5));
+    }
+    return pool.idleCount;
+  };
+
+  it("serves a burst of calls through pre-connected sockets", async () => {
+    const mock = createPoolingMock();
+    const client = new WorkbenchClient("127.0.0.1", mock.port, poolConfig(2));
+    try {
+      await client.call("Warmup", {}, { skipAutoLaunch: true });
+      expect(await waitForIdle(client, 2)).toBe(2);
+
+      for (let i = 0; i < 50; i++) {
+        await client.call("Burst", { i }, { skipAutoLaunch: true });
+      }
+      expect(mock.requests).toBe(51);
+    } finally {
+      client.close();
+      await mock.close();
+    }
+  });
+
+  it("falls back to a fresh connection when Workbench drops idle sockets", async () => {
+    const mock = createPoolingMock();
+    const client = new WorkbenchClient("127.0.0.1", mock.port, poolConfig(1));
+    try {
+      await client.call("Warmup", {}, { skipAutoLaunch: true });
+      expect(await waitForIdle(client, 1)).toBe(1);
+
+      // Simulate the server reaping the idle connection
+      for (const s of mock.sockets) s.destroy();
+      await new Promise((r) => setTimeout(r, 20));
+
+      const result = await client.call<{ n: number }>("AfterDrop", {}, { skipAutoLaunch: true });
+      expect(result.n).toBe(2);
+    } finally {
+      client.close();
+      await mock.close();
+    }
+  });
+
+  it("resends only replay-safe calls after a pooled socket drops mid-call", async () => {
+    const mock = createPoolingMock();
+    const client = new WorkbenchClient("127.0.0.1", mock.port, poolConfig(1));
+    try {
+      await client.call("Warmup", {}, { skipAutoLaunch: true });
+      expect(await waitForIdle(client, 1)).toBe(1);
+
+      // Workbench may have run the request before dropping: a create must not be sent twice
+      mock.dropNext();
+      await expect(client.call("EMCP_WB_CreateEntity", {}, { skipAutoLaunch: true })).rejects.toThrow();
+      expect(mock.requests).toBe(2);
+
+      await client.call("Warmup", {}, { skipAutoLaunch: true });
+      expect(await waitForIdle(client, 1)).toBe(1);
+      mock.dropNext();
+      const state = await client.call<{ n: number }>(
+        "EMCP_WB_GetState",
+        {},
+        { skipAutoLaunch: true, replaySafe: true }
+      );
+      expect(state.n).toBe(5);
+    } finally {
+      client.close();
+      await mock.close();
+    }
+  });
+
+  it("does not pool when pool size is 0", async () => {
+    const mock = createPoolingMock();
+    const client = new WorkbenchClient("127.0.0.1", mock.port, poolConfig(0));
+    try {
+      await client.call("One", {}, { skipAutoLaunch: true });
+      expect((client as unknown as { pool: unknown }).pool).toBeNull();
+    } finally {
+      client.close();
+      await mock.close();
+    }
+  });
+});
@@ -0,0 +1,106 @@
+import { describe, it, expect } from "vitest";
+import { decodeEntityColumns, isColumnar } from "../../src/workbench/columnar.js";
+
+describe("columnar", () => {
+  const columnar = {
+    status: "ok",
+    encoding: "columnar",
+    totalCount: 3,
+    classNames: ["GenericEntity", "SCR_DestructibleEntity"],
+    names: ["Tree_01", "House_02", "Tree_03"],
+    classIndex: [1, 0, 1],
+    positions: [1, 2, 3, 4.5, 5, 6, -7, 8, 9.25],
+  };
+
+  it("detects columnar responses", () => {
+    expect(isColumnar(columnar)).toBe(true);
+    expect(isColumnar({ entities: [] })).toBe(false);
+  });
+
+  it("expands parallel arrays into entity objects", () => {
+    const entities = decodeEntityColumns(columnar);
+    expect(entities).toEqual([
+      { name: "Tree_01", className: "SCR_DestructibleEntity", position: "1 2 3" },
+      { name: "House_02", className: "GenericEntity", position: "4.5 5 6" },
+      { name: "Tree_03", className: "SCR_DestructibleEntity", position: "-7 8 9.25" },
+    ]);
+  });
+
+  it("omits position when the handler sent none", () => {
+    const entities = decodeEntityColumns({
+      encoding: "columnar",
+      classNames: ["GenericEntity"],
+      names: ["A"],
+      classIndex: [0],
+    });
+    expect(entities).toEqual([{ name: "A", className: "GenericEntity" }]);
+  });
+
+  it("decodes projected columns without class indices", () => {
+    const entities = decodeEntityColumns({
+      encoding: "columnar",
+      names: ["A", "B"],
+      prefabs: ["{1}Prefabs/A.et", ""],
+      layerIDs: [0, 3],
+    });
+    expect(entities).toEqual([
+      { name: "A", className: "", prefab: "{1}Prefabs/A.et", layerID: 0 },
+      { name: "B", className: "", prefab: "", layerID: 3 },
+    ]);
+    expect(() => decodeEntityColumns({ encoding: "columnar", names: ["A"], layerIDs: [] })).toThrow("layer IDs");
+  });
+
+  it("passes object-encoded responses through", () => {
+    const entities = decodeEntityColumns({
+      entities: [{ name: "A", className: "X", position: "0 0 0" }],
+    });
+    expect(entities).toHaveLength(1);
+    expect(entities[0].name).toBe("A");
+  });
+
+  it("reads object arrays from a custom key", () => {
+    const entities = decodeEntityColumns(
+      { selectedEntities: [{ name: "Sel", className: "Y" }] },
+      "selectedEntities"
+    );
+    expect(entities[0].name).toBe("Sel");
+  });
+
+  it("rejects mismatched column lengths", () => {
+    expect(() =>
+      decodeEntityColumns({ encoding: "columnar", classNames: [], names: ["A", "B"], classIndex: [0] })
+    ).toThrow("Malformed columnar response");
+    expect(() =>
+      decodeEntityColumns({
+        encoding: "columnar",
+        classNames: ["X"],
+        names: ["A"],
+        classIndex: [0],
+        positions: [1, 2],
+      })
+    ).toThrow("position values");
+  });
+
+  it("is several times smaller than the object encoding for repetitive levels", () => {
+    const count = 1000;
+    const classes = ["GenericEntity", "SCR_DestructibleEntity", "StaticModelEntity"];
+    const objects = {
+      entities: Array.from({ length: count }, (_, i) => ({
+        name: `E${i}`,
+        className: classes[i % classes.length],
+        position: `${i * 1.5} 12.25 ${i * 2.75}`,
+      })),
+    };
+    const cols = {
+      encoding: "columnar",
+      classNames: classes,
+      names: objects.entities.map((e) => e.name),
+      classIndex: objects.entities.map((_, i) => i % classes.length),
+      positions: objects.entities.flatMap((_, i) => [i * 1.5, 12.25, i * 2.75]),
+    };
+    const objectBytes = JSON.stringify(objects).length;
+    const columnarBytes = JSON.stringify(cols).length;
+    expect(columnarBytes * 2).toBeLessThan(objectBytes);
+    expect(decodeEntityColumns(cols)).toEqual(objects.entities);
+  });
+});
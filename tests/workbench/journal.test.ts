@@ -0,0 +1,90 @@
+import { describe, it, expect } from "vitest";
+import { collapseChanges, fetchChanges, type ChangeEvent } from "../../src/workbench/journal.js";
+import type { WorkbenchClient } from "../../src/workbench/client.js";
+
+let seq = 0;
+function ev(type: string, name: string, detail = ""): ChangeEvent {
+  seq++;
+  return { seq, type, name, detail };
+}
+
+describe("collapseChanges", () => {
+  it("keeps only the last move per entity", () => {
+    const deltas = collapseChanges([ev("move", "Tree_01", "1 0 1"), ev("move", "Tree_01", "2 0 2")]);
+    expect(deltas).toHaveLength(1);
+    expect(deltas[0]).toMatchObject({ name: "Tree_01", position: "2 0 2", created: false, deleted: false });
+  });
+
+  it("drops entities created and deleted within the run", () => {
+    const deltas = collapseChanges([
+      ev("create", "Temp", "0 0 0"),
+      ev("move", "Temp", "5 0 5"),
+      ev("delete", "Temp"),
+      ev("move", "Keep", "1 1 1"),
+    ]);
+    expect(deltas.map((d) => d.name)).toEqual(["Keep"]);
+  });
+
+  it("chains renames onto one delta and remembers the original name", () => {
+    const deltas = collapseChanges([
+      ev("move", "A", "1 0 0"),
+      ev("rename", "A", "B"),
+      ev("rename", "B", "C"),
+      ev("property", "C", "MeshObject.Object = x.xob"),
+    ]);
+    expect(deltas).toHaveLength(1);
+    expect(deltas[0]).toMatchObject({ name: "C", previousName: "A", position: "1 0 0" });
+    expect(deltas[0].properties).toEqual(["MeshObject.Object = x.xob"]);
+  });
+
+  it("does not report previousName for entities created in the run", () => {
+    const deltas = collapseChanges([ev("create", "New", "0 0 0"), ev("rename", "New", "Renamed")]);
+    expect(deltas[0]).toMatchObject({ name: "Renamed", created: true });
+    expect(deltas[0].previousName).toBeUndefined();
+  });
+
+  it("treats delete then re-create of a name as two entities", () => {
+    const deltas = collapseChanges([ev("delete", "Box"), ev("create", "Box", "3 0 3")]);
+    expect(deltas).toHaveLength(2);
+    expect(deltas[0]).toMatchObject({ deleted: true, created: false });
+    expect(deltas[1]).toMatchObject({ deleted: false, created: true, position: "3 0 3" });
+  });
+});
+
+describe("fetchChanges", () => {
+  function fakeClient(res: Record<string, unknown>, sent: Record<string, unknown>[] = []): WorkbenchClient {
+    return {
+      call: async (_func: string, params: Record<string, unknown>) => {
+        sent.push(params);
+        return res;
+      },
+    } as unknown as WorkbenchClient;
+  }
+
+  it("sends the cursor epoch and reports a restarted journal as a reset", async () => {
+    const sent: Record<string, unknown>[] = [];
+    // The new journal already passed the old cursor's seq; only the epoch tells them apart
+    const client = fakeClient(
+      { status: "ok", epoch: "200-7", latestSeq: 50, oldestSeq: 1, nextSince: 50, reset: true, events: [] },
+      sent
+    );
+    const page = await fetchChanges(client, { since: 40, epoch: "100-3" });
+    expect(sent[0]).toMatchObject({ since: 40, epoch: "100-3" });
+    expect(page).toMatchObject({ reset: true, epoch: "200-7", nextSince: 50 });
+  });
+
+  it("passes a normal page through", async () => {
+    const client = fakeClient({
+      status: "ok",
+      epoch: "100-3",
+      latestSeq: 5,
+      oldestSeq: 1,
+      nextSince: 5,
+      events: [{ seq: 5, type: "move", name: "A", detail: "1 0 1" }],
+    });
+    const page = await fetchChanges(client, { since: 4, epoch: "100-3" });
+    expect(page.reset).toBe(false);
+    expect(page.epoch).toBe("100-3");
+    expect(page.events).toEqual([{ seq: 5, type: "move", name: "A", detail: "1 0 1" }]);
+  });
+});
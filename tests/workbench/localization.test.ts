@@ -0,0 +1,60 @@
+import { describe, it, expect } from "vitest";
+import { diffLocalizationRows, importColumns, parseCsv, toCsv } from "../../src/workbench/localization.js";
+
+describe("localization CSV", () => {
+  it("round-trips quoted fields with commas, quotes and line breaks", () => {
+    const rows = [
+      { Id: "A", en_us: 'Say "hi", then\nleave' },
+      { Id: "B", en_us: "plain" },
+    ];
+    const csv = toCsv(["Id", "en_us"], rows);
+    expect(csv).toBe('Id,en_us\nA,"Say ""hi"", then\nleave"\nB,plain');
+    expect(parseCsv(csv)).toEqual(rows);
+  });
+
+  it("accepts CRLF and ignores blank trailing lines", () => {
+    expect(parseCsv("Id,en_us\r\nX,1\r\n\r\n")).toEqual([{ Id: "X", en_us: "1" }]);
+  });
+});
+
+describe("diffLocalizationRows", () => {
+  const current = [
+    { Id: "A", en_us: "Alpha", comment: "c" },
+    { Id: "B", en_us: "Beta", comment: "" },
+  ];
+
+  it("sends only new or changed rows", () => {
+    const desired = [
+      { Id: "A", en_us: "Alpha" },
+      { Id: "B", en_us: "Beta 2" },
+      { Id: "C", en_us: "Gamma" },
+    ];
+    const diff = diffLocalizationRows(current, desired, importColumns(desired));
+    expect(diff.changed.map((r) => r.Id)).toEqual(["B", "C"]);
+    expect(diff.unchanged).toBe(1);
+    expect(diff.deleteIds).toEqual([]);
+  });
+
+  it("leaves columns a row does not mention alone", () => {
+    const desired = [{ Id: "A", en_us: "Alpha" }];
+    const diff = diffLocalizationRows(current, desired, ["Id", "en_us", "comment"]);
+    expect(diff.changed).toEqual([]);
+  });
+
+  it("lists missing ids for deletion only when asked", () => {
+    const desired = [{ Id: "A", en_us: "Alpha" }];
+    expect(diffLocalizationRows(current, desired, ["Id", "en_us"], { deleteMissing: true }).deleteIds).toEqual(["B"]);
+  });
+
+  it("refuses deleteMissing with an empty import", () => {
+    expect(() => diffLocalizationRows(current, [], ["Id"], { deleteMissing: true })).toThrow(/empty import/);
+    expect(() => diffLocalizationRows(current, parseCsv("Id,en_us\n"), ["Id", "en_us"], { deleteMissing: true })).toThrow(
+      /empty import/
+    );
+    expect(diffLocalizationRows(current, [], ["Id"]).deleteIds).toEqual([]);
+  });
+
+  it("rejects duplicate ids", () => {
+    expect(() => diffLocalizationRows(current, [{ Id: "A" }, { Id: "A" }], ["Id"])).toThrow(/Duplicate/);
+  });
+});
@@ -0,0 +1,146 @@
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { mkdirSync, rmSync, writeFileSync, appendFileSync, utimesSync } from "node:fs";
+import { join } from "node:path";
+import { tmpdir } from "node:os";
+import { waitForReady, formatReadinessPhases, type ProbeOutcome } from "../../src/workbench/readiness.js";
+
+const TEST_DIR = join(tmpdir(), "enfusion-mcp-readiness-test-" + process.pid);
+
+/** Start of a Workbench console.log up to the module our handlers compile in. */
+const SESSION_START = [
+  "12:00:00.000 INIT         : Workbench startup",
+  "12:00:00.120  INIT         : Workbench Init Engine",
+  "12:00:01.900   ENGINE    (E): Addon 'SampleMod' dependency '' can't be added",
+  "12:00:03.100 SCRIPT       : Compiling GameLib scripts",
+  "12:00:04.200 SCRIPT       : Compiling Game scripts",
+].join("\n") + "\n";
+const COMPILE_WORKBENCH_GAME = "12:00:06.300 SCRIPT       : Compiling WorkbenchGame scripts\n";
+/** Any line from another category ends the compile — nothing logs its end explicitly. */
+const AFTER_COMPILE = "12:00:07.400  WORLD        : Loading world\n";
+
+beforeAll(() => {
+  mkdirSync(TEST_DIR, { recursive: true });
+});
+
+afterAll(() => {
+  rmSync(TEST_DIR, { recursive: true, force: true });
+});
+
+describe("waitForReady", () => {
+  it("returns as soon as the probe succeeds", async () => {
+    const outcomes: ProbeOutcome[] = ["CONNECTION_REFUSED", "API_ERROR", "ready"];
+    const report = await waitForReady({
+      probe: async () => outcomes.shift() ?? "ready",
+      timeoutMs: 5_000,
+    });
+    expect(report.ready).toBe(true);
+    expect(report.probes).toBe(3);
+    expect(report.phases.portOpen).toBeDefined();
+    expect(report.phases.handlersReady).toBeDefined();
+    // Backoff starts at 100ms and grows 1.6x — two waits well under the old 3s poll
+    expect(report.totalMs).toBeLessThan(1_000);
+  });
+
+  it("times out and reports the last probe error", async () => {
+    const report = await waitForReady({
+      probe: async () => "CONNECTION_REFUSED",
+      timeoutMs: 300,
+    });
+    expect(report.ready).toBe(false);
+    expect(report.lastProbeError).toBe("CONNECTION_REFUSED");
+    expect(report.phases.portOpen).toBeUndefined();
+    expect(formatReadinessPhases(report)).toBe("no phases reached");
+  });
+
+  it("probes immediately when a log marker appears", async () => {
+    const logsDir = join(TEST_DIR, "logs");
+    const sessionDir = join(logsDir, "logs_2026-01-01_00-00-00");
+    mkdirSync(sessionDir, { recursive: true });
+    const logFile = join(sessionDir, "console.log");
+    writeFileSync(logFile, SESSION_START);
+
+    let compiled = false;
+    let probesAfterMarker = 0;
+    const probe = async (): Promise<ProbeOutcome> => {
+      if (!compiled) return "API_ERROR";
+      probesAfterMarker++;
+      return "ready";
+    };
+
+    // The start-of-compile line and the module's own warnings must not count
+    setTimeout(() => {
+      appendFileSync(logFile, COMPILE_WORKBENCH_GAME);
+      appendFileSync(logFile, "12:00:06.900 SCRIPT    (W): @\"Scripts/WorkbenchGame/Foo.c,12\": Variable 'x' is not used\n");
+    }, 300);
+    // Let the backoff grow past the log poll interval, then log past the compile
+    setTimeout(() => {
+      appendFileSync(logFile, AFTER_COMPILE);
+      compiled = true;
+    }, 1_200);
+
+    const report = await waitForReady({ probe, timeoutMs: 10_000, logsDir });
+    expect(report.ready).toBe(true);
+    expect(report.logFile).toBe(logFile);
+    expect(report.phases.logFound).toBeDefined();
+    expect(report.phases.scriptsCompiled).toBeGreaterThanOrEqual(1_000);
+    expect(probesAfterMarker).toBe(1);
+    // Without the wake-up the next probe would land up to 2s later
+    expect(report.phases.handlersReady! - report.phases.scriptsCompiled!).toBeLessThan(500);
+  });
+
+  it("does not report a failed WorkbenchGame compile", async () => {
+    const logsDir = join(TEST_DIR, "logs-failed");
+    const sessionDir = join(logsDir, "logs_2026-01-01_00-00-00");
+    mkdirSync(sessionDir, { recursive: true });
+    writeFileSync(
+      join(sessionDir, "console.log"),
+      SESSION_START +
+        COMPILE_WORKBENCH_GAME +
+        '12:00:06.800 SCRIPT    (E): Can\'t compile "WorkbenchGame" script module!\n' +
+        AFTER_COMPILE
+    );
+
+    const report = await waitForReady({ probe: async () => "API_ERROR", timeoutMs: 600, logsDir });
+    expect(report.ready).toBe(false);
+    expect(report.phases.logFound).toBeDefined();
+    expect(report.phases.scriptsCompiled).toBeUndefined();
+  });
+
+  it("tails the newest log from its end when Workbench was already running", async () => {
+    const logsDir = join(TEST_DIR, "logs-attached");
+    const olderDir = join(logsDir, "logs_2026-01-01_08-00-00");
+    const sessionDir = join(logsDir, "logs_2026-01-01_09-00-00");
+    mkdirSync(olderDir, { recursive: true });
+    mkdirSync(sessionDir, { recursive: true });
+    const logFile = join(sessionDir, "console.log");
+    // Both sessions started hours ago; the running one already finished its first compile
+    writeFileSync(join(olderDir, "console.log"), SESSION_START);
+    writeFileSync(logFile, SESSION_START + COMPILE_WORKBENCH_GAME + AFTER_COMPILE);
+    const hoursAgo = (Date.now() - 3 * 3600_000) / 1000;
+    utimesSync(join(olderDir, "console.log"), hoursAgo - 3600, hoursAgo - 3600);
+    utimesSync(olderDir, hoursAgo - 3600, hoursAgo - 3600);
+    utimesSync(sessionDir, hoursAgo, hoursAgo);
+
+    let compiled = false;
+    setTimeout(() => {
+      appendFileSync(logFile, COMPILE_WORKBENCH_GAME);
+      appendFileSync(logFile, AFTER_COMPILE);
+      compiled = true;
+    }, 600);
+
+    const report = await waitForReady({
+      probe: async () => (compiled ? "ready" : "API_ERROR"),
+      timeoutMs: 10_000,
+      logsDir,
+      attached: true,
+    });
+    expect(report.ready).toBe(true);
+    expect(report.logFile).toBe(logFile);
+    // The compile already in the log is history; only the recompile counts
+    expect(report.phases.scriptsCompiled).toBeGreaterThanOrEqual(500);
+
+    // A caller that launched Workbench itself would not pick up the hours-old log
+    const launched = await waitForReady({ probe: async () => "API_ERROR", timeoutMs: 400, logsDir });
+    expect(launched.phases.logFound).toBeUndefined();
+  });
+});
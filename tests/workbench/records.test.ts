@@ -0,0 +1,35 @@
+import { describe, it, expect } from "vitest";
+import { encodeRecords, decodeRecords, encodeEscapedRecords, unescapeField } from "../../src/workbench/records.js";
+
+describe("records", () => {
+  it("joins fields with tabs and records with newlines", () => {
+    const payload = encodeRecords([
+      ["move", "Tree_01", "1 2 3"],
+      ["setProperty", "House_02", "5", "MeshObject", "Object"],
+    ]);
+    expect(payload).toBe("move\tTree_01\t1 2 3\nsetProperty\tHouse_02\t5\tMeshObject\tObject");
+  });
+
+  it("keeps empty and undefined fields positional", () => {
+    const payload = encodeRecords([["clearProperty", "Tree_01", undefined, "", "Object"]]);
+    expect(decodeRecords(payload)).toEqual([["clearProperty", "Tree_01", "", "", "Object"]]);
+  });
+
+  it("round-trips numbers as strings", () => {
+    expect(decodeRecords(encodeRecords([["a", 1.5, -2]]))).toEqual([["a", "1.5", "-2"]]);
+  });
+
+  it("rejects fields containing separators", () => {
+    expect(() => encodeRecords([["rename", "A", "bad\tname"]])).toThrow(/Record 0 field 2/);
+    expect(() => encodeRecords([["ok"], ["rename", "A\nB"]])).toThrow(/Record 1 field 1/);
+    expect(() => encodeRecords([["x\r"]])).toThrow(/tab or newline/);
+  });
+});
+
+describe("escaped records", () => {
+  it("escapes free text so tabs and line breaks survive the wire", () => {
+    const payload = encodeEscapedRecords([["Id_1", "line one\nline\ttwo", "C:\\path"]]);
+    expect(payload).toBe("Id_1\tline one\\nline\\ttwo\tC:\\\\path");
+    expect(decodeRecords(payload)[0].map(unescapeField)).toEqual(["Id_1", "line one\nline\ttwo", "C:\\path"]);
+  });
+});
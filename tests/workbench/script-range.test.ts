@@ -0,0 +1,48 @@
+import { describe, it, expect } from "vitest";
+import { diffToHunk, encodePatch, splitLines } from "../../src/workbench/script-range.js";
+
+describe("splitLines", () => {
+  it("treats empty text as zero lines and strips CR", () => {
+    expect(splitLines("")).toEqual([]);
+    expect(splitLines("a\r\n\tb\r\n")).toEqual(["a", "\tb", ""]);
+  });
+});
+
+describe("diffToHunk", () => {
+  it("returns null for identical content", () => {
+    expect(diffToHunk(["a", "b"], ["a", "b"])).toBeNull();
+  });
+
+  it("trims the common prefix and suffix", () => {
+    expect(diffToHunk(["a", "b", "c", "d"], ["a", "x", "y", "d"])).toEqual({ line: 1, removeCount: 2, lines: ["x", "y"] });
+  });
+
+  it("handles pure inserts and deletes", () => {
+    expect(diffToHunk(["a", "c"], ["a", "b", "c"])).toEqual({ line: 1, removeCount: 0, lines: ["b"] });
+    expect(diffToHunk(["a", "b", "c"], ["a", "c"])).toEqual({ line: 1, removeCount: 1, lines: [] });
+  });
+
+  it("does not let prefix and suffix overlap on repeated lines", () => {
+    expect(diffToHunk(["x", "x"], ["x", "x", "x"])).toEqual({ line: 2, removeCount: 0, lines: ["x"] });
+  });
+});
+
+describe("encodePatch", () => {
+  it("sends numeric headers as records and all inserted lines as one block", () => {
+    const payload = encodePatch([
+      { line: 0, removeCount: 1, lines: ["\tint a;"] },
+      { line: 5, removeCount: 0, lines: ["b", "c"] },
+    ]);
+    expect(payload.hunks).toBe("0\t1\t1\n5\t0\t2");
+    expect(payload.text).toBe("\tint a;\nb\nc");
+  });
+
+  it("rejects overlapping or unordered hunks", () => {
+    expect(() =>
+      encodePatch([
+        { line: 3, removeCount: 2, lines: [] },
+        { line: 4, removeCount: 1, lines: [] },
+      ])
+    ).toThrow(/overlaps/);
+  });
+});
@@ -0,0 +1,42 @@
+import { describe, it, expect } from "vitest";
+import { LevelSnapshot } from "../../src/workbench/snapshot.js";
+
+const EXPORT = [
+  '{"type":"header","entityCount":3,"generation":"4-3"}',
+  '{"name":"Base_HQ","class":"GenericEntity","prefab":"{A1}Prefabs/Base.et","layer":0,"parent":"","position":"100 5 200","rotation":"0 90 0","props":{},"components":[{"class":"SCR_FactionAffiliationComponent","props":{"faction affiliation":"US"}}]}',
+  '{"name":"Tree_01","class":"Tree","prefab":"{B2}Prefabs/Tree.et","layer":1,"parent":"","position":"10 0 10","rotation":"0 0 0","props":{"scale":"1.2"},"components":[]}',
+  '{"name":"Flag","class":"GenericEntity","prefab":"","layer":0,"parent":"Base_HQ","position":"1 0 1","rotation":"0 0 0","props":{},"components":[{"class":"MeshObject","props":{}},{"class":"MeshObject","props":{}}]}',
+  '{"name":"Trunc',
+].join("\n");
+
+describe("LevelSnapshot", () => {
+  const snapshot = LevelSnapshot.fromText(EXPORT);
+
+  it("reads the header and indexes entities by name", () => {
+    expect(snapshot.header).toEqual({ entityCount: 3, generation: "4-3" });
+    expect(snapshot.entities).toHaveLength(3);
+    expect(snapshot.byName.get("Flag")?.parent).toBe("Base_HQ");
+    expect(snapshot.skippedLines).toBe(1);
+  });
+
+  it("filters by component and property value", () => {
+    const hits = snapshot.query({ component: "faction", property: "faction affiliation", value: "us" });
+    expect(hits.map((e) => e.name)).toEqual(["Base_HQ"]);
+    expect(snapshot.query({ property: "scale" }).map((e) => e.name)).toEqual(["Tree_01"]);
+  });
+
+  it("filters by XZ box, layer and parent", () => {
+    expect(snapshot.query({ bboxMin: { x: 50, z: 50 }, bboxMax: { x: 150, z: 250 } }).map((e) => e.name)).toEqual(["Base_HQ"]);
+    expect(snapshot.query({ layer: 1 }).map((e) => e.name)).toEqual(["Tree_01"]);
+    expect(snapshot.query({ parent: "" }).map((e) => e.name)).toEqual(["Base_HQ", "Tree_01"]);
+  });
+
+  it("counts components once per entity", () => {
+    expect(snapshot.countBy("component")).toEqual([
+      ["MeshObject", 1],
+      ["SCR_FactionAffiliationComponent", 1],
+    ]);
+    expect(snapshot.countBy("class")[0]).toEqual(["GenericEntity", 2]);
+    expect(snapshot.countBy("prefab")).toContainEqual(["(no prefab)", 1]);
+  });
+});
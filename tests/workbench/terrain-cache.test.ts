@@ -0,0 +1,154 @@
+import { describe, it, expect } from "vitest";
+import { TerrainTileCache, interpolateHeight, type HeightGrid } from "../../src/workbench/terrain-cache.js";
+
+/** Planar terrain y = 0.5x + 0.25z + 10, sampled like the Workbench grid action. */
+function planeGrid(minX: number, minZ: number, maxX: number, maxZ: number, step: number): HeightGrid {
+  const cols = Math.floor((maxX - minX) / step) + 1;
+  const rows = Math.floor((maxZ - minZ) / step) + 1;
+  const heights: number[] = [];
+  for (let r = 0; r < rows; r++) {
+    for (let c = 0; c < cols; c++) {
+      heights.push(0.5 * (minX + c * step) + 0.25 * (minZ + r * step) + 10);
+    }
+  }
+  return { originX: minX, originZ: minZ, step, cols, rows, heights };
+}
+
+describe("interpolateHeight", () => {
+  it("is exact on grid nodes and linear in between", () => {
+    const grid = planeGrid(0, 0, 4, 4, 1);
+    expect(interpolateHeight(grid, 2, 3)).toBeCloseTo(11.75);
+    expect(interpolateHeight(grid, 2.5, 3.5)).toBeCloseTo(12.125);
+  });
+
+  it("clamps outside the grid", () => {
+    const grid = planeGrid(0, 0, 4, 4, 1);
+    expect(interpolateHeight(grid, -10, 0)).toBeCloseTo(10);
+    expect(interpolateHeight(grid, 100, 4)).toBeCloseTo(13);
+  });
+});
+
+describe("TerrainTileCache", () => {
+  it("fetches each tile once and answers repeats from memory", async () => {
+    const fetches: number[][] = [];
+    const cache = new TerrainTileCache(async (...args) => {
+      fetches.push(args);
+      return planeGrid(...args);
+    });
+
+    const first = await cache.sample([
+      { x: 10, z: 10 },
+      { x: 20.5, z: 30.25 },
+      { x: 70, z: 10 },
+    ]);
+    expect(first.tilesFetched).toBe(2);
+    expect(first.heights[1]).toBeCloseTo(0.5 * 20.5 + 0.25 * 30.25 + 10);
+    expect(fetches).toEqual([
+      [0, 0, 64, 64, 1],
+      [64, 0, 128, 64, 1],
+    ]);
+
+    const second = await cache.sample([{ x: 63.9, z: 63.9 }, { x: 100, z: 5 }]);
+    expect(second.tilesFetched).toBe(0);
+    expect(second.tilesCached).toBe(2);
+    expect(fetches).toHaveLength(2);
+  });
+
+  it("handles negative coordinates", async () => {
+    const cache = new TerrainTileCache(async (...args) => planeGrid(...args));
+    const { heights } = await cache.sample([{ x: -0.5, z: -64 }]);
+    expect(heights[0]).toBeCloseTo(0.5 * -0.5 + 0.25 * -64 + 10);
+  });
+
+  it("evicts least recently used tiles beyond maxTiles", async () => {
+    let fetchCount = 0;
+    const cache = new TerrainTileCache(
+      async (...args) => {
+        fetchCount++;
+        return planeGrid(...args);
+      },
+      { maxTiles: 2 }
+    );
+    await cache.sample([{ x: 1, z: 1 }]); // tile A
+    await cache.sample([{ x: 65, z: 1 }]); // tile B
+    await cache.sample([{ x: 1, z: 1 }]); // A becomes most recent
+    await cache.sample([{ x: 129, z: 1 }]); // C evicts B
+    expect(cache.size).toBe(2);
+    await cache.sample([{ x: 1, z: 1 }]);
+    expect(fetchCount).toBe(3);
+    await cache.sample([{ x: 65, z: 1 }]);
+    expect(fetchCount).toBe(4);
+  });
+
+  it("batches scattered points into one call and fetches tiles only where dense", async () => {
+    const gridFetches: number[][] = [];
+    const pointCalls: number[] = [];
+    const plane = (p: { x: number; z: number }) => 0.5 * p.x + 0.25 * p.z + 10;
+    const cache = new TerrainTileCache(
+      async (...args) => {
+        gridFetches.push(args);
+        return planeGrid(...args);
+      },
+      {
+        denseTilePoints: 4,
+        fetchPoints: async (points) => {
+          pointCalls.push(points.length);
+          return points.map(plane);
+        },
+      }
+    );
+
+    // Four points in one tile, plus three far apart in different tiles
+    const dense = [1, 2, 3, 4].map((i) => ({ x: i, z: i }));
+    const scattered = [
+      { x: 1000, z: 0 },
+      { x: 0, z: 5000 },
+      { x: -3000, z: -3000 },
+    ];
+    const result = await cache.sample([scattered[0], ...dense, scattered[1], scattered[2]]);
+    expect(gridFetches).toEqual([[0, 0, 64, 64, 1]]);
+    expect(pointCalls).toEqual([3]);
+    expect(result).toMatchObject({ tilesFetched: 1, tilesCached: 0, pointsFetched: 3 });
+    expect(result.heights[0]).toBeCloseTo(plane(scattered[0]));
+    expect(result.heights[2]).toBeCloseTo(plane(dense[1]));
+    expect(result.heights[6]).toBeCloseTo(plane(scattered[2]));
+
+    // A single point in the now cached tile is answered locally
+    const again = await cache.sample([{ x: 10, z: 10 }]);
+    expect(again).toMatchObject({ tilesFetched: 0, tilesCached: 1, pointsFetched: 0 });
+    expect(pointCalls).toEqual([3]);
+  });
+
+  it("fetches a tile once scattered queries have hit it enough", async () => {
+    let gridFetches = 0;
+    const pointCalls: number[] = [];
+    const cache = new TerrainTileCache(
+      async (...args) => {
+        gridFetches++;
+        return planeGrid(...args);
+      },
+      {
+        denseTilePoints: 4,
+        fetchPoints: async (points) => {
+          pointCalls.push(points.length);
+          return points.map((p) => 0.5 * p.x + 0.25 * p.z + 10);
+        },
+      }
+    );
+
+    for (const x of [1, 2, 3]) {
+      expect(await cache.sample([{ x, z: 5 }])).toMatchObject({ tilesFetched: 0, pointsFetched: 1 });
+    }
+    expect(gridFetches).toBe(0);
+    // The fourth point in the same tile reaches denseTilePoints
+    expect(await cache.sample([{ x: 4, z: 5 }])).toMatchObject({ tilesFetched: 1, pointsFetched: 0 });
+    expect(await cache.sample([{ x: 5, z: 5 }])).toMatchObject({ tilesCached: 1, pointsFetched: 0 });
+    expect(gridFetches).toBe(1);
+    expect(pointCalls).toEqual([1, 1, 1]);
+  });
+
+  it("rejects malformed tiles", async () => {
+    const cache = new TerrainTileCache(async () => ({ originX: 0, originZ: 0, step: 1, cols: 3, rows: 3, heights: [1, 2] }));
+    await expect(cache.sample([{ x: 1, z: 1 }])).rejects.toThrow(/Malformed terrain tile/);
+  });
+});